@@ -1,6 +1,7 @@
 // --- cdrom.c ---
 #include "cdrom.h"
 #include "interconnect.h" // For interrupt definitions/requests IRQ_CDROM
+#include "logger.h"
 #include <stdio.h>
 #include <string.h> // For memset
 #include <stdlib.h> // For exit if needed
@@ -55,6 +56,7 @@ static uint8_t bcd_to_int(uint8_t bcd);
 static void update_status_register(Cdrom* cdrom);
 static void trigger_interrupt(Cdrom* cdrom, uint8_t int_code);
 static void cdrom_schedule_event(Cdrom* cdrom, uint32_t cycles, void (*handler)(Cdrom*));
+static void cdrom_event(void* context, SchedulerEvent event);
 
 
 // --- FIFO Helpers (Your implementation is great, no changes needed) ---
@@ -89,8 +91,8 @@ static uint8_t bcd_to_int(uint8_t bcd) { return ((bcd >> 4) * 10) + (bcd & 0x0F)
 // --- Internal Helper Functions ---
 
 static void cdrom_schedule_event(Cdrom* cdrom, uint32_t cycles, void (*handler)(Cdrom*)) {
-    cdrom->cycles_until_event = cycles;
     cdrom->pending_completion_handler = handler;
+    scheduler_schedule(&cdrom->inter->scheduler, SCHED_EVENT_CDROM, cycles);
 }
 
 static void update_status_register(Cdrom* cdrom) {
@@ -116,7 +118,7 @@ static void trigger_interrupt(Cdrom* cdrom, uint8_t int_code) {
 // --- Command Handlers (This is where the main logic is filled in) ---
 
 static void cmd_get_stat(Cdrom* cdrom) {
-    printf("~ CDROM CMD: GetStat (0x01)\n");    
+    LOG_TRACE(LOG_CDROM, "~ CDROM CMD: GetStat (0x01)\n");    
     // <<< MODIFIED >>>
     fifo_clear(&cdrom->response_fifo);
     update_status_register(cdrom);
@@ -126,7 +128,7 @@ static void cmd_get_stat(Cdrom* cdrom) {
 
 // <<< MODIFIED: Implemented two-stage Init >>>
 static void cmd_init(Cdrom* cdrom) {
-    printf("~ CDROM CMD: Init (0x0A) - Step 1\n");
+    LOG_TRACE(LOG_CDROM, "~ CDROM CMD: Init (0x0A) - Step 1\n");
     cdrom->current_state = CD_STATE_CMD_EXEC;
     cdrom->status |= STAT_BUSY | STAT_MOTORON;
 
@@ -141,7 +143,7 @@ static void cmd_init(Cdrom* cdrom) {
 }
 
 static void cmd_init_complete(Cdrom* cdrom) {
-    printf("  CDROM Init - Step 2 (Completion)\n");
+    LOG_DEBUG(LOG_CDROM, "  CDROM Init - Step 2 (Completion)\n");
     cdrom->status &= ~STAT_BUSY;
 
     // Reset internal state
@@ -160,7 +162,7 @@ static void cmd_init_complete(Cdrom* cdrom) {
 
 // <<< MODIFIED: Implemented two-stage GetID >>>
 static void cmd_get_id(Cdrom* cdrom) {
-    printf("~ CDROM CMD: GetID (0x1A) - Step 1\n");
+    LOG_TRACE(LOG_CDROM, "~ CDROM CMD: GetID (0x1A) - Step 1\n");
     cdrom->current_state = CD_STATE_CMD_EXEC;
     cdrom->status |= STAT_BUSY;
 
@@ -175,7 +177,7 @@ static void cmd_get_id(Cdrom* cdrom) {
 }
 
 static void cmd_get_id_complete(Cdrom* cdrom) {
-    printf("  CDROM GetID - Step 2 (Completion)\n");
+    LOG_DEBUG(LOG_CDROM, "  CDROM GetID - Step 2 (Completion)\n");
     cdrom->status &= ~STAT_BUSY;
 
     if (!cdrom->disc_present) {
@@ -204,7 +206,7 @@ static void cmd_get_id_complete(Cdrom* cdrom) {
 // <<< MODIFIED: Implemented Test(0x20) >>>
 static void cmd_test(Cdrom* cdrom) {
     uint8_t sub_command = fifo_pop(&cdrom->param_fifo);
-    printf("~ CDROM CMD: Test (0x19), Sub: 0x%02x\n", sub_command);
+    LOG_TRACE(LOG_CDROM, "~ CDROM CMD: Test (0x19), Sub: 0x%02x\n", sub_command);
     
     fifo_clear(&cdrom->response_fifo);
     
@@ -215,14 +217,14 @@ static void cmd_test(Cdrom* cdrom) {
 
     switch (sub_command) {
         case 0x20: // Get BIOS Date/Version
-            printf("  CDROM Test(0x20): Get BIOS Date\n");
+            LOG_DEBUG(LOG_CDROM, "  CDROM Test(0x20): Get BIOS Date\n");
             fifo_push(&cdrom->response_fifo, 0x94); // Year
             fifo_push(&cdrom->response_fifo, 0x12); // Month
             fifo_push(&cdrom->response_fifo, 0x20); // Day
             fifo_push(&cdrom->response_fifo, 0xC2); // Version (from SCPH1001)
             break;
         default:
-             printf("  CDROM Test: Unhandled sub 0x%02x\n", sub_command);
+             LOG_WARN(LOG_CDROM, "  CDROM Test: Unhandled sub 0x%02x\n", sub_command);
              fifo_push(&cdrom->response_fifo, 0x00); // Placeholder
              break;
     }
@@ -232,7 +234,7 @@ static void cmd_test(Cdrom* cdrom) {
 
 // Stubs for other commands - no changes needed yet
 static void cmd_pause(Cdrom* cdrom) {
-    printf("~ CDROM CMD: Pause (0x09)\n");
+    LOG_TRACE(LOG_CDROM, "~ CDROM CMD: Pause (0x09)\n");
     cdrom->current_state = CD_STATE_CMD_EXEC;
     cdrom->status |= STAT_BUSY;
     update_status_register(cdrom);
@@ -242,7 +244,7 @@ static void cmd_pause(Cdrom* cdrom) {
 }
 
 static void cmd_pause_complete(Cdrom* cdrom) {
-    printf("  CDROM Pause - Complete\n");
+    LOG_DEBUG(LOG_CDROM, "  CDROM Pause - Complete\n");
     cdrom->status &= ~STAT_BUSY;
     cdrom->current_state = CD_STATE_IDLE;
     update_status_register(cdrom);
@@ -265,17 +267,39 @@ static void cdrom_handle_command(Cdrom* cdrom, uint8_t command) {
         case CDC_TEST:    cmd_test(cdrom); break;
         case CDC_GETID:   cmd_get_id(cdrom); break;
         default:
-            fprintf(stderr, "CDROM Error: Unhandled command 0x%02x\n", command);
+            LOG_ERROR(LOG_CDROM, "CDROM Error: Unhandled command 0x%02x\n", command);
             break;
     }
 }
 
 
+// --- I/O Registers ---
+// The four byte-wide registers at CDROM_START. The register file (cdrom_read_register /
+// cdrom_write_register) is not hooked up to the bus yet: reads return 0 and writes are
+// dropped, as the interconnect did before the dispatch table.
+static uint8_t cdrom_io_read8(void* device, uint32_t offset) {
+    (void)device;
+    (void)offset;
+    return 0; // Placeholder response
+}
+
+static void cdrom_io_write8(void* device, uint32_t offset, uint8_t value) {
+    (void)device;
+    LOG_TRACE(LOG_CDROM, "~ Write8 to CDROM Reg (0x%08x) = 0x%02x (Ignoring)\n", CDROM_START + offset, value);
+}
+
+static const IoHandler cdrom_io_handler = {
+    .name = "CDROM",
+    .read8 = cdrom_io_read8,
+    .write8 = cdrom_io_write8,
+};
+
+
 // --- Core Public Functions ---
 
 // cdrom_init: No changes needed
 void cdrom_init(Cdrom* cdrom, struct Interconnect* inter) {
-    printf("Initializing CD-ROM...\n");
+    LOG_INFO(LOG_CDROM, "Initializing CD-ROM...\n");
     memset(cdrom, 0, sizeof(Cdrom));
     cdrom->inter = inter;
     cdrom->status = STAT_PRMEMPT | STAT_PRMWRDY;
@@ -284,20 +308,22 @@ void cdrom_init(Cdrom* cdrom, struct Interconnect* inter) {
     cdrom->current_state = CD_STATE_IDLE;
     fifo_init(&cdrom->param_fifo);
     fifo_init(&cdrom->response_fifo);
-    printf("  CDROM Initial Status: 0x%02x\n", cdrom->status);
+    scheduler_register(&inter->scheduler, SCHED_EVENT_CDROM, cdrom_event, cdrom);
+    interconnect_register_io(inter, CDROM_START, CDROM_SIZE, &cdrom_io_handler, cdrom);
+    LOG_INFO(LOG_CDROM, "  CDROM Initial Status: 0x%02x\n", cdrom->status);
 }
 
 static void cmd_set_loc(Cdrom* cdrom) {
-    printf("~ CDROM CMD: SetLoc (0x02)\n");
+    LOG_TRACE(LOG_CDROM, "~ CDROM CMD: SetLoc (0x02)\n");
     if (cdrom->param_fifo.count < 3) {
-        printf("  ERROR: SetLoc requires 3 parameters.\n");
+        LOG_ERROR(LOG_CDROM, "  ERROR: SetLoc requires 3 parameters.\n");
         return;
     }
     uint8_t m = bcd_to_int(fifo_pop(&cdrom->param_fifo));
     uint8_t s = bcd_to_int(fifo_pop(&cdrom->param_fifo));
     uint8_t f = bcd_to_int(fifo_pop(&cdrom->param_fifo));
     cdrom->target_lba = (m * 60 * 75) + (s * 75) + f - 150;
-    printf("  Set LBA to %u (M:%u S:%u F:%u)\n", cdrom->target_lba, m, s, f);
+    LOG_DEBUG(LOG_CDROM, "  Set LBA to %u (M:%u S:%u F:%u)\n", cdrom->target_lba, m, s, f);
 
     cdrom->current_state = CD_STATE_CMD_EXEC;
     cdrom->status |= STAT_BUSY;
@@ -306,7 +332,7 @@ static void cmd_set_loc(Cdrom* cdrom) {
 
 // ADDED completion handler
 static void cmd_set_loc_complete(Cdrom* cdrom) {
-    printf("~ CDROM CMD set_loc_complete)\n");
+    LOG_TRACE(LOG_CDROM, "~ CDROM CMD set_loc_complete)\n");
 
     cdrom->status &= ~STAT_BUSY;
     update_status_register(cdrom);
@@ -320,7 +346,7 @@ static void cmd_set_loc_complete(Cdrom* cdrom) {
 bool cdrom_load_disc(Cdrom* cdrom, const char* bin_filename) {
     if (cdrom->disc_file) { fclose(cdrom->disc_file); cdrom->disc_file = NULL; }
     
-    printf("CDROM: Attempting to load disc image '%s'\n", bin_filename);
+    LOG_INFO(LOG_CDROM, "CDROM: Attempting to load disc image '%s'\n", bin_filename);
     cdrom->disc_file = fopen(bin_filename, "rb");
     if (!cdrom->disc_file) {
         perror("CDROM Error: Failed to open disc image");
@@ -339,7 +365,7 @@ bool cdrom_load_disc(Cdrom* cdrom, const char* bin_filename) {
     }
     rewind(cdrom->disc_file);
 
-    printf("CDROM: Disc image loaded successfully.\n");
+    LOG_INFO(LOG_CDROM, "CDROM: Disc image loaded successfully.\n");
     cdrom->disc_present = true;
     cdrom->current_state = CD_STATE_IDLE;
     return true;
@@ -368,7 +394,7 @@ uint8_t cdrom_read_register(Cdrom* cdrom, uint32_t addr) {
 
 // cdrom_write_register: No changes needed
 void cdrom_write_register(Cdrom* cdrom, uint32_t addr, uint8_t value) {
-    printf("CDROM Write: Index=%d, Offset=0x%x, Value=0x%02x\n", cdrom->index, addr & 3, value);
+    LOG_DEBUG(LOG_CDROM, "CDROM Write: Index=%d, Offset=0x%x, Value=0x%02x\n", cdrom->index, addr & 3, value);
     uint8_t offset = addr & 3;
     uint8_t reg_index = cdrom->index;
 
@@ -397,7 +423,7 @@ void cdrom_write_register(Cdrom* cdrom, uint32_t addr, uint8_t value) {
 }
 
 static void cmd_read_n(Cdrom* cdrom) {
-    printf("~ CDROM CMD: ReadN (0x06)\n");
+    LOG_TRACE(LOG_CDROM, "~ CDROM CMD: ReadN (0x06)\n");
     cdrom->current_state = CD_STATE_CMD_EXEC;
     cdrom->status |= STAT_BUSY;
     update_status_register(cdrom);
@@ -408,7 +434,7 @@ static void cmd_read_n(Cdrom* cdrom) {
 
 // ADDED completion handler
 static void cmd_read_n_complete(Cdrom* cdrom) {
-    printf("  CDROM ReadN - Complete\n");
+    LOG_DEBUG(LOG_CDROM, "  CDROM ReadN - Complete\n");
     // This is a dummy read. We don't load from the file yet.
     // We just signal that data is ready.
     cdrom->status &= ~STAT_BUSY;
@@ -420,13 +446,13 @@ static void cmd_read_n_complete(Cdrom* cdrom) {
 }
 
 static void cmd_seek_l(Cdrom* cdrom) {
-    printf("~ CDROM CMD: SeekL (0x15) - Forwarding to SetLoc\n");
+    LOG_TRACE(LOG_CDROM, "~ CDROM CMD: SeekL (0x15) - Forwarding to SetLoc\n");
     cmd_set_loc(cdrom); // SeekL is mechanically the same as SetLoc for our purposes
 }
 
 static void cmd_set_mode(Cdrom* cdrom) {
     uint8_t mode = fifo_pop(&cdrom->param_fifo);
-    printf("~ CDROM CMD: SetMode (0x0E) to 0x%02x\n", mode);
+    LOG_TRACE(LOG_CDROM, "~ CDROM CMD: SetMode (0x0E) to 0x%02x\n", mode);
     cdrom->double_speed = (mode & 0x80) != 0;
     cdrom->is_cd_da = (mode & 0x40) != 0;
     cdrom->sector_size_is_2340 = (mode & 0x20) != 0;
@@ -437,7 +463,7 @@ static void cmd_set_mode(Cdrom* cdrom) {
 }
 
 static void cmd_stop(Cdrom* cdrom) {
-    printf("~ CDROM CMD: Stop (0x08)\n");
+    LOG_TRACE(LOG_CDROM, "~ CDROM CMD: Stop (0x08)\n");
     cdrom->current_state = CD_STATE_IDLE;
     cdrom->status &= ~(STAT_BUSY | STAT_MOTORON);
     update_status_register(cdrom);
@@ -445,17 +471,44 @@ static void cmd_stop(Cdrom* cdrom) {
     trigger_interrupt(cdrom, 2); // INT2
 }
 
-// cdrom_step: No changes needed
-void cdrom_step(Cdrom* cdrom, uint32_t cycles) {
-    if (cdrom->cycles_until_event > 0) {
-        if (cycles >= cdrom->cycles_until_event) {
-            cdrom->cycles_until_event = 0;
-            if (cdrom->pending_completion_handler) {
-                cdrom->pending_completion_handler(cdrom);
-                cdrom->pending_completion_handler = NULL;
-            }
-        } else {
-            cdrom->cycles_until_event -= cycles;
-        }
+/**
+ * @brief SCHED_EVENT_CDROM callback: runs the second stage of the pending command.
+ * The handler is cleared before the call so it can schedule a follow-up stage.
+ */
+static void cdrom_event(void* context, SchedulerEvent event) {
+    (void)event;
+    Cdrom* cdrom = (Cdrom*)context;
+    void (*handler)(Cdrom*) = cdrom->pending_completion_handler;
+    cdrom->pending_completion_handler = NULL;
+    if (handler) {
+        handler(cdrom);
     }
-}
\ No newline at end of file
+}
+
+// --- Save State Support ---
+// Stable IDs for pending_completion_handler (0 = none). They are stored in save states:
+// append new handlers at the end, never reorder.
+static void (* const completion_table[])(Cdrom*) = {
+    NULL,
+    cmd_init_complete,
+    cmd_get_id_complete,
+    cmd_pause_complete,
+    cmd_read_n_complete,
+    cmd_set_loc_complete,
+};
+#define COMPLETION_COUNT (sizeof(completion_table) / sizeof(completion_table[0]))
+
+uint8_t cdrom_completion_id(const Cdrom* cdrom) {
+    for (uint32_t id = 0; id < COMPLETION_COUNT; ++id) {
+        if (completion_table[id] == cdrom->pending_completion_handler) return (uint8_t)id;
+    }
+    LOG_WARN(LOG_CDROM, "Warning: completion handler for CDROM command 0x%02x has no save-state ID, storing none\n",
+             cdrom->pending_command);
+    return 0;
+}
+
+bool cdrom_set_completion_id(Cdrom* cdrom, uint8_t id) {
+    if (id >= COMPLETION_COUNT) return false;
+    cdrom->pending_completion_handler = completion_table[id];
+    return true;
+}
@@ -93,8 +93,7 @@ typedef struct Cdrom {
     uint8_t pending_command;
 
     // --- Timing & Scheduling --- <<< NEW SECTION
-    /** @brief Cycles until the current command is complete */
-    uint32_t cycles_until_event;
+    // The delay itself is the SCHED_EVENT_CDROM deadline in the global scheduler.
     /** @brief The second part of a command to execute after a delay */
     void (*pending_completion_handler)(struct Cdrom*);
 
@@ -159,11 +158,19 @@ void cdrom_write_register(Cdrom* cdrom, uint32_t addr, uint8_t value);
  */
 bool cdrom_load_disc(Cdrom* cdrom, const char* bin_filename);
 
-// TODO: Add function prototype for stepping CDROM state machine/timing if needed
 /**
- * @brief Steps the CD-ROM state machine, handling command delays and completion.
+ * @brief Save-state ID of the pending completion handler (0 = none).
  * @param cdrom Pointer to the Cdrom state structure.
- * @param cycles The number of CPU cycles that have passed since the last step.
+ * @return The handler's ID.
  */
-void cdrom_step(Cdrom* cdrom, uint32_t cycles);
+uint8_t cdrom_completion_id(const Cdrom* cdrom);
+
+/**
+ * @brief Restores the pending completion handler from its save-state ID.
+ * @param cdrom Pointer to the Cdrom state structure.
+ * @param id ID returned by cdrom_completion_id().
+ * @return False if the ID is unknown.
+ */
+bool cdrom_set_completion_id(Cdrom* cdrom, uint8_t id);
+
 #endif // CDROM_H
\ No newline at end of file
@@ -1,8 +1,11 @@
 #include "cpu.h"
+#include "cpu_jit.h"
+#include "logger.h"
+#include "trace.h"
 #include <stdio.h>
 #include <stdlib.h> // For exit() on fatal errors (like GTE)
 #include <limits.h> // If needed for overflow checks (though __builtin is used)
-#include <string.h> // For memcpy
+#include <string.h> // For memset
 #include <stdbool.h>// For bool type
 
 // --- CPU Initialization ---
@@ -10,7 +13,7 @@
  * @brief Initializes the CPU state to power-on defaults.
  */
 void cpu_init(Cpu* cpu, Interconnect* inter) {
-    printf("Initializing CPU...\n");
+    LOG_INFO(LOG_CPU, "Initializing CPU...\n");
 
     cpu->pc = 0xbfc00000;         // Reset vector: Start of BIOS
     cpu->next_pc = cpu->pc + 4;   // Initial next PC
@@ -19,15 +22,15 @@ void cpu_init(Cpu* cpu, Interconnect* inter) {
 
     // Initialize GPRs
     for (int i = 0; i < 32; ++i) {
-        cpu->regs[i] = 0xdeadbeef;     // Input set garbage value
-        cpu->out_regs[i] = 0xdeadbeef; // Output set garbage value
+        cpu->regs[i] = 0xdeadbeef;     // Garbage value
     }
     cpu->regs[REG_ZERO] = 0;      // R0 is always 0
-    cpu->out_regs[REG_ZERO] = 0;  // Ensure R0 is 0 in output set too
 
     // Initialize Load Delay Slot state
     cpu->load_reg_idx = REG_ZERO; // Target R0 initially (no-op)
     cpu->load_value = 0;
+    cpu->next_load_reg_idx = REG_ZERO;
+    cpu->next_load_value = 0;
 
     // Initialize HI/LO registers
     cpu->hi = 0xdeadbeef;
@@ -42,7 +45,7 @@ void cpu_init(Cpu* cpu, Interconnect* inter) {
     cpu->cause = 0;         // Cause Register (cleared)
     cpu->epc = 0;           // Exception PC (cleared)
 
-    printf("  Initializing I-Cache...\n");
+    LOG_INFO(LOG_CPU, "  Initializing I-Cache...\n");
     for (int i = 0; i < ICACHE_NUM_LINES; ++i) {
         cpu->icache[i].tag = 0xFFFFFFFF; // Initialize tag to an invalid pattern
         for (int j = 0; j < ICACHE_LINE_WORDS; ++j) {
@@ -51,37 +54,89 @@ void cpu_init(Cpu* cpu, Interconnect* inter) {
         }
     }
 
-    printf("CPU Initialized: PC=0x%08x, NextPC=0x%08x, SR=0x%08x\n", cpu->pc, cpu->next_pc, cpu->sr);
+    LOG_INFO(LOG_CPU, "  Initializing Block Cache...\n");
+    cpu->exec_mode = CPU_EXEC_CACHED;
+    cpu->block_exit = false;
+    cpu->irq_pending = false;
+    cpu->blocks_compiled = 0;
+    cpu->idle_loop_hit = false;
+    cpu->idle_cycles_skipped = 0;
+    cpu->block_cache = malloc(sizeof(CpuBlock) * CPU_BLOCK_CACHE_SIZE);
+    if (!cpu->block_cache) {
+        LOG_WARN(LOG_CPU, "Warning: Failed to allocate CPU block cache, using the interpreter.\n");
+        cpu->exec_mode = CPU_EXEC_INTERPRETER;
+    } else {
+        for (int i = 0; i < CPU_BLOCK_CACHE_SIZE; ++i) {
+            cpu->block_cache[i].paddr = CPU_BLOCK_INVALID;
+            cpu->block_cache[i].len = 0;
+        }
+    }
+    inter->cpu = cpu; // Register for code page invalidations
+
+    LOG_INFO(LOG_CPU, "  Initializing JIT Code Buffer...\n");
+    if (!cpu_jit_init(cpu)) {
+        LOG_INFO(LOG_CPU, "  JIT unavailable on this host (cached interpreter only).\n");
+    }
+
+    LOG_INFO(LOG_CPU, "CPU Initialized: PC=0x%08x, NextPC=0x%08x, SR=0x%08x\n", cpu->pc, cpu->next_pc, cpu->sr);
+}
+
+/**
+ * @brief Releases the block cache.
+ */
+void cpu_destroy(Cpu* cpu) {
+    cpu_jit_destroy(cpu);
+    free(cpu->block_cache);
+    cpu->block_cache = NULL;
+    cpu->exec_mode = CPU_EXEC_INTERPRETER;
 }
 
 
 // --- Register Access ---
+// Indices always come from 5-bit instruction fields, so no bounds checks are needed.
 /**
- * @brief Reads the value of a GPR from the input set (cpu->regs).
+ * @brief Reads the value of a GPR.
  */
 uint32_t cpu_reg(Cpu* cpu, RegisterIndex index) {
     // No need to check index 0 specifically, as cpu->regs[0] is always 0.
-    if (index >= 32) {
-        fprintf(stderr, "GPR read index out of bounds: %u\n", index);
-        return 0; // Or trigger an internal error
-    }
-    return cpu->regs[index];
+    return cpu->regs[index & 0x1F];
 }
 
 /**
- * @brief Writes a value to a GPR in the output set (cpu->out_regs).
+ * @brief Writes a value to a GPR. The write wins over a pending load to the same register.
  */
 void cpu_set_reg(Cpu* cpu, RegisterIndex index, uint32_t value) {
-    if (index >= 32) {
-        fprintf(stderr, "GPR write index out of bounds: %u\n", index);
-        return;
+    index &= 0x1F;
+    cpu->regs[index] = value;
+    cpu->regs[REG_ZERO] = 0; // Cheaper than branching on index 0
+    if (cpu->load_reg_idx == index) {
+        cpu->load_reg_idx = REG_ZERO; // Cancel the pending load
     }
-    // Write to output register file, *except* for R0
-    if (index != REG_ZERO) {
-        cpu->out_regs[index] = value;
+}
+
+// --- Load Delay Slot Helpers ---
+/**
+ * @brief Records a load issued by the current instruction; it lands after the next one.
+ * A newer load to the same register supersedes the pending one.
+ */
+static inline void cpu_schedule_load(Cpu* cpu, RegisterIndex index, uint32_t value) {
+    if (cpu->load_reg_idx == index) {
+        cpu->load_reg_idx = REG_ZERO;
     }
-    // Ensure R0 in the output set remains 0, regardless of attempted write.
-    cpu->out_regs[REG_ZERO] = 0;
+    cpu->next_load_reg_idx = index;
+    cpu->next_load_value = value;
+}
+
+/**
+ * @brief Retires the current instruction's load delay bookkeeping:
+ * the pending load is written back and the load issued by this instruction becomes pending.
+ */
+static inline void cpu_retire_load_delay(Cpu* cpu) {
+    cpu->regs[cpu->load_reg_idx] = cpu->load_value;
+    cpu->regs[REG_ZERO] = 0;
+    cpu->load_reg_idx = cpu->next_load_reg_idx;
+    cpu->load_value = cpu->next_load_value;
+    cpu->next_load_reg_idx = REG_ZERO;
 }
 
 
@@ -106,10 +161,12 @@ static bool handle_bios_syscall(Cpu* cpu, uint32_t syscall_num) {
     switch (syscall_num) {
         case 0x01: // EnterCriticalSection
             cpu->sr &= ~1; // Disable interrupts
+            cpu_update_irq_pending(cpu);
             return true;   // Syscall was handled
 
         case 0x02: // ExitCriticalSection
             cpu->sr |= 1;  // Enable interrupts
+            cpu_update_irq_pending(cpu);
             return true;   // Syscall was handled
 
         case 0x19: // B_clr_event(event)
@@ -131,9 +188,15 @@ static bool handle_bios_syscall(Cpu* cpu, uint32_t syscall_num) {
  */
 void cpu_exception(Cpu* cpu, ExceptionCause cause) {
     // Minimal debug print for exceptions
-    printf("!!! CPU Exception: Cause=0x%02x, PC=0x%08x, InDelaySlot=%d !!!\n",
+    LOG_DEBUG(LOG_CPU, "!!! CPU Exception: Cause=0x%02x, PC=0x%08x, InDelaySlot=%d !!!\n",
            cause, cpu->current_pc, cpu->in_delay_slot);
 
+    // Exceptions flush the load delay pipeline: the pending load lands, a new one is dropped
+    cpu->regs[cpu->load_reg_idx] = cpu->load_value;
+    cpu->regs[REG_ZERO] = 0;
+    cpu->load_reg_idx = REG_ZERO;
+    cpu->next_load_reg_idx = REG_ZERO;
+
     // Determine exception handler address based on SR bit 22 (BEV)
     uint32_t handler_addr = (cpu->sr & (1 << 22)) ? 0xbfc00180  : 0x80000080;
 
@@ -143,6 +206,7 @@ void cpu_exception(Cpu* cpu, ExceptionCause cause) {
     uint32_t mode_stack = cpu->sr & 0x3F;
     cpu->sr &= ~0x3F; // Clear the 6 bits
     cpu->sr |= (mode_stack << 2) & 0x3F; // Shift and re-insert
+    cpu_update_irq_pending(cpu); // IEc is now 0
 
     // Update the Cause register
     // Set the exception code (bits 6:2)
@@ -157,9 +221,26 @@ void cpu_exception(Cpu* cpu, ExceptionCause cause) {
         cpu->cause &= ~(1 << 31);      // Clear the Branch Delay (BD) bit
     }
 
-    // Jump to the exception handler
+    // Jump to the exception handler (its first instruction is never in a delay slot)
     cpu->pc = handler_addr;
     cpu->next_pc = cpu->pc + 4;
+    cpu->branch_taken = false;
+
+    // A cached block must not keep executing past the faulting instruction
+    cpu->block_exit = true;
+}
+
+/**
+ * @brief Takes a hardware interrupt between two instructions.
+ * The interrupted instruction is the one at pc, which has not started yet: EPC must
+ * point at it (or at its branch when it sits in a delay slot), not at the instruction
+ * that just retired, otherwise RFE would run that one twice.
+ * @param cpu Pointer to the Cpu state.
+ */
+static void cpu_interrupt(Cpu* cpu) {
+    cpu->current_pc = cpu->pc;
+    cpu->in_delay_slot = cpu->branch_taken;
+    cpu_exception(cpu, EXCEPTION_INTERRUPT);
 }
 
 
@@ -171,36 +252,28 @@ void cpu_run_next_instruction(Cpu* cpu) {
 
     // --- 1. Check for Interrupts ---
     // Must happen before fetching the next instruction.
-    uint16_t status = cpu->inter->irq_status;
-    uint16_t mask = cpu->inter->irq_mask;
-    bool interrupts_globally_enabled = (cpu->sr & 1) != 0; // Check SR[0] (IEC)
-
-    if ((status & mask) != 0 && interrupts_globally_enabled) {
+    if (cpu->irq_pending) {
         // Trigger Interrupt exception (Cause Code 0)
-        cpu_exception(cpu, EXCEPTION_INTERRUPT);
+        cpu_interrupt(cpu);
         return; // Skip instruction execution, jump to handler
     }
 
-    // --- 2. Handle Pending Load Delay ---
-    // Apply the value from the *previous* cycle's load to the *current* output register set.
-    cpu_set_reg(cpu, cpu->load_reg_idx, cpu->load_value);
-    cpu->load_reg_idx = REG_ZERO; // Reset for the current cycle
-
-    // --- 3. Fetch Instruction ---
+    // --- 2. Fetch Instruction ---
     // Store PC of instruction being fetched/executed
     cpu->current_pc = cpu->pc;
 
     // Check PC alignment before fetch
     if (cpu->current_pc % 4 != 0) {
-        fprintf(stderr, "PC Alignment Error: PC=0x%08x\n", cpu->current_pc);
+        LOG_ERROR(LOG_CPU, "PC Alignment Error: PC=0x%08x\n", cpu->current_pc);
         cpu_exception(cpu, EXCEPTION_LOAD_ADDRESS_ERROR);
         return;
     }
 
     // Fetch instruction word from memory via interconnect
     uint32_t instruction = cpu_icache_fetch(cpu, cpu->current_pc); // <<< NEW LINE
+    if (trace_on(TRACE_CPU)) trace_instruction(cpu->current_pc, instruction);
 
-    // --- 4. Update Delay Slot State & Advance PC ---
+    // --- 3. Update Delay Slot State & Advance PC ---
     cpu->in_delay_slot = cpu->branch_taken; // Are we in a delay slot caused by the *previous* instruction?
     cpu->branch_taken = false;              // Reset branch flag for *current* instruction
 
@@ -208,22 +281,17 @@ void cpu_run_next_instruction(Cpu* cpu) {
     cpu->pc = cpu->next_pc;             // Advance PC to what was calculated last cycle
     cpu->next_pc = cpu->pc + 4;         // Assume sequential execution for now
 
-    // --- 5. Commit Register State ---
-    // Copy the output registers from the previous cycle to the input registers for this cycle.
-    memcpy(cpu->regs, cpu->out_regs, sizeof(cpu->regs));
-    // cpu->regs[REG_ZERO] is already 0 due to previous cpu_set_reg calls
-
-    // --- 6. Decode and Execute ---
+    // --- 4. Decode and Execute ---
     // This might update cpu->next_pc and set cpu->branch_taken = true
     decode_and_execute(cpu, instruction);
 
-    // Step timers forward by 1 'CPU cycle' (placeholder for real timing)
-    timers_step(&cpu->inter->timers_state, 1); // Pass 1 cycle for now
+    // Advance the global clock by 1 'CPU cycle' (placeholder for real timing).
+    // Devices catch up lazily / through their scheduled events.
+    cpu->inter->scheduler.now++;
 
-    // --- 7. Finalize State ---
-    // Ensure R0 in the output set is still 0 for the next cycle.
-    // (cpu_set_reg already handles this, but double-checking doesn't hurt)
-    cpu->out_regs[REG_ZERO] = 0;
+    // --- 5. Retire Load Delay Slot ---
+    // The previous instruction's load lands now; this instruction's load becomes pending.
+    cpu_retire_load_delay(cpu);
 }
 
 /**
@@ -241,7 +309,7 @@ static uint32_t cpu_icache_fetch(Cpu* cpu, uint32_t vaddr) {
     if ((vaddr >> 29) == 0b101) {
         // KSEG1: Bypass cache, fetch directly from interconnect
         // printf("~ I-Cache Bypass (KSEG1 address: 0x%08x)\n", vaddr); // Optional debug
-        return interconnect_load32(cpu->inter, vaddr);
+        return interconnect_fast_load32(cpu->inter, vaddr);
     }
     // TODO: Add checks for SR[IsC] (cache isolation) and SR[SwC] (swap caches)
     //       if implementing those features later. For now, assume cache is active.
@@ -295,7 +363,7 @@ static uint32_t cpu_icache_fetch(Cpu* cpu, uint32_t vaddr) {
         // Calculate the physical address for this word
         uint32_t fetch_paddr = line_paddr_start + (j * 4);
         // Fetch from interconnect (bypassing cache itself - interconnect doesn't call back here)
-        uint32_t instruction_data = interconnect_load32(cpu->inter, fetch_paddr);
+        uint32_t instruction_data = interconnect_fast_load32(cpu->inter, fetch_paddr);
         // Store fetched data in the cache line
         line->data[j] = instruction_data;
         // Mark this word as valid
@@ -413,6 +481,589 @@ void decode_and_execute(Cpu* cpu, uint32_t instruction) {
 }
 
 
+// ============================================================= //
+// ==========>>> THREADED INTERPRETER (COMPUTED GOTO) <<<======== //
+// ============================================================= //
+
+/**
+ * @brief True while the CPU may keep running: the slice end has not been reached and no
+ * device event is due. next_deadline is re-read every time, so an event scheduled by an
+ * I/O write (CD-ROM command, timer mode change) stops the current slice early.
+ */
+static inline bool cpu_before_deadline(const Scheduler* sched, uint64_t stop) {
+    return sched->now < stop && sched->now < sched->next_deadline;
+}
+
+#if CPU_THREADED_DISPATCH
+/**
+ * @brief Interpreter loop using GCC labels-as-values instead of the decode_and_execute() switch.
+ * Every handler label ends with its own copy of the fetch/dispatch sequence, so each opcode
+ * gets a separately predicted indirect jump. Per-instruction semantics are identical to
+ * cpu_run_next_instruction(), which is still used for the rare interrupt/misaligned-PC steps.
+ * @param cpu Pointer to the Cpu state.
+ * @param stop Scheduler time at which the slice ends (returns earlier at the next device deadline).
+ */
+static void cpu_run_threaded(Cpu* cpu, uint64_t stop) {
+    static void* const primary[64] = { // Every slot listed: unused opcodes are l_illegal
+        /* 0x00 */ &&l_special, &&l_bxx, &&l_j, &&l_jal, &&l_beq, &&l_bne, &&l_blez, &&l_bgtz,
+        /* 0x08 */ &&l_addi, &&l_addiu, &&l_slti, &&l_sltiu, &&l_andi, &&l_ori, &&l_xori, &&l_lui,
+        /* 0x10 */ &&l_cop0, &&l_cop1, &&l_cop2, &&l_cop3, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal,
+        /* 0x18 */ &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal,
+        /* 0x20 */ &&l_lb, &&l_lh, &&l_lwl, &&l_lw, &&l_lbu, &&l_lhu, &&l_lwr, &&l_illegal,
+        /* 0x28 */ &&l_sb, &&l_sh, &&l_swl, &&l_sw, &&l_illegal, &&l_illegal, &&l_swr, &&l_illegal,
+        /* 0x30 */ &&l_lwc0, &&l_lwc1, &&l_lwc2, &&l_lwc3, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal,
+        /* 0x38 */ &&l_swc0, &&l_swc1, &&l_swc2, &&l_swc3, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal,
+    };
+    static void* const special[64] = { // Every slot listed: unused opcodes are l_illegal
+        /* 0x00 */ &&l_sll, &&l_illegal, &&l_srl, &&l_sra, &&l_sllv, &&l_illegal, &&l_srlv, &&l_srav,
+        /* 0x08 */ &&l_jr, &&l_jalr, &&l_illegal, &&l_illegal, &&l_syscall, &&l_break, &&l_illegal, &&l_illegal,
+        /* 0x10 */ &&l_mfhi, &&l_mthi, &&l_mflo, &&l_mtlo, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal,
+        /* 0x18 */ &&l_mult, &&l_multu, &&l_div, &&l_divu, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal,
+        /* 0x20 */ &&l_add, &&l_addu, &&l_sub, &&l_subu, &&l_and, &&l_or, &&l_xor, &&l_nor,
+        /* 0x28 */ &&l_illegal, &&l_illegal, &&l_slt, &&l_sltu, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal,
+        /* 0x30 */ &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal,
+        /* 0x38 */ &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal, &&l_illegal,
+    };
+    Scheduler* sched = &cpu->inter->scheduler;
+    uint32_t instruction;
+
+// Interrupt check, fetch, delay slot update and jump to the handler of the next instruction
+#define THREADED_DISPATCH() do { \
+        if (cpu->irq_pending || (cpu->pc % 4) != 0) { \
+            goto l_slow_step; \
+        } \
+        cpu->current_pc = cpu->pc; \
+        instruction = cpu_icache_fetch(cpu, cpu->current_pc); \
+        cpu->in_delay_slot = cpu->branch_taken; \
+        cpu->branch_taken = false; \
+        cpu->pc = cpu->next_pc; \
+        cpu->next_pc = cpu->pc + 4; \
+        goto *primary[instr_function(instruction)]; \
+    } while (0)
+
+// Handler label: execute, finish the instruction, dispatch the next one
+#define THREADED_OP(label, handler) \
+    label: \
+        handler(cpu, instruction); \
+        sched->now++; \
+        cpu_retire_load_delay(cpu); \
+        if (!cpu_before_deadline(sched, stop)) return; \
+        THREADED_DISPATCH();
+
+    if (!cpu_before_deadline(sched, stop)) return;
+    THREADED_DISPATCH();
+
+l_slow_step:
+    // Interrupts and misaligned PCs take the reference path (exception entry)
+    cpu_run_next_instruction(cpu);
+    if (!cpu_before_deadline(sched, stop)) return;
+    THREADED_DISPATCH();
+
+l_special:
+    goto *special[instr_subfunction(instruction)];
+
+    THREADED_OP(l_add, op_add)
+    THREADED_OP(l_addi, op_addi)
+    THREADED_OP(l_addiu, op_addiu)
+    THREADED_OP(l_addu, op_addu)
+    THREADED_OP(l_and, op_and)
+    THREADED_OP(l_andi, op_andi)
+    THREADED_OP(l_beq, op_beq)
+    THREADED_OP(l_bgtz, op_bgtz)
+    THREADED_OP(l_blez, op_blez)
+    THREADED_OP(l_bne, op_bne)
+    THREADED_OP(l_break, op_break)
+    THREADED_OP(l_bxx, op_bxx)
+    THREADED_OP(l_cop0, op_cop0)
+    THREADED_OP(l_cop1, op_cop1)
+    THREADED_OP(l_cop2, op_cop2)
+    THREADED_OP(l_cop3, op_cop3)
+    THREADED_OP(l_div, op_div)
+    THREADED_OP(l_divu, op_divu)
+    THREADED_OP(l_illegal, op_illegal)
+    THREADED_OP(l_j, op_j)
+    THREADED_OP(l_jal, op_jal)
+    THREADED_OP(l_jalr, op_jalr)
+    THREADED_OP(l_jr, op_jr)
+    THREADED_OP(l_lb, op_lb)
+    THREADED_OP(l_lbu, op_lbu)
+    THREADED_OP(l_lh, op_lh)
+    THREADED_OP(l_lhu, op_lhu)
+    THREADED_OP(l_lui, op_lui)
+    THREADED_OP(l_lw, op_lw)
+    THREADED_OP(l_lwc0, op_lwc0)
+    THREADED_OP(l_lwc1, op_lwc1)
+    THREADED_OP(l_lwc2, op_lwc2)
+    THREADED_OP(l_lwc3, op_lwc3)
+    THREADED_OP(l_lwl, op_lwl)
+    THREADED_OP(l_lwr, op_lwr)
+    THREADED_OP(l_mfhi, op_mfhi)
+    THREADED_OP(l_mflo, op_mflo)
+    THREADED_OP(l_mthi, op_mthi)
+    THREADED_OP(l_mtlo, op_mtlo)
+    THREADED_OP(l_mult, op_mult)
+    THREADED_OP(l_multu, op_multu)
+    THREADED_OP(l_nor, op_nor)
+    THREADED_OP(l_or, op_or)
+    THREADED_OP(l_ori, op_ori)
+    THREADED_OP(l_sb, op_sb)
+    THREADED_OP(l_sh, op_sh)
+    THREADED_OP(l_sll, op_sll)
+    THREADED_OP(l_sllv, op_sllv)
+    THREADED_OP(l_slt, op_slt)
+    THREADED_OP(l_slti, op_slti)
+    THREADED_OP(l_sltiu, op_sltiu)
+    THREADED_OP(l_sltu, op_sltu)
+    THREADED_OP(l_sra, op_sra)
+    THREADED_OP(l_srav, op_srav)
+    THREADED_OP(l_srl, op_srl)
+    THREADED_OP(l_srlv, op_srlv)
+    THREADED_OP(l_sub, op_sub)
+    THREADED_OP(l_subu, op_subu)
+    THREADED_OP(l_sw, op_sw)
+    THREADED_OP(l_swc0, op_swc0)
+    THREADED_OP(l_swc1, op_swc1)
+    THREADED_OP(l_swc2, op_swc2)
+    THREADED_OP(l_swc3, op_swc3)
+    THREADED_OP(l_swl, op_swl)
+    THREADED_OP(l_swr, op_swr)
+    THREADED_OP(l_syscall, op_syscall)
+    THREADED_OP(l_xor, op_xor)
+    THREADED_OP(l_xori, op_xori)
+
+#undef THREADED_OP
+#undef THREADED_DISPATCH
+}
+#endif // CPU_THREADED_DISPATCH
+
+
+// ============================================================= //
+// =============>>> CACHED INTERPRETER (BLOCK CACHE) <<<========== //
+// ============================================================= //
+
+// Primary opcode -> handler. NULL entries decode to op_illegal.
+static const CpuOpHandler cpu_primary_ops[64] = {
+    [0x01] = op_bxx,   [0x02] = op_j,     [0x03] = op_jal,   [0x04] = op_beq,
+    [0x05] = op_bne,   [0x06] = op_blez,  [0x07] = op_bgtz,  [0x08] = op_addi,
+    [0x09] = op_addiu, [0x0A] = op_slti,  [0x0B] = op_sltiu, [0x0C] = op_andi,
+    [0x0D] = op_ori,   [0x0E] = op_xori,  [0x0F] = op_lui,   [0x10] = op_cop0,
+    [0x11] = op_cop1,  [0x12] = op_cop2,  [0x13] = op_cop3,  [0x20] = op_lb,
+    [0x21] = op_lh,    [0x22] = op_lwl,   [0x23] = op_lw,    [0x24] = op_lbu,
+    [0x25] = op_lhu,   [0x26] = op_lwr,   [0x28] = op_sb,    [0x29] = op_sh,
+    [0x2A] = op_swl,   [0x2B] = op_sw,    [0x2E] = op_swr,   [0x30] = op_lwc0,
+    [0x31] = op_lwc1,  [0x32] = op_lwc2,  [0x33] = op_lwc3,  [0x38] = op_swc0,
+    [0x39] = op_swc1,  [0x3A] = op_swc2,  [0x3B] = op_swc3,
+};
+
+// SPECIAL (opcode 0) subfunction -> handler. NULL entries decode to op_illegal.
+static const CpuOpHandler cpu_special_ops[64] = {
+    [0x00] = op_sll,   [0x02] = op_srl,   [0x03] = op_sra,   [0x04] = op_sllv,
+    [0x06] = op_srlv,  [0x07] = op_srav,  [0x08] = op_jr,    [0x09] = op_jalr,
+    [0x0C] = op_syscall, [0x0D] = op_break, [0x10] = op_mfhi, [0x11] = op_mthi,
+    [0x12] = op_mflo,  [0x13] = op_mtlo,  [0x18] = op_mult,  [0x19] = op_multu,
+    [0x1A] = op_div,   [0x1B] = op_divu,  [0x20] = op_add,   [0x21] = op_addu,
+    [0x22] = op_sub,   [0x23] = op_subu,  [0x24] = op_and,   [0x25] = op_or,
+    [0x26] = op_xor,   [0x27] = op_nor,   [0x2A] = op_slt,   [0x2B] = op_sltu,
+};
+
+/**
+ * @brief Decodes one instruction into a CpuDecodedOp (handler + fields + flags).
+ * Mirrors the dispatch in decode_and_execute().
+ * @param instruction The raw 32-bit instruction word.
+ * @return The decoded op.
+ */
+static CpuDecodedOp cpu_decode_op(uint32_t instruction) {
+    CpuDecodedOp op;
+    uint32_t opcode = instr_function(instruction);
+    op.instruction = instruction;
+    op.rs = (uint8_t)instr_s(instruction);
+    op.rt = (uint8_t)instr_t(instruction);
+    op.rd = (uint8_t)instr_d(instruction);
+    op.flags = 0;
+
+    if (opcode == 0x00) {
+        uint32_t subfunc = instr_subfunction(instruction);
+        op.handler = cpu_special_ops[subfunc];
+        if (subfunc == 0x08 || subfunc == 0x09) op.flags |= CPU_OP_BRANCH;      // JR, JALR
+        if (subfunc == 0x0C || subfunc == 0x0D) op.flags |= CPU_OP_ENDS_BLOCK;  // SYSCALL, BREAK
+    } else {
+        op.handler = cpu_primary_ops[opcode];
+        if (opcode >= 0x01 && opcode <= 0x07) op.flags |= CPU_OP_BRANCH;        // REGIMM, J, JAL, Bxx
+        if (opcode >= 0x20 && opcode <= 0x26) op.flags |= CPU_OP_LOAD;
+        if (opcode >= 0x28 && opcode <= 0x2E) op.flags |= CPU_OP_STORE;
+        if (opcode == 0x22 || opcode == 0x26) op.flags |= CPU_OP_LOAD;          // LWL/LWR
+        if (opcode == 0x2A || opcode == 0x2E) op.flags |= CPU_OP_LOAD;          // SWL/SWR read-modify-write
+        if (opcode >= 0x10) {
+            // Coprocessor ops change SR (MTC0/RFE) or raise exceptions
+            if (opcode <= 0x13 || opcode >= 0x30) op.flags |= CPU_OP_ENDS_BLOCK;
+        }
+        // Resolve COP0 sub-ops at decode time as well
+        if (opcode == 0x10) {
+            uint32_t cop_opcode = instr_cop_opcode(instruction);
+            if (cop_opcode == 0x00) op.handler = op_mfc0;
+            else if (cop_opcode == 0x04) op.handler = op_mtc0;
+            else if (cop_opcode == 0x10 && (instruction & 0x3F) == 0x10) op.handler = op_rfe;
+        }
+    }
+    if (op.handler == NULL) {
+        op.handler = op_illegal;
+        op.flags |= CPU_OP_ENDS_BLOCK;
+    }
+    return op;
+}
+
+/**
+ * @brief Returns the exclusive end of the RAM/BIOS region holding paddr, or 0 if the
+ * address is not in a region we can cache code from.
+ */
+static uint32_t cpu_code_region_end(uint32_t paddr) {
+    if (paddr <= RAM_END) return RAM_END + 1;
+    if (paddr >= BIOS_START && paddr <= BIOS_END) return BIOS_END + 1;
+    return 0;
+}
+
+/**
+ * @brief Returns true if the op only reads guest state: a load or an ALU op that
+ * cannot trap and does not touch HI/LO or COP0.
+ */
+static bool cpu_idle_op_is_pure(const CpuDecodedOp* op) {
+    if (op->flags & CPU_OP_LOAD) {
+        return !(op->flags & CPU_OP_STORE) && op->handler != op_lwl && op->handler != op_lwr;
+    }
+    CpuOpHandler h = op->handler;
+    return h == op_sll  || h == op_srl  || h == op_sra  || h == op_sllv || h == op_srlv ||
+           h == op_srav || h == op_addu || h == op_subu || h == op_and  || h == op_or   ||
+           h == op_xor  || h == op_nor  || h == op_slt  || h == op_sltu || h == op_addiu ||
+           h == op_slti || h == op_sltiu || h == op_andi || h == op_ori || h == op_xori ||
+           h == op_lui;
+}
+
+/**
+ * @brief Flags a block as an idle-loop candidate: at most CPU_IDLE_LOOP_MAX_OPS ops,
+ * ending in a non-linking branch/jump whose static target is the block start, with
+ * every other op (delay slot included) pure.
+ */
+static bool cpu_block_is_idle_loop(const CpuBlock* block) {
+    if (block->len < 2 || block->len > CPU_IDLE_LOOP_MAX_OPS) return false;
+
+    const CpuDecodedOp* branch = &block->ops[block->len - 2];
+    uint32_t branch_pc = block->vaddr + (block->len - 2) * 4;
+    uint32_t target;
+    if (branch->handler == op_j) {
+        target = ((branch_pc + 4) & 0xF0000000) | ((branch->instruction & 0x03FFFFFF) << 2);
+    } else if (branch->handler == op_beq || branch->handler == op_bne || branch->handler == op_blez ||
+               branch->handler == op_bgtz || (branch->handler == op_bxx && (branch->rt & 0x1E) != 0x10)) {
+        target = branch_pc + 4 + ((uint32_t)(int32_t)(int16_t)(branch->instruction & 0xFFFF) << 2);
+    } else {
+        return false; // JR/JALR targets are dynamic, BxxAL/JAL write $ra
+    }
+    if (target != block->vaddr) return false;
+
+    for (uint32_t i = 0; i < block->len; ++i) {
+        if (i != block->len - 2 && !cpu_idle_op_is_pure(&block->ops[i])) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Decodes the basic block starting at paddr into the given slot.
+ * Marks the RAM pages it covers so stores can invalidate it.
+ */
+static void cpu_compile_block(Cpu* cpu, CpuBlock* block, uint32_t vaddr, uint32_t paddr) {
+    uint32_t region_end = cpu_code_region_end(paddr);
+    uint32_t addr = paddr;
+    uint32_t len = 0;
+    bool delay_slot_next = false;
+
+    while (len < CPU_BLOCK_MAX_OPS && addr < region_end) {
+        CpuDecodedOp op = cpu_decode_op(interconnect_load32(cpu->inter, addr));
+        // Keep a branch and its delay slot together in the same block
+        if ((op.flags & CPU_OP_BRANCH) && !delay_slot_next && len == CPU_BLOCK_MAX_OPS - 1) {
+            break;
+        }
+        block->ops[len++] = op;
+        addr += 4;
+        if (delay_slot_next) break;                  // Delay slot included: block ends
+        if (op.flags & CPU_OP_BRANCH) delay_slot_next = true;
+        else if (op.flags & CPU_OP_ENDS_BLOCK) break;
+    }
+    if (len == 0) {
+        // Branch at the very end of a region: decode it alone, the interpreter handles the rest
+        block->ops[len++] = cpu_decode_op(interconnect_load32(cpu->inter, paddr));
+        addr = paddr + 4;
+    }
+
+    block->paddr = paddr;
+    block->vaddr = vaddr;
+    block->len = len;
+    block->flags = cpu_block_is_idle_loop(block) ? CPU_BLOCK_IDLE_LOOP : 0;
+    block->jit_code = NULL; // Translated lazily in JIT mode
+    cpu->blocks_compiled++;
+
+    if (paddr <= RAM_END) {
+        for (uint32_t page = paddr >> CODE_PAGE_SHIFT; page <= ((addr - 1) >> CODE_PAGE_SHIFT); ++page) {
+            cpu->inter->ram_code_pages[page] = 1;
+        }
+    }
+}
+
+/**
+ * @brief Recomputes the interrupt-pending flag tested before every instruction.
+ * Called whenever one of its inputs changes: I_STAT/I_MASK (interconnect) and SR (MTC0,
+ * RFE, exception entry). When an IRQ becomes deliverable in the middle of a block, the
+ * block is cut after the current instruction so the interrupt is taken on time.
+ * @param cpu Pointer to the Cpu state.
+ */
+void cpu_update_irq_pending(Cpu* cpu) {
+    const Interconnect* inter = cpu->inter;
+    bool pending = (inter->irq_status & inter->irq_mask) != 0 && (cpu->sr & 1) != 0;
+    if (pending && !cpu->irq_pending) {
+        cpu->block_exit = true;
+    }
+    cpu->irq_pending = pending;
+}
+
+/**
+ * @brief Drops every cached block decoded from the given RAM page.
+ */
+void cpu_invalidate_code_page(Cpu* cpu, uint32_t page) {
+    if (cpu == NULL || cpu->block_cache == NULL) return;
+    uint32_t page_start = page << CODE_PAGE_SHIFT;
+    uint32_t page_end = page_start + (1u << CODE_PAGE_SHIFT);
+
+    for (int i = 0; i < CPU_BLOCK_CACHE_SIZE; ++i) {
+        CpuBlock* block = &cpu->block_cache[i];
+        if (block->paddr > RAM_END) continue; // Empty slot or BIOS block
+        uint32_t block_end = block->paddr + block->len * 4;
+        if (block->paddr < page_end && block_end > page_start) {
+            block->paddr = CPU_BLOCK_INVALID;
+        }
+    }
+    cpu->inter->ram_code_pages[page] = 0;
+    // The store may have overwritten the block we are running: leave it after this op
+    cpu->block_exit = true;
+}
+
+/**
+ * @brief Drops every decoded block and host translation.
+ */
+void cpu_flush_block_cache(Cpu* cpu) {
+    if (cpu->block_cache == NULL) return;
+    for (int i = 0; i < CPU_BLOCK_CACHE_SIZE; ++i) {
+        cpu->block_cache[i].paddr = CPU_BLOCK_INVALID;
+    }
+    memset(cpu->inter->ram_code_pages, 0, sizeof(cpu->inter->ram_code_pages));
+    cpu_jit_flush(cpu);
+    cpu->block_exit = true;
+}
+
+/**
+ * @brief Switches execution mode, flushing the block cache.
+ */
+void cpu_set_exec_mode(Cpu* cpu, CpuExecMode mode) {
+    if (mode == CPU_EXEC_JIT && cpu->jit_buffer == NULL) {
+        LOG_WARN(LOG_CPU, "Warning: JIT not available, using the cached interpreter.\n");
+        mode = CPU_EXEC_CACHED;
+    }
+    if (mode != CPU_EXEC_INTERPRETER && cpu->block_cache == NULL) {
+        LOG_WARN(LOG_CPU, "Warning: No block cache available, staying in interpreter mode.\n");
+        mode = CPU_EXEC_INTERPRETER;
+    }
+    cpu_flush_block_cache(cpu);
+    cpu->exec_mode = mode;
+    LOG_INFO(LOG_CPU, "CPU: Execution mode set to %s\n",
+           mode == CPU_EXEC_JIT ? "x86-64 JIT" : (mode == CPU_EXEC_CACHED ? "cached interpreter" : "interpreter"));
+}
+
+/**
+ * @brief Runs one decoded op with the same bookkeeping as cpu_run_next_instruction()
+ * (branch delay, load delay retirement) minus fetch/decode.
+ */
+static inline void cpu_run_decoded_op(Cpu* cpu, const CpuDecodedOp* op) {
+    cpu->current_pc = cpu->pc;
+    cpu->in_delay_slot = cpu->branch_taken;
+    cpu->branch_taken = false;
+    cpu->pc = cpu->next_pc;
+    cpu->next_pc = cpu->pc + 4;
+
+    op->handler(cpu, op->instruction);
+    cpu_retire_load_delay(cpu);
+}
+
+/**
+ * @brief Returns true if a polling load from this physical address reads a value that
+ * only the CPU or a scheduled device event can change: memory, I_STAT/I_MASK, GPUSTAT and
+ * the DMA registers.
+ * Timer counters, FIFOs (GPUREAD, CD-ROM) and anything else with read side effects are excluded.
+ */
+static bool cpu_idle_load_is_stable(uint32_t paddr) {
+    return paddr <= RAM_MIRROR_END ||
+           (paddr >= SCRATCHPAD_START && paddr <= SCRATCHPAD_END) ||
+           (paddr >= BIOS_START && paddr <= BIOS_END) ||
+           (paddr >= IRQ_REGS_START && paddr <= IRQ_REGS_END) ||
+           (paddr >= DMA_START && paddr <= DMA_END) ||
+           (paddr & ~3u) == GPU_GPUSTAT_ADDR;
+}
+
+/**
+ * @brief Runs one iteration of an idle-loop candidate op by op and checks whether it
+ * is spinning: it started at the block head, only read stable addresses, branched back
+ * to the head and left the registers (and pending load) exactly as it found them.
+ * Since nothing in the loop writes memory, every further iteration would do the same
+ * until a device event changes what it reads. Sets cpu->idle_loop_hit in that case.
+ * @return Number of instructions executed.
+ */
+static uint32_t cpu_run_idle_candidate(Cpu* cpu, const CpuBlock* block) {
+    uint32_t regs_before[32];
+    memcpy(regs_before, cpu->regs, sizeof(regs_before));
+    RegisterIndex load_reg_before = cpu->load_reg_idx;
+    uint32_t load_value_before = cpu->load_value;
+    bool stable = true;
+
+    uint32_t executed = 0;
+    for (const CpuDecodedOp* op = block->ops; op < block->ops + block->len; ++op) {
+        if (op->flags & CPU_OP_LOAD) {
+            uint32_t vaddr = cpu->regs[op->rs] + (uint32_t)(int32_t)(int16_t)(op->instruction & 0xFFFF);
+            stable = stable && cpu_idle_load_is_stable(mask_region(vaddr));
+        }
+        cpu_run_decoded_op(cpu, op);
+        executed++;
+        if (cpu->block_exit) return executed; // Exception taken or code overwritten
+    }
+
+    cpu->idle_loop_hit = stable &&
+        cpu->pc == block->vaddr && cpu->next_pc == block->vaddr + 4 &&
+        cpu->load_reg_idx == load_reg_before && cpu->load_value == load_value_before &&
+        memcmp(regs_before, cpu->regs, sizeof(regs_before)) == 0;
+    return executed;
+}
+
+/**
+ * @brief Executes one cached block starting at cpu->pc.
+ * Performs the same per-instruction bookkeeping as cpu_run_next_instruction()
+ * (branch delay, load delay retirement) without fetching or decoding.
+ * @return Number of instructions executed.
+ */
+static uint32_t cpu_run_block(Cpu* cpu) {
+    // --- 1. Check for Interrupts ---
+    // Blocks stop right after an instruction that makes an IRQ deliverable (block_exit),
+    // so this check at entry is exact.
+    if (cpu->irq_pending) {
+        cpu_interrupt(cpu);
+        return 1;
+    }
+
+    uint32_t paddr = mask_region(cpu->pc);
+    if ((cpu->pc % 4) != 0 || cpu_code_region_end(paddr) == 0) {
+        // Misaligned PC or code outside RAM/BIOS: let the reference path deal with it
+        cpu_run_next_instruction(cpu);
+        return 0; // cpu_run_next_instruction already advanced the clock
+    }
+
+    // --- 2. Look up (or decode) the block ---
+    CpuBlock* block = &cpu->block_cache[(paddr >> 2) & (CPU_BLOCK_CACHE_SIZE - 1)];
+    if (block->paddr != paddr || block->vaddr != cpu->pc) {
+        cpu_compile_block(cpu, block, cpu->pc, paddr);
+    }
+
+    cpu->block_exit = false;
+
+    // --- 3. Polling loops: run op by op and watch for a fixed point ---
+    if ((block->flags & CPU_BLOCK_IDLE_LOOP) && !cpu->branch_taken && cpu->next_pc == cpu->pc + 4) {
+        return cpu_run_idle_candidate(cpu, block);
+    }
+
+    // --- 3a. Run the translated block ---
+    // Entering in a delay slot (previous block ended on a branch) uses the op loop below.
+    if (cpu->exec_mode == CPU_EXEC_JIT && !cpu->branch_taken && cpu->next_pc == cpu->pc + 4) {
+        if (block->jit_code == NULL) {
+            block->jit_code = cpu_jit_compile(cpu, block);
+        }
+        if (block->jit_code != NULL) {
+            // First op's PC bookkeeping; the generated code takes it from there
+            cpu->current_pc = cpu->pc;
+            cpu->in_delay_slot = false;
+            cpu->pc = cpu->next_pc;
+            cpu->next_pc = cpu->pc + 4;
+            return block->jit_code(cpu);
+        }
+    }
+
+    // --- 3b. Run it op by op ---
+    const CpuDecodedOp* op = block->ops;
+    const CpuDecodedOp* end = op + block->len;
+    uint32_t executed = 0;
+    while (op < end) {
+        cpu_run_decoded_op(cpu, op);
+        executed++;
+        op++;
+        if (cpu->block_exit) break; // Exception taken or code overwritten
+    }
+    return executed;
+}
+
+/**
+ * @brief Runs cached blocks until the slice ends or a device deadline is reached.
+ * @param cpu Pointer to the Cpu state.
+ * @param stop Scheduler time at which the slice ends.
+ */
+static void cpu_run_blocks(Cpu* cpu, uint64_t stop) {
+    Scheduler* sched = &cpu->inter->scheduler;
+
+    while (cpu_before_deadline(sched, stop)) {
+        // One cycle per instruction, like the reference path (which advances the clock
+        // itself when cpu_run_block() single-steps and returns 0)
+        sched->now += cpu_run_block(cpu);
+
+        if (cpu->idle_loop_hit) {
+            // Spinning on unchanged state: nothing can change before the next device
+            // event, so jump straight to it (or to the end of the slice).
+            cpu->idle_loop_hit = false;
+            uint64_t target = stop < sched->next_deadline ? stop : sched->next_deadline;
+            if (target > sched->now) {
+                cpu->idle_cycles_skipped += target - sched->now;
+                sched->now = target;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Runs the CPU for at least 'cycles' cycles in the selected mode.
+ * Execution stops at every scheduler deadline to dispatch the due device events,
+ * then resumes until the slice is over. While a trace is recording, every mode uses
+ * the reference interpreter.
+ * @return The number of cycles that elapsed (may exceed 'cycles' by the tail of a block).
+ */
+uint32_t cpu_run(Cpu* cpu, uint32_t cycles) {
+    Scheduler* sched = &cpu->inter->scheduler;
+    uint64_t start = sched->now;
+    uint64_t stop = start + cycles;
+
+    while (sched->now < stop) {
+        if (trace_active != 0) {
+            // Tracing: the reference path is the one with the instruction hook, and it
+            // performs no block decoding reads that would show up as bus accesses.
+            while (cpu_before_deadline(sched, stop)) {
+                cpu_run_next_instruction(cpu);
+            }
+        } else if (cpu->exec_mode == CPU_EXEC_INTERPRETER) {
+#if CPU_THREADED_DISPATCH
+            cpu_run_threaded(cpu, stop);
+#else
+            while (cpu_before_deadline(sched, stop)) {
+                cpu_run_next_instruction(cpu);
+            }
+#endif
+        } else {
+            cpu_run_blocks(cpu, stop);
+        }
+        scheduler_run_due(sched);
+    }
+    return (uint32_t)(sched->now - start);
+}
+
+
 // --- Individual Instruction Implementations ---
 // (Keep essential debug prints only: exceptions, cache isolation, GTE/COP errors)
 
@@ -440,7 +1091,7 @@ static void op_sw(Cpu* cpu, uint32_t instruction) {
     uint32_t rs = instr_s(instruction);
     uint32_t address = cpu_reg(cpu, rs) + offset;
     uint32_t value = cpu_reg(cpu, rt); // Use input register set
-    interconnect_store32(cpu->inter, address, value); // Alignment checked in interconnect
+    interconnect_fast_store32(cpu->inter, address, value); // Alignment checked in interconnect
 }
 
 static void op_sll(Cpu* cpu, uint32_t instruction) {
@@ -487,7 +1138,7 @@ static void op_cop0(Cpu* cpu, uint32_t instruction) {
             break;
         default:
              // Other COP0 ops (TLBR, TLBWI, TLBP etc.) are for MMU, trigger exception
-             fprintf(stderr, "Warning: Unhandled COP0 instruction: 0x%08x (CopOp=%u) at PC=0x%08x\n", instruction, cop_opcode, cpu->current_pc);
+             LOG_WARN(LOG_CPU, "Warning: Unhandled COP0 instruction: 0x%08x (CopOp=%u) at PC=0x%08x\n", instruction, cop_opcode, cpu->current_pc);
              cpu_exception(cpu, EXCEPTION_ILLEGAL_INSTRUCTION); // Or maybe COPROCESSOR_ERROR? Illegal seems better.
             break;
     }
@@ -500,24 +1151,25 @@ static void op_mtc0(Cpu* cpu, uint32_t instruction) {
 
     switch (cop_r) {
         case 3: case 5: case 6: case 7: case 9: case 11: // Breakpoint/DCIC regs
-             if (value != 0) fprintf(stderr, "Warning: MTC0 to unhandled Breakpoint/DCIC Reg %u = 0x%08x at PC=0x%08x\n", cop_r, value, cpu->current_pc);
+             if (value != 0) LOG_WARN(LOG_CPU, "Warning: MTC0 to unhandled Breakpoint/DCIC Reg %u = 0x%08x at PC=0x%08x\n", cop_r, value, cpu->current_pc);
              // No state change for now
              break;
         case 12: // SR (Status Register)
             // printf("~ MTC0 SR = 0x%08x\n", value); // Debug
             cpu->sr = value;
+            cpu_update_irq_pending(cpu);
             break;
         case 13: // CAUSE
              // Only bits 8 and 9 (IP0, IP1) seem writable to force software interrupts.
              // Mask other bits.
              cpu->cause = (cpu->cause & ~0x300) | (value & 0x300);
              if ((value & ~0x300) != 0) {
-                 fprintf(stderr, "Warning: MTC0 to CAUSE attempting to write non-SW bits: 0x%08x at PC=0x%08x\n", value, cpu->current_pc);
+                 LOG_WARN(LOG_CPU, "Warning: MTC0 to CAUSE attempting to write non-SW bits: 0x%08x at PC=0x%08x\n", value, cpu->current_pc);
              }
              break;
         // EPC (Reg 14) is read-only. Other registers are typically MMU-related or unused.
         default:
-            fprintf(stderr, "Warning: MTC0 to unhandled/read-only COP0 Register %u = 0x%08x at PC=0x%08x\n", cop_r, value, cpu->current_pc);
+            LOG_WARN(LOG_CPU, "Warning: MTC0 to unhandled/read-only COP0 Register %u = 0x%08x at PC=0x%08x\n", cop_r, value, cpu->current_pc);
             break;
     }
 }
@@ -527,6 +1179,7 @@ static void op_rfe(Cpu* cpu, uint32_t instruction) {
     uint32_t mode_stack = cpu->sr & 0x3f;
     cpu->sr &= ~0x3f;
     cpu->sr |= (mode_stack >> 2) & 0x3f; // Following guide's code
+    cpu_update_irq_pending(cpu);
 }
 
 static void op_bne(Cpu* cpu, uint32_t instruction) {
@@ -548,7 +1201,7 @@ static void op_addi(Cpu* cpu, uint32_t instruction) {
     // Use GCC/Clang builtin for checked signed addition
     if (__builtin_add_overflow(rs_value, imm_se, &result)) {
         // Debug print kept as it indicates an exception condition
-        fprintf(stderr, "ADDI Signed Overflow: %d + %d (PC=0x%08x)\n", rs_value, imm_se, cpu->current_pc);
+        LOG_WARN(LOG_CPU, "ADDI Signed Overflow: %d + %d (PC=0x%08x)\n", rs_value, imm_se, cpu->current_pc);
         cpu_exception(cpu, EXCEPTION_OVERFLOW); // Trigger overflow exception
     } else {
         cpu_set_reg(cpu, rt, (uint32_t)result);
@@ -557,7 +1210,7 @@ static void op_addi(Cpu* cpu, uint32_t instruction) {
 
 static void op_lw(Cpu* cpu, uint32_t instruction) {
     if ((cpu->sr & 0x10000) != 0) { // Check cache isolation
-        printf("~ LW Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
+        LOG_TRACE(LOG_CPU, "~ LW Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
         return;
     }
     uint32_t offset = instr_imm_se(instruction);
@@ -566,9 +1219,8 @@ static void op_lw(Cpu* cpu, uint32_t instruction) {
     uint32_t address = cpu_reg(cpu, rs) + offset;
 
     // Perform load and schedule it for the delay slot
-    uint32_t value_loaded = interconnect_load32(cpu->inter, address); // Alignment checked in interconnect
-    cpu->load_reg_idx = rt;
-    cpu->load_value = value_loaded;
+    uint32_t value_loaded = interconnect_fast_load32(cpu->inter, address); // Alignment checked in interconnect
+    cpu_schedule_load(cpu, rt, value_loaded);
 }
 
 static void op_sltu(Cpu* cpu, uint32_t instruction) {
@@ -587,7 +1239,7 @@ static void op_addu(Cpu* cpu, uint32_t instruction) {
 
 static void op_sh(Cpu* cpu, uint32_t instruction) {
     if ((cpu->sr & 0x10000) != 0) {
-        printf("~ SH Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
+        LOG_TRACE(LOG_CPU, "~ SH Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
         return;
     }
     uint32_t offset = instr_imm_se(instruction);
@@ -595,7 +1247,7 @@ static void op_sh(Cpu* cpu, uint32_t instruction) {
     uint32_t rs = instr_s(instruction);
     uint32_t address = cpu_reg(cpu, rs) + offset;
     uint16_t value = (uint16_t)cpu_reg(cpu, rt); // Lower 16 bits of rt
-    interconnect_store16(cpu->inter, address, value); // Alignment checked in interconnect
+    interconnect_fast_store16(cpu->inter, address, value); // Alignment checked in interconnect
 }
 
 static void op_jal(Cpu* cpu, uint32_t instruction) {
@@ -614,7 +1266,7 @@ static void op_andi(Cpu* cpu, uint32_t instruction) {
 
 static void op_sb(Cpu* cpu, uint32_t instruction) {
     if ((cpu->sr & 0x10000) != 0) {
-        printf("~ SB Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
+        LOG_TRACE(LOG_CPU, "~ SB Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
         return;
     }
     uint32_t offset = instr_imm_se(instruction);
@@ -622,7 +1274,7 @@ static void op_sb(Cpu* cpu, uint32_t instruction) {
     uint32_t rs = instr_s(instruction);
     uint32_t address = cpu_reg(cpu, rs) + offset;
     uint8_t value = (uint8_t)cpu_reg(cpu, rt); // Lower 8 bits of rt
-    interconnect_store8(cpu->inter, address, value);
+    interconnect_fast_store8(cpu->inter, address, value);
 }
 
 static void op_jr(Cpu* cpu, uint32_t instruction) {
@@ -635,19 +1287,18 @@ static void op_jr(Cpu* cpu, uint32_t instruction) {
 
 static void op_lb(Cpu* cpu, uint32_t instruction) {
     if ((cpu->sr & 0x10000) != 0) {
-        printf("~ LB Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
+        LOG_TRACE(LOG_CPU, "~ LB Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
         return;
     }
     uint32_t offset = instr_imm_se(instruction);
     uint32_t rt = instr_t(instruction);
     uint32_t rs = instr_s(instruction);
     uint32_t address = cpu_reg(cpu, rs) + offset;
-    uint8_t value_loaded = interconnect_load8(cpu->inter, address);
+    uint8_t value_loaded = interconnect_fast_load8(cpu->inter, address);
     // Sign-extend the 8-bit value to 32 bits
     uint32_t value_sign_extended = (uint32_t)(int32_t)(int8_t)value_loaded;
     // Schedule load for delay slot
-    cpu->load_reg_idx = rt;
-    cpu->load_value = value_sign_extended;
+    cpu_schedule_load(cpu, rt, value_sign_extended);
 }
 
 static void op_beq(Cpu* cpu, uint32_t instruction) {
@@ -672,14 +1323,13 @@ static void op_mfc0(Cpu* cpu, uint32_t instruction) {
         // Add reads for other COP0 registers if needed (mostly MMU/debug related)
         default:
             // Keep warning for unhandled read
-            fprintf(stderr, "Warning: MFC0 read from unhandled COP0 Register %u (PC=0x%08x)\n",
+            LOG_WARN(LOG_CPU, "Warning: MFC0 read from unhandled COP0 Register %u (PC=0x%08x)\n",
                     cop_r_src, cpu->current_pc);
             // Should it trigger an exception? Probably not, just return garbage/0.
             break;
     }
     // Schedule load for delay slot
-    cpu->load_reg_idx = cpu_r_dest;
-    cpu->load_value = value_read;
+    cpu_schedule_load(cpu, cpu_r_dest, value_read);
 }
 
 static void op_and(Cpu* cpu, uint32_t instruction) {
@@ -699,7 +1349,7 @@ static void op_add(Cpu* cpu, uint32_t instruction) {
     // Use GCC/Clang builtin for checked signed addition
     if (__builtin_add_overflow(rs_value, rt_value, &result)) {
         // Keep exception print
-        fprintf(stderr, "ADD Signed Overflow: %d + %d (PC=0x%08x)\n", rs_value, rt_value, cpu->current_pc);
+        LOG_WARN(LOG_CPU, "ADD Signed Overflow: %d + %d (PC=0x%08x)\n", rs_value, rt_value, cpu->current_pc);
         cpu_exception(cpu, EXCEPTION_OVERFLOW); // Trigger overflow exception
     } else {
         cpu_set_reg(cpu, rd, (uint32_t)result);
@@ -728,19 +1378,18 @@ static void op_blez(Cpu* cpu, uint32_t instruction) {
 
 static void op_lbu(Cpu* cpu, uint32_t instruction) {
      if ((cpu->sr & 0x10000) != 0) {
-        printf("~ LBU Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
+        LOG_TRACE(LOG_CPU, "~ LBU Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
         return;
     }
     uint32_t offset = instr_imm_se(instruction);
     uint32_t rt = instr_t(instruction);
     uint32_t rs = instr_s(instruction);
     uint32_t address = cpu_reg(cpu, rs) + offset;
-    uint8_t value_loaded = interconnect_load8(cpu->inter, address);
+    uint8_t value_loaded = interconnect_fast_load8(cpu->inter, address);
     // Zero-extend the 8-bit value to 32 bits
     uint32_t value_zero_extended = (uint32_t)value_loaded;
     // Schedule load for delay slot
-    cpu->load_reg_idx = rt;
-    cpu->load_value = value_zero_extended;
+    cpu_schedule_load(cpu, rt, value_zero_extended);
 }
 
 static void op_jalr(Cpu* cpu, uint32_t instruction) {
@@ -900,7 +1549,7 @@ static void op_syscall(Cpu* cpu, uint32_t instruction) {
     // syscall implemented yet. In that case, trigger a full exception
     // so we can see it in the logs and debug it.
     if (!was_handled) {
-        printf("Unhandled BIOS Syscall: 0x%02x, triggering full exception.\n", syscall_num);
+        LOG_DEBUG(LOG_CPU, "Unhandled BIOS Syscall: 0x%02x, triggering full exception.\n", syscall_num);
         cpu_exception(cpu, EXCEPTION_SYSCALL);
     }
     // If it was handled, we do nothing and simply proceed to the next instruction.
@@ -931,37 +1580,35 @@ static void op_mthi(Cpu* cpu, uint32_t instruction) {
 // Load Halfword Unsigned
 static void op_lhu(Cpu* cpu, uint32_t instruction) {
      if ((cpu->sr & 0x10000) != 0) {
-        printf("~ LHU Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
+        LOG_TRACE(LOG_CPU, "~ LHU Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
         return;
     }
     uint32_t offset = instr_imm_se(instruction);
     uint32_t rt = instr_t(instruction);
     uint32_t rs = instr_s(instruction);
     uint32_t address = cpu_reg(cpu, rs) + offset;
-    uint16_t value_loaded = interconnect_load16(cpu->inter, address); // Alignment checked in interconnect
+    uint16_t value_loaded = interconnect_fast_load16(cpu->inter, address); // Alignment checked in interconnect
     // Zero-extend the 16-bit value
     uint32_t value_zero_extended = (uint32_t)value_loaded;
     // Schedule load for delay slot
-    cpu->load_reg_idx = rt;
-    cpu->load_value = value_zero_extended;
+    cpu_schedule_load(cpu, rt, value_zero_extended);
 }
 
 // Load Halfword (Signed)
 static void op_lh(Cpu* cpu, uint32_t instruction) {
     if ((cpu->sr & 0x10000) != 0) {
-        printf("~ LH Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
+        LOG_TRACE(LOG_CPU, "~ LH Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); // Keep debug print
         return;
     }
     uint32_t offset = instr_imm_se(instruction);
     uint32_t rt = instr_t(instruction);
     uint32_t rs = instr_s(instruction);
     uint32_t address = cpu_reg(cpu, rs) + offset;
-    uint16_t value_loaded = interconnect_load16(cpu->inter, address); // Alignment checked in interconnect
+    uint16_t value_loaded = interconnect_fast_load16(cpu->inter, address); // Alignment checked in interconnect
     // Sign-extend the 16-bit value
     uint32_t value_sign_extended = (uint32_t)(int32_t)(int16_t)value_loaded;
     // Schedule load for delay slot
-    cpu->load_reg_idx = rt;
-    cpu->load_value = value_sign_extended;
+    cpu_schedule_load(cpu, rt, value_sign_extended);
 }
 
 // Shift Left Logical Variable
@@ -1020,7 +1667,7 @@ static void op_xor(Cpu* cpu, uint32_t instruction) {
 // Breakpoint
 static void op_break(Cpu* cpu, uint32_t /* instruction */) {
     // Keep essential debug print
-    printf("BREAK instruction executed (PC=0x%08x)\n", cpu->current_pc);
+    LOG_DEBUG(LOG_CPU, "BREAK instruction executed (PC=0x%08x)\n", cpu->current_pc);
     cpu_exception(cpu, EXCEPTION_BREAK); //
 }
 
@@ -1049,7 +1696,7 @@ static void op_sub(Cpu* cpu, uint32_t instruction) {
     // Use GCC/Clang builtin for checked signed subtraction
     if (__builtin_sub_overflow(rs_value, rt_value, &result)) {
         // Keep exception print
-        fprintf(stderr, "SUB Signed Overflow: %d - %d (PC=0x%08x)\n", rs_value, rt_value, cpu->current_pc);
+        LOG_WARN(LOG_CPU, "SUB Signed Overflow: %d - %d (PC=0x%08x)\n", rs_value, rt_value, cpu->current_pc);
         cpu_exception(cpu, EXCEPTION_OVERFLOW); //
     } else {
         cpu_set_reg(cpu, rd, (uint32_t)result);
@@ -1067,7 +1714,7 @@ static void op_xori(Cpu* cpu, uint32_t instruction) {
 // Coprocessor 1 (FPU) Opcode - Triggers exception
 static void op_cop1(Cpu* cpu, uint32_t instruction) {
     // Keep warning/exception for unimplemented hardware
-    fprintf(stderr, "Warning: Unsupported COP1 (FPU) instruction: 0x%08x (PC=0x%08x)\n",
+    LOG_WARN(LOG_CPU, "Warning: Unsupported COP1 (FPU) instruction: 0x%08x (PC=0x%08x)\n",
             instruction, cpu->current_pc);
     cpu_exception(cpu, EXCEPTION_COPROCESSOR_ERROR); //
 }
@@ -1075,7 +1722,7 @@ static void op_cop1(Cpu* cpu, uint32_t instruction) {
 // Coprocessor 2 (GTE) Opcode - Currently unimplemented
 static void op_cop2(Cpu* cpu, uint32_t instruction) {
     // Keep error and exit for unimplemented GTE
-    fprintf(stderr, "FATAL ERROR: Unhandled GTE (COP2) instruction: 0x%08x (PC=0x%08x)\n",
+    LOG_ERROR(LOG_CPU, "FATAL ERROR: Unhandled GTE (COP2) instruction: 0x%08x (PC=0x%08x)\n",
             instruction, cpu->current_pc);
     exit(1); //
 }
@@ -1083,7 +1730,7 @@ static void op_cop2(Cpu* cpu, uint32_t instruction) {
 // Coprocessor 3 Opcode - Triggers exception
 static void op_cop3(Cpu* cpu, uint32_t instruction) {
     // Keep warning/exception for unimplemented hardware
-    fprintf(stderr, "Warning: Unsupported COP3 instruction: 0x%08x (PC=0x%08x)\n",
+    LOG_WARN(LOG_CPU, "Warning: Unsupported COP3 instruction: 0x%08x (PC=0x%08x)\n",
             instruction, cpu->current_pc);
     cpu_exception(cpu, EXCEPTION_COPROCESSOR_ERROR); //
 }
@@ -1091,7 +1738,7 @@ static void op_cop3(Cpu* cpu, uint32_t instruction) {
 // Load Word Left (Handles unaligned loads)
 static void op_lwl(Cpu* cpu, uint32_t instruction) {
     if ((cpu->sr & 0x10000) != 0) {
-        printf("~ LWL Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); return;
+        LOG_TRACE(LOG_CPU, "~ LWL Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); return;
     }
     uint32_t offset = instr_imm_se(instruction);
     uint32_t rt = instr_t(instruction);
@@ -1099,10 +1746,10 @@ static void op_lwl(Cpu* cpu, uint32_t instruction) {
     uint32_t addr = cpu_reg(cpu, rs) + offset;
 
     // Merge with pending load value if target register matches
-    uint32_t current_rt_value = (cpu->load_reg_idx == rt) ? cpu->load_value : cpu->out_regs[rt];
+    uint32_t current_rt_value = (cpu->load_reg_idx == rt) ? cpu->load_value : cpu->regs[rt];
 
     uint32_t aligned_addr = addr & ~3;
-    uint32_t aligned_word = interconnect_load32(cpu->inter, aligned_addr);
+    uint32_t aligned_word = interconnect_fast_load32(cpu->inter, aligned_addr);
     uint32_t merged_value;
 
     // Shift and mask based on address alignment (Little Endian)
@@ -1114,14 +1761,13 @@ static void op_lwl(Cpu* cpu, uint32_t instruction) {
         default: merged_value = 0; /* Should not happen */ break;
     }
     // Schedule merged value for load delay slot
-    cpu->load_reg_idx = rt;
-    cpu->load_value = merged_value;
+    cpu_schedule_load(cpu, rt, merged_value);
 }
 
 // Load Word Right (Handles unaligned loads)
 static void op_lwr(Cpu* cpu, uint32_t instruction) {
      if ((cpu->sr & 0x10000) != 0) {
-        printf("~ LWR Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); return;
+        LOG_TRACE(LOG_CPU, "~ LWR Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); return;
     }
     uint32_t offset = instr_imm_se(instruction);
     uint32_t rt = instr_t(instruction);
@@ -1129,10 +1775,10 @@ static void op_lwr(Cpu* cpu, uint32_t instruction) {
     uint32_t addr = cpu_reg(cpu, rs) + offset;
 
     // Merge with pending load value if target register matches
-    uint32_t current_rt_value = (cpu->load_reg_idx == rt) ? cpu->load_value : cpu->out_regs[rt];
+    uint32_t current_rt_value = (cpu->load_reg_idx == rt) ? cpu->load_value : cpu->regs[rt];
 
     uint32_t aligned_addr = addr & ~3;
-    uint32_t aligned_word = interconnect_load32(cpu->inter, aligned_addr);
+    uint32_t aligned_word = interconnect_fast_load32(cpu->inter, aligned_addr);
     uint32_t merged_value;
 
     // Shift and mask based on address alignment (Little Endian)
@@ -1144,14 +1790,13 @@ static void op_lwr(Cpu* cpu, uint32_t instruction) {
         default: merged_value = 0; /* Should not happen */ break;
     }
     // Schedule merged value for load delay slot
-    cpu->load_reg_idx = rt;
-    cpu->load_value = merged_value;
+    cpu_schedule_load(cpu, rt, merged_value);
 }
 
 // Store Word Left (Handles unaligned stores)
 static void op_swl(Cpu* cpu, uint32_t instruction) {
      if ((cpu->sr & 0x10000) != 0) {
-        printf("~ SWL Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); return;
+        LOG_TRACE(LOG_CPU, "~ SWL Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); return;
     }
     uint32_t offset = instr_imm_se(instruction);
     uint32_t rt = instr_t(instruction); // Register containing data to store
@@ -1161,7 +1806,7 @@ static void op_swl(Cpu* cpu, uint32_t instruction) {
 
     uint32_t aligned_addr = addr & ~3;
     // Read-Modify-Write the aligned word in memory
-    uint32_t current_mem_word = interconnect_load32(cpu->inter, aligned_addr);
+    uint32_t current_mem_word = interconnect_fast_load32(cpu->inter, aligned_addr);
     uint32_t modified_mem_word;
 
     // Shift and mask based on address alignment (Little Endian)
@@ -1172,13 +1817,13 @@ static void op_swl(Cpu* cpu, uint32_t instruction) {
         case 3: modified_mem_word = (current_mem_word & 0x00000000) | (value_to_store >> 0);  break;
         default: modified_mem_word = current_mem_word; /* Should not happen */ break;
     }
-    interconnect_store32(cpu->inter, aligned_addr, modified_mem_word);
+    interconnect_fast_store32(cpu->inter, aligned_addr, modified_mem_word);
 }
 
 // Store Word Right (Handles unaligned stores)
 static void op_swr(Cpu* cpu, uint32_t instruction) {
     if ((cpu->sr & 0x10000) != 0) {
-        printf("~ SWR Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); return;
+        LOG_TRACE(LOG_CPU, "~ SWR Ignored (Cache Isolated, SR=0x%08x)\n", cpu->sr); return;
     }
     uint32_t offset = instr_imm_se(instruction);
     uint32_t rt = instr_t(instruction); // Register containing data to store
@@ -1188,7 +1833,7 @@ static void op_swr(Cpu* cpu, uint32_t instruction) {
 
     uint32_t aligned_addr = addr & ~3;
     // Read-Modify-Write
-    uint32_t current_mem_word = interconnect_load32(cpu->inter, aligned_addr);
+    uint32_t current_mem_word = interconnect_fast_load32(cpu->inter, aligned_addr);
     uint32_t modified_mem_word;
 
     // Shift and mask based on address alignment (Little Endian)
@@ -1199,61 +1844,61 @@ static void op_swr(Cpu* cpu, uint32_t instruction) {
         case 3: modified_mem_word = (current_mem_word & 0x00FFFFFF) | (value_to_store << 24); break;
         default: modified_mem_word = current_mem_word; /* Should not happen */ break;
     }
-    interconnect_store32(cpu->inter, aligned_addr, modified_mem_word);
+    interconnect_fast_store32(cpu->inter, aligned_addr, modified_mem_word);
 }
 
 // Load Word Coprocessor 0 - Not supported
 static void op_lwc0(Cpu* cpu, uint32_t instruction) {
-    fprintf(stderr, "Warning: Unsupported LWC0 instruction: 0x%08x (PC=0x%08x)\n",
+    LOG_WARN(LOG_CPU, "Warning: Unsupported LWC0 instruction: 0x%08x (PC=0x%08x)\n",
             instruction, cpu->current_pc);
     cpu_exception(cpu, EXCEPTION_COPROCESSOR_ERROR); //
 }
 
 // Load Word Coprocessor 1 (FPU) - Not supported
 static void op_lwc1(Cpu* cpu, uint32_t instruction) {
-    fprintf(stderr, "Warning: Unsupported LWC1 instruction: 0x%08x (PC=0x%08x)\n",
+    LOG_WARN(LOG_CPU, "Warning: Unsupported LWC1 instruction: 0x%08x (PC=0x%08x)\n",
             instruction, cpu->current_pc);
     cpu_exception(cpu, EXCEPTION_COPROCESSOR_ERROR); //
 }
 
 // Load Word Coprocessor 2 (GTE) - Unimplemented
 static void op_lwc2(Cpu* cpu, uint32_t instruction) {
-    fprintf(stderr, "FATAL ERROR: Unhandled GTE LWC2 instruction: 0x%08x (PC=0x%08x)\n",
+    LOG_ERROR(LOG_CPU, "FATAL ERROR: Unhandled GTE LWC2 instruction: 0x%08x (PC=0x%08x)\n",
             instruction, cpu->current_pc);
     exit(1); //
 }
 
 // Load Word Coprocessor 3 - Not supported
 static void op_lwc3(Cpu* cpu, uint32_t instruction) {
-    fprintf(stderr, "Warning: Unsupported LWC3 instruction: 0x%08x (PC=0x%08x)\n",
+    LOG_WARN(LOG_CPU, "Warning: Unsupported LWC3 instruction: 0x%08x (PC=0x%08x)\n",
             instruction, cpu->current_pc);
     cpu_exception(cpu, EXCEPTION_COPROCESSOR_ERROR); //
 }
 
 // Store Word Coprocessor 0 - Not supported
 static void op_swc0(Cpu* cpu, uint32_t instruction) {
-    fprintf(stderr, "Warning: Unsupported SWC0 instruction: 0x%08x (PC=0x%08x)\n",
+    LOG_WARN(LOG_CPU, "Warning: Unsupported SWC0 instruction: 0x%08x (PC=0x%08x)\n",
             instruction, cpu->current_pc);
     cpu_exception(cpu, EXCEPTION_COPROCESSOR_ERROR); //
 }
 
 // Store Word Coprocessor 1 (FPU) - Not supported
 static void op_swc1(Cpu* cpu, uint32_t instruction) {
-    fprintf(stderr, "Warning: Unsupported SWC1 instruction: 0x%08x (PC=0x%08x)\n",
+    LOG_WARN(LOG_CPU, "Warning: Unsupported SWC1 instruction: 0x%08x (PC=0x%08x)\n",
             instruction, cpu->current_pc);
     cpu_exception(cpu, EXCEPTION_COPROCESSOR_ERROR); //
 }
 
 // Store Word Coprocessor 2 (GTE) - Unimplemented
 static void op_swc2(Cpu* cpu, uint32_t instruction) {
-    fprintf(stderr, "FATAL ERROR: Unhandled GTE SWC2 instruction: 0x%08x (PC=0x%08x)\n",
+    LOG_ERROR(LOG_CPU, "FATAL ERROR: Unhandled GTE SWC2 instruction: 0x%08x (PC=0x%08x)\n",
             instruction, cpu->current_pc);
     exit(1); //
 }
 
 // Store Word Coprocessor 3 - Not supported
 static void op_swc3(Cpu* cpu, uint32_t instruction) {
-    fprintf(stderr, "Warning: Unsupported SWC3 instruction: 0x%08x (PC=0x%08x)\n",
+    LOG_WARN(LOG_CPU, "Warning: Unsupported SWC3 instruction: 0x%08x (PC=0x%08x)\n",
             instruction, cpu->current_pc);
     cpu_exception(cpu, EXCEPTION_COPROCESSOR_ERROR); //
 }
@@ -1261,7 +1906,7 @@ static void op_swc3(Cpu* cpu, uint32_t instruction) {
 // Illegal/Unhandled Instruction Handler
 static void op_illegal(Cpu* cpu, uint32_t instruction) {
     // Keep essential error print for illegal instructions
-    fprintf(stderr, "Error: Illegal/Unhandled instruction 0x%08x encountered at PC=0x%08x\n",
+    LOG_ERROR(LOG_CPU, "Error: Illegal/Unhandled instruction 0x%08x encountered at PC=0x%08x\n",
             instruction, cpu->current_pc);
     cpu_exception(cpu, EXCEPTION_ILLEGAL_INSTRUCTION); //
 }
\ No newline at end of file
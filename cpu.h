@@ -2,6 +2,7 @@
 #define CPU_H
 
 #include <stdbool.h> // For bool type
+#include <stddef.h>  // For size_t
 #include <stdint.h>  // For uint32_t, int32_t etc.
 #include "interconnect.h" // Needs definition of Interconnect for the pointer member
 
@@ -70,6 +71,84 @@ typedef struct {
 // ============================================================= //
 // ============================================================= //
 
+
+// ============================================================= //
+// ==========>>> CACHED INTERPRETER (BLOCK CACHE) <<<=========== //
+// ============================================================= //
+
+// Threaded (computed-goto) dispatch for the interpreter mode of cpu_run().
+// Needs GCC/Clang labels-as-values; build with -DCPU_THREADED_DISPATCH=0 to force the
+// portable decode_and_execute() switch.
+#ifndef CPU_THREADED_DISPATCH
+#if defined(__GNUC__)
+#define CPU_THREADED_DISPATCH 1
+#else
+#define CPU_THREADED_DISPATCH 0
+#endif
+#endif
+
+/**
+ * @brief Selects how cpu_run() executes guest code.
+ * The per-instruction interpreter is kept as the reference implementation;
+ * the cached interpreter decodes each basic block once and replays it.
+ */
+typedef enum {
+    CPU_EXEC_INTERPRETER = 0, // Fetch + decode every instruction (reference mode)
+    CPU_EXEC_CACHED      = 1, // Decode basic blocks once, keyed by physical PC
+    CPU_EXEC_JIT         = 2  // Translate basic blocks to x86-64 host code (cpu_jit.c)
+} CpuExecMode;
+
+#define CPU_BLOCK_CACHE_SIZE 4096 // Number of direct-mapped block slots (power of two)
+#define CPU_BLOCK_MAX_OPS    64   // Longest basic block we decode in one go
+#define CPU_BLOCK_INVALID    0xFFFFFFFF // Tag value for an empty block slot
+#define CPU_IDLE_LOOP_MAX_OPS 16        // Longest block considered for idle-loop detection
+
+// Flags describing a decoded block (CpuBlock.flags)
+#define CPU_BLOCK_IDLE_LOOP (1 << 0) // Short loop back to its own start: only loads, pure ALU ops and the branch
+
+// Flags describing a decoded instruction (CpuDecodedOp.flags)
+#define CPU_OP_BRANCH     (1 << 0) // Jump/branch: the next op is its delay slot
+#define CPU_OP_LOAD       (1 << 1) // Reads memory through the interconnect
+#define CPU_OP_STORE      (1 << 2) // Writes memory through the interconnect
+#define CPU_OP_ENDS_BLOCK (1 << 3) // May change SR or raise an exception: stop the block after it
+
+/**
+ * @brief Signature shared by all op_* instruction handlers.
+ */
+typedef void (*CpuOpHandler)(Cpu* cpu, uint32_t instruction);
+
+/**
+ * @brief One pre-decoded guest instruction inside a cached block.
+ * The handler is resolved once at decode time so execution skips the opcode switch.
+ */
+typedef struct {
+    CpuOpHandler handler;  // Resolved op_* handler
+    uint32_t instruction;  // Raw instruction word (handlers still take it)
+    uint8_t rs, rt, rd;    // Pre-extracted register fields
+    uint8_t flags;         // CPU_OP_* flags
+} CpuDecodedOp;
+
+/**
+ * @brief Entry point of a translated block. Returns the number of guest instructions executed.
+ */
+typedef uint32_t (*CpuJitCode)(Cpu* cpu);
+
+/**
+ * @brief A decoded basic block: straight-line ops ending after a branch delay slot,
+ * an SR-changing/exception-raising op, a region boundary or CPU_BLOCK_MAX_OPS.
+ */
+typedef struct {
+    uint32_t paddr;  // Physical address of the first op (CPU_BLOCK_INVALID if empty)
+    uint32_t vaddr;  // Virtual address it was decoded at (the JIT bakes PC values in)
+    uint32_t len;    // Number of valid entries in ops[]
+    uint32_t flags;  // CPU_BLOCK_* flags
+    CpuJitCode jit_code; // Host code for this block (NULL until translated)
+    CpuDecodedOp ops[CPU_BLOCK_MAX_OPS];
+} CpuBlock;
+
+// ============================================================= //
+// ============================================================= //
+
 // --- CPU State Structure ---
 // Defines the internal state of the emulated MIPS R3000A-compatible CPU.
 typedef struct Cpu {
@@ -79,13 +158,16 @@ typedef struct Cpu {
     uint32_t current_pc;    // Address of the instruction currently executing (used for exception EPC).
 
     // --- General Purpose Registers (GPRs) ---
-    uint32_t regs[32];      // Input register values for the current instruction. R0 is hardwired to 0.
-    uint32_t out_regs[32];  // Output register values written by the current instruction.
+    uint32_t regs[32];      // Single register file. R0 is hardwired to 0.
 
     // --- Load Delay Slot ---
     // MIPS I has a one-instruction delay after a load before the data is available.
-    RegisterIndex load_reg_idx; // Target register for the pending load.
-    uint32_t load_value;        // Value to be loaded into the target register.
+    // A load issued by instruction N is recorded in next_load_*, becomes the pending load
+    // when N retires, and is written to regs[] when N+1 retires (unless N+1 wrote the register).
+    RegisterIndex load_reg_idx;      // Target register of the pending load (REG_ZERO = none).
+    uint32_t load_value;             // Value of the pending load.
+    RegisterIndex next_load_reg_idx; // Target register of the load issued by the current instruction.
+    uint32_t next_load_value;        // Value of the load issued by the current instruction.
 
     // --- HI/LO Registers ---
     // Used for results of multiplication and division.
@@ -107,6 +189,22 @@ typedef struct Cpu {
 
     ICacheLine icache[ICACHE_NUM_LINES];
 
+    // --- Execution Mode / Block Cache ---
+    CpuExecMode exec_mode;  // Selected by cpu_set_exec_mode(), used by cpu_run()
+    CpuBlock* block_cache;  // CPU_BLOCK_CACHE_SIZE direct-mapped slots (heap allocated)
+    bool block_exit;        // Set by exceptions/code invalidation to leave the running block early
+    bool irq_pending;       // (I_STAT & I_MASK) != 0 && SR.IEc, kept current by cpu_update_irq_pending()
+    uint64_t blocks_compiled; // Statistics: number of blocks decoded so far
+
+    // --- Idle Loop Skipping ---
+    bool idle_loop_hit;          // Set when the block just run was a polling loop at a fixed point
+    uint64_t idle_cycles_skipped; // Statistics: cycles fast-forwarded instead of spinning
+
+    // --- JIT Code Buffer (cpu_jit.c) ---
+    uint8_t* jit_buffer;    // Executable memory for translated blocks (NULL if unavailable)
+    size_t jit_buffer_size; // Size of jit_buffer in bytes
+    size_t jit_buffer_used; // Bump pointer; the whole buffer is flushed when full
+
 } Cpu;
 
 
@@ -144,6 +242,38 @@ void cpu_init(Cpu* cpu, Interconnect* inter);
  */
 void cpu_run_next_instruction(Cpu* cpu);
 
+/**
+ * @brief Releases memory owned by the CPU (the block cache).
+ * @param cpu Pointer to the Cpu state.
+ */
+void cpu_destroy(Cpu* cpu);
+
+/**
+ * @brief Selects the execution mode used by cpu_run().
+ * Switching modes flushes the block cache.
+ * @param cpu Pointer to the Cpu state.
+ * If the JIT is unavailable on this host, CPU_EXEC_JIT falls back to CPU_EXEC_CACHED.
+ * @param mode CPU_EXEC_INTERPRETER, CPU_EXEC_CACHED or CPU_EXEC_JIT.
+ */
+void cpu_set_exec_mode(Cpu* cpu, CpuExecMode mode);
+
+/**
+ * @brief Drops every cached block and JIT translation.
+ * @param cpu Pointer to the Cpu state.
+ */
+void cpu_flush_block_cache(Cpu* cpu);
+
+/**
+ * @brief Runs the CPU for (at least) the requested number of cycles.
+ * In cached mode whole blocks are executed, so the result may overshoot by up to one block.
+ * One instruction is one cycle on the scheduler clock; device events that fall due
+ * are dispatched inside the call, at the block/instruction boundary where they expire.
+ * @param cpu Pointer to the Cpu state.
+ * @param cycles Number of cycles to run.
+ * @return The number of cycles actually executed.
+ */
+uint32_t cpu_run(Cpu* cpu, uint32_t cycles);
+
 /**
  * @brief Decodes the fetched instruction and calls the appropriate handler function.
  * @param cpu Pointer to the Cpu state.
@@ -165,7 +295,7 @@ static bool handle_bios_syscall(Cpu* cpu, uint32_t syscall_num);
 
 // --- Register Access ---
 /**
- * @brief Reads the value of a General Purpose Register (GPR) from the input set.
+ * @brief Reads the value of a General Purpose Register (GPR).
  * Handles reads from $zero (always returns 0).
  * @param cpu Pointer to the Cpu state.
  * @param index The index (0-31) of the register to read.
@@ -174,8 +304,9 @@ static bool handle_bios_syscall(Cpu* cpu, uint32_t syscall_num);
 uint32_t cpu_reg(Cpu* cpu, RegisterIndex index);
 
 /**
- * @brief Writes a value to a General Purpose Register (GPR) in the output set.
+ * @brief Writes a value to a General Purpose Register (GPR).
  * Ignores writes to $zero (index 0), ensuring it remains 0.
+ * A write to the target of the pending load cancels that load.
  * @param cpu Pointer to the Cpu state.
  * @param index The index (0-31) of the register to write.
  * @param value The 32-bit value to write.
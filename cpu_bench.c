@@ -0,0 +1,209 @@
+// cpu_bench.c
+// Times the CPU execution paths on a fixed instruction mix (see cpu_bench.h).
+#include "cpu_bench.h"
+#include "cpu.h"
+#include "bios.h"
+#include "ram.h"
+#include "interconnect.h"
+#include "logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define CPU_BENCH_INSTRUCTIONS 100000000u // Per configuration
+#define CPU_BENCH_CODE_ADDR    0x80010000u // KSEG0: fetched through the instruction cache
+#define CPU_BENCH_DATA_ADDR    0x80020000u
+#define CPU_BENCH_IDLE_CYCLES  (10 * VBLANK_PERIOD_CYCLES) // Per idle loop check
+
+// The loop body: a load, ALU work depending on it, a store, and a jump back with a filled
+// delay slot. No register reaches a fixed point, so idle loop detection never kicks in.
+static const uint32_t cpu_bench_code[] = {
+    0x3C108002, //       lui   s0, 0x8002          (CPU_BENCH_DATA_ADDR)
+    0x8E080000, // loop: lw    t0, 0(s0)
+    0x25290001, //       addiu t1, t1, 1
+    0x01495021, //       addu  t2, t2, t1
+    0x01485826, //       xor   t3, t2, t0
+    0x016A602B, //       sltu  t4, t3, t2
+    0xAE0B0004, //       sw    t3, 4(s0)
+    0x08004001, //       j     loop
+    0x01CC7021, //       addu  t6, t6, t4          (delay slot)
+};
+
+typedef struct {
+    Bios* bios;
+    Ram* ram;
+    Interconnect* inter;
+    Cpu* cpu;
+} CpuBenchMachine;
+
+static double cpu_bench_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void cpu_bench_machine_destroy(CpuBenchMachine* machine) {
+    if (machine->cpu) cpu_destroy(machine->cpu);
+    free(machine->cpu);
+    free(machine->inter);
+    free(machine->ram);
+    free(machine->bios);
+}
+
+/**
+ * @brief Powers on a machine with a zeroed BIOS, writes 'code' at CPU_BENCH_CODE_ADDR and
+ * points the CPU at it (interrupts stay disabled: SR is 0 after cpu_init).
+ */
+static bool cpu_bench_machine_create(CpuBenchMachine* machine, CpuExecMode mode,
+                                     const uint32_t* code, uint32_t count) {
+    machine->bios = calloc(1, sizeof(Bios));
+    machine->ram = calloc(1, sizeof(Ram));
+    machine->inter = calloc(1, sizeof(Interconnect));
+    machine->cpu = calloc(1, sizeof(Cpu));
+    if (!machine->bios || !machine->ram || !machine->inter || !machine->cpu) {
+        fprintf(stderr, "CPU bench: failed to allocate the machine\n");
+        free(machine->cpu);
+        machine->cpu = NULL;
+        cpu_bench_machine_destroy(machine);
+        return false;
+    }
+    ram_init(machine->ram);
+    interconnect_init(machine->inter, machine->bios, machine->ram);
+    gpu_set_backend(&machine->inter->gpu, GPU_BACKEND_SOFTWARE); // VBlanks must not need a renderer
+    cpu_init(machine->cpu, machine->inter);
+    cpu_set_exec_mode(machine->cpu, mode);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        ram_store32(machine->ram, (CPU_BENCH_CODE_ADDR & 0x1FFFFFFF) + i * 4, code[i]);
+    }
+    machine->cpu->pc = CPU_BENCH_CODE_ADDR;
+    machine->cpu->next_pc = CPU_BENCH_CODE_ADDR + 4;
+    return true;
+}
+
+/**
+ * @brief Runs CPU_BENCH_INSTRUCTIONS through cpu_run_next_instruction, or through cpu_run()
+ * in 'mode' if 'stepped' is false, and prints the rate.
+ */
+static bool cpu_bench_case(const char* name, CpuExecMode mode, bool stepped, double* step_rate) {
+    CpuBenchMachine machine;
+    if (!cpu_bench_machine_create(&machine, mode, cpu_bench_code,
+                                  sizeof(cpu_bench_code) / sizeof(cpu_bench_code[0]))) {
+        return false;
+    }
+    Cpu* cpu = machine.cpu;
+    uint64_t cycles_start = machine.inter->scheduler.now;
+
+    double start = cpu_bench_seconds();
+    if (stepped) {
+        for (uint32_t i = 0; i < CPU_BENCH_INSTRUCTIONS; ++i) cpu_run_next_instruction(cpu);
+    } else {
+        cpu_run(cpu, CPU_BENCH_INSTRUCTIONS);
+    }
+    double elapsed = cpu_bench_seconds() - start;
+
+    // One cycle per instruction, as in the exit report of the main loop
+    uint64_t instructions = machine.inter->scheduler.now - cycles_start - cpu->idle_cycles_skipped;
+    double rate = elapsed > 0 ? instructions / elapsed / 1e6 : 0.0;
+    if (stepped) *step_rate = rate;
+    printf("  %-30s %9.1f M instructions/s  x%.2f  (t6 %08x)\n", name, rate,
+           *step_rate > 0 ? rate / *step_rate : 0.0, cpu->regs[14]);
+
+    cpu_bench_machine_destroy(&machine);
+    return true;
+}
+
+bool cpu_bench_run(void) {
+    // Block compilation and device messages would be timed along with the guest code
+    uint8_t cpu_log_level = logger_category_level[LOG_CPU];
+    logger_category_level[LOG_CPU] = LOG_LEVEL_WARN;
+
+    printf("CPU bench: %u-instruction loop, %u instructions per run\n",
+           (unsigned)(sizeof(cpu_bench_code) / sizeof(cpu_bench_code[0])) - 1, CPU_BENCH_INSTRUCTIONS);
+    double step_rate = 0;
+    bool ok = cpu_bench_case("cpu_run_next_instruction", CPU_EXEC_INTERPRETER, true, &step_rate) &&
+              cpu_bench_case("cpu_run, interpreter", CPU_EXEC_INTERPRETER, false, &step_rate) &&
+              cpu_bench_case("cpu_run, cached blocks", CPU_EXEC_CACHED, false, &step_rate) &&
+              cpu_bench_case("cpu_run, JIT", CPU_EXEC_JIT, false, &step_rate);
+
+    logger_category_level[LOG_CPU] = cpu_log_level;
+    return ok;
+}
+
+// --- Idle Loop Check ---
+
+// Waits for any IRQ the way game code polls I_STAT. The loop only reads a stable register,
+// so one iteration that leaves the registers unchanged proves it is spinning.
+static const uint32_t cpu_bench_poll_code[] = {
+    0x3C091F80, //       lui   t1, 0x1F80
+    0x8D281070, // loop: lw    t0, 0x1070(t1)      (I_STAT)
+    0x00000000, //       nop                       (load delay)
+    0x1100FFFD, //       beq   t0, zero, loop
+    0x00000000, //       nop
+    0x08004005, // done: j     done
+    0x00000000, //       nop
+};
+
+// Counts down like the BIOS's delay loops. It never reaches a register fixed point, so it
+// is intentionally run instruction by instruction (and the count always ends the loop).
+static const uint32_t cpu_bench_counter_code[] = {
+    0x3C0A0100, //       lui   t2, 0x0100
+    0x254AFFFF, // loop: addiu t2, t2, -1
+    0x1540FFFE, //       bne   t2, zero, loop
+    0x00000000, //       nop
+    0x08004004, // done: j     done
+    0x00000000, //       nop
+};
+
+/**
+ * @brief Runs 'code' for CPU_BENCH_IDLE_CYCLES in 'mode' and prints the cycles skipped.
+ * @return The cycles skipped, or UINT64_MAX if the machine could not be allocated.
+ */
+static uint64_t cpu_bench_idle_case(const char* name, CpuExecMode mode, const uint32_t* code, uint32_t count) {
+    CpuBenchMachine machine;
+    if (!cpu_bench_machine_create(&machine, mode, code, count)) return UINT64_MAX;
+    Cpu* cpu = machine.cpu;
+
+    uint32_t cycles = cpu_run(cpu, CPU_BENCH_IDLE_CYCLES);
+    uint64_t skipped = cpu->idle_cycles_skipped;
+    printf("  %-30s %10u cycles, %10llu skipped as idle (%.1f%%)\n", name, cycles,
+           (unsigned long long)skipped, cycles ? skipped * 100.0 / cycles : 0.0);
+
+    cpu_bench_machine_destroy(&machine);
+    return skipped;
+}
+
+bool cpu_bench_idle(void) {
+    uint8_t cpu_log_level = logger_category_level[LOG_CPU];
+    logger_category_level[LOG_CPU] = LOG_LEVEL_WARN;
+
+    printf("CPU idle loop check: %u cycles per loop\n", (unsigned)CPU_BENCH_IDLE_CYCLES);
+    static const struct {
+        const char* name;
+        CpuExecMode mode;
+    } modes[] = {
+        { "cached blocks", CPU_EXEC_CACHED },
+        { "JIT", CPU_EXEC_JIT },
+    };
+    bool ok = true;
+    char name[64];
+    for (uint32_t i = 0; i < sizeof(modes) / sizeof(modes[0]) && ok; ++i) {
+        snprintf(name, sizeof(name), "I_STAT poll, %s", modes[i].name);
+        uint64_t skipped = cpu_bench_idle_case(name, modes[i].mode, cpu_bench_poll_code,
+                                               sizeof(cpu_bench_poll_code) / sizeof(cpu_bench_poll_code[0]));
+        if (skipped == UINT64_MAX) {
+            ok = false;
+        } else if (skipped == 0) {
+            printf("  the I_STAT polling loop was not detected as idle\n");
+            ok = false;
+        }
+
+        snprintf(name, sizeof(name), "countdown, %s", modes[i].name);
+        skipped = cpu_bench_idle_case(name, modes[i].mode, cpu_bench_counter_code,
+                                      sizeof(cpu_bench_counter_code) / sizeof(cpu_bench_counter_code[0]));
+        if (skipped == UINT64_MAX) ok = false;
+    }
+
+    logger_category_level[LOG_CPU] = cpu_log_level;
+    return ok;
+}
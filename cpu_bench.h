@@ -0,0 +1,26 @@
+// cpu_bench.h
+// CPU benchmarks on a standalone machine (zeroed BIOS, code written straight into RAM).
+#ifndef CPU_BENCH_H
+#define CPU_BENCH_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Runs a fixed integer loop (lw, addiu, addu, xor, sltu, sw, j + delay slot) from RAM
+ * and prints the guest instructions per second: one instruction at a time through
+ * cpu_run_next_instruction (the reference path), then through cpu_run() in each execution
+ * mode. Every configuration executes the same number of instructions on a fresh machine.
+ * @return false if the machine could not be allocated.
+ */
+bool cpu_bench_run(void);
+
+/**
+ * @brief Checks the idle loop skip in the cached and JIT modes. Runs a polling loop on I_STAT
+ * (lw; nop; beq; nop), which must be fast-forwarded to the next device event, and a counter
+ * loop (addiu; bne; nop), which is not: its registers change every iteration. Prints the
+ * cycles executed and skipped for each.
+ * @return false if the machine could not be allocated or the polling loop was not skipped.
+ */
+bool cpu_bench_idle(void);
+
+#endif // CPU_BENCH_H
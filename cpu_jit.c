@@ -0,0 +1,401 @@
+// cpu_jit.c
+// x86-64 dynamic recompiler for the MIPS core.
+//
+// Translation unit = one CpuBlock (already decoded by cpu.c). The generated code keeps
+// the interpreter's observable behaviour:
+//  - Load delay: only handlers schedule loads, so the pending-load record is retired after
+//    every handler call and after the first inline op that follows one. Inline ops in between
+//    know statically that no load is pending.
+//  - Branch delay: branches always go through their op_* handler; the delay slot op then
+//    does the PC/delay-slot bookkeeping dynamically, exactly like cpu_run_next_instruction().
+//  - PC: for straight-line code, current_pc/pc/next_pc are only written back before a
+//    handler call and at block end (inline ops cannot fault).
+//  - Exceptions/invalidation: after every handler call, cpu->block_exit is tested and the
+//    block returns early.
+#include "cpu_jit.h"
+#include "logger.h"
+#include <stdio.h>
+#include <string.h> // For memcpy
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#include <sys/mman.h>
+#define CPU_JIT_AVAILABLE 1
+#else
+#define CPU_JIT_AVAILABLE 0
+#endif
+
+// Worst-case host bytes for one guest op (PC bookkeeping + call + load retirement + exit test)
+#define CPU_JIT_MAX_OP_BYTES 256
+
+// --- Emitter ---
+typedef struct {
+    uint8_t* code; // Start of the code being emitted
+    size_t pos;    // Bytes emitted so far
+} JitEmitter;
+
+static void emit8(JitEmitter* e, uint8_t b) { e->code[e->pos++] = b; }
+
+static void emit32(JitEmitter* e, uint32_t v) {
+    memcpy(&e->code[e->pos], &v, 4); // x86 is little-endian
+    e->pos += 4;
+}
+
+static void emit64(JitEmitter* e, uint64_t v) {
+    memcpy(&e->code[e->pos], &v, 8);
+    e->pos += 8;
+}
+
+// All guest state is addressed as [rbx + disp32], rbx = Cpu*.
+// ModRM for (reg, [rbx + disp32]): mod=10, rm=011.
+static void emit_modrm_rbx(JitEmitter* e, uint8_t reg, uint32_t disp) {
+    emit8(e, 0x80 | (reg << 3) | 3);
+    emit32(e, disp);
+}
+
+// Host register numbers
+#define HOST_EAX 0
+#define HOST_ECX 1
+#define HOST_EDX 2
+
+// <op> r32, [rbx + disp] (op = 0x8B mov, 0x03 add, 0x0B or, 0x23 and, 0x2B sub, 0x33 xor, 0x3B cmp)
+static void emit_op_reg_mem(JitEmitter* e, uint8_t opcode, uint8_t reg, uint32_t disp) {
+    emit8(e, opcode);
+    emit_modrm_rbx(e, reg, disp);
+}
+
+// mov [rbx + disp], r32
+static void emit_store_reg(JitEmitter* e, uint8_t reg, uint32_t disp) {
+    emit8(e, 0x89);
+    emit_modrm_rbx(e, reg, disp);
+}
+
+// mov dword [rbx + disp], imm32
+static void emit_store_imm32(JitEmitter* e, uint32_t disp, uint32_t imm) {
+    emit8(e, 0xC7);
+    emit_modrm_rbx(e, 0, disp);
+    emit32(e, imm);
+}
+
+// mov byte [rbx + disp], imm8
+static void emit_store_imm8(JitEmitter* e, uint32_t disp, uint8_t imm) {
+    emit8(e, 0xC6);
+    emit_modrm_rbx(e, 0, disp);
+    emit8(e, imm);
+}
+
+// <op> eax, imm32 (group 1: /0 add, /1 or, /4 and, /6 xor, /7 cmp)
+static void emit_alu_eax_imm(JitEmitter* e, uint8_t group_op, uint32_t imm) {
+    emit8(e, 0x81);
+    emit8(e, 0xC0 | (group_op << 3));
+    emit32(e, imm);
+}
+
+// setcc al; movzx eax, al (cc = 0x9C setl, 0x92 setb)
+static void emit_setcc_eax(JitEmitter* e, uint8_t setcc) {
+    emit8(e, 0x0F); emit8(e, setcc); emit8(e, 0xC0);
+    emit8(e, 0x0F); emit8(e, 0xB6); emit8(e, 0xC0);
+}
+
+// mov eax, imm32; pop rbx; ret
+static void emit_return(JitEmitter* e, uint32_t executed) {
+    emit8(e, 0xB8);
+    emit32(e, executed);
+    emit8(e, 0x5B);
+    emit8(e, 0xC3);
+}
+
+// --- Guest State Offsets ---
+#define OFF_REG(i)     ((uint32_t)(offsetof(Cpu, regs) + 4 * (i)))
+#define OFF_PC         ((uint32_t)offsetof(Cpu, pc))
+#define OFF_NEXT_PC    ((uint32_t)offsetof(Cpu, next_pc))
+#define OFF_CURRENT_PC ((uint32_t)offsetof(Cpu, current_pc))
+#define OFF_LOAD_IDX   ((uint32_t)offsetof(Cpu, load_reg_idx))
+#define OFF_LOAD_VALUE ((uint32_t)offsetof(Cpu, load_value))
+#define OFF_NEXT_LOAD_IDX   ((uint32_t)offsetof(Cpu, next_load_reg_idx))
+#define OFF_NEXT_LOAD_VALUE ((uint32_t)offsetof(Cpu, next_load_value))
+#define OFF_BRANCH     ((uint32_t)offsetof(Cpu, branch_taken))
+#define OFF_DELAY_SLOT ((uint32_t)offsetof(Cpu, in_delay_slot))
+#define OFF_BLOCK_EXIT ((uint32_t)offsetof(Cpu, block_exit))
+
+_Static_assert(sizeof(bool) == 1, "JIT stores bool fields as bytes");
+_Static_assert(sizeof(RegisterIndex) == 4, "JIT loads load_reg_idx as a dword");
+
+// Writes the pending load to regs[] (regs[load_reg_idx] = load_value). Leaves eax untouched.
+static void emit_apply_pending_load(JitEmitter* e) {
+    emit_op_reg_mem(e, 0x8B, HOST_ECX, OFF_LOAD_IDX);
+    emit_op_reg_mem(e, 0x8B, HOST_EDX, OFF_LOAD_VALUE);
+    // mov [rbx + rcx*4 + disp32], edx
+    emit8(e, 0x89); emit8(e, 0x94); emit8(e, 0x8B); emit32(e, OFF_REG(0));
+}
+
+// cpu_retire_load_delay(): pending load lands, the load issued by this op becomes pending.
+static void emit_retire_load_delay(JitEmitter* e) {
+    emit_apply_pending_load(e);
+    emit_store_imm32(e, OFF_REG(0), 0);
+    emit_op_reg_mem(e, 0x8B, HOST_EAX, OFF_NEXT_LOAD_IDX);
+    emit_store_reg(e, HOST_EAX, OFF_LOAD_IDX);
+    emit_op_reg_mem(e, 0x8B, HOST_EAX, OFF_NEXT_LOAD_VALUE);
+    emit_store_reg(e, HOST_EAX, OFF_LOAD_VALUE);
+    emit_store_imm32(e, OFF_NEXT_LOAD_IDX, 0);
+}
+
+// Delay slot bookkeeping, identical to step 4 of cpu_run_next_instruction().
+static void emit_dynamic_pc_update(JitEmitter* e) {
+    emit_op_reg_mem(e, 0x8B, HOST_EAX, OFF_PC);
+    emit_store_reg(e, HOST_EAX, OFF_CURRENT_PC);
+    emit8(e, 0x0F); emit8(e, 0xB6); emit_modrm_rbx(e, HOST_ECX, OFF_BRANCH); // movzx ecx, byte [branch_taken]
+    emit8(e, 0x88); emit_modrm_rbx(e, HOST_ECX, OFF_DELAY_SLOT);            // mov [in_delay_slot], cl
+    emit_store_imm8(e, OFF_BRANCH, 0);
+    emit_op_reg_mem(e, 0x8B, HOST_EAX, OFF_NEXT_PC);
+    emit_store_reg(e, HOST_EAX, OFF_PC);
+    emit8(e, 0x83); emit8(e, 0xC0); emit8(e, 0x04); // add eax, 4
+    emit_store_reg(e, HOST_EAX, OFF_NEXT_PC);
+}
+
+/**
+ * @brief Emits the computation of an ALU op into eax if it is one we translate.
+ * Mirrors the corresponding op_* handlers in cpu.c.
+ * @param dest Receives the destination register (0 = result discarded, nothing emitted).
+ * @return true if the op is translated inline, false if it needs its handler.
+ */
+static bool emit_inline_op(JitEmitter* e, const CpuDecodedOp* op, uint32_t* dest) {
+    uint32_t instruction = op->instruction;
+    uint32_t opcode = instr_function(instruction);
+    uint32_t rs = op->rs, rt = op->rt, rd = op->rd;
+    uint32_t imm = instr_imm(instruction);
+    uint32_t imm_se = instr_imm_se(instruction);
+
+    if (opcode == 0x00) {
+        uint32_t subfunc = instr_subfunction(instruction);
+        uint32_t shamt = instr_shift(instruction);
+        switch (subfunc) {
+            case 0x00: case 0x02: case 0x03: // SLL, SRL, SRA
+                *dest = rd;
+                if (rd == 0) return true;
+                emit_op_reg_mem(e, 0x8B, HOST_EAX, OFF_REG(rt));
+                if (shamt != 0) {
+                    emit8(e, 0xC1);
+                    emit8(e, subfunc == 0x00 ? 0xE0 : (subfunc == 0x02 ? 0xE8 : 0xF8));
+                    emit8(e, (uint8_t)shamt);
+                }
+                return true;
+            case 0x04: case 0x06: case 0x07: // SLLV, SRLV, SRAV (x86 masks cl to 5 bits, like MIPS)
+                *dest = rd;
+                if (rd == 0) return true;
+                emit_op_reg_mem(e, 0x8B, HOST_EAX, OFF_REG(rt));
+                emit_op_reg_mem(e, 0x8B, HOST_ECX, OFF_REG(rs));
+                emit8(e, 0xD3);
+                emit8(e, subfunc == 0x04 ? 0xE0 : (subfunc == 0x06 ? 0xE8 : 0xF8));
+                return true;
+            case 0x21: case 0x23: case 0x24: case 0x25: case 0x26: case 0x27: { // ADDU, SUBU, AND, OR, XOR, NOR
+                static const uint8_t alu_ops[8] = { 0x03, 0, 0x2B, 0x23, 0x0B, 0x33, 0x0B, 0 };
+                *dest = rd;
+                if (rd == 0) return true;
+                emit_op_reg_mem(e, 0x8B, HOST_EAX, OFF_REG(rs));
+                emit_op_reg_mem(e, alu_ops[subfunc - 0x21], HOST_EAX, OFF_REG(rt));
+                if (subfunc == 0x27) { emit8(e, 0xF7); emit8(e, 0xD0); } // not eax
+                return true;
+            }
+            case 0x2A: case 0x2B: // SLT, SLTU
+                *dest = rd;
+                if (rd == 0) return true;
+                emit_op_reg_mem(e, 0x8B, HOST_EAX, OFF_REG(rs));
+                emit_op_reg_mem(e, 0x3B, HOST_EAX, OFF_REG(rt));
+                emit_setcc_eax(e, subfunc == 0x2A ? 0x9C : 0x92);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    switch (opcode) {
+        case 0x0F: // LUI
+            *dest = rt;
+            if (rt == 0) return true;
+            emit8(e, 0xB8); emit32(e, imm << 16); // mov eax, imm32
+            return true;
+        case 0x09: case 0x0C: case 0x0D: case 0x0E: { // ADDIU, ANDI, ORI, XORI
+            *dest = rt;
+            if (rt == 0) return true;
+            emit_op_reg_mem(e, 0x8B, HOST_EAX, OFF_REG(rs));
+            if (opcode == 0x09) emit_alu_eax_imm(e, 0, imm_se);
+            else if (opcode == 0x0C) emit_alu_eax_imm(e, 4, imm);
+            else if (opcode == 0x0D) emit_alu_eax_imm(e, 1, imm);
+            else emit_alu_eax_imm(e, 6, imm);
+            return true;
+        }
+        case 0x0A: case 0x0B: // SLTI, SLTIU (both compare against the sign-extended immediate)
+            *dest = rt;
+            if (rt == 0) return true;
+            emit_op_reg_mem(e, 0x8B, HOST_EAX, OFF_REG(rs));
+            emit_alu_eax_imm(e, 7, imm_se);
+            emit_setcc_eax(e, opcode == 0x0A ? 0x9C : 0x92);
+            return true;
+        default:
+            return false;
+    }
+}
+
+// --- Code Buffer ---
+
+/**
+ * @brief Allocates the executable code buffer.
+ */
+bool cpu_jit_init(Cpu* cpu) {
+    cpu->jit_buffer = NULL;
+    cpu->jit_buffer_size = 0;
+    cpu->jit_buffer_used = 0;
+#if CPU_JIT_AVAILABLE
+    void* mem = mmap(NULL, CPU_JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        LOG_WARN(LOG_CPU, "JIT code buffer allocation failed, JIT disabled.\n");
+        return false;
+    }
+    cpu->jit_buffer = (uint8_t*)mem;
+    cpu->jit_buffer_size = CPU_JIT_BUFFER_SIZE;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Releases the code buffer.
+ */
+void cpu_jit_destroy(Cpu* cpu) {
+#if CPU_JIT_AVAILABLE
+    if (cpu->jit_buffer) {
+        munmap(cpu->jit_buffer, cpu->jit_buffer_size);
+    }
+#endif
+    cpu->jit_buffer = NULL;
+    cpu->jit_buffer_size = 0;
+    cpu->jit_buffer_used = 0;
+}
+
+/**
+ * @brief Drops every translated block.
+ */
+void cpu_jit_flush(Cpu* cpu) {
+    if (cpu->block_cache) {
+        for (int i = 0; i < CPU_BLOCK_CACHE_SIZE; ++i) {
+            cpu->block_cache[i].jit_code = NULL;
+        }
+    }
+    cpu->jit_buffer_used = 0;
+}
+
+/**
+ * @brief Translates one decoded block to host code.
+ */
+CpuJitCode cpu_jit_compile(Cpu* cpu, CpuBlock* block) {
+    if (cpu->jit_buffer == NULL || block->len == 0) return NULL;
+
+    size_t worst_case = 16 + (size_t)block->len * CPU_JIT_MAX_OP_BYTES;
+    if (cpu->jit_buffer_used + worst_case > cpu->jit_buffer_size) {
+        LOG_WARN(LOG_CPU, "JIT: Code buffer full, flushing all translations.\n");
+        cpu_jit_flush(cpu);
+    }
+
+    // First pass: which ops are translated inline (probe-emit into a scratch buffer)
+    bool inline_op[CPU_BLOCK_MAX_OPS];
+    for (uint32_t k = 0; k < block->len; ++k) {
+        uint8_t scratch[64];
+        JitEmitter probe = { scratch, 0 };
+        uint32_t dest;
+        inline_op[k] = emit_inline_op(&probe, &block->ops[k], &dest);
+    }
+
+    JitEmitter e = { cpu->jit_buffer + cpu->jit_buffer_used, 0 };
+
+    // Prologue: push rbx; mov rbx, rdi (rbx = Cpu*, stack is now 16-byte aligned for calls)
+    emit8(&e, 0x53);
+    emit8(&e, 0x48); emit8(&e, 0x89); emit8(&e, 0xFB);
+
+    // PC state currently in memory belongs to op 0 (set up by the caller).
+    int32_t state_op = 0;
+    bool delay_flags_clear = true; // in_delay_slot == branch_taken == false in memory
+    bool load_pending = true;      // A load may be pending (unknown at block entry)
+
+    for (uint32_t k = 0; k < block->len; ++k) {
+        const CpuDecodedOp* op = &block->ops[k];
+        uint32_t op_vaddr = block->vaddr + 4 * k;
+        bool after_branch = k > 0 && (block->ops[k - 1].flags & CPU_OP_BRANCH) != 0;
+
+        // 1. PC bookkeeping for a delay slot has to follow the branch dynamically.
+        if (after_branch) {
+            emit_dynamic_pc_update(&e);
+            state_op = (int32_t)k;
+            delay_flags_clear = false;
+        }
+
+        // 2. The op itself
+        if (inline_op[k]) {
+            uint32_t dest;
+            emit_inline_op(&e, op, &dest); // Result in eax
+            if (load_pending) {
+                // Retire: pending load lands first, so a write to the same register wins
+                emit_apply_pending_load(&e);
+                if (dest != 0) emit_store_reg(&e, HOST_EAX, OFF_REG(dest));
+                emit_store_imm32(&e, OFF_REG(0), 0);
+                emit_store_imm32(&e, OFF_LOAD_IDX, 0); // Inline ops issue no load
+                load_pending = false;
+            } else if (dest != 0) {
+                emit_store_reg(&e, HOST_EAX, OFF_REG(dest));
+            }
+            continue;
+        }
+
+        if (state_op != (int32_t)k) {
+            emit_store_imm32(&e, OFF_CURRENT_PC, op_vaddr);
+            emit_store_imm32(&e, OFF_PC, op_vaddr + 4);
+            emit_store_imm32(&e, OFF_NEXT_PC, op_vaddr + 8);
+            if (!delay_flags_clear) {
+                emit_store_imm8(&e, OFF_DELAY_SLOT, 0);
+                emit_store_imm8(&e, OFF_BRANCH, 0);
+                delay_flags_clear = true;
+            }
+            state_op = (int32_t)k;
+        }
+
+        // mov rdi, rbx; mov esi, instruction; mov rax, handler; call rax
+        emit8(&e, 0x48); emit8(&e, 0x89); emit8(&e, 0xDF);
+        emit8(&e, 0xBE); emit32(&e, op->instruction);
+        emit8(&e, 0x48); emit8(&e, 0xB8); emit64(&e, (uint64_t)(uintptr_t)op->handler);
+        emit8(&e, 0xFF); emit8(&e, 0xD0);
+
+        if (op->flags & CPU_OP_BRANCH) {
+            delay_flags_clear = false; // Handler may have set branch_taken
+        }
+
+        // 3. Load delay retirement (skipped when nothing can be pending or issued)
+        bool may_issue_load = (op->flags & (CPU_OP_LOAD | CPU_OP_ENDS_BLOCK)) != 0;
+        if (load_pending || may_issue_load) {
+            emit_retire_load_delay(&e);
+        }
+        load_pending = may_issue_load;
+
+        // cmp byte [block_exit], 0; je +7; mov eax, k+1; pop rbx; ret
+        emit8(&e, 0x80); emit_modrm_rbx(&e, 7, OFF_BLOCK_EXIT); emit8(&e, 0x00);
+        emit8(&e, 0x74); emit8(&e, 0x07);
+        emit_return(&e, k + 1);
+    }
+
+    // Epilogue: write back the PC state of the last op if inline ops left it pending.
+    uint32_t last = block->len - 1;
+    if (state_op != (int32_t)last) {
+        uint32_t last_vaddr = block->vaddr + 4 * last;
+        emit_store_imm32(&e, OFF_CURRENT_PC, last_vaddr);
+        emit_store_imm32(&e, OFF_PC, last_vaddr + 4);
+        emit_store_imm32(&e, OFF_NEXT_PC, last_vaddr + 8);
+        if (!delay_flags_clear) {
+            emit_store_imm8(&e, OFF_DELAY_SLOT, 0);
+            emit_store_imm8(&e, OFF_BRANCH, 0);
+        }
+    }
+    emit_return(&e, block->len);
+
+    cpu->jit_buffer_used += (e.pos + 15) & ~(size_t)15; // Keep entry points 16-byte aligned
+    return (CpuJitCode)(void*)e.code;
+}
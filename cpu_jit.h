@@ -0,0 +1,44 @@
+// cpu_jit.h
+// x86-64 dynamic recompiler for cached CPU blocks.
+#ifndef CPU_JIT_H
+#define CPU_JIT_H
+
+#include <stdbool.h>
+#include "cpu.h"
+
+// Size of the executable code buffer. When it fills up, every translation is dropped.
+#define CPU_JIT_BUFFER_SIZE (16 * 1024 * 1024)
+
+/**
+ * @brief Allocates the executable code buffer.
+ * @param cpu Pointer to the Cpu state.
+ * @return true if the JIT can be used on this host.
+ */
+bool cpu_jit_init(Cpu* cpu);
+
+/**
+ * @brief Releases the code buffer.
+ * @param cpu Pointer to the Cpu state.
+ */
+void cpu_jit_destroy(Cpu* cpu);
+
+/**
+ * @brief Drops every translated block (the decoded blocks stay valid).
+ * @param cpu Pointer to the Cpu state.
+ */
+void cpu_jit_flush(Cpu* cpu);
+
+/**
+ * @brief Translates a decoded block into host code and stores it in block->jit_code.
+ *
+ * Simple ALU ops are emitted inline; everything else (loads, stores, branches,
+ * HI/LO, COP0, exceptions) calls the matching op_* handler. The generated code
+ * expects cpu_run_block() to have performed the first op's PC bookkeeping.
+ *
+ * @param cpu Pointer to the Cpu state.
+ * @param block The decoded block (must start at cpu->pc).
+ * @return The translated code, or NULL if the block could not be translated.
+ */
+CpuJitCode cpu_jit_compile(Cpu* cpu, CpuBlock* block);
+
+#endif // CPU_JIT_H
@@ -1,5 +1,5 @@
 #include "dma.h"
-#include <stdio.h> // For fprintf, stderr
+#include "logger.h"
 
 // Helper function to get channel control register value
 // REMOVED 'static'
@@ -28,7 +28,7 @@ void channel_set_control(DmaChannel* ch, uint32_t value) {
         case 1: ch->sync = REQUEST; break;
         case 2: ch->sync = LINKED_LIST; break;
         default:
-            fprintf(stderr, "Warning: Invalid DMA Sync mode %d written to CHCR\n", (value >> 9) & 3);
+            LOG_WARN(LOG_DMA, "Warning: Invalid DMA Sync mode %d written to CHCR\n", (value >> 9) & 3);
             break;
     }
     // ch->chopping_dma_sz = (value >> 16) & 7; // Not implemented
@@ -53,7 +53,23 @@ bool dma_channel_is_active(DmaChannel* ch) {
 void dma_channel_done(DmaChannel* ch) {
     ch->enable = false;
     ch->trigger = false;
-    // TODO: Handle setting/clearing interrupt flags in DICR here later
+    // DICR flags are latched by dma_channel_complete()
+}
+
+// DICR bit 31: set when forced, or when master-enabled and an enabled channel flag is set.
+static bool dma_master_irq_flag(const Dma* dma) {
+    return dma->force_irq || (dma->master_irq_enable && ((dma->channel_irq_flags & dma->channel_irq_enable) != 0));
+}
+
+// Finishes a channel's transfer: clears its busy bits and latches its DICR interrupt flag.
+// Returns true if the master flag went from 0 to 1 (the DMA IRQ line should be raised).
+bool dma_channel_complete(Dma* dma, uint32_t channel_index) {
+    bool master_before = dma_master_irq_flag(dma);
+    dma_channel_done(&dma->channels[channel_index]);
+    if (dma->channel_irq_enable & (1u << channel_index)) {
+        dma->channel_irq_flags |= (uint8_t)(1u << channel_index);
+    }
+    return !master_before && dma_master_irq_flag(dma);
 }
 
 
@@ -82,7 +98,7 @@ void dma_init(Dma* dma) {
         dma->channels[i].block_count = 0;
     }
 
-    printf("DMA Initialized. DPCR=0x%08x, Channels initialized.\n", dma->control);
+    LOG_INFO(LOG_DMA, "DMA Initialized. DPCR=0x%08x, Channels initialized.\n", dma->control);
 }
 
 // Reads a 32-bit value from a DMA register address (relative offset).
@@ -100,7 +116,7 @@ uint32_t dma_read(Dma* dma, uint32_t offset) {
             case 0x8: // CHCR
                 return channel_get_control(ch);
             default:
-                fprintf(stderr, "Warning: Unhandled DMA Channel read at offset 0x%x (Channel %d, Reg %x)\n", offset, channel_index, register_offset);
+                LOG_WARN(LOG_DMA, "Warning: Unhandled DMA Channel read at offset 0x%x (Channel %d, Reg %x)\n", offset, channel_index, register_offset);
                 return 0;
         }
     } else { // Main DMA Register Access
@@ -115,12 +131,11 @@ uint32_t dma_read(Dma* dma, uint32_t offset) {
                     dicr |= ((uint32_t)dma->channel_irq_enable << 16);
                     dicr |= ((uint32_t)dma->master_irq_enable << 23);
                     dicr |= ((uint32_t)dma->channel_irq_flags << 24);
-                    bool master_flag = dma->force_irq || (dma->master_irq_enable && ((dma->channel_irq_flags & dma->channel_irq_enable) != 0));
-                    dicr |= ((uint32_t)master_flag << 31);
+                    dicr |= ((uint32_t)dma_master_irq_flag(dma) << 31);
                     return dicr;
                 }
             default:
-                fprintf(stderr, "Error: Unhandled DMA Main register read at offset 0x%x\n", offset);
+                LOG_ERROR(LOG_DMA, "Error: Unhandled DMA Main register read at offset 0x%x\n", offset);
                 return 0;
         }
     }
@@ -149,7 +164,7 @@ bool dma_write(Dma* dma, uint32_t offset, uint32_t value) {
                 channel_became_active = dma_channel_is_active(ch);
                 break;
             default:
-                fprintf(stderr, "Warning: Unhandled DMA Channel write at offset 0x%x = 0x%08x (Channel %d, Reg %x)\n", offset, value, channel_index, register_offset);
+                LOG_WARN(LOG_DMA, "Warning: Unhandled DMA Channel write at offset 0x%x = 0x%08x (Channel %d, Reg %x)\n", offset, value, channel_index, register_offset);
                 break;
         }
     } else { // Main DMA Register Access
@@ -166,7 +181,7 @@ bool dma_write(Dma* dma, uint32_t offset, uint32_t value) {
                 dma->channel_irq_flags &= ~ack_flags;
                 break;
             default:
-                fprintf(stderr, "Error: Unhandled DMA Main register write at offset 0x%x = 0x%08x\n", offset, value);
+                LOG_ERROR(LOG_DMA, "Error: Unhandled DMA Main register write at offset 0x%x = 0x%08x\n", offset, value);
                 break;
         }
     }
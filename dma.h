@@ -70,6 +70,8 @@ uint32_t dma_read(Dma* dma, uint32_t offset);
 bool dma_write(Dma* dma, uint32_t offset, uint32_t value); // <-- Return type changed here
 bool dma_channel_is_active(DmaChannel* ch);
 void dma_channel_done(DmaChannel* ch);
+// Completes a transfer (busy bits + DICR flag); returns true if IRQ 3 should be raised
+bool dma_channel_complete(Dma* dma, uint32_t channel_index);
 
 // Helper to get channel control register value
 uint32_t channel_get_control(DmaChannel* ch); // <-- Declaration added
@@ -0,0 +1,183 @@
+// fastmem.c
+// Host virtual-memory arena: guest RAM/BIOS mapped at base + physical address,
+// everything else left unmapped and serviced from a SIGSEGV handler.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // For memfd_create and REG_RIP/REG_RAX in ucontext
+#endif
+
+#include "fastmem.h"
+#include "interconnect.h"
+#include "logger.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#if FASTMEM_ARENA_SUPPORTED
+
+#include <signal.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// The handler has no user pointer, so the active arena is tracked here (one per process)
+static Interconnect* arena_owner = NULL;
+static int arena_ram_fd = -1;
+static struct sigaction previous_segv_action;
+
+
+// --- Fault Handling ---
+/**
+ * @brief Forwards a fault that did not come from the arena to the previously installed action.
+ */
+static void fastmem_chain_segv(int sig, siginfo_t* info, void* context) {
+    if (previous_segv_action.sa_flags & SA_SIGINFO) {
+        previous_segv_action.sa_sigaction(sig, info, context);
+    } else if (previous_segv_action.sa_handler != SIG_DFL && previous_segv_action.sa_handler != SIG_IGN) {
+        previous_segv_action.sa_handler(sig);
+    } else {
+        // Restore the default action; returning re-executes the access and crashes normally
+        signal(SIGSEGV, SIG_DFL);
+    }
+}
+
+/**
+ * @brief SIGSEGV handler: replays a faulting arena access through the I/O path.
+ *
+ * The fault is synchronous and always raised by one of the fastmem_arena_* accessors,
+ * so running the (non async-signal-safe) interconnect code here is fine: the emulator
+ * thread was interrupted at a well-defined point, not inside libc.
+ */
+static void fastmem_segv_handler(int sig, siginfo_t* info, void* context) {
+    Interconnect* inter = arena_owner;
+    uint8_t* fault = (uint8_t*)info->si_addr;
+    if (!inter || fault < inter->fastmem_arena || fault >= inter->fastmem_arena + FASTMEM_ARENA_SIZE) {
+        fastmem_chain_segv(sig, info, context);
+        return;
+    }
+
+    ucontext_t* uc = (ucontext_t*)context;
+    greg_t* gregs = uc->uc_mcontext.gregs;
+    const uint8_t* rip = (const uint8_t*)gregs[REG_RIP];
+    uint32_t address = (uint32_t)(fault - inter->fastmem_arena);
+    uint32_t value = (uint32_t)gregs[REG_RAX];
+
+    // Decode one of the six fixed accessor encodings (see fastmem.h)
+    if (rip[0] == 0x8B && rip[1] == 0x02) {
+        gregs[REG_RAX] = interconnect_load32(inter, address);
+        gregs[REG_RIP] += 2;
+    } else if (rip[0] == 0x0F && rip[1] == 0xB7 && rip[2] == 0x02) {
+        gregs[REG_RAX] = interconnect_load16(inter, address);
+        gregs[REG_RIP] += 3;
+    } else if (rip[0] == 0x0F && rip[1] == 0xB6 && rip[2] == 0x02) {
+        gregs[REG_RAX] = interconnect_load8(inter, address);
+        gregs[REG_RIP] += 3;
+    } else if (rip[0] == 0x89 && rip[1] == 0x02) {
+        interconnect_store32(inter, address, value);
+        gregs[REG_RIP] += 2;
+    } else if (rip[0] == 0x66 && rip[1] == 0x89 && rip[2] == 0x02) {
+        interconnect_store16(inter, address, (uint16_t)value);
+        gregs[REG_RIP] += 3;
+    } else if (rip[0] == 0x88 && rip[1] == 0x02) {
+        interconnect_store8(inter, address, (uint8_t)value);
+        gregs[REG_RIP] += 2;
+    } else {
+        LOG_ERROR(LOG_BUS, "Fastmem: unexpected faulting instruction at %p (guest address 0x%08x)\n", (const void*)rip, address);
+        fastmem_chain_segv(sig, info, context);
+    }
+}
+
+
+// --- Arena Setup ---
+bool fastmem_arena_init(Interconnect* inter) {
+    if (inter->fastmem_arena) return true;
+    if (arena_owner) {
+        LOG_ERROR(LOG_BUS, "Fastmem: arena already owned by another interconnect.\n");
+        return false;
+    }
+
+    uint8_t* base = mmap(NULL, FASTMEM_ARENA_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        LOG_ERROR(LOG_BUS, "Fastmem: failed to reserve the 4 GiB arena: %s\n", strerror(errno));
+        return false;
+    }
+
+    // RAM lives in a shared memory object so each mirror can be a view of the same pages
+    int fd = memfd_create("psx_ram", 0);
+    if (fd < 0 || ftruncate(fd, RAM_SIZE) != 0) {
+        LOG_ERROR(LOG_BUS, "Fastmem: failed to create the RAM backing object: %s\n", strerror(errno));
+        if (fd >= 0) close(fd);
+        munmap(base, FASTMEM_ARENA_SIZE);
+        return false;
+    }
+    for (uint32_t mirror = RAM_START; mirror < RAM_MIRROR_END; mirror += RAM_SIZE) {
+        if (mmap(base + mirror, RAM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            LOG_ERROR(LOG_BUS, "Fastmem: failed to map a RAM mirror: %s\n", strerror(errno));
+            close(fd);
+            munmap(base, FASTMEM_ARENA_SIZE);
+            return false;
+        }
+    }
+
+    // BIOS: private copy, write-protected so stores fault into the I/O path (which ignores them)
+    uint8_t* bios_view = mmap(base + BIOS_START, BIOS_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    if (bios_view == MAP_FAILED) {
+        LOG_ERROR(LOG_BUS, "Fastmem: failed to map the BIOS: %s\n", strerror(errno));
+        close(fd);
+        munmap(base, FASTMEM_ARENA_SIZE);
+        return false;
+    }
+    memcpy(bios_view, inter->bios->data, BIOS_SIZE);
+    mprotect(bios_view, BIOS_SIZE, PROT_READ);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = fastmem_segv_handler;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGSEGV, &action, &previous_segv_action) != 0) {
+        LOG_ERROR(LOG_BUS, "Fastmem: failed to install the SIGSEGV handler: %s\n", strerror(errno));
+        close(fd);
+        munmap(base, FASTMEM_ARENA_SIZE);
+        return false;
+    }
+
+    // Move the current RAM contents into the shared view and switch every user over to it
+    memcpy(base + RAM_START, inter->ram->data, RAM_SIZE);
+    inter->ram->data = base + RAM_START;
+    arena_ram_fd = fd;
+    arena_owner = inter;
+    inter->fastmem_arena = base;
+    interconnect_map_fastmem(inter);
+    LOG_INFO(LOG_BUS, "Fastmem: 4 GiB arena reserved at %p.\n", (void*)base);
+    return true;
+}
+
+void fastmem_arena_destroy(Interconnect* inter) {
+    if (!inter->fastmem_arena) return;
+
+    uint8_t* base = inter->fastmem_arena;
+    memcpy(inter->ram->storage, inter->ram->data, RAM_SIZE);
+    inter->ram->data = inter->ram->storage;
+    inter->fastmem_arena = NULL;
+    interconnect_map_fastmem(inter);
+
+    sigaction(SIGSEGV, &previous_segv_action, NULL);
+    munmap(base, FASTMEM_ARENA_SIZE);
+    close(arena_ram_fd);
+    arena_ram_fd = -1;
+    arena_owner = NULL;
+}
+
+#else // !FASTMEM_ARENA_SUPPORTED
+
+bool fastmem_arena_init(Interconnect* inter) {
+    (void)inter;
+    LOG_WARN(LOG_BUS, "Fastmem: host arena not supported on this platform, using the page tables.\n");
+    return false;
+}
+
+void fastmem_arena_destroy(Interconnect* inter) {
+    (void)inter;
+}
+
+#endif // FASTMEM_ARENA_SUPPORTED
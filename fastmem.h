@@ -0,0 +1,85 @@
+// fastmem.h
+// Optional host virtual-memory arena for guest memory accesses.
+#ifndef FASTMEM_H
+#define FASTMEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// The arena relies on Linux signal contexts and the x86-64 register layout
+#if defined(__linux__) && defined(__x86_64__)
+#define FASTMEM_ARENA_SUPPORTED 1
+#else
+#define FASTMEM_ARENA_SUPPORTED 0
+#endif
+
+// One host byte per physical address (KSEG2 included), so base + offset never leaves the arena
+#define FASTMEM_ARENA_SIZE (1ull << 32)
+
+struct Interconnect;
+
+/**
+ * @brief Reserves the 4 GiB arena and maps RAM (+mirrors) and BIOS into it.
+ *
+ * RAM is moved into a shared memory object mapped four times (one per mirror) and
+ * Ram.data is pointed at the first view, so the regular RAM/DMA code and the page
+ * tables keep working on the same bytes. BIOS pages are mapped read-only. Every
+ * other page stays unmapped: accesses to it fault and the SIGSEGV handler replays
+ * them through interconnect_load/store.
+ *
+ * @param inter Pointer to the initialized Interconnect.
+ * @return true if the arena is active, false if the host does not support it.
+ */
+bool fastmem_arena_init(struct Interconnect* inter);
+
+/**
+ * @brief Copies RAM back into Ram.storage, unmaps the arena and restores the old SIGSEGV action.
+ * Does nothing if the arena is not active.
+ * @param inter Pointer to the Interconnect.
+ */
+void fastmem_arena_destroy(struct Interconnect* inter);
+
+
+// --- Arena Accessors ---
+// The SIGSEGV handler decodes the faulting instruction, so every access uses one fixed
+// encoding: host address in RDX, data in EAX/AX/AL.
+//   8B 02     mov eax, [rdx]           89 02     mov [rdx], eax
+//   0F B7 02  movzx eax, word [rdx]    66 89 02  mov [rdx], ax
+//   0F B6 02  movzx eax, byte [rdx]    88 02     mov [rdx], al
+// The "memory" clobber keeps the compiler from caching emulator state across an
+// access, since a faulting one runs arbitrary I/O code.
+#if FASTMEM_ARENA_SUPPORTED
+
+static inline uint32_t fastmem_arena_load32(const uint8_t* host) {
+    uint32_t value;
+    __asm__ volatile(".byte 0x8b, 0x02" : "=a"(value) : "d"(host) : "memory");
+    return value;
+}
+
+static inline uint16_t fastmem_arena_load16(const uint8_t* host) {
+    uint32_t value;
+    __asm__ volatile(".byte 0x0f, 0xb7, 0x02" : "=a"(value) : "d"(host) : "memory");
+    return (uint16_t)value;
+}
+
+static inline uint8_t fastmem_arena_load8(const uint8_t* host) {
+    uint32_t value;
+    __asm__ volatile(".byte 0x0f, 0xb6, 0x02" : "=a"(value) : "d"(host) : "memory");
+    return (uint8_t)value;
+}
+
+static inline void fastmem_arena_store32(uint8_t* host, uint32_t value) {
+    __asm__ volatile(".byte 0x89, 0x02" : : "d"(host), "a"(value) : "memory");
+}
+
+static inline void fastmem_arena_store16(uint8_t* host, uint16_t value) {
+    __asm__ volatile(".byte 0x66, 0x89, 0x02" : : "d"(host), "a"(value) : "memory");
+}
+
+static inline void fastmem_arena_store8(uint8_t* host, uint8_t value) {
+    __asm__ volatile(".byte 0x88, 0x02" : : "d"(host), "a"(value) : "memory");
+}
+
+#endif // FASTMEM_ARENA_SUPPORTED
+
+#endif // FASTMEM_H
@@ -4,10 +4,15 @@
  * Handles GPU state, command processing (GP0/GP1), VRAM access, and rendering calls.
  */
 #include "gpu.h"
+#include "logger.h"
 #include <stdio.h>
 #include <stdlib.h> // For exit()
 #include <string.h> // For memset
 #include "renderer.h"
+#include "rasterizer.h"
+#include "trace.h"
+#include "gpu_thread.h"
+#include "interconnect.h" // I/O register registration
 // vram.h is implicitly included via gpu.h
 
 // --- Forward Declarations for GP0 Handlers (Internal linkage) ---
@@ -20,12 +25,29 @@ static void gp0_drawing_area_top_left(Gpu* gpu);
 static void gp0_drawing_area_bottom_right(Gpu* gpu);
 static void gp0_drawing_offset(Gpu* gpu);
 static void gp0_mask_bit_setting(Gpu* gpu);
-static void gp0_quad_mono_opaque(Gpu* gpu);
-static void gp0_quad_texture_blend_opaque(Gpu* gpu);
-static void gp0_quad_shaded_opaque(Gpu* gpu);
-static void gp0_triangle_shaded_opaque(Gpu* gpu);
+static void gp0_image_copy(Gpu* gpu);
 static void gp0_image_load(Gpu* gpu);
 static void gp0_image_store(Gpu* gpu);
+static void image_load_size(uint32_t dimensions, uint16_t* w, uint16_t* h);
+
+/* --- Generated Draw Handlers ---
+ * Polygons (0x20-0x3F), lines (0x40-0x5F) and rectangles (0x60-0x7F) get one handler per
+ * opcode, gp0_polygon_20 to gp0_rectangle_7F, each an instance of gp0_polygon/gp0_line/
+ * gp0_rectangle with the opcode as a constant: the attribute bits (shaded, textured,
+ * semi-transparent, raw texture, quad, polyline, size) are resolved at compile time.
+ * GP0_OPCODES_32(X, 2, 3) expands X(20) X(21) ... X(3F).
+ */
+#define GP0_OPCODES_16(X, hi) \
+    X(hi##0) X(hi##1) X(hi##2) X(hi##3) X(hi##4) X(hi##5) X(hi##6) X(hi##7) \
+    X(hi##8) X(hi##9) X(hi##A) X(hi##B) X(hi##C) X(hi##D) X(hi##E) X(hi##F)
+#define GP0_OPCODES_32(X, hi0, hi1) GP0_OPCODES_16(X, hi0) GP0_OPCODES_16(X, hi1)
+
+#define GP0_DECLARE_POLYGON(op)   static void gp0_polygon_##op(Gpu* gpu);
+#define GP0_DECLARE_LINE(op)      static void gp0_line_##op(Gpu* gpu);
+#define GP0_DECLARE_RECTANGLE(op) static void gp0_rectangle_##op(Gpu* gpu);
+GP0_OPCODES_32(GP0_DECLARE_POLYGON, 2, 3)
+GP0_OPCODES_32(GP0_DECLARE_LINE, 4, 5)
+GP0_OPCODES_32(GP0_DECLARE_RECTANGLE, 6, 7)
 
 // --- Forward Declarations for GP1 Handlers (Internal linkage) ---
 static void gp1_reset(Gpu* gpu, uint32_t value);
@@ -58,7 +80,7 @@ static void clear_gp0_command_buffer(Gpu* gpu) {
  */
 static void push_gp0_command_word(Gpu* gpu, uint32_t word) {
     if (gpu->gp0_command_buffer.count >= MAX_GPU_COMMAND_WORDS) {
-        fprintf(stderr, "FATAL: GP0 Command Buffer Overflow! Opcode: 0x%02x\n", gpu->gp0_current_opcode);
+        LOG_ERROR(LOG_GPU, "FATAL: GP0 Command Buffer Overflow! Opcode: 0x%02x\n", gpu->gp0_current_opcode);
         // Consider triggering a CPU exception or other error handling
         exit(EXIT_FAILURE); // Exit for now, as this indicates a major issue
     }
@@ -66,11 +88,68 @@ static void push_gp0_command_word(Gpu* gpu, uint32_t word) {
     gpu->gp0_command_buffer.count++;
 }
 
+// --- GP0 Command Table ---
+typedef struct {
+    uint8_t length;         // Words in the packet, the command word included (polylines: two vertices)
+    uint8_t polyline_words; // Polylines: words per further vertex, until a terminator word; else 0
+    void (*handler)(Gpu*);  // Run once the packet is complete (polylines: once per segment)
+} Gp0Command;
+
+// Packet lengths from the opcode bits: 0x10 shaded, 0x08 quad/polyline, 0x04 textured,
+// 0x18 rectangle size (0 = variable, given by an extra word)
+#define GP0_POLYGON_VERTICES(op) (((op) & 0x08) ? 4 : 3)
+#define GP0_POLYGON_LENGTH(op)   (1 + GP0_POLYGON_VERTICES(op) * (1 + (((op) >> 2) & 1)) + \
+                                  (GP0_POLYGON_VERTICES(op) - 1) * (((op) >> 4) & 1))
+#define GP0_LINE_LENGTH(op)      (3 + (((op) >> 4) & 1))
+#define GP0_LINE_POLYLINE(op)    (((op) & 0x08) ? 1 + (((op) >> 4) & 1) : 0)
+#define GP0_RECTANGLE_LENGTH(op) (2 + (((op) >> 2) & 1) + (((op) & 0x18) == 0))
+
+#define GP0_POLYGON_ENTRY(op)   [0x##op] = { GP0_POLYGON_LENGTH(0x##op), 0, gp0_polygon_##op },
+#define GP0_LINE_ENTRY(op)      [0x##op] = { GP0_LINE_LENGTH(0x##op), GP0_LINE_POLYLINE(0x##op), gp0_line_##op },
+#define GP0_RECTANGLE_ENTRY(op) [0x##op] = { GP0_RECTANGLE_LENGTH(0x##op), 0, gp0_rectangle_##op },
+#define GP0_COPY_ENTRY(op)      [0x##op] = { 4, 0, gp0_image_copy },
+#define GP0_LOAD_ENTRY(op)      [0x##op] = { 3, 0, gp0_image_load }, // Sets up IMAGE_LOAD mode
+#define GP0_STORE_ENTRY(op)     [0x##op] = { 3, 0, gp0_image_store },
+
+/**
+ * Every GP0 opcode; the ones left out (0x03-0x1F, 0xE0, 0xE7-0xFF) are all-zero entries
+ * and run as one-word NOPs, like on hardware (GP0(1F) would also raise the GPU IRQ,
+ * which nothing here emulates). The VRAM transfer commands decode only bits 31-29.
+ */
+static const Gp0Command gp0_commands[256] = {
+    [0x00] = { 1, 0, gp0_nop },
+    [0x01] = { 1, 0, gp0_clear_cache },
+    [0x02] = { 3, 0, gp0_fill_rectangle },
+    GP0_OPCODES_32(GP0_POLYGON_ENTRY, 2, 3)
+    GP0_OPCODES_32(GP0_LINE_ENTRY, 4, 5)
+    GP0_OPCODES_32(GP0_RECTANGLE_ENTRY, 6, 7)
+    GP0_OPCODES_32(GP0_COPY_ENTRY, 8, 9)
+    GP0_OPCODES_32(GP0_LOAD_ENTRY, A, B)
+    GP0_OPCODES_32(GP0_STORE_ENTRY, C, D)
+    [0xE1] = { 1, 0, gp0_draw_mode },
+    [0xE2] = { 1, 0, gp0_texture_window },
+    [0xE3] = { 1, 0, gp0_drawing_area_top_left },
+    [0xE4] = { 1, 0, gp0_drawing_area_bottom_right },
+    [0xE5] = { 1, 0, gp0_drawing_offset },
+    [0xE6] = { 1, 0, gp0_mask_bit_setting },
+};
+
+static const Gp0Command gp0_nop_command = { 1, 0, gp0_nop };
+
+/**
+ * @brief Looks up the packet layout and handler of a GP0 command.
+ * @param opcode The command byte (bits 31-24 of the first word).
+ */
+static inline const Gp0Command* gp0_decode(uint8_t opcode) {
+    const Gp0Command* command = &gp0_commands[opcode];
+    return command->handler != NULL ? command : &gp0_nop_command;
+}
+
 // --- GP1 Handler Function Definitions ---
 
 /** GP1(0x00): Soft Reset */
 static void gp1_reset(Gpu* gpu, uint32_t value) {
-    printf("GPU: Soft Reset (GP1 Cmd 0x00)\n");
+    LOG_DEBUG(LOG_GPU, "GPU: Soft Reset (GP1 Cmd 0x00)\n");
     (void)value; // value is unused for this command
     // Re-initialize GPU state AND the VRAM state by calling gpu_init
     gpu_init(gpu);
@@ -78,7 +157,7 @@ static void gp1_reset(Gpu* gpu, uint32_t value) {
 
 /** GP1(0x01): Reset Command Buffer */
 static void gp1_reset_command_buffer(Gpu* gpu, uint32_t value) {
-     printf("GPU: Reset Command Buffer (GP1 Cmd 0x01)\n");
+     LOG_DEBUG(LOG_GPU, "GPU: Reset Command Buffer (GP1 Cmd 0x01)\n");
     (void)value; // value is unused for this command
     clear_gp0_command_buffer(gpu);
     gpu->gp0_words_remaining = 0;
@@ -90,7 +169,7 @@ static void gp1_reset_command_buffer(Gpu* gpu, uint32_t value) {
 
 /** GP1(0x02): Acknowledge GPU Interrupt */
 static void gp1_acknowledge_irq(Gpu* gpu, uint32_t value) {
-     printf("GPU: Acknowledge IRQ (GP1 Cmd 0x02)\n");
+     LOG_DEBUG(LOG_GPU, "GPU: Acknowledge IRQ (GP1 Cmd 0x02)\n");
      (void)value; // value is unused for this command
      gpu->interrupt = false; // Clear the interrupt flag (STAT[24])
 }
@@ -99,7 +178,7 @@ static void gp1_acknowledge_irq(Gpu* gpu, uint32_t value) {
 static void gp1_display_enable(Gpu* gpu, uint32_t value) {
     // Bit 0: 0 = Enable Display, 1 = Disable Display
     gpu->display_disabled = (value & 1);
-    printf("GPU: Display Enable = %s (GP1 Cmd 0x03)\n", gpu->display_disabled ? "Disabled" : "Enabled");
+    LOG_DEBUG(LOG_GPU, "GPU: Display Enable = %s (GP1 Cmd 0x03)\n", gpu->display_disabled ? "Disabled" : "Enabled");
 }
 
 /** GP1(0x04): DMA Direction / Request settings */
@@ -111,7 +190,7 @@ static void gp1_dma_direction(Gpu* gpu, uint32_t value) {
         case 2: gpu->dma_setting = GPU_DMA_CpuToGp0; break;
         case 3: gpu->dma_setting = GPU_DMA_VRamToCpu; break;
     }
-     printf("GPU: DMA Direction = %d (GP1 Cmd 0x04)\n", gpu->dma_setting);
+     LOG_DEBUG(LOG_GPU, "GPU: DMA Direction = %d (GP1 Cmd 0x04)\n", gpu->dma_setting);
 }
 
 /** GP1(0x05): Start of Display area in VRAM */
@@ -120,7 +199,7 @@ static void gp1_display_vram_start(Gpu* gpu, uint32_t value) {
     // Bits 10-18: Y start coordinate in VRAM (512 height)
     gpu->display_vram_x_start = (uint16_t)(value & 0x3FE);
     gpu->display_vram_y_start = (uint16_t)((value >> 10) & 0x1FF);
-    printf("GPU: Display VRAM Start X=%u Y=%u (GP1 Cmd 0x05)\n",
+    LOG_DEBUG(LOG_GPU, "GPU: Display VRAM Start X=%u Y=%u (GP1 Cmd 0x05)\n",
         gpu->display_vram_x_start, gpu->display_vram_y_start);
 }
 
@@ -130,7 +209,7 @@ static void gp1_display_horizontal_range(Gpu* gpu, uint32_t value) {
     // Bits 12-23: Hsync End coordinate (dotclock units)
     gpu->display_horiz_start = (uint16_t)(value & 0xFFF);
     gpu->display_horiz_end = (uint16_t)((value >> 12) & 0xFFF);
-    printf("GPU: Display H-Range Start=%u End=%u (GP1 Cmd 0x06)\n",
+    LOG_DEBUG(LOG_GPU, "GPU: Display H-Range Start=%u End=%u (GP1 Cmd 0x06)\n",
         gpu->display_horiz_start, gpu->display_horiz_end);
 }
 
@@ -140,7 +219,7 @@ static void gp1_display_vertical_range(Gpu* gpu, uint32_t value) {
     // Bits 10-19: Vsync End coordinate (scanline units)
     gpu->display_line_start = (uint16_t)(value & 0x3FF);
     gpu->display_line_end = (uint16_t)((value >> 10) & 0x3FF);
-     printf("GPU: Display V-Range Start=%u End=%u (GP1 Cmd 0x07)\n",
+     LOG_DEBUG(LOG_GPU, "GPU: Display V-Range Start=%u End=%u (GP1 Cmd 0x07)\n",
         gpu->display_line_start, gpu->display_line_end);
 }
 
@@ -160,12 +239,190 @@ static void gp1_display_mode(Gpu* gpu, uint32_t value) {
     gpu->interlaced = ((value >> 5) & 1);
     // Bit 7: Unsupported "Reverseflag"
     if ((value >> 7) & 1) {
-        fprintf(stderr, "Warning: GPU GP1(0x08) set unsupported Reverseflag bit\n");
+        LOG_WARN(LOG_GPU, "Warning: GPU GP1(0x08) set unsupported Reverseflag bit\n");
+    }
+    LOG_DEBUG(LOG_GPU, "GPU: Display Mode set (GP1 Cmd 0x08)\n");
+}
+
+
+/**
+ * @brief Sign-extends an 11-bit vertex coordinate.
+ */
+static inline int32_t sign_extend_11(uint32_t value) {
+    return (int32_t)(value << 21) >> 21;
+}
+
+// Every generated handler is one copy of these bodies with a constant opcode
+#define GP0_SPECIALIZED static inline __attribute__((always_inline))
+
+// GP0(E1) bits 0-8 of the current draw mode: the texpage of rectangles
+static uint16_t gp0_draw_mode_tpage(const Gpu* gpu) {
+    return (uint16_t)((gpu->tpage_x_base / 64) | (gpu->tpage_y_base / 256) << 4 |
+                      gpu->semi_transparency << 5 | (uint32_t)gpu->texture_depth << 7);
+}
+
+/**
+ * @brief GP0(20)-(3F): draws the polygon in the command buffer.
+ * Word layout: color0 (+opcode), vertex0, [uv0 + CLUT], then for each further vertex:
+ * [color, if shaded], vertex, [uv, the second one carrying the texpage, if textured].
+ * The GL renderer has no textured triangles and no blending; those draw with the
+ * software backend only.
+ * @param gpu Pointer to the Gpu instance.
+ * @param opcode The handler's opcode (a constant in every instance).
+ */
+GP0_SPECIALIZED void gp0_polygon(Gpu* gpu, const uint8_t opcode) {
+    const uint32_t* words = gpu->gp0_command_buffer.buffer;
+    const bool shaded = (opcode & 0x10) != 0;
+    const bool textured = (opcode & 0x04) != 0;
+    const uint32_t vertex_count = GP0_POLYGON_VERTICES(opcode);
+
+    uint32_t color[4], position[4], uv[4] = { 0, 0, 0, 0 };
+    uint32_t w = 1;
+    color[0] = words[0];
+    for (uint32_t i = 0; i < vertex_count; ++i) {
+        if (i > 0) color[i] = shaded ? words[w++] : color[0];
+        position[i] = words[w++];
+        if (textured) uv[i] = words[w++];
+    }
+    uint16_t clut = (uint16_t)(uv[0] >> 16);
+    // Untextured polygons only use the semi-transparency mode of the current draw mode
+    uint16_t tpage = textured ? (uint16_t)(uv[1] >> 16) : (uint16_t)(gpu->semi_transparency << 5);
+
+    if (gpu->backend == GPU_BACKEND_SOFTWARE) {
+        RasterVertex v[4];
+        for (uint32_t i = 0; i < vertex_count; ++i) {
+            v[i].x = sign_extend_11(position[i] & 0x7FF) + gpu->drawing_x_offset;
+            v[i].y = sign_extend_11((position[i] >> 16) & 0x7FF) + gpu->drawing_y_offset;
+            v[i].r = (uint8_t)color[i];
+            v[i].g = (uint8_t)(color[i] >> 8);
+            v[i].b = (uint8_t)(color[i] >> 16);
+            v[i].u = (uint8_t)uv[i];
+            v[i].v = (uint8_t)(uv[i] >> 8);
+        }
+        if (vertex_count == 4) {
+            raster_quad(gpu, v, opcode & RASTER_OPCODE_FLAGS, clut, tpage);
+        } else {
+            raster_triangle(gpu, v, opcode & RASTER_OPCODE_FLAGS, clut, tpage);
+        }
+        return;
+    }
+
+    RendererPosition p[4];
+    RendererColor c[4];
+    RendererTexCoord t[4];
+    for (uint32_t i = 0; i < vertex_count; ++i) {
+        p[i] = (RendererPosition){ .x = (GLshort)(int16_t)(position[i] & 0xFFFF), .y = (GLshort)(int16_t)(position[i] >> 16) };
+        c[i] = (RendererColor){ .r = (GLubyte)color[i], .g = (GLubyte)(color[i] >> 8), .b = (GLubyte)(color[i] >> 16) };
+        // The renderer samples VRAM directly: add the texture page base
+        t[i] = (RendererTexCoord){ .u = (uint8_t)uv[i] + gpu->tpage_x_base, .v = (uint8_t)(uv[i] >> 8) + gpu->tpage_y_base };
+    }
+    if (textured) {
+        if (vertex_count == 4) renderer_push_textured_quad(&gpu->renderer, p, t, clut, tpage);
+    } else if (vertex_count == 4) {
+        renderer_push_quad(&gpu->renderer, p, c);
+    } else {
+        renderer_push_triangle(&gpu->renderer, p, c);
+    }
+}
+
+/**
+ * @brief GP0(40)-(5F): draws the segment between the last two vertices in the command
+ * buffer. Layout: color0 (+opcode), vertex0, [color1, if shaded], vertex1.
+ * Polylines then keep the last vertex as the start of the next segment and wait for
+ * more vertices in GP0_MODE_POLYLINE, until a terminator word (gpu_gp0_execute).
+ * Lines are drawn by the software backend only.
+ */
+GP0_SPECIALIZED void gp0_line(Gpu* gpu, const uint8_t opcode) {
+    uint32_t* words = gpu->gp0_command_buffer.buffer;
+    const bool shaded = (opcode & 0x10) != 0;
+    const uint32_t vertex_words = shaded ? 2 : 1;
+
+    if (gpu->backend == GPU_BACKEND_SOFTWARE) {
+        RasterVertex v[2];
+        for (uint32_t i = 0; i < 2; ++i) {
+            uint32_t color = shaded ? words[i * 2] : words[0];
+            uint32_t position = words[1 + i * vertex_words];
+            v[i].x = sign_extend_11(position & 0x7FF) + gpu->drawing_x_offset;
+            v[i].y = sign_extend_11((position >> 16) & 0x7FF) + gpu->drawing_y_offset;
+            v[i].r = (uint8_t)color;
+            v[i].g = (uint8_t)(color >> 8);
+            v[i].b = (uint8_t)(color >> 16);
+            v[i].u = v[i].v = 0;
+        }
+        raster_line(gpu, v, opcode & RASTER_OPCODE_FLAGS);
+    }
+
+    if (opcode & 0x08) { // Polyline: the second vertex starts the next segment
+        if (shaded) words[0] = words[2];
+        words[1] = words[1 + vertex_words];
+        gpu->gp0_command_buffer.count = 2;
+        gpu->gp0_words_remaining = vertex_words;
+        gpu->gp0_mode = GP0_MODE_POLYLINE;
     }
-    printf("GPU: Display Mode set (GP1 Cmd 0x08)\n");
 }
 
+/**
+ * @brief GP0(60)-(7F): draws the rectangle in the command buffer.
+ * Layout: color (+opcode), top-left vertex, [uv + CLUT, if textured], [size, if
+ * variable]; the other sizes are 1x1, 8x8 and 16x16. The texture page, its depth and
+ * the semi-transparency mode come from the current draw mode (GP0(E1)).
+ */
+GP0_SPECIALIZED void gp0_rectangle(Gpu* gpu, const uint8_t opcode) {
+    const uint32_t* words = gpu->gp0_command_buffer.buffer;
+    const bool textured = (opcode & 0x04) != 0;
+    const uint32_t size_code = (opcode >> 3) & 3;
+    uint32_t color = words[0], position = words[1];
+    uint32_t uv = textured ? words[2] : 0;
+    uint32_t width, height;
+    if (size_code == 0) {
+        uint32_t size = words[textured ? 3 : 2];
+        width = size & 0x3FF;
+        height = (size >> 16) & 0x1FF;
+    } else {
+        width = height = size_code == 1 ? 1 : (size_code == 2 ? 8 : 16);
+    }
+    uint16_t clut = (uint16_t)(uv >> 16);
+    uint16_t tpage = gp0_draw_mode_tpage(gpu);
+
+    if (gpu->backend == GPU_BACKEND_SOFTWARE) {
+        RasterVertex origin;
+        origin.x = sign_extend_11(position & 0x7FF) + gpu->drawing_x_offset;
+        origin.y = sign_extend_11((position >> 16) & 0x7FF) + gpu->drawing_y_offset;
+        origin.r = (uint8_t)color;
+        origin.g = (uint8_t)(color >> 8);
+        origin.b = (uint8_t)(color >> 16);
+        origin.u = (uint8_t)uv;
+        origin.v = (uint8_t)(uv >> 8);
+        raster_rectangle(gpu, &origin, width, height, opcode & RASTER_OPCODE_FLAGS, clut, tpage);
+        return;
+    }
+
+    // Corners in perimeter order: the renderer splits quads into 0-1-2 and 0-2-3
+    int16_t x = (int16_t)(position & 0xFFFF), y = (int16_t)(position >> 16);
+    RendererPosition p[4] = {
+        { (GLshort)x, (GLshort)y }, { (GLshort)(x + width), (GLshort)y },
+        { (GLshort)(x + width), (GLshort)(y + height) }, { (GLshort)x, (GLshort)(y + height) },
+    };
+    if (textured) {
+        GLshort u0 = (GLshort)((uv & 0xFF) + gpu->tpage_x_base), v0 = (GLshort)(((uv >> 8) & 0xFF) + gpu->tpage_y_base);
+        RendererTexCoord t[4] = {
+            { u0, v0 }, { (GLshort)(u0 + width), v0 },
+            { (GLshort)(u0 + width), (GLshort)(v0 + height) }, { u0, (GLshort)(v0 + height) },
+        };
+        renderer_push_textured_quad(&gpu->renderer, p, t, clut, tpage);
+    } else {
+        RendererColor c = { .r = (GLubyte)color, .g = (GLubyte)(color >> 8), .b = (GLubyte)(color >> 16) };
+        RendererColor colors[4] = { c, c, c, c };
+        renderer_push_quad(&gpu->renderer, p, colors);
+    }
+}
 
+#define GP0_DEFINE_POLYGON(op)   static void gp0_polygon_##op(Gpu* gpu) { gp0_polygon(gpu, 0x##op); }
+#define GP0_DEFINE_LINE(op)      static void gp0_line_##op(Gpu* gpu) { gp0_line(gpu, 0x##op); }
+#define GP0_DEFINE_RECTANGLE(op) static void gp0_rectangle_##op(Gpu* gpu) { gp0_rectangle(gpu, 0x##op); }
+GP0_OPCODES_32(GP0_DEFINE_POLYGON, 2, 3)
+GP0_OPCODES_32(GP0_DEFINE_LINE, 4, 5)
+GP0_OPCODES_32(GP0_DEFINE_RECTANGLE, 6, 7)
 // --- GP0 Command Handler Definitions ---
 
 /** GP0(0x00): No Operation */
@@ -175,15 +432,97 @@ static void gp0_nop(Gpu* gpu) {
 
 /** GP0(0x01): Clear Cache (Texture Cache Invalidation) */
 static void gp0_clear_cache(Gpu* gpu) {
-    printf("GP0(0x01): Clear Cache (Ignoring - No texture cache implemented)\n");
+    LOG_DEBUG(LOG_GPU, "GP0(0x01): Clear Cache (Ignoring - No texture cache implemented)\n");
     (void)gpu;
 }
 
-/** GP0(0x02): Fill Rectangle in VRAM */
+/**
+ * GP0(0x02): Fill Rectangle in VRAM
+ * Fills with the color of word 0 (8 bits per channel, reduced to 15 with the mask bit
+ * clear). X and the width are in 16-pixel steps and both coordinates wrap around VRAM;
+ * the drawing area, the drawing offset and the GP0(E6) mask settings do not apply.
+ */
 static void gp0_fill_rectangle(Gpu* gpu) {
-    // TODO: Implement VRAM fill using color (word 0), coords (word 1), dimensions (word 2)
-    printf("GP0(0x02): Fill Rectangle (Not Implemented Yet)\n");
-    (void)gpu;
+    raster_flush(gpu); // Writes VRAM outside the rasterizer: batched polygons go first
+    uint32_t color = gpu->gp0_command_buffer.buffer[0];
+    uint32_t coord = gpu->gp0_command_buffer.buffer[1];
+    uint32_t dimensions = gpu->gp0_command_buffer.buffer[2];
+    uint16_t pixel = (uint16_t)(((color >> 3) & 0x1F) | (((color >> 11) & 0x1F) << 5) | (((color >> 19) & 0x1F) << 10));
+    uint32_t x = coord & 0x3F0, y = (coord >> 16) & 0x1FF;
+    uint32_t w = ((dimensions & 0x3FF) + 0xF) & ~0xFu, h = (dimensions >> 16) & 0x1FF;
+    LOG_DEBUG(LOG_GPU, "GP0(0x02): Fill Rectangle (%u,%u) Size=(%ux%u) Color=0x%04x\n", x, y, w, h, pixel);
+    if (w == 0 || h == 0) return;
+
+    uint16_t* vram = (uint16_t*)gpu->vram.data;
+    uint32_t before_wrap = VRAM_WIDTH - x < w ? VRAM_WIDTH - x : w;
+    for (uint32_t row = 0; row < h; ++row) {
+        uint16_t* line = vram + ((y + row) & (VRAM_HEIGHT - 1)) * VRAM_WIDTH;
+        vram_fill_span(line + x, pixel, before_wrap);
+        if (before_wrap < w) vram_fill_span(line, pixel, w - before_wrap);
+    }
+    vram_mark_dirty_rect(&gpu->vram, x, y, w, h);
+}
+
+/**
+ * @brief Copies 'w' pixels of VRAM line 'y' from 'x' on into 'out' (X and Y wrap).
+ */
+static inline void image_copy_read_row(const Gpu* gpu, uint16_t* out, uint32_t x, uint32_t y, uint32_t w) {
+    const uint16_t* line = (const uint16_t*)gpu->vram.data + (y & (VRAM_HEIGHT - 1)) * VRAM_WIDTH;
+    uint32_t before_wrap = VRAM_WIDTH - x < w ? VRAM_WIDTH - x : w;
+    memcpy(out, line + x, (size_t)before_wrap * VRAM_BPP);
+    memcpy(out + before_wrap, line, (size_t)(w - before_wrap) * VRAM_BPP);
+}
+
+/**
+ * GP0(0x80): Copy Rectangle (VRAM to VRAM)
+ * Source (word 1), destination (word 2) and size (word 3, 0 meaning 1024 x 512) wrap
+ * around VRAM. The result is the same as copying through a temporary image, so
+ * overlapping rectangles work in any direction; the GP0(E6) mask settings apply.
+ */
+static void gp0_image_copy(Gpu* gpu) {
+    raster_flush(gpu);
+    uint32_t src_coord = gpu->gp0_command_buffer.buffer[1];
+    uint32_t dst_coord = gpu->gp0_command_buffer.buffer[2];
+    uint16_t w, h;
+    image_load_size(gpu->gp0_command_buffer.buffer[3], &w, &h);
+    uint32_t src_x = src_coord & 0x3FF, src_y = (src_coord >> 16) & 0x1FF;
+    uint32_t dst_x = dst_coord & 0x3FF, dst_y = (dst_coord >> 16) & 0x1FF;
+    LOG_DEBUG(LOG_GPU, "GP0(0x80): Copy Rectangle (%u,%u) -> (%u,%u) Size=(%ux%u)\n", src_x, src_y, dst_x, dst_y, w, h);
+
+    uint16_t mask_or = gpu->force_set_mask_bit ? 0x8000 : 0;
+    uint16_t* vram = (uint16_t*)gpu->vram.data;
+    uint32_t dst_before_wrap = VRAM_WIDTH - dst_x < w ? VRAM_WIDTH - dst_x : w;
+    // When the destination starts lower down inside the source, rows go bottom-up so that
+    // each one is read before it is overwritten
+    uint32_t down = (dst_y - src_y) & (VRAM_HEIGHT - 1);
+    bool bottom_up = down != 0 && down < h;
+    uint16_t* staged = NULL;
+    if (bottom_up && down + h > VRAM_HEIGHT) {
+        // The destination also wraps onto the top source rows, so no row order works: the
+        // source goes to a temporary image first (copies over 256 lines only)
+        staged = malloc((size_t)w * h * VRAM_BPP);
+        if (staged == NULL) {
+            LOG_ERROR(LOG_GPU, "GP0(0x80) Error: Out of memory for a %ux%u overlapping copy\n", w, h);
+            return;
+        }
+        for (uint32_t row = 0; row < h; ++row) image_copy_read_row(gpu, staged + row * w, src_x, src_y + row, w);
+    }
+
+    uint16_t line[VRAM_WIDTH]; // Rows go through a line buffer: X wraps differently on both sides
+    for (uint32_t i = 0; i < h; ++i) {
+        uint32_t row = bottom_up ? h - 1 - i : i;
+        const uint16_t* pixels = line;
+        if (staged != NULL) {
+            pixels = staged + row * w;
+        } else {
+            image_copy_read_row(gpu, line, src_x, src_y + row, w);
+        }
+        uint16_t* to = vram + ((dst_y + row) & (VRAM_HEIGHT - 1)) * VRAM_WIDTH;
+        vram_write_span(to + dst_x, pixels, dst_before_wrap, mask_or, gpu->preserve_masked_pixels);
+        vram_write_span(to, pixels + dst_before_wrap, w - dst_before_wrap, mask_or, gpu->preserve_masked_pixels);
+    }
+    free(staged);
+    vram_mark_dirty_rect(&gpu->vram, dst_x, dst_y, w, h);
 }
 
 /** GP0(0xE1): Set Draw Mode */
@@ -201,7 +540,7 @@ static void gp0_draw_mode(Gpu* gpu) {
     gpu->tpage_x_base = tpage_x_field * 64;
     gpu->tpage_y_base = tpage_y_field * 256;
     
-    printf("  -> Draw Mode: TPage base set to (%u, %u)\n", gpu->tpage_x_base, gpu->tpage_y_base);
+    LOG_DEBUG(LOG_GPU, "  -> Draw Mode: TPage base set to (%u, %u)\n", gpu->tpage_x_base, gpu->tpage_y_base);
     // --- END FIX ---
     
     // The rest of the function remains the same
@@ -210,7 +549,7 @@ static void gp0_draw_mode(Gpu* gpu) {
         case 0: gpu->texture_depth = T4Bit; break;
         case 1: gpu->texture_depth = T8Bit; break;
         case 2: gpu->texture_depth = T15Bit; break;
-        default: printf("Warn: GP0(E1) Unknown texture depth %d\n", (value >> 7) & 3); break;
+        default: LOG_WARN(LOG_GPU, "Warn: GP0(E1) Unknown texture depth %d\n", (value >> 7) & 3); break;
     }
     gpu->dithering = ((value >> 9) & 1);
     gpu->draw_to_display = ((value >> 10) & 1);
@@ -255,6 +594,7 @@ static void gp0_drawing_offset(Gpu* gpu) {
     gpu->drawing_x_offset = offset_x;
     gpu->drawing_y_offset = offset_y;
     // printf("GP0(0xE5): Draw Offset set = (%d,%d)\n", offset_x, offset_y);
+    if (gpu->backend != GPU_BACKEND_OPENGL) return; // No GL calls: this may be the GPU thread
     renderer_set_draw_offset(&gpu->renderer, offset_x, offset_y); // Update renderer uniform
     // --- TEMPORARY HACK from guide ---
     // printf("GP0(0xE5): Triggering display (temporary hack)\n");
@@ -270,112 +610,95 @@ static void gp0_mask_bit_setting(Gpu* gpu) {
      // printf("GP0(0xE6): Mask Bit Setting = Force:%d Preserve:%d\n", gpu->force_set_mask_bit, gpu->preserve_masked_pixels);
 }
 
-/** GP0(0x28): Monochrome Opaque Quad */
-static void gp0_quad_mono_opaque(Gpu* gpu) {
-    if (gpu->gp0_command_buffer.count < 5) {
-         fprintf(stderr, "GP0(0x28) Error: Expected 5 words, got %u\n", gpu->gp0_command_buffer.count); return; }
-    RendererColor c = { .r=(GLubyte)(gpu->gp0_command_buffer.buffer[0]&0xFF), .g=(GLubyte)((gpu->gp0_command_buffer.buffer[0]>>8)&0xFF), .b=(GLubyte)((gpu->gp0_command_buffer.buffer[0]>>16)&0xFF) };
-    RendererColor colors[4] = {c, c, c, c};
-    RendererPosition positions[4];
-    for(int i=0; i<4; ++i){ uint32_t v=gpu->gp0_command_buffer.buffer[i+1]; positions[i].x=(GLshort)(int16_t)(v&0xFFFF); positions[i].y=(GLshort)(int16_t)(v>>16); }
-    // printf("GP0(0x28): Mono Quad ...\n");
-    renderer_push_quad(&gpu->renderer, positions, colors);
+/**
+ * @brief Decodes the size word of GP0(A0), GP0(C0) and GP0(80).
+ */
+static void image_load_size(uint32_t dimensions, uint16_t* w, uint16_t* h) {
+    *w = (uint16_t)(dimensions & 0x3FF); // Width is 10 bits
+    *h = (uint16_t)((dimensions >> 16) & 0x1FF); // Height is 9 bits
+
+    // Width and height seem to be stored as W-1, H-1 in some docs, but maybe not always?
+    // Let's assume they are direct values for now. Clamp values for safety.
+    if (*w == 0) *w = 1024; // Nocash says 0 means 1024?
+    if (*h == 0) *h = 512;  // Nocash says 0 means 512?
+    *w = (*w > VRAM_WIDTH) ? VRAM_WIDTH : *w;
+    *h = (*h > VRAM_HEIGHT) ? VRAM_HEIGHT : *h;
 }
 
-/** GP0(0x2C): Textured Opaque Quadrilateral with Blend */
-static void gp0_quad_texture_blend_opaque(Gpu* gpu) {
-    // This is the handler for GP0 command 0x2C
+uint32_t gpu_image_load_words(uint32_t dimensions) {
+    uint16_t w, h;
+    image_load_size(dimensions, &w, &h);
+    uint32_t image_size_pixels = (uint32_t)w * (uint32_t)h;
+    return ((image_size_pixels + 1) & ~1u) / 2; // Round up for pairs
+}
 
-    // 1. Check if we have received all the words for this command
-    if (gpu->gp0_command_buffer.count < 9) {
-        fprintf(stderr, "GP0(0x2C) Error: Expected 9 words, got %u\n", gpu->gp0_command_buffer.count);
-        return;
+/**
+ * @brief Writes one span of an image load into VRAM line 'y' from pixel 'x' on, applying
+ * the GP0(E6) mask settings, and marks its blocks dirty. The span must end before the
+ * right edge of VRAM.
+ */
+static inline void image_load_span(Gpu* gpu, uint32_t x, uint32_t y, const uint8_t* src, uint32_t count) {
+    uint32_t first_col = x >> VRAM_DIRTY_BLOCK_W_SHIFT, last_col = (x + count - 1) >> VRAM_DIRTY_BLOCK_W_SHIFT;
+    gpu->vram.dirty[y >> VRAM_DIRTY_BLOCK_H_SHIFT] |= (uint16_t)((2u << last_col) - (1u << first_col));
+    uint16_t* dst = (uint16_t*)gpu->vram.data + y * VRAM_WIDTH + x;
+    vram_write_span(dst, src, count, gpu->force_set_mask_bit ? 0x8000 : 0, gpu->preserve_masked_pixels);
+}
+
+/**
+ * @brief GP0(A0) data phase: stores 'count' data words (two pixels each, low half first)
+ * at the load cursor, a row segment at a time. The cursor is vram_load_count (pixels
+ * done); x and y wrap around VRAM like on hardware, and the pixel padding an odd-sized
+ * image ends with is dropped. Leaves IMAGE_LOAD mode after the last word.
+ * @param count Words to take, at most gp0_words_remaining.
+ */
+static void gp0_image_load_data(Gpu* gpu, const uint32_t* words, uint32_t count) {
+    uint32_t width = gpu->vram_load_w;
+    uint32_t total = width * gpu->vram_load_h;
+    uint32_t left = gpu->vram_load_count < total ? total - gpu->vram_load_count : 0;
+    uint32_t pixels = count * 2 < left ? count * 2 : left;
+    const uint8_t* src = (const uint8_t*)words; // Pixel i is bytes 2i, 2i+1 (little-endian words)
+
+    uint32_t row = gpu->vram_load_count / width, col = gpu->vram_load_count % width;
+    while (pixels > 0) {
+        uint32_t span = width - col < pixels ? width - col : pixels;
+        uint32_t y = (gpu->vram_load_y + row) & (VRAM_HEIGHT - 1);
+        uint32_t x = (gpu->vram_load_x + col) & (VRAM_WIDTH - 1);
+        uint32_t before_wrap = VRAM_WIDTH - x < span ? VRAM_WIDTH - x : span;
+        image_load_span(gpu, x, y, src, before_wrap);
+        if (before_wrap < span) image_load_span(gpu, 0, y, src + before_wrap * VRAM_BPP, span - before_wrap);
+        src += span * VRAM_BPP;
+        pixels -= span;
+        col += span;
+        if (col == width) {
+            col = 0;
+            row++;
+        }
     }
 
-    // 2. Create arrays to hold the final data for the renderer
-    RendererPosition p[4];
-    RendererTexCoord t[4];
-    
-    // 3. Extract vertex positions from the command buffer
-    p[0] = (RendererPosition){ .x = (GLshort)(int16_t)(gpu->gp0_command_buffer.buffer[1] & 0xFFFF), .y = (GLshort)(int16_t)(gpu->gp0_command_buffer.buffer[1] >> 16) };
-    p[1] = (RendererPosition){ .x = (GLshort)(int16_t)(gpu->gp0_command_buffer.buffer[3] & 0xFFFF), .y = (GLshort)(int16_t)(gpu->gp0_command_buffer.buffer[3] >> 16) };
-    p[2] = (RendererPosition){ .x = (GLshort)(int16_t)(gpu->gp0_command_buffer.buffer[5] & 0xFFFF), .y = (GLshort)(int16_t)(gpu->gp0_command_buffer.buffer[5] >> 16) };
-    p[3] = (RendererPosition){ .x = (GLshort)(int16_t)(gpu->gp0_command_buffer.buffer[7] & 0xFFFF), .y = (GLshort)(int16_t)(gpu->gp0_command_buffer.buffer[7] >> 16) };
-    
-    // 4. Extract the raw UV and CLUT/TPage data words
-    uint32_t uv_word0 = gpu->gp0_command_buffer.buffer[2];
-    uint32_t uv_word1 = gpu->gp0_command_buffer.buffer[4];
-    uint32_t uv_word2 = gpu->gp0_command_buffer.buffer[6];
-    uint32_t uv_word3 = gpu->gp0_command_buffer.buffer[8];
-
-    // 5. Calculate the FINAL texture coordinates by adding the tpage base
-    t[0] = (RendererTexCoord){ .u = (uint8_t)(uv_word0 & 0xFF) + gpu->tpage_x_base, .v = (uint8_t)((uv_word0 >> 8) & 0xFF) + gpu->tpage_y_base };
-    t[1] = (RendererTexCoord){ .u = (uint8_t)(uv_word1 & 0xFF) + gpu->tpage_x_base, .v = (uint8_t)((uv_word1 >> 8) & 0xFF) + gpu->tpage_y_base };
-    t[2] = (RendererTexCoord){ .u = (uint8_t)(uv_word2 & 0xFF) + gpu->tpage_x_base, .v = (uint8_t)((uv_word2 >> 8) & 0xFF) + gpu->tpage_y_base };
-    t[3] = (RendererTexCoord){ .u = (uint8_t)(uv_word3 & 0xFF) + gpu->tpage_x_base, .v = (uint8_t)((uv_word3 >> 8) & 0xFF) + gpu->tpage_y_base };
-
-    // 6. Extract CLUT and TPage info
-    uint16_t clut = (uint16_t)(uv_word0 >> 16);
-    uint16_t tpage = (uint16_t)(uv_word1 >> 16);
-
-    // 7. Call our NEW renderer function with the correct, textured data
-    renderer_push_textured_quad(&gpu->renderer, p, t, clut, tpage);
-}
-
-/** GP0(0x38): Shaded Opaque Quad */
-static void gp0_quad_shaded_opaque(Gpu* gpu) {
-    if (gpu->gp0_command_buffer.count < 8) {
-         fprintf(stderr, "GP0(0x38) Error: Expected 8 words, got %u\n", gpu->gp0_command_buffer.count); return; }
-    RendererColor c[4]; RendererPosition p[4];
-    for (int i = 0; i < 4; ++i) {
-        uint32_t cw=gpu->gp0_command_buffer.buffer[i*2]; uint32_t vw=gpu->gp0_command_buffer.buffer[i*2+1];
-        c[i].r=(GLubyte)(cw&0xFF); c[i].g=(GLubyte)((cw>>8)&0xFF); c[i].b=(GLubyte)((cw>>16)&0xFF);
-        p[i].x=(GLshort)(int16_t)(vw&0xFFFF); p[i].y=(GLshort)(int16_t)(vw>>16); }
-    // printf("GP0(0x38): Shaded Quad ...\n");
-    renderer_push_quad(&gpu->renderer, p, c);
-}
-
-/** GP0(0x30): Shaded Opaque Triangle */
-static void gp0_triangle_shaded_opaque(Gpu* gpu) {
-    if (gpu->gp0_command_buffer.count < 6) {
-         fprintf(stderr, "GP0(0x30) Error: Expected 6 words, got %u\n", gpu->gp0_command_buffer.count); return; }
-    RendererColor c[3]; RendererPosition p[3];
-    for (int i = 0; i < 3; ++i) {
-        uint32_t cw=gpu->gp0_command_buffer.buffer[i*2]; uint32_t vw=gpu->gp0_command_buffer.buffer[i*2+1];
-        c[i].r=(GLubyte)(cw&0xFF); c[i].g=(GLubyte)((cw>>8)&0xFF); c[i].b=(GLubyte)((cw>>16)&0xFF);
-        p[i].x=(GLshort)(int16_t)(vw&0xFFFF); p[i].y=(GLshort)(int16_t)(vw>>16); }
-    // printf("GP0(0x30): Shaded Triangle ...\n");
-    renderer_push_triangle(&gpu->renderer, p, c);
+    gpu->vram_load_count += count * 2;
+    gpu->gp0_words_remaining -= count;
+    if (gpu->gp0_words_remaining == 0) { // Check if transfer complete
+        gpu->gp0_mode = GP0_MODE_COMMAND; // Switch back to command mode
+    }
 }
 
 /** GP0(0xA0): Copy Rectangle (CPU/DMA to VRAM) - Setup Phase */
 static void gp0_image_load(Gpu* gpu) {
      if (gpu->gp0_command_buffer.count < 3) {
-         fprintf(stderr, "GP0(0xA0) Error: Expected 3 words, got %u\n", gpu->gp0_command_buffer.count); return; }
+         LOG_ERROR(LOG_GPU, "GP0(0xA0) Error: Expected 3 words, got %u\n", gpu->gp0_command_buffer.count); return; }
+    raster_flush(gpu); // The image data overwrites VRAM the batched polygons may draw or sample
     uint32_t dest_coord = gpu->gp0_command_buffer.buffer[1];
     uint32_t dimensions = gpu->gp0_command_buffer.buffer[2];
     gpu->vram_load_x = (uint16_t)(dest_coord & 0x3FF); // X coord is 10 bits
     gpu->vram_load_y = (uint16_t)((dest_coord >> 16) & 0x1FF); // Y coord is 9 bits
-    gpu->vram_load_w = (uint16_t)(dimensions & 0x3FF); // Width is 10 bits
-    gpu->vram_load_h = (uint16_t)((dimensions >> 16) & 0x1FF); // Height is 9 bits
-
-    // Width and height seem to be stored as W-1, H-1 in some docs, but maybe not always?
-    // Let's assume they are direct values for now. Clamp values for safety.
-    if (gpu->vram_load_w == 0) gpu->vram_load_w = 1024; // Nocash says 0 means 1024?
-    if (gpu->vram_load_h == 0) gpu->vram_load_h = 512;  // Nocash says 0 means 512?
-    gpu->vram_load_w = (gpu->vram_load_w > VRAM_WIDTH) ? VRAM_WIDTH : gpu->vram_load_w;
-    gpu->vram_load_h = (gpu->vram_load_h > VRAM_HEIGHT) ? VRAM_HEIGHT : gpu->vram_load_h;
-
+    image_load_size(dimensions, &gpu->vram_load_w, &gpu->vram_load_h);
+    uint32_t words_to_load = gpu_image_load_words(dimensions); // Each word contains 2 pixels
 
-    uint32_t image_size_pixels = (uint32_t)gpu->vram_load_w * (uint32_t)gpu->vram_load_h;
-    uint32_t image_size_pixels_rounded = (image_size_pixels + 1) & ~1; // Round up for pairs
-    uint32_t words_to_load = image_size_pixels_rounded / 2;            // Each word contains 2 pixels
-
-    printf("GP0(0xA0): Setup Image Load to VRAM (%u,%u) Size=(%ux%u) -> Expecting %u words\n",
+    LOG_DEBUG(LOG_GPU, "GP0(0xA0): Setup Image Load to VRAM (%u,%u) Size=(%ux%u) -> Expecting %u words\n",
            gpu->vram_load_x, gpu->vram_load_y, gpu->vram_load_w, gpu->vram_load_h, words_to_load);
 
     if (words_to_load == 0 || ((uint64_t)words_to_load * 4) > VRAM_SIZE) { // Basic sanity check
-        fprintf(stderr, "Warning: Invalid image load size %u words requested.\n", words_to_load);
+        LOG_WARN(LOG_GPU, "Warning: Invalid image load size %u words requested.\n", words_to_load);
         gpu->gp0_words_remaining = 0; gpu->gp0_mode = GP0_MODE_COMMAND; return; }
 
     gpu->gp0_words_remaining = words_to_load;
@@ -386,13 +709,15 @@ static void gp0_image_load(Gpu* gpu) {
 /** GP0(0xC0): Copy Rectangle (VRAM to CPU/DMA) */
 static void gp0_image_store(Gpu* gpu) {
      if (gpu->gp0_command_buffer.count < 3) {
-         fprintf(stderr, "GP0(0xC0) Error: Expected 3 words, got %u\n", gpu->gp0_command_buffer.count); return; }
-    // TODO: Implement VRAM read logic & buffering for GPUREAD
-    uint32_t dimensions = gpu->gp0_command_buffer.buffer[2];
-    uint16_t w = (uint16_t)(dimensions & 0x3FF); // Width is 10 bits
-    uint16_t h = (uint16_t)((dimensions >> 16) & 0x1FF); // Height is 9 bits
-    printf("GP0(0xC0): Image Store (%ux%u) - VRAM Read Not Implemented\n", w, h);
-    (void)gpu;
+         LOG_ERROR(LOG_GPU, "GP0(0xC0) Error: Expected 3 words, got %u\n", gpu->gp0_command_buffer.count); return; }
+    raster_flush(gpu);
+    uint32_t src_coord = gpu->gp0_command_buffer.buffer[1];
+    gpu->vram_store_x = (uint16_t)(src_coord & 0x3FF);
+    gpu->vram_store_y = (uint16_t)((src_coord >> 16) & 0x1FF);
+    image_load_size(gpu->gp0_command_buffer.buffer[2], &gpu->vram_store_w, &gpu->vram_store_h);
+    gpu->vram_store_count = 0; // GPUREAD packs the pixels as it is read (gpu_read_data_block)
+    LOG_DEBUG(LOG_GPU, "GP0(0xC0): Image Store from VRAM (%u,%u) Size=(%ux%u)\n",
+           gpu->vram_store_x, gpu->vram_store_y, gpu->vram_store_w, gpu->vram_store_h);
 }
 
 
@@ -402,7 +727,7 @@ static void gp0_image_store(Gpu* gpu) {
  * @brief Initializes the GPU state, including VRAM and default register values.
  */
 void gpu_init(Gpu* gpu) {
-    printf("GPU Initializing...\n");
+    LOG_INFO(LOG_GPU, "GPU Initializing...\n");
     vram_init(&gpu->vram); // Init VRAM first
     // Initialize all Gpu struct members to power-on/GP1 Reset defaults
     gpu->interrupt = false; gpu->page_base_x = 0; gpu->page_base_y = 0;
@@ -427,83 +752,58 @@ void gpu_init(Gpu* gpu) {
     gpu->gp0_command_method = NULL;
     gpu->vram_load_x = 0; gpu->vram_load_y = 0; gpu->vram_load_w = 0;
     gpu->vram_load_h = 0; gpu->vram_load_count = 0;
-    printf("GPU Initialized (State reset, VRAM initialized).\n");
+    gpu->vram_store_x = 0; gpu->vram_store_y = 0; gpu->vram_store_w = 0;
+    gpu->vram_store_h = 0; gpu->vram_store_count = 0; gpu->read_latch = 0;
+    LOG_INFO(LOG_GPU, "GPU Initialized (State reset, VRAM initialized).\n");
 }
 
-/** Processes commands/data sent to GP0 port */
+/** Processes commands/data sent to GP0 port (queued instead when the GPU thread runs) */
 void gpu_gp0(Gpu* gpu, uint32_t command) {
+    if (trace_on(TRACE_GPU)) trace_gpu(0, command);
+    if (gpu->thread != NULL) {
+        gpu_thread_push(gpu, command);
+        return;
+    }
+    gpu_gp0_execute(gpu, command);
+}
+
+/** Sends a run of words to GP0 (DMA): the same as gpu_gp0 on each word, but image data is stored in bulk */
+void gpu_gp0_block(Gpu* gpu, const uint32_t* words, size_t count) {
+    if (trace_on(TRACE_GPU)) {
+        for (size_t i = 0; i < count; ++i) trace_gpu(0, words[i]);
+    }
+    if (gpu->thread != NULL) {
+        gpu_thread_push_block(gpu, words, count);
+        return;
+    }
+    gpu_gp0_execute_block(gpu, words, count);
+}
+
+void gpu_gp0_execute(Gpu* gpu, uint32_t command) {
     // Handle IMAGE_LOAD state first
     if (gpu->gp0_mode == GP0_MODE_IMAGE_LOAD) {
-        uint16_t pixel1 = (uint16_t)(command & 0xFFFF);
-        uint16_t pixel2 = (uint16_t)(command >> 16);
-        uint32_t idx = gpu->vram_load_count; // Base index for pixel 1
-        // Check if pixel 1 is within the logical height*width boundary
-        if (idx < ((uint32_t)gpu->vram_load_w * gpu->vram_load_h)) {
-             uint16_t x = gpu->vram_load_x + (uint16_t)(idx % gpu->vram_load_w);
-             uint16_t y = gpu->vram_load_y + (uint16_t)(idx / gpu->vram_load_w);
-             // Check against physical VRAM boundaries
-             if (y < VRAM_HEIGHT && x < VRAM_WIDTH) {
-                 uint32_t offset = (uint32_t)y * VRAM_WIDTH * VRAM_BPP + (uint32_t)x * VRAM_BPP;
-                 vram_store16(&gpu->vram, offset, pixel1);
-             } // Else: Pixel write out of VRAM bounds (optional warning)
-        }
-        idx++; // Index for pixel 2
-        // Check if pixel 2 is within the logical height*width boundary
-        if (idx < ((uint32_t)gpu->vram_load_w * gpu->vram_load_h)) {
-            uint16_t x = gpu->vram_load_x + (uint16_t)(idx % gpu->vram_load_w);
-            uint16_t y = gpu->vram_load_y + (uint16_t)(idx / gpu->vram_load_w);
-            // Check against physical VRAM boundaries
-             if (y < VRAM_HEIGHT && x < VRAM_WIDTH) {
-                 uint32_t offset = (uint32_t)y * VRAM_WIDTH * VRAM_BPP + (uint32_t)x * VRAM_BPP;
-                 vram_store16(&gpu->vram, offset, pixel2);
-             } // Else: Pixel write out of VRAM bounds (optional warning)
-        }
-        gpu->vram_load_count += 2; // Increment count by 2 pixels
-        gpu->gp0_words_remaining--; // Decrement remaining data words
-        if (gpu->gp0_words_remaining == 0) { // Check if transfer complete
-            gpu->gp0_mode = GP0_MODE_COMMAND; // Switch back to command mode
-            // printf("GPU Img Load Finished.\n"); // Optional debug
-        }
+        gp0_image_load_data(gpu, &command, 1);
         return; // Done processing this data word
     }
 
+    // Handle POLYLINE mode: the first word of each further vertex may end the line
+    if (gpu->gp0_mode == GP0_MODE_POLYLINE && gpu->gp0_command_buffer.count == 2 && gpu_gp0_polyline_end(command)) {
+        gpu->gp0_mode = GP0_MODE_COMMAND;
+        gpu->gp0_words_remaining = 0;
+        clear_gp0_command_buffer(gpu);
+        gpu->gp0_current_opcode = 0xFF;
+        return;
+    }
+
     // Handle COMMAND mode
     if (gpu->gp0_words_remaining == 0) {
-        // Start of a new command
+        // Start of a new command: one table lookup gives its length and handler
         uint8_t opcode = (uint8_t)(command >> 24);
-        printf("~ GP0: Received Command 0x%02x (Full Value: 0x%08x)\n", opcode, command);
-
-        uint32_t expected_len = 0; void (*handler)(Gpu*) = NULL;
+        LOG_TRACE(LOG_GPU, "~ GP0: Received Command 0x%02x (Full Value: 0x%08x)\n", opcode, command);
+        const Gp0Command* decoded = gp0_decode(opcode);
         gpu->gp0_current_opcode = opcode; clear_gp0_command_buffer(gpu);
-
-        // Determine expected length and handler based on opcode
-        switch (opcode) {
-            case 0x00: expected_len = 1; handler = gp0_nop; break;
-            case 0x01: expected_len = 1; handler = gp0_clear_cache; break;
-            case 0x02: expected_len = 3; handler = gp0_fill_rectangle; break;
-            case 0x28: expected_len = 5; handler = gp0_quad_mono_opaque; break;
-            case 0x2C: expected_len = 9; handler = gp0_quad_texture_blend_opaque; break;
-            case 0x30: expected_len = 6; handler = gp0_triangle_shaded_opaque; break;
-            case 0x38: expected_len = 8; handler = gp0_quad_shaded_opaque; break;
-            case 0xA0: expected_len = 3; handler = gp0_image_load; break; // Sets up IMAGE_LOAD mode
-            case 0xC0: expected_len = 3; handler = gp0_image_store; break;
-            case 0xE1: expected_len = 1; handler = gp0_draw_mode; break;
-            case 0xE2: expected_len = 1; handler = gp0_texture_window; break;
-            case 0xE3: expected_len = 1; handler = gp0_drawing_area_top_left; break;
-            case 0xE4: expected_len = 1; handler = gp0_drawing_area_bottom_right; break;
-            case 0xE5: expected_len = 1; handler = gp0_drawing_offset; break;
-            case 0xE6: expected_len = 1; handler = gp0_mask_bit_setting; break;
-            default:
-                fprintf(stderr, "GPU Error: Unhandled GP0 Opcode 0x%02x (Cmd 0x%08x)\n", opcode, command);
-                expected_len = 1; handler = gp0_nop; gpu->gp0_current_opcode = 0xFF; break; }
-
-        // Sanity check length
-        if (expected_len == 0 || expected_len > MAX_GPU_COMMAND_WORDS) {
-             fprintf(stderr, "GPU Error: Cmd 0x%02x invalid length %u\n", opcode, expected_len);
-             expected_len = 1; handler = gp0_nop; gpu->gp0_current_opcode = 0xFF; }
-
-        gpu->gp0_words_remaining = expected_len;
-        gpu->gp0_command_method = handler;
+        gpu->gp0_words_remaining = decoded->length;
+        gpu->gp0_command_method = decoded->handler;
     }
 
     // Buffer the current command word
@@ -515,7 +815,7 @@ void gpu_gp0(Gpu* gpu, uint32_t command) {
          if (gpu->gp0_command_method != NULL) {
              (gpu->gp0_command_method)(gpu); // Call the stored function pointer
          } else {
-             fprintf(stderr,"GPU Error: NULL handler for GP0 opcode 0x%02x\n", gpu->gp0_current_opcode);
+             LOG_ERROR(LOG_GPU, "GPU Error: NULL handler for GP0 opcode 0x%02x\n", gpu->gp0_current_opcode);
          }
          // If we didn't just finish setting up IMAGE_LOAD mode, reset for next command
          if (gpu->gp0_mode == GP0_MODE_COMMAND) {
@@ -525,8 +825,38 @@ void gpu_gp0(Gpu* gpu, uint32_t command) {
     }
 }
 
-/** Processes commands sent to GP1 port */
+/** Words in the GP0 packet started by 'opcode' (1 for NOPs; polylines: up to the second vertex) */
+uint32_t gpu_gp0_command_length(uint8_t opcode) {
+    return gp0_decode(opcode)->length;
+}
+
+uint32_t gpu_gp0_polyline_words(uint8_t opcode) {
+    return gp0_decode(opcode)->polyline_words;
+}
+
+void gpu_gp0_execute_block(Gpu* gpu, const uint32_t* words, size_t count) {
+    while (count > 0) {
+        if (gpu->gp0_mode == GP0_MODE_IMAGE_LOAD) {
+            // Image data: as much of the block as the transfer still takes, in one go
+            uint32_t take = count < gpu->gp0_words_remaining ? (uint32_t)count : gpu->gp0_words_remaining;
+            gp0_image_load_data(gpu, words, take);
+            words += take;
+            count -= take;
+        } else {
+            gpu_gp0_execute(gpu, *words++);
+            count--;
+        }
+    }
+}
+
+/**
+ * Processes commands sent to GP1 port. GP1 writes are a handful per frame, so with the
+ * GPU thread they wait for the queued GP0 words and then run here, in order (a reset
+ * must not overtake the commands written before it).
+ */
 void gpu_gp1(Gpu* gpu, uint32_t command) {
+    if (trace_on(TRACE_GPU)) trace_gpu(1, command);
+    gpu_flush(gpu);
     uint32_t opcode = (command >> 24) & 0xFF;
     switch (opcode) {
         case 0x00: gp1_reset(gpu, command); break;
@@ -540,13 +870,13 @@ void gpu_gp1(Gpu* gpu, uint32_t command) {
         case 0x08: gp1_display_mode(gpu, command); break;
         // Add cases for 0x09 (Get GPU Info), 0x10-0x1F (GPU Info responses) if needed
         default:
-            fprintf(stderr, "Error: Unhandled GP1 command: Opcode 0x%02x, Value 0x%08x\n", opcode, command);
+            LOG_ERROR(LOG_GPU, "Error: Unhandled GP1 command: Opcode 0x%02x, Value 0x%08x\n", opcode, command);
             break;
     }
 }
 
-/** Reads the GPU Status Register (GPUSTAT) */
-uint32_t gpu_read_status(Gpu* gpu) {
+/** GPUSTAT bits set by GP0 commands: the draw mode (E1) and the mask settings (E6) */
+uint32_t gpu_draw_status(const Gpu* gpu) {
     uint32_t r = 0;
     r |= (uint32_t)gpu->page_base_x << 0;
     r |= (uint32_t)gpu->page_base_y << 4;
@@ -556,8 +886,31 @@ uint32_t gpu_read_status(Gpu* gpu) {
     r |= (uint32_t)gpu->draw_to_display << 10;
     r |= (uint32_t)gpu->force_set_mask_bit << 11;
     r |= (uint32_t)gpu->preserve_masked_pixels << 12;
-    r |= (uint32_t)gpu->field << 13; // TODO: Needs timing update
     r |= (uint32_t)gpu->texture_disable << 15;
+    return r;
+}
+
+/** gpu_draw_status after a one-word GP0 command, without running it */
+uint32_t gpu_draw_status_update(uint32_t status, uint32_t command) {
+    switch (command >> 24) {
+        case 0xE1: { // Mirrors gp0_draw_mode, which keeps page_base_x/y as they are
+            uint32_t mask = 0x7E0u | (1u << 15);
+            if (((command >> 7) & 3) == 3) mask &= ~(3u << 7); // Depth 3 is ignored
+            uint32_t bits = (command & 0x7FF) | (((command >> 11) & 1) << 15);
+            return (status & ~mask) | (bits & mask);
+        }
+        case 0xE6:
+            return (status & ~(3u << 11)) | ((command & 3) << 11);
+        default:
+            return status;
+    }
+}
+
+/** Reads the GPU Status Register (GPUSTAT) */
+uint32_t gpu_read_status(Gpu* gpu) {
+    // The draw mode bits come from the GPU thread's shadow while it has GP0 words queued
+    uint32_t r = gpu->thread != NULL ? gpu_thread_draw_status(gpu) : gpu_draw_status(gpu);
+    r |= (uint32_t)gpu->field << 13; // TODO: Needs timing update
     // Horizontal Resolution bits (check Nocash STAT description for exact mapping)
     // STAT[16] = Hres2?(0) | Hres1(0) -> Raw=0..3 -> (raw & 1)
     // STAT[17] = Hres1(1)             -> Raw=0..3 -> (raw >> 1) & 1
@@ -590,10 +943,154 @@ uint32_t gpu_read_status(Gpu* gpu) {
     return r;
 }
 
+/**
+ * @brief Reads 'count' GPUREAD words. During a GP0(C0) transfer they are packed straight
+ * from VRAM at the store cursor, two pixels a word (low half first), a row segment at a
+ * time, with X and Y wrapping like the load; an odd-sized image ends with a zero half.
+ * Past the end (or without a transfer) GPUREAD repeats the last word it returned.
+ */
+void gpu_read_data_block(Gpu* gpu, uint32_t* out, size_t count) {
+    gpu_flush(gpu); // The data depends on every GP0 word written so far
+    uint32_t width = gpu->vram_store_w;
+    uint32_t total = width * gpu->vram_store_h;
+    uint32_t left = gpu->vram_store_count < total ? total - gpu->vram_store_count : 0;
+    size_t words = (left + 1) / 2 < count ? (left + 1) / 2 : count;
+    uint32_t pixels = words * 2 < left ? (uint32_t)words * 2 : left;
+    uint8_t* dst = (uint8_t*)out; // Pixel i is bytes 2i, 2i+1 (little-endian words)
+    const uint16_t* vram = (const uint16_t*)gpu->vram.data;
+
+    uint32_t row = width ? gpu->vram_store_count / width : 0, col = width ? gpu->vram_store_count % width : 0;
+    for (uint32_t todo = pixels; todo > 0;) {
+        uint32_t span = width - col < todo ? width - col : todo;
+        const uint16_t* line = vram + ((gpu->vram_store_y + row) & (VRAM_HEIGHT - 1)) * VRAM_WIDTH;
+        uint32_t x = (gpu->vram_store_x + col) & (VRAM_WIDTH - 1);
+        uint32_t before_wrap = VRAM_WIDTH - x < span ? VRAM_WIDTH - x : span;
+        memcpy(dst, line + x, (size_t)before_wrap * VRAM_BPP);
+        memcpy(dst + before_wrap * VRAM_BPP, line, (size_t)(span - before_wrap) * VRAM_BPP);
+        dst += span * VRAM_BPP;
+        todo -= span;
+        col += span;
+        if (col == width) {
+            col = 0;
+            row++;
+        }
+    }
+    if (pixels & 1) memset(dst, 0, VRAM_BPP);
+    gpu->vram_store_count += pixels;
+
+    if (words > 0) gpu->read_latch = out[words - 1];
+    for (size_t i = words; i < count; ++i) out[i] = gpu->read_latch;
+}
+
 /** Reads data from the GPUREAD port (e.g., after Image Store command) */
 uint32_t gpu_read_data(Gpu* gpu) {
-      // TODO: Implement reading data prepared by GP0(C0) Image Store
-      fprintf(stderr, "GPU Read Data (GPUREAD) - Not Implemented, returning 0\n");
-      (void)gpu; // Suppress unused warning
-      return 0; // Return dummy data for now
-}
\ No newline at end of file
+    uint32_t word;
+    gpu_read_data_block(gpu, &word, 1);
+    return word;
+}
+
+
+// --- I/O Registers ---
+// 0x1f801810: GP0 (write) / GPUREAD (read); 0x1f801814: GP1 (write) / GPUSTAT (read)
+static uint32_t gpu_io_read32(void* device, uint32_t offset) {
+    Gpu* gpu = (Gpu*)device;
+    switch (GPU_START + offset) {
+        case GPU_GPUREAD_ADDR:
+            LOG_TRACE(LOG_GPU, "~ Read32 from GPUREAD (0x1f801810)\n");
+            return gpu_read_data(gpu);
+        case GPU_GPUSTAT_ADDR:
+            return gpu_read_status(gpu); // Polled constantly, not logged
+        default:
+            LOG_WARN(LOG_GPU, "Warning: Unhandled GPU read32 at 0x%08x\n", GPU_START + offset);
+            return 0;
+    }
+}
+
+static void gpu_io_write32(void* device, uint32_t offset, uint32_t value) {
+    Gpu* gpu = (Gpu*)device;
+    switch (GPU_START + offset) {
+        case GPU_GP0_ADDR: gpu_gp0(gpu, value); break;
+        case GPU_GP1_ADDR: gpu_gp1(gpu, value); break;
+        default:
+            LOG_WARN(LOG_GPU, "Warning: Unhandled GPU write32 at 0x%08x = 0x%08x\n", GPU_START + offset, value);
+            break;
+    }
+}
+
+static const IoHandler gpu_io_handler = {
+    .name = "GPU",
+    .read32 = gpu_io_read32,
+    .write32 = gpu_io_write32,
+};
+
+/**
+ * @brief Registers the GPU ports with the interconnect's I/O dispatch table.
+ */
+void gpu_register_io(Gpu* gpu, struct Interconnect* inter) {
+    interconnect_register_io(inter, GPU_START, GPU_SIZE, &gpu_io_handler, gpu);
+}
+
+/**
+ * @brief Makes the Gpu and VRAM current: waits for the GPU thread's queue, then draws the
+ * polygons batched for tiled rendering (the thread is idle by then, so this thread may).
+ */
+void gpu_flush(Gpu* gpu) {
+    gpu_thread_sync(gpu);
+    raster_flush(gpu);
+}
+
+/**
+ * @brief Selects where draw commands go. The software backend needs no GL context.
+ */
+void gpu_set_backend(Gpu* gpu, GpuBackend backend) {
+    if (backend != GPU_BACKEND_SOFTWARE) gpu_thread_stop(gpu); // GL calls stay on this thread
+    gpu->backend = backend;
+    LOG_INFO(LOG_GPU, "GPU: %s backend selected\n", backend == GPU_BACKEND_SOFTWARE ? "software" : "OpenGL");
+}
+
+
+// --- Save State Support ---
+// Stable IDs for gp0_command_method (0 = none). They are stored in save states:
+// append new handlers at the end, never reorder.
+#define GP0_METHOD_POLYGON(op)   gp0_polygon_##op,
+#define GP0_METHOD_LINE(op)      gp0_line_##op,
+#define GP0_METHOD_RECTANGLE(op) gp0_rectangle_##op,
+static void (* const gp0_method_table[])(Gpu*) = {
+    NULL,
+    gp0_nop,
+    gp0_clear_cache,
+    gp0_fill_rectangle,
+    gp0_draw_mode,
+    gp0_texture_window,
+    gp0_drawing_area_top_left,
+    gp0_drawing_area_bottom_right,
+    gp0_drawing_offset,
+    gp0_mask_bit_setting,
+    gp0_polygon_28,
+    gp0_polygon_2C,
+    gp0_polygon_38,
+    gp0_polygon_30,
+    gp0_image_load,
+    gp0_image_store,
+    gp0_image_copy,
+    // Every generated handler (the four above again: lookups find their first ID)
+    GP0_OPCODES_32(GP0_METHOD_POLYGON, 2, 3)
+    GP0_OPCODES_32(GP0_METHOD_LINE, 4, 5)
+    GP0_OPCODES_32(GP0_METHOD_RECTANGLE, 6, 7)
+};
+#define GP0_METHOD_COUNT (sizeof(gp0_method_table) / sizeof(gp0_method_table[0]))
+
+uint8_t gpu_gp0_method_id(const Gpu* gpu) {
+    for (uint32_t id = 0; id < GP0_METHOD_COUNT; ++id) {
+        if (gp0_method_table[id] == gpu->gp0_command_method) return (uint8_t)id;
+    }
+    LOG_WARN(LOG_GPU, "Warning: handler for GP0 opcode 0x%02x has no save-state ID, storing none\n",
+             gpu->gp0_current_opcode);
+    return 0;
+}
+
+bool gpu_set_gp0_method_id(Gpu* gpu, uint8_t id) {
+    if (id >= GP0_METHOD_COUNT) return false;
+    gpu->gp0_command_method = gp0_method_table[id];
+    return true;
+}
@@ -7,9 +7,14 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "renderer.h" // Includes OpenGL renderer definitions
 #include "vram.h"     // Includes VRAM definitions
 
+struct Interconnect; // Forward declaration (I/O register registration)
+struct GpuThread;   // Forward declaration (gpu_thread.h)
+struct RasterPool;  // Forward declaration (rasterizer.h)
+
 // --- GPU Data Types & Enums ---
 
 // Texture Color Depth (from STAT[8:7])
@@ -61,9 +66,16 @@ typedef enum {
 // GP0 Port Mode (internal state)
 typedef enum {
     GP0_MODE_COMMAND,   // Expecting GP0 command words
-    GP0_MODE_IMAGE_LOAD // Expecting pixel data words for VRAM transfer
+    GP0_MODE_IMAGE_LOAD, // Expecting pixel data words for VRAM transfer
+    GP0_MODE_POLYLINE    // Expecting further polyline vertices or the terminator word
 } Gp0Mode;
 
+// Where GP0 draw commands end up (chosen at init with gpu_set_backend)
+typedef enum {
+    GPU_BACKEND_OPENGL,  // Batched into the GL Renderer; drawing does not touch vram
+    GPU_BACKEND_SOFTWARE // Rasterized on the CPU straight into vram (rasterizer.c)
+} GpuBackend;
+
 // GP0 Command Buffer
 #define MAX_GPU_COMMAND_WORDS 16 // Max parameters for any single command + opcode word
 typedef struct {
@@ -141,6 +153,14 @@ typedef struct Gpu { // Define struct Gpu
     uint16_t vram_load_h;             // Height of the image being loaded
     uint32_t vram_load_count;         // Counter for pixels transferred during current load
 
+    // --- VRAM Store State (for GP0(C0)) ---
+    uint16_t vram_store_x;            // Source X coordinate in VRAM for current image store
+    uint16_t vram_store_y;            // Source Y coordinate in VRAM for current image store
+    uint16_t vram_store_w;            // Width of the image being read back
+    uint16_t vram_store_h;            // Height of the image being read back
+    uint32_t vram_store_count;        // Counter for pixels already read through GPUREAD
+    uint32_t read_latch;              // Last GPUREAD word, returned again once the image is read
+
     //members to store the calculated texture page base coordinates
     uint16_t tpage_x_base;
     uint16_t tpage_y_base;
@@ -149,15 +169,41 @@ typedef struct Gpu { // Define struct Gpu
     Vram vram;                         // The 1MB Video RAM buffer
 
     // --- Renderer ---
+    GpuBackend backend;                // Host choice, kept across GP1 resets and save states
     Renderer renderer;                 // Handles OpenGL drawing operations
+    struct GpuThread* thread;          // Non-NULL: GP0 words run on the GPU thread (gpu_thread.c)
+    struct RasterPool* raster_pool;    // Non-NULL: software polygons are drawn by tiles (rasterizer.c)
 
 } Gpu;
 
 // --- Function Prototypes ---
 void gpu_init(Gpu* gpu);
 void gpu_gp0(Gpu* gpu, uint32_t command); // Handles commands/data sent to GP0 port
+void gpu_gp0_block(Gpu* gpu, const uint32_t* words, size_t count); // gpu_gp0 on a run of words (DMA)
 void gpu_gp1(Gpu* gpu, uint32_t command); // Handles commands sent to GP1 port
 uint32_t gpu_read_status(Gpu* gpu);       // Reads the GPUSTAT register value
 uint32_t gpu_read_data(Gpu* gpu);         // Reads data from GPUREAD port (e.g., after Image Store)
+void gpu_read_data_block(Gpu* gpu, uint32_t* out, size_t count); // gpu_read_data on a run of words (DMA)
+void gpu_register_io(Gpu* gpu, struct Interconnect* inter); // Maps GP0/GPUREAD and GP1/GPUSTAT into the I/O window
+void gpu_set_backend(Gpu* gpu, GpuBackend backend);         // Selects the draw backend (before emulation starts)
+void gpu_flush(Gpu* gpu); // Finishes queued GP0 words and batched polygons (before reading VRAM or GPU state)
+
+// GPU thread support (gpu_thread.c parses ahead of the worker with these)
+void gpu_gp0_execute(Gpu* gpu, uint32_t command);  // gpu_gp0 without tracing or queueing
+void gpu_gp0_execute_block(Gpu* gpu, const uint32_t* words, size_t count); // The same for gpu_gp0_block
+uint32_t gpu_gp0_command_length(uint8_t opcode);    // Words in the packet of a GP0 command
+uint32_t gpu_gp0_polyline_words(uint8_t opcode);    // Words per further polyline vertex (0: not a polyline)
+uint32_t gpu_image_load_words(uint32_t dimensions); // Data words following GP0(A0) with this size word
+uint32_t gpu_draw_status(const Gpu* gpu);           // GPUSTAT bits set by GP0(E1)/GP0(E6)
+uint32_t gpu_draw_status_update(uint32_t status, uint32_t command); // Those bits after one GP0 word
+
+// A word starting a polyline vertex that ends the polyline instead (usually 0x55555555)
+static inline bool gpu_gp0_polyline_end(uint32_t word) {
+    return (word & 0xF000F000) == 0x50005000;
+}
+
+// Save-state IDs for gp0_command_method (0 = no command in progress)
+uint8_t gpu_gp0_method_id(const Gpu* gpu);
+bool gpu_set_gp0_method_id(Gpu* gpu, uint8_t id); // false if the ID is unknown
 
 #endif // GPU_H
\ No newline at end of file
@@ -0,0 +1,227 @@
+// gpu_bench.c
+// Times the software rasterizer on a captured command stream (see gpu_bench.h).
+#include "gpu_bench.h"
+#include "gpu.h"
+#include "rasterizer.h"
+#include "trace.h"
+#include "logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define GPU_BENCH_MIN_SECONDS 1.0 // Replays are repeated until the immediate run takes this long
+#define GPU_BENCH_MAX_PASSES  100000
+#define GPU_BENCH_VRAM_SECONDS 0.25 // Time spent on each VRAM transfer case
+
+typedef struct {
+    uint32_t word;
+    uint8_t port; // 0: GP0, 1: GP1
+} GpuBenchWord;
+
+/**
+ * @brief Reads the GP0/GP1 records of a trace file, in order.
+ */
+static GpuBenchWord* gpu_bench_load(const char* path, size_t* count) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        perror("GPU bench: failed to open the trace");
+        return NULL;
+    }
+    TraceHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, TRACE_MAGIC, 8) != 0 ||
+        header.version != TRACE_VERSION || header.record_size != sizeof(TraceRecord)) {
+        fprintf(stderr, "GPU bench: '%s' is not a trace file of this version\n", path);
+        fclose(file);
+        return NULL;
+    }
+
+    size_t capacity = 4096, used = 0;
+    GpuBenchWord* words = malloc(capacity * sizeof(GpuBenchWord));
+    TraceRecord record;
+    while (words != NULL && fread(&record, sizeof(record), 1, file) == 1) {
+        if (record.type != TRACE_REC_GP0 && record.type != TRACE_REC_GP1) continue;
+        if (used == capacity) {
+            capacity *= 2;
+            GpuBenchWord* grown = realloc(words, capacity * sizeof(GpuBenchWord));
+            if (grown == NULL) {
+                free(words);
+                words = NULL;
+                break;
+            }
+            words = grown;
+        }
+        words[used].word = record.b;
+        words[used].port = record.type == TRACE_REC_GP1;
+        used++;
+    }
+    fclose(file);
+    if (words == NULL) fprintf(stderr, "GPU bench: out of memory reading '%s'\n", path);
+    *count = used;
+    return words;
+}
+
+static double gpu_bench_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static uint64_t gpu_bench_vram_hash(const Gpu* gpu) {
+    uint64_t hash = 1469598103934665603ull; // FNV-1a
+    for (size_t i = 0; i < VRAM_SIZE; ++i) {
+        hash ^= gpu->vram.data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Powers the GPU on and replays the stream 'passes' times.
+ * @return Seconds taken, the final gpu_flush included.
+ */
+static double gpu_bench_replay(Gpu* gpu, const GpuBenchWord* words, size_t count, uint32_t passes) {
+    gpu_init(gpu);
+    double start = gpu_bench_seconds();
+    for (uint32_t pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < count; ++i) {
+            if (words[i].port) {
+                gpu_gp1(gpu, words[i].word);
+            } else {
+                gpu_gp0(gpu, words[i].word);
+            }
+        }
+    }
+    gpu_flush(gpu);
+    return gpu_bench_seconds() - start;
+}
+
+bool gpu_bench_run(const char* trace_path, uint32_t max_threads, uint32_t tile_size) {
+    size_t count = 0;
+    GpuBenchWord* words = gpu_bench_load(trace_path, &count);
+    if (words == NULL) return false;
+    if (count == 0) {
+        fprintf(stderr, "GPU bench: '%s' has no GPU words (record it with --trace-events=gpu)\n", trace_path);
+        free(words);
+        return false;
+    }
+    Gpu* gpu = calloc(1, sizeof(Gpu)); // No renderer, no GPU thread, no pool
+    if (gpu == NULL) {
+        free(words);
+        return false;
+    }
+    gpu->backend = GPU_BACKEND_SOFTWARE;
+    if (max_threads == 0) max_threads = 1;
+
+    // GPU logging (unhandled opcodes, resets) would be timed along with the drawing
+    uint8_t gpu_log_level = logger_category_level[LOG_GPU];
+    logger_category_level[LOG_GPU] = LOG_LEVEL_OFF;
+
+    double once = gpu_bench_replay(gpu, words, count, 1);
+    uint32_t passes = once > 0 ? (uint32_t)(GPU_BENCH_MIN_SECONDS / once) + 1 : GPU_BENCH_MAX_PASSES;
+    if (passes > GPU_BENCH_MAX_PASSES) passes = GPU_BENCH_MAX_PASSES;
+    printf("GPU bench: %zu GPU words from '%s', %u replays per run, %ux%u tiles\n",
+           count, trace_path, passes, tile_size, tile_size);
+
+    double immediate = gpu_bench_replay(gpu, words, count, passes);
+    uint64_t expected = gpu_bench_vram_hash(gpu);
+    printf("  immediate:  %9.3f ms per replay  (VRAM %016llx)\n", immediate * 1000.0 / passes,
+           (unsigned long long)expected);
+
+    bool ok = true;
+    double single = 0;
+    for (uint32_t threads = 1; threads <= max_threads; ++threads) {
+        if (!raster_pool_start(gpu, threads, tile_size)) {
+            ok = false;
+            break;
+        }
+        double elapsed = gpu_bench_replay(gpu, words, count, passes);
+        raster_pool_stop(gpu);
+        uint64_t hash = gpu_bench_vram_hash(gpu);
+        if (threads == 1) single = elapsed;
+        printf("  %2u thread%s: %9.3f ms per replay  x%.2f%s\n", threads, threads == 1 ? " " : "s",
+               elapsed * 1000.0 / passes, elapsed > 0 ? single / elapsed : 0.0,
+               hash == expected ? "" : "  VRAM DIFFERS from the immediate run");
+        if (hash != expected) ok = false;
+    }
+
+    logger_category_level[LOG_GPU] = gpu_log_level;
+    free(gpu);
+    free(words);
+    return ok;
+}
+
+// --- VRAM Transfer Benchmark ---
+
+typedef struct {
+    const char* name;
+    uint32_t words[5]; // GP0 packet, run as is
+    uint8_t length;
+    uint32_t mask_setting; // GP0(E6) bits set around the packet
+    uint32_t pixels;       // Pixels written or read per packet
+    uint8_t readback;      // 0: none, 1: per GPUREAD word, 2: gpu_read_data_block
+} GpuBenchVramCase;
+
+static const GpuBenchVramCase gpu_bench_vram_cases[] = {
+    { "fill 1008x511",            { 0x02123456, 0x00000000, 0x01FF03F0 }, 3, 0, 1008 * 511, 0 },
+    { "fill 16x16",               { 0x02123456, 0x00100010, 0x00100010 }, 3, 0, 16 * 16, 0 },
+    { "copy 512x256 disjoint",    { 0x80000000, 0x00000000, 0x00000200, 0x01000200 }, 4, 0, 512 * 256, 0 },
+    { "copy 512x256 overlapping", { 0x80000000, 0x00000000, 0x00080004, 0x01000200 }, 4, 0, 512 * 256, 0 },
+    { "copy 512x256 masked",      { 0x80000000, 0x00000000, 0x00000200, 0x01000200 }, 4, 3, 512 * 256, 0 },
+    { "readback 1024x512 words",  { 0xC0000000, 0x00000000, 0x02000400 }, 3, 0, 1024 * 512, 1 },
+    { "readback 1024x512 block",  { 0xC0000000, 0x00000000, 0x02000400 }, 3, 0, 1024 * 512, 2 },
+};
+
+/**
+ * @brief Runs one case 'passes' times.
+ * @return Seconds taken.
+ */
+static double gpu_bench_vram_case(Gpu* gpu, const GpuBenchVramCase* test, uint32_t* buffer, uint32_t passes) {
+    uint32_t words = (test->pixels + 1) / 2;
+    gpu_gp0(gpu, 0xE6000000 | test->mask_setting);
+    double start = gpu_bench_seconds();
+    for (uint32_t pass = 0; pass < passes; ++pass) {
+        for (uint8_t i = 0; i < test->length; ++i) gpu_gp0(gpu, test->words[i]);
+        if (test->readback == 1) {
+            for (uint32_t i = 0; i < words; ++i) buffer[i] = gpu_read_data(gpu);
+        } else if (test->readback == 2) {
+            gpu_read_data_block(gpu, buffer, words);
+        }
+    }
+    gpu_flush(gpu);
+    double elapsed = gpu_bench_seconds() - start;
+    gpu_gp0(gpu, 0xE6000000);
+    return elapsed;
+}
+
+bool gpu_bench_vram(void) {
+    Gpu* gpu = calloc(1, sizeof(Gpu)); // No renderer, no GPU thread, no pool
+    uint32_t* buffer = malloc(VRAM_SIZE);
+    if (gpu == NULL || buffer == NULL) {
+        free(gpu);
+        free(buffer);
+        return false;
+    }
+    gpu->backend = GPU_BACKEND_SOFTWARE;
+    uint8_t gpu_log_level = logger_category_level[LOG_GPU];
+    logger_category_level[LOG_GPU] = LOG_LEVEL_OFF;
+    gpu_init(gpu);
+    for (size_t i = 0; i < VRAM_SIZE; ++i) gpu->vram.data[i] = (uint8_t)(i * 2654435761u >> 24); // Not all one color
+
+    printf("VRAM bench: GB/s of pixels written or read\n");
+    for (size_t i = 0; i < sizeof(gpu_bench_vram_cases) / sizeof(gpu_bench_vram_cases[0]); ++i) {
+        const GpuBenchVramCase* test = &gpu_bench_vram_cases[i];
+        double once = gpu_bench_vram_case(gpu, test, buffer, 1);
+        uint32_t passes = once > 0 ? (uint32_t)(GPU_BENCH_VRAM_SECONDS / once) + 1 : GPU_BENCH_MAX_PASSES;
+        if (passes > GPU_BENCH_MAX_PASSES) passes = GPU_BENCH_MAX_PASSES;
+        double elapsed = gpu_bench_vram_case(gpu, test, buffer, passes);
+        double bytes = (double)passes * test->pixels * VRAM_BPP;
+        printf("  %-26s %8.2f GB/s  (%8.0f ns per command)\n", test->name,
+               elapsed > 0 ? bytes / elapsed / 1e9 : 0.0, elapsed * 1e9 / passes);
+    }
+
+    logger_category_level[LOG_GPU] = gpu_log_level;
+    free(buffer);
+    free(gpu);
+    return true;
+}
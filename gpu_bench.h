@@ -0,0 +1,32 @@
+// gpu_bench.h
+// GPU benchmarks on a standalone software GPU: the rasterizer replaying the GP0/GP1 words of a
+// trace file, and the VRAM transfer commands.
+#ifndef GPU_BENCH_H
+#define GPU_BENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Replays a captured command stream (a --trace file recorded with the "gpu" event
+ * class) drawing immediately, then with tiled rendering on 1 to 'max_threads' threads,
+ * and prints the time per replay and the speedup over one thread. Every configuration
+ * replays the stream the same number of times (enough for about a second of drawing)
+ * and must leave VRAM bit-identical to the immediate run.
+ * @param trace_path Trace file to replay.
+ * @param max_threads Highest thread count measured.
+ * @param tile_size Tile edge in pixels.
+ * @return false if the trace could not be read or a configuration drew different VRAM.
+ */
+bool gpu_bench_run(const char* trace_path, uint32_t max_threads, uint32_t tile_size);
+
+/**
+ * @brief Times the VRAM transfer commands and prints their throughput in GB/s of pixels:
+ * GP0(02) fills (large and 16x16), GP0(80) copies (disjoint, overlapping, and with both
+ * GP0(E6) mask bits set) and GP0(C0) readback one GPUREAD word at a time and in bulk
+ * (gpu_read_data_block, the DMA path). Each case repeats for about a quarter second.
+ * @return false if the GPU could not be allocated.
+ */
+bool gpu_bench_vram(void);
+
+#endif // GPU_BENCH_H
@@ -0,0 +1,263 @@
+// gpu_thread.c
+// Single-producer/single-consumer ring of GP0 words, executed by one GPU worker thread.
+#include "gpu_thread.h"
+#include "logger.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define GPU_RING_WORDS        (1u << 16) // Must be a power of two (256 KiB of words)
+#define GPU_PUBLISH_INTERVAL  1024       // Words executed between read position updates
+#define GPU_SPIN_LIMIT        256        // Empty polls (each a sched_yield) before sleeping
+#define GPU_IDLE_SLEEP_NS     1000000L   // Longest sleep, in case a wakeup was missed (1 ms)
+
+typedef struct GpuThread {
+    uint32_t ring[GPU_RING_WORDS];
+    _Alignas(64) _Atomic uint32_t write_pos; // Words queued (producer)
+    _Alignas(64) _Atomic uint32_t read_pos;  // Words executed (worker)
+
+    // Producer side only
+    _Alignas(64) uint32_t cached_read_pos; // Last read_pos seen, to avoid polling it per word
+    bool resync;              // Ring drained since the last push: re-read the parser state
+    bool image_load;          // Parser: inside GP0(A0) pixel data
+    uint32_t polyline_words;  // Parser: inside a polyline, words per vertex (0 otherwise)
+    uint8_t opcode;           // Parser: command of the current packet
+    uint32_t words_remaining; // Parser: words left in the current packet or image data
+    uint32_t draw_status;     // gpu_draw_status as of the last queued word
+
+    Gpu* gpu;
+    pthread_t worker;
+    atomic_bool stop;
+    atomic_bool sleeping;     // Worker is (about to be) waiting on 'wake'
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+} GpuThread;
+
+
+// --- Worker Thread ---
+static void gpu_thread_wake(GpuThread* thread) {
+    pthread_mutex_lock(&thread->lock);
+    pthread_cond_signal(&thread->wake);
+    pthread_mutex_unlock(&thread->lock);
+}
+
+/**
+ * @brief Sleeps until the producer queues words or asks to stop. The producer checks
+ * 'sleeping' without a full fence, so a wakeup can be missed; the timeout bounds that.
+ */
+static void gpu_thread_sleep(GpuThread* thread, uint32_t pos) {
+    pthread_mutex_lock(&thread->lock);
+    atomic_store(&thread->sleeping, true);
+    if (atomic_load(&thread->write_pos) == pos && !atomic_load(&thread->stop)) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += GPU_IDLE_SLEEP_NS;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&thread->wake, &thread->lock, &deadline);
+    }
+    atomic_store(&thread->sleeping, false);
+    pthread_mutex_unlock(&thread->lock);
+}
+
+static void* gpu_thread_main(void* arg) {
+    GpuThread* thread = arg;
+    uint32_t pos = atomic_load_explicit(&thread->read_pos, memory_order_relaxed);
+    uint32_t idle = 0;
+    for (;;) {
+        uint32_t end = atomic_load_explicit(&thread->write_pos, memory_order_acquire);
+        if (pos != end) {
+            while (pos != end) {
+                // Contiguous words up to the ring's end or the next publish point, in one call
+                // (image data then goes to VRAM in bulk)
+                uint32_t index = pos & (GPU_RING_WORDS - 1);
+                uint32_t count = end - pos;
+                uint32_t to_publish = GPU_PUBLISH_INTERVAL - (pos & (GPU_PUBLISH_INTERVAL - 1));
+                if (count > to_publish) count = to_publish;
+                if (count > GPU_RING_WORDS - index) count = GPU_RING_WORDS - index;
+                gpu_gp0_execute_block(thread->gpu, &thread->ring[index], count);
+                pos += count;
+                // Publish progress now and then so a producer waiting for space can go on
+                if ((pos & (GPU_PUBLISH_INTERVAL - 1)) == 0) {
+                    atomic_store_explicit(&thread->read_pos, pos, memory_order_release);
+                }
+            }
+            atomic_store_explicit(&thread->read_pos, pos, memory_order_release);
+            idle = 0;
+        } else if (atomic_load_explicit(&thread->stop, memory_order_acquire)) {
+            break; // Stop is only requested once the ring has drained
+        } else if (++idle < GPU_SPIN_LIMIT) {
+            sched_yield();
+        } else {
+            gpu_thread_sleep(thread, pos);
+            idle = 0;
+        }
+    }
+    return NULL;
+}
+
+
+// --- Producer ---
+/**
+ * @brief Takes the parser state and draw mode from the Gpu. Only valid while the ring is
+ * empty, which is the case after a sync: the caller may have changed the Gpu since
+ * (GP1 commands, save state loads).
+ */
+static void gpu_thread_resync(GpuThread* thread) {
+    const Gpu* gpu = thread->gpu;
+    thread->image_load = gpu->gp0_mode == GP0_MODE_IMAGE_LOAD;
+    thread->polyline_words = gpu->gp0_mode == GP0_MODE_POLYLINE ? gpu_gp0_polyline_words(gpu->gp0_current_opcode) : 0;
+    thread->opcode = gpu->gp0_current_opcode;
+    thread->words_remaining = gpu->gp0_words_remaining;
+    thread->draw_status = gpu_draw_status(gpu);
+    thread->resync = false;
+}
+
+/**
+ * @brief Follows the packet boundaries gpu_gp0_execute will see, so that the words
+ * starting a packet (the only ones that can be E1/E6) are told apart from parameters
+ * and image data.
+ */
+static void gpu_thread_track(GpuThread* thread, uint32_t command) {
+    if (thread->image_load) {
+        if (--thread->words_remaining == 0) thread->image_load = false;
+        return;
+    }
+    if (thread->polyline_words > 0 && thread->words_remaining == thread->polyline_words &&
+        gpu_gp0_polyline_end(command)) {
+        thread->polyline_words = 0;
+        thread->words_remaining = 0;
+        return;
+    }
+    if (thread->words_remaining == 0) {
+        thread->opcode = (uint8_t)(command >> 24);
+        thread->words_remaining = gpu_gp0_command_length(thread->opcode);
+        thread->draw_status = gpu_draw_status_update(thread->draw_status, command);
+    }
+    if (--thread->words_remaining > 0) return;
+    if ((thread->opcode & 0xE0) == 0xA0) { // GP0(A0), mirrored up to BF
+        thread->words_remaining = gpu_image_load_words(command); // Last word: the size
+        thread->image_load = thread->words_remaining > 0;
+    } else if ((thread->polyline_words = gpu_gp0_polyline_words(thread->opcode)) > 0) {
+        thread->words_remaining = thread->polyline_words; // Segment drawn, next vertex
+    }
+}
+
+/**
+ * @brief Copies words into the ring, as many at a time as there is space for.
+ */
+static void gpu_thread_write(GpuThread* thread, const uint32_t* words, size_t count) {
+    uint32_t pos = atomic_load_explicit(&thread->write_pos, memory_order_relaxed);
+    while (count > 0) {
+        uint32_t space = GPU_RING_WORDS - (pos - thread->cached_read_pos);
+        if (space == 0) {
+            thread->cached_read_pos = atomic_load_explicit(&thread->read_pos, memory_order_acquire);
+            if (pos - thread->cached_read_pos < GPU_RING_WORDS) continue;
+            if (atomic_load_explicit(&thread->sleeping, memory_order_relaxed)) gpu_thread_wake(thread);
+            sched_yield(); // Ring full: the worker is behind by a whole ring
+            continue;
+        }
+        uint32_t index = pos & (GPU_RING_WORDS - 1);
+        uint32_t chunk = count < space ? (uint32_t)count : space;
+        if (chunk > GPU_RING_WORDS - index) chunk = GPU_RING_WORDS - index;
+        memcpy(&thread->ring[index], words, chunk * sizeof(uint32_t));
+        pos += chunk;
+        words += chunk;
+        count -= chunk;
+        atomic_store_explicit(&thread->write_pos, pos, memory_order_release);
+        if (atomic_load_explicit(&thread->sleeping, memory_order_relaxed)) gpu_thread_wake(thread);
+    }
+}
+
+void gpu_thread_push(Gpu* gpu, uint32_t command) {
+    GpuThread* thread = gpu->thread;
+    if (thread->resync) gpu_thread_resync(thread);
+    gpu_thread_track(thread, command);
+    gpu_thread_write(thread, &command, 1);
+}
+
+void gpu_thread_push_block(Gpu* gpu, const uint32_t* words, size_t count) {
+    GpuThread* thread = gpu->thread;
+    if (thread->resync) gpu_thread_resync(thread);
+    for (size_t i = 0; i < count;) {
+        if (thread->image_load) { // Image data needs no parsing: skip over it
+            size_t take = count - i < thread->words_remaining ? count - i : thread->words_remaining;
+            thread->words_remaining -= (uint32_t)take;
+            if (thread->words_remaining == 0) thread->image_load = false;
+            i += take;
+        } else {
+            gpu_thread_track(thread, words[i++]);
+        }
+    }
+    gpu_thread_write(thread, words, count);
+}
+
+uint32_t gpu_thread_draw_status(Gpu* gpu) {
+    GpuThread* thread = gpu->thread;
+    return thread->resync ? gpu_draw_status(gpu) : thread->draw_status;
+}
+
+void gpu_thread_sync(Gpu* gpu) {
+    GpuThread* thread = gpu->thread;
+    if (thread == NULL) return;
+    uint32_t end = atomic_load_explicit(&thread->write_pos, memory_order_relaxed);
+    while ((thread->cached_read_pos = atomic_load_explicit(&thread->read_pos, memory_order_acquire)) != end) {
+        if (atomic_load_explicit(&thread->sleeping, memory_order_relaxed)) gpu_thread_wake(thread);
+        sched_yield();
+    }
+    thread->resync = true;
+}
+
+
+// --- Public API ---
+bool gpu_thread_start(Gpu* gpu) {
+    if (gpu->thread != NULL) return true;
+    if (gpu->backend != GPU_BACKEND_SOFTWARE) {
+        LOG_WARN(LOG_GPU, "GPU thread: only the software backend can run threaded\n");
+        return false;
+    }
+    GpuThread* thread = malloc(sizeof(GpuThread));
+    if (thread == NULL) {
+        LOG_ERROR(LOG_GPU, "GPU thread: failed to allocate the command ring\n");
+        return false;
+    }
+    atomic_init(&thread->write_pos, 0);
+    atomic_init(&thread->read_pos, 0);
+    atomic_init(&thread->stop, false);
+    atomic_init(&thread->sleeping, false);
+    thread->cached_read_pos = 0;
+    thread->resync = true;
+    thread->gpu = gpu;
+    pthread_mutex_init(&thread->lock, NULL);
+    pthread_cond_init(&thread->wake, NULL);
+
+    if (pthread_create(&thread->worker, NULL, gpu_thread_main, thread) != 0) {
+        LOG_ERROR(LOG_GPU, "GPU thread: failed to start the worker, GP0 stays synchronous\n");
+        pthread_cond_destroy(&thread->wake);
+        pthread_mutex_destroy(&thread->lock);
+        free(thread);
+        return false;
+    }
+    gpu->thread = thread;
+    LOG_INFO(LOG_GPU, "GPU thread: started (%u-word command ring)\n", GPU_RING_WORDS);
+    return true;
+}
+
+void gpu_thread_stop(Gpu* gpu) {
+    GpuThread* thread = gpu->thread;
+    if (thread == NULL) return;
+    gpu_thread_sync(gpu);
+    atomic_store_explicit(&thread->stop, true, memory_order_release);
+    gpu_thread_wake(thread);
+    pthread_join(thread->worker, NULL);
+    pthread_cond_destroy(&thread->wake);
+    pthread_mutex_destroy(&thread->lock);
+    free(thread);
+    gpu->thread = NULL; // GP0 runs synchronously again
+    LOG_INFO(LOG_GPU, "GPU thread: stopped\n");
+}
@@ -0,0 +1,60 @@
+// gpu_thread.h
+// Threaded GPU: GP0 words are queued in a lock-free ring and executed by a worker thread.
+#ifndef GPU_THREAD_H
+#define GPU_THREAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpu.h"
+
+/* --- Synchronization ---
+ * The CPU thread is the only producer and the worker the only consumer. While words are
+ * queued the worker owns the draw state, VRAM and the GP0 parser; the CPU thread keeps
+ * the GP1 (display) state. Everything that reads what GP0 produces waits for the ring
+ * to drain first (gpu_flush): GPUREAD, GP1 writes, save states (and with them
+ * rewind, run-ahead and movie hashes) and presenting a frame. GPUSTAT does not wait:
+ * the producer parses packet boundaries as it queues and tracks the E1/E6 draw mode
+ * bits itself, and the busy bits stay "ready" like in the synchronous GPU, so replays
+ * see exactly the same values with or without the thread.
+ *
+ * Only the software backend can run threaded, since GL calls must stay on the thread
+ * that owns the context.
+ */
+
+/**
+ * @brief Starts the worker; GP0 words are queued from now on.
+ * @return false if the backend is not GPU_BACKEND_SOFTWARE or the thread could not be
+ *         created (GP0 then keeps running on the calling thread).
+ */
+bool gpu_thread_start(Gpu* gpu);
+
+/**
+ * @brief Drains the ring, joins the worker and goes back to synchronous GP0. No-op
+ * without a worker.
+ */
+void gpu_thread_stop(Gpu* gpu);
+
+/**
+ * @brief Waits until the worker has executed every queued word, after which the whole
+ * Gpu may be read or modified by the caller. No-op without a worker.
+ */
+void gpu_thread_sync(Gpu* gpu);
+
+/**
+ * @brief Queues one GP0 word (gpu_gp0 does this while the worker runs). Waits only if
+ * the ring is full.
+ */
+void gpu_thread_push(Gpu* gpu, uint32_t command);
+
+/**
+ * @brief Queues a run of GP0 words (gpu_gp0_block). Image data is copied into the ring
+ * without being parsed word by word.
+ */
+void gpu_thread_push_block(Gpu* gpu, const uint32_t* words, size_t count);
+
+/**
+ * @brief The gpu_draw_status bits as of the last queued word, without waiting.
+ */
+uint32_t gpu_thread_draw_status(Gpu* gpu);
+
+#endif // GPU_THREAD_H
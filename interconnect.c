@@ -1,9 +1,17 @@
 #include "interconnect.h" // Includes associated header and headers for components (gpu.h, dma.h etc.)
+#include "logger.h"
+#include "trace.h"
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h> // For memset
 
 // Forward declaration for the internal DMA transfer function
 static void interconnect_perform_dma(Interconnect* inter, uint32_t channel_index);
+// Scheduler callbacks owned by the interconnect (VBlank IRQ, DMA completion)
+static void interconnect_vblank_event(void* context, SchedulerEvent event);
+static void interconnect_dma_event(void* context, SchedulerEvent event);
+// Registers the I/O handlers of the interconnect's own registers (IRQ, DMA, memory control)
+static void interconnect_register_builtin_io(Interconnect* inter);
 
 // --- Memory Region Masking ---
 // Array mapping the top 3 bits of a virtual address to a mask
@@ -16,16 +24,45 @@ const uint32_t REGION_MASK[8] = {
     0xffffffff, 0xffffffff                          // KSEG2 (0xC0000000 - 0xFFFFFFFF) - No mask
 };
 
+// mask_region() itself is inline in interconnect.h.
+
+// Guest RAM is little-endian. On a little-endian host, DMA can hand the GPU runs of RAM
+// as uint32_t words in place; elsewhere it moves one word at a time through the bus.
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define DMA_BULK_RAM_WORDS 1
+#else
+#define DMA_BULK_RAM_WORDS 0
+#endif
+
+
+// --- Fastmem Page Tables ---
 /**
- * @brief Maps a CPU virtual address to a physical address by masking region bits.
- * KSEG2 addresses are returned unchanged.
- * @param addr The 32-bit virtual address.
- * @return The 32-bit physical address.
+ * @brief Fills the fastmem page tables: RAM and its mirrors are readable and writable,
+ * BIOS is read-only. Everything else stays NULL and is routed through the I/O checks.
+ * On big-endian hosts, and while the fast paths are bypassed, the tables stay empty.
+ * @param inter Pointer to the Interconnect struct.
  */
-uint32_t mask_region(uint32_t addr) {
-    // Use top 3 bits to index into the mask array
-    size_t index = (addr >> 29) & 0x7;
-    return addr & REGION_MASK[index];
+void interconnect_map_fastmem(Interconnect* inter) {
+    memset(inter->fastmem_read, 0, sizeof(inter->fastmem_read));
+    memset(inter->fastmem_write, 0, sizeof(inter->fastmem_write));
+    inter->fastmem_arena_fast = inter->fastmem_bypass ? NULL : inter->fastmem_arena;
+    inter->scratchpad_fast = inter->fastmem_bypass ? NULL : inter->scratchpad;
+    if (inter->fastmem_bypass) return;
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (uint32_t addr = RAM_START; addr <= RAM_MIRROR_END; addr += (1u << FASTMEM_PAGE_SHIFT)) {
+        uint8_t* host = &inter->ram->data[addr & (RAM_SIZE - 1)];
+        inter->fastmem_read[addr >> FASTMEM_PAGE_SHIFT] = host;
+        inter->fastmem_write[addr >> FASTMEM_PAGE_SHIFT] = host;
+    }
+    for (uint32_t addr = BIOS_START; addr <= BIOS_END; addr += (1u << FASTMEM_PAGE_SHIFT)) {
+        inter->fastmem_read[addr >> FASTMEM_PAGE_SHIFT] = &inter->bios->data[addr - BIOS_START];
+    }
+#endif
+}
+
+void interconnect_set_fastmem_bypass(Interconnect* inter, bool bypass) {
+    inter->fastmem_bypass = bypass;
+    interconnect_map_fastmem(inter);
 }
 
 
@@ -41,8 +78,20 @@ uint32_t mask_region(uint32_t addr) {
 void interconnect_init(Interconnect* inter, Bios* bios, Ram* ram) {
     inter->bios = bios;
     inter->ram = ram;
+    scheduler_init(&inter->scheduler); // Before the devices: they register their events
+    // I/O slots are cleared before the devices register their registers in them
+    memset(inter->io_slots, 0, sizeof(inter->io_slots));
+    interconnect_register_builtin_io(inter);
     dma_init(&inter->dma); // Initialize DMA controller state
     gpu_init(&inter->gpu); // Initialize GPU state (now contains Renderer)
+    // The GL side is set up later by renderer_init, which headless runs skip
+    // (not in gpu_init: GP1(00) soft resets go through it too)
+    inter->gpu.renderer.initialized = false;
+    inter->gpu.renderer.vertex_count = 0;
+    inter->gpu.backend = GPU_BACKEND_OPENGL;
+    inter->gpu.thread = NULL;
+    inter->gpu.raster_pool = NULL;
+    gpu_register_io(&inter->gpu, inter);
 
 
     cdrom_init(&inter->cdrom,inter);
@@ -53,12 +102,64 @@ void interconnect_init(Interconnect* inter, Bios* bios, Ram* ram) {
     
     // Initialize Timer state <<< ADD THIS CALL
     timers_init(&inter->timers_state, inter);
+
+    // VBlank and DMA completions are driven by the scheduler
+    scheduler_register(&inter->scheduler, SCHED_EVENT_VBLANK, interconnect_vblank_event, inter);
+    for (int channel = 0; channel < 7; ++channel) {
+        scheduler_register(&inter->scheduler, (SchedulerEvent)(SCHED_EVENT_DMA0 + channel), interconnect_dma_event, inter);
+    }
+    scheduler_schedule(&inter->scheduler, SCHED_EVENT_VBLANK, VBLANK_PERIOD_CYCLES);
+
+    // No CPU attached yet (cpu_init registers itself) and no RAM page holds cached code
+    inter->cpu = NULL;
+    memset(inter->ram_code_pages, 0, sizeof(inter->ram_code_pages));
+    memset(inter->scratchpad, 0, sizeof(inter->scratchpad));
+    inter->pad_buttons = 0;
+
+    // RAM/BIOS accesses go straight to host memory through the page tables
+    // (fastmem_arena_init can switch to the host VM arena afterwards)
+    inter->fastmem_arena = NULL;
+    inter->fastmem_bypass = false;
+    interconnect_map_fastmem(inter);
     
-    printf("Interconnect Initialized (BIOS, RAM, DMA, GPU, CDROM, IRQ states set).\n");
+    LOG_INFO(LOG_BUS, "Interconnect Initialized (BIOS, RAM, DMA, GPU, CDROM, IRQ states set).\n");
+}
+
+
+// --- Scheduled Events ---
+/**
+ * @brief SCHED_EVENT_VBLANK callback: raises IRQ 0 and re-arms one frame after the
+ * previous deadline (not after 'now', so late dispatch does not drift).
+ */
+static void interconnect_vblank_event(void* context, SchedulerEvent event) {
+    Interconnect* inter = (Interconnect*)context;
+    interconnect_request_irq(inter, IRQ_VBLANK);
+    scheduler_schedule_at(&inter->scheduler, event, inter->scheduler.deadline[event] + VBLANK_PERIOD_CYCLES);
+}
+
+/**
+ * @brief SCHED_EVENT_DMA0..6 callback: the transfer time has elapsed, so the channel
+ * stops reporting busy and its DICR interrupt flag (and IRQ 3) is raised if enabled.
+ */
+static void interconnect_dma_event(void* context, SchedulerEvent event) {
+    Interconnect* inter = (Interconnect*)context;
+    uint32_t channel_index = (uint32_t)(event - SCHED_EVENT_DMA0);
+    if (dma_channel_complete(&inter->dma, channel_index)) {
+        interconnect_request_irq(inter, IRQ_DMA);
+    }
 }
 
 
 // --- Peripheral Interrupt Request ---
+/**
+ * @brief Forwards an I_STAT/I_MASK change to the CPU's interrupt-pending flag.
+ */
+static void interconnect_irq_changed(Interconnect* inter) {
+    if (inter->cpu) {
+        cpu_update_irq_pending(inter->cpu);
+    }
+}
+
 /**
  * @brief Allows peripherals to signal an interrupt request.
  * Sets the corresponding bit in the I_STAT register (irq_status).
@@ -67,17 +168,208 @@ void interconnect_init(Interconnect* inter, Bios* bios, Ram* ram) {
  */
 void interconnect_request_irq(Interconnect* inter, uint32_t irq_line) {
     if (irq_line <= IRQ_PIO) { // Check if line is valid (0-10)
+        if (trace_on(TRACE_IRQ)) trace_irq(irq_line);
         uint16_t old_stat = inter->irq_status;
         inter->irq_status |= (1 << irq_line); // Set the corresponding bit
         if (old_stat != inter->irq_status) {
             // Optional: Print only when status actually changes
-            printf("IRQ Requested: Line %u. I_STAT is now 0x%04x\n", irq_line, inter->irq_status);
+            LOG_DEBUG(LOG_BUS, "IRQ Requested: Line %u. I_STAT is now 0x%04x\n", irq_line, inter->irq_status);
+            interconnect_irq_changed(inter);
         }
     } else {
-        fprintf(stderr, "Warning: Invalid IRQ line %u requested by peripheral.\n", irq_line);
+        LOG_WARN(LOG_BUS, "Warning: Invalid IRQ line %u requested by peripheral.\n", irq_line);
+    }
+}
+
+
+// --- I/O Register Handlers ---
+// Registers owned by the interconnect itself (memory control, IRQ controller, DMA) and
+// the placeholders for devices that are not emulated yet (SPU, expansion 2). Timers,
+// CD-ROM and GPU register their own handlers from their init functions.
+
+void interconnect_register_io(Interconnect* inter, uint32_t start, uint32_t size,
+                              const IoHandler* handler, void* device) {
+    if (size == 0 || start < IO_PORTS_START || start - IO_PORTS_START + size > IO_PORTS_SIZE) {
+        LOG_ERROR(LOG_BUS, "I/O registration of '%s' outside the register window: 0x%08x (+0x%x)\n",
+                  handler->name, start, size);
+        return;
+    }
+    uint32_t first = (start - IO_PORTS_START) >> IO_SLOT_SHIFT;
+    uint32_t last = (start - IO_PORTS_START + size - 1) >> IO_SLOT_SHIFT;
+    for (uint32_t slot = first; slot <= last; ++slot) {
+        inter->io_slots[slot].handler = handler;
+        inter->io_slots[slot].device = device;
+        inter->io_slots[slot].base = start;
+    }
+}
+
+/**
+ * @brief Returns the slot owning a physical address, or NULL if the address is outside
+ * the I/O window or no device registered it.
+ */
+static inline const IoSlot* interconnect_io_slot(const Interconnect* inter, uint32_t physical_addr) {
+    uint32_t offset = physical_addr - IO_PORTS_START;
+    if (offset >= IO_PORTS_SIZE) return NULL;
+    const IoSlot* slot = &inter->io_slots[offset >> IO_SLOT_SHIFT];
+    return slot->handler ? slot : NULL;
+}
+
+// Memory control (0x1f801000-0x1f80107f, minus the IRQ registers registered on top of it)
+static void memctrl_io_write32(void* device, uint32_t offset, uint32_t value) {
+    (void)device;
+    uint32_t physical_addr = MEM_CONTROL_START + offset;
+    switch (physical_addr) {
+        case EXPANSION_1_BASE_ADDR: // 0x1f801000
+            if (value != 0x1f000000) LOG_WARN(LOG_BUS, "Warning: Bad Expansion 1 base address write: 0x%08x\n", value);
+            else LOG_TRACE(LOG_BUS, "~ Write32 to EXP1_BASE_ADDR = 0x%08x\n", value);
+            break;
+        case EXPANSION_2_BASE_ADDR: // 0x1f801004
+            if (value != 0x1f802000) LOG_WARN(LOG_BUS, "Warning: Bad Expansion 2 base address write: 0x%08x\n", value);
+            else LOG_TRACE(LOG_BUS, "~ Write32 to EXP2_BASE_ADDR = 0x%08x\n", value);
+            break;
+        case RAM_SIZE_ADDR: // 0x1f801060
+            LOG_TRACE(LOG_BUS, "~ Write32 to RAM_SIZE register (0x1f801060) = 0x%08x (Ignoring)\n", value);
+            break;
+        default:
+            LOG_TRACE(LOG_BUS, "~ Write32 to Unknown MEM_CONTROL addr 0x%08x = 0x%08x (Ignoring)\n", physical_addr, value);
+            break;
+    }
+}
+
+static void memctrl_io_write16(void* device, uint32_t offset, uint16_t value) {
+    (void)device;
+    LOG_TRACE(LOG_BUS, "~ Write16 to MEM_CONTROL region: Addr 0x%08x = 0x%04x (Ignoring)\n", MEM_CONTROL_START + offset, value);
+}
+
+static void memctrl_io_write8(void* device, uint32_t offset, uint8_t value) {
+    (void)device;
+    LOG_TRACE(LOG_BUS, "~ Write8 to MEM_CONTROL region: 0x%08x = 0x%02x (Ignoring)\n", MEM_CONTROL_START + offset, value);
+}
+
+static const IoHandler memctrl_io_handler = {
+    .name = "MEM_CONTROL",
+    .write32 = memctrl_io_write32, .write16 = memctrl_io_write16, .write8 = memctrl_io_write8,
+};
+
+// Interrupt controller: I_STAT (0x1f801070) and I_MASK (0x1f801074)
+static uint16_t irq_io_read16(void* device, uint32_t offset) {
+    Interconnect* inter = (Interconnect*)device;
+    switch (IRQ_REGS_START + offset) {
+        case IRQ_STATUS_ADDR:
+            LOG_TRACE(LOG_BUS, "~ Read from IRQ_STATUS (0x1f801070): Returning 0x%04x\n", inter->irq_status);
+            return inter->irq_status;
+        case IRQ_MASK_ADDR:
+            LOG_TRACE(LOG_BUS, "~ Read from IRQ_MASK (0x1f801074): Returning 0x%04x\n", inter->irq_mask);
+            return inter->irq_mask;
+        default:
+            LOG_WARN(LOG_BUS, "Warning: Unhandled IRQ controller read at 0x%08x\n", IRQ_REGS_START + offset);
+            return 0;
     }
 }
 
+static uint32_t irq_io_read32(void* device, uint32_t offset) {
+    return irq_io_read16(device, offset);
+}
+
+static void irq_io_write16(void* device, uint32_t offset, uint16_t value) {
+    Interconnect* inter = (Interconnect*)device;
+    switch (IRQ_REGS_START + offset) {
+        case IRQ_STATUS_ADDR:
+            // Writing acknowledges (clears) the interrupt flags set in value (bits 0-10)
+            inter->irq_status &= ~(value & 0x7FF);
+            LOG_TRACE(LOG_BUS, "~ Write to IRQ_STATUS (Ack): Value=0x%04x -> I_STAT=0x%04x\n", value, inter->irq_status);
+            interconnect_irq_changed(inter);
+            break;
+        case IRQ_MASK_ADDR:
+            inter->irq_mask = value & 0x7FF;
+            LOG_TRACE(LOG_BUS, "~ Write to IRQ_MASK: Value=0x%04x -> I_MASK=0x%04x\n", value, inter->irq_mask);
+            interconnect_irq_changed(inter);
+            break;
+        default:
+            LOG_TRACE(LOG_BUS, "~ Write to Unknown MEM_CONTROL addr 0x%08x = 0x%04x (Ignoring)\n", IRQ_REGS_START + offset, value);
+            break;
+    }
+}
+
+static void irq_io_write32(void* device, uint32_t offset, uint32_t value) {
+    irq_io_write16(device, offset, (uint16_t)value); // Only bits 0-10 matter
+}
+
+static const IoHandler irq_io_handler = {
+    .name = "IRQ",
+    .read32 = irq_io_read32, .read16 = irq_io_read16,
+    .write32 = irq_io_write32, .write16 = irq_io_write16,
+};
+
+// DMA controller (0x1f801080-0x1f8010ff): a CHCR write can start a transfer
+static uint32_t dma_io_read32(void* device, uint32_t offset) {
+    Interconnect* inter = (Interconnect*)device;
+    LOG_TRACE(LOG_BUS, "~ Read32 from DMA region: Addr=0x%08x Offset=0x%x\n", DMA_START + offset, offset);
+    return dma_read(&inter->dma, offset);
+}
+
+static void dma_io_write32(void* device, uint32_t offset, uint32_t value) {
+    Interconnect* inter = (Interconnect*)device;
+    LOG_TRACE(LOG_BUS, "~ Write32 to DMA region: Addr=0x%08x Offset=0x%x = 0x%08x\n", DMA_START + offset, offset, value);
+    if (dma_write(&inter->dma, offset, value)) {
+        uint32_t channel_index = (offset >> 4) & 0x7;
+        LOG_DEBUG(LOG_DMA, "  DMA Channel %d activated by write to offset 0x%x.\n", channel_index, offset);
+        interconnect_perform_dma(inter, channel_index);
+    }
+}
+
+static const IoHandler dma_io_handler = {
+    .name = "DMA",
+    .read32 = dma_io_read32,
+    .write32 = dma_io_write32,
+};
+
+// SPU (0x1f801c00-0x1f801e7f): not emulated, reads return 0 and writes are dropped
+static uint32_t spu_io_read32(void* device, uint32_t offset) { (void)device; (void)offset; return 0; }
+static uint16_t spu_io_read16(void* device, uint32_t offset) { (void)device; (void)offset; return 0; }
+static uint8_t spu_io_read8(void* device, uint32_t offset) { (void)device; (void)offset; return 0; }
+static void spu_io_write32(void* device, uint32_t offset, uint32_t value) { (void)device; (void)offset; (void)value; }
+static void spu_io_write16(void* device, uint32_t offset, uint16_t value) { (void)device; (void)offset; (void)value; }
+static void spu_io_write8(void* device, uint32_t offset, uint8_t value) { (void)device; (void)offset; (void)value; }
+
+static const IoHandler spu_io_handler = {
+    .name = "SPU",
+    .read32 = spu_io_read32, .read16 = spu_io_read16, .read8 = spu_io_read8,
+    .write32 = spu_io_write32, .write16 = spu_io_write16, .write8 = spu_io_write8,
+};
+
+// Expansion 2 (0x1f802000-0x1f802041, debug/POST port): writes are ignored
+static void exp2_io_write32(void* device, uint32_t offset, uint32_t value) {
+    (void)device;
+    LOG_TRACE(LOG_BUS, "~ Write32 to Expansion 2 region: Address 0x%08x = 0x%08x (Ignoring)\n", EXPANSION_2_START + offset, value);
+}
+
+static void exp2_io_write16(void* device, uint32_t offset, uint16_t value) {
+    (void)device;
+    LOG_TRACE(LOG_BUS, "~ Write16 to Expansion 2 region: Address 0x%08x = 0x%04x (Ignoring)\n", EXPANSION_2_START + offset, value);
+}
+
+static void exp2_io_write8(void* device, uint32_t offset, uint8_t value) {
+    (void)device;
+    LOG_TRACE(LOG_BUS, "~ Write8 to Expansion 2 region: Address 0x%08x = 0x%02x (Ignoring)\n", EXPANSION_2_START + offset, value);
+}
+
+static const IoHandler exp2_io_handler = {
+    .name = "Expansion 2",
+    .write32 = exp2_io_write32, .write16 = exp2_io_write16, .write8 = exp2_io_write8,
+};
+
+/**
+ * @brief Registers the I/O handlers owned by the interconnect.
+ */
+static void interconnect_register_builtin_io(Interconnect* inter) {
+    interconnect_register_io(inter, MEM_CONTROL_START, MEM_CONTROL_SIZE, &memctrl_io_handler, inter);
+    interconnect_register_io(inter, IRQ_REGS_START, IRQ_REGS_END + 1 - IRQ_REGS_START, &irq_io_handler, inter);
+    interconnect_register_io(inter, DMA_START, DMA_SIZE, &dma_io_handler, inter);
+    interconnect_register_io(inter, SPU_START, SPU_SIZE, &spu_io_handler, NULL);
+    interconnect_register_io(inter, EXPANSION_2_START, EXPANSION_2_SIZE, &exp2_io_handler, NULL);
+}
+
 
 // --- Load Operations ---
 
@@ -87,68 +379,42 @@ void interconnect_request_irq(Interconnect* inter, uint32_t irq_line) {
  * @param address Virtual address to read from.
  * @return The 32-bit value read.
  */
-uint32_t interconnect_load32(Interconnect* inter, uint32_t address) {
+static uint32_t interconnect_load32_untraced(Interconnect* inter, uint32_t address) {
     // Check for 32-bit alignment (Word access)
     if (address % 4 != 0) {
         // TODO: This should trigger an Address Error Load exception in the CPU.
-        fprintf(stderr, "Unaligned load32 address: 0x%08x\n", address);
+        LOG_ERROR(LOG_BUS, "Unaligned load32 address: 0x%08x\n", address);
         // For now, just return a garbage value, but an exception is correct.
         return 0xBADBAD32; // Placeholder for unaligned access
     }
 
     uint32_t physical_addr = mask_region(address);
 
-    // --- Hardware Register Checks (Specific Addresses First) ---
-
-// --- Check Timer Range --- <<< ADD THIS BLOCK
-    if (physical_addr >= TIMERS_START && physical_addr <= TIMERS_END) {
-        uint32_t timer_base_offset = physical_addr - TIMERS_START;
-        int timer_index = timer_base_offset / 0x10; // Each timer block is 0x10 bytes wide
-        uint32_t register_offset = physical_addr & 0xF; // Offset within the timer block (0, 4, 8)
-
-        // printf("~ Read32 from Timer %d Offset 0x%x\n", timer_index, register_offset);
-        return timer_read32(&inter->timers_state, timer_index, register_offset);
-    }
-    
-    // Interrupt Controller Registers
-    if (physical_addr == IRQ_STATUS_ADDR) { // 0x1f801070 (I_STAT)
-        printf("~ Read32 from IRQ_STATUS (0x1f801070): Returning 0x%04x\n", inter->irq_status);
-        return (uint32_t)inter->irq_status;
-    }
-    if (physical_addr == IRQ_MASK_ADDR) { // 0x1f801074 (I_MASK)
-        printf("~ Read32 from IRQ_MASK (0x1f801074): Returning 0x%04x\n", inter->irq_mask);
-        return (uint32_t)inter->irq_mask;
+    // --- Scratchpad: KUSEG/KSEG0 only (the KSEG1 alias falls through as unmapped) ---
+    uint8_t* scratch = interconnect_scratchpad_ptr(inter->scratchpad, address);
+    if (scratch) {
+        uint32_t value;
+        memcpy(&value, scratch, 4);
+        return value;
     }
 
-    // GPU Registers
-    if (physical_addr == GPU_GPUREAD_ADDR) { // 0x1f801810 (Read = GPUREAD)
-        // Reading GPUREAD should return data from VRAM transfers or command responses
-        printf("~ Read32 from GPUREAD (0x1f801810)\n");
-        return gpu_read_data(&inter->gpu);
-    }
-    if (physical_addr == GPU_GPUSTAT_ADDR) { // 0x1f801814 (Read = GPUSTAT)
-        // Reading GPUSTAT returns the GPU status flags
-        // printf("~ Read32 from GPUSTAT (0x1f801814)\n"); // Often read, can be noisy
-        return gpu_read_status(&inter->gpu);
+    // --- Fastmem: RAM (+mirrors) and BIOS pages resolve straight to host memory ---
+    uint8_t* host = interconnect_fastmem_ptr(inter->fastmem_read, physical_addr);
+    if (host) {
+        uint32_t value;
+        memcpy(&value, host, 4);
+        return value;
     }
 
-    // Timer Registers (Example: Read Timer 1 Counter)
-    if (physical_addr == 0x1f801110) { // Timer 1 Counter Value (T1_COUNT)
-         // TODO: Implement actual Timer read logic
-         printf("~ Read32 from Timer 1 Counter (0x1f801110): Returning 0 (Placeholder)\n");
-         return 0;
+    // --- Hardware Registers: one table lookup for the whole I/O window ---
+    const IoSlot* io = interconnect_io_slot(inter, physical_addr);
+    if (io) {
+        if (io->handler->read32) return io->handler->read32(io->device, physical_addr - io->base);
+        LOG_WARN(LOG_BUS, "Warning: Unhandled %s read32 at 0x%08x\n", io->handler->name, physical_addr);
+        return 0;
     }
-    // Add reads for other Timer counters/modes/targets if needed
-
 
-    // --- Region Checks (Broader Ranges) ---
-
-    // DMA Region (0x1f801080 - 0x1f8010FF)
-    if (physical_addr >= DMA_START && physical_addr <= DMA_END) {
-        uint32_t offset = physical_addr - DMA_START;
-        printf("~ Read32 from DMA region: Addr=0x%08x Offset=0x%x\n", physical_addr, offset);
-        return dma_read(&inter->dma, offset); // Delegate to DMA module
-    }
+    // --- Memory Regions (only reached here while fastmem is bypassed) ---
 
     // BIOS Region (0x1fc00000 - 0x1fc7ffff)
     if (physical_addr >= BIOS_START && physical_addr <= BIOS_END) {
@@ -158,32 +424,20 @@ uint32_t interconnect_load32(Interconnect* inter, uint32_t address) {
     }
 
     // Main RAM Region (0x00000000 - 0x001fffff)
-    if (physical_addr <= RAM_END) {
+    if (physical_addr <= RAM_MIRROR_END) {
         // printf("~ Read32 from RAM region: Addr=0x%08x\n", physical_addr); // Can be very noisy
-        return ram_load32(inter->ram, physical_addr); // Delegate to RAM module
-    }
-
-    // Timer Region (General Check - 0x1f801100 - 0x1f80112F)
-    if (physical_addr >= TIMERS_START && physical_addr <= TIMERS_END) {
-        fprintf(stderr, "Warning: Unhandled Timer read32 at 0x%08x\n", physical_addr);
-        return 0; // Return 0 for unhandled timer reads
-    }
-
-    // SPU Region (0x1f801C00 - 0x1f801E7F)
-    if (physical_addr >= SPU_START && physical_addr <= SPU_END) {
-         // printf("~ Read32 from SPU region: Address 0x%08x (Ignoring, returning 0)\n", physical_addr); // Often noisy
-         return 0; // SPU not implemented yet
+        return ram_load32(inter->ram, physical_addr & (RAM_SIZE - 1)); // Delegate to RAM module
     }
 
     // Expansion 1 Region (0x1f000000 - 0x1f7fffff)
     if (physical_addr >= EXPANSION_1_START && physical_addr <= EXPANSION_1_END) {
-         printf("~ Read32 from Expansion 1 region: Address 0x%08x (Returning 0xFFFFFFFF)\n", physical_addr);
+         LOG_TRACE(LOG_BUS, "~ Read32 from Expansion 1 region: Address 0x%08x (Returning 0xFFFFFFFF)\n", physical_addr);
          return 0xFFFFFFFF; // Expansion 1 returns all Fs when empty
     }
 
 
     // --- Fallback for Unhandled Addresses ---
-    fprintf(stderr, "Unhandled physical memory read32 at address: 0x%08x (Mapped from 0x%08x)\n",
+    LOG_ERROR(LOG_BUS, "Unhandled physical memory read32 at address: 0x%08x (Mapped from 0x%08x)\n",
             physical_addr, address);
     return 0; // Or a more distinct "garbage" value like 0xDEADBEEF
 }
@@ -194,85 +448,64 @@ uint32_t interconnect_load32(Interconnect* inter, uint32_t address) {
  * @param address Virtual address to read from.
  * @return The 16-bit value read.
  */
-uint16_t interconnect_load16(Interconnect* inter, uint32_t address) {
+static uint16_t interconnect_load16_untraced(Interconnect* inter, uint32_t address) {
      // Check for 16-bit alignment (Halfword access)
      if (address % 2 != 0) {
         // TODO: Trigger Address Error Load exception
-        fprintf(stderr, "Unaligned load16 address: 0x%08x\n", address);
+        LOG_ERROR(LOG_BUS, "Unaligned load16 address: 0x%08x\n", address);
         return 0xBADB; // Placeholder
     }
     uint32_t physical_addr = mask_region(address);
 
-// --- Check Timer Range --- <<< ADD THIS BLOCK
-    if (physical_addr >= TIMERS_START && physical_addr <= TIMERS_END) {
-        uint32_t timer_base_offset = physical_addr - TIMERS_START;
-        int timer_index = timer_base_offset / 0x10;
-        uint32_t register_offset = physical_addr & 0xF;
-
-        // printf("~ Read16 from Timer %d Offset 0x%x\n", timer_index, register_offset);
-        return timer_read16(&inter->timers_state, timer_index, register_offset);
+    // --- Scratchpad: KUSEG/KSEG0 only (the KSEG1 alias falls through as unmapped) ---
+    uint8_t* scratch = interconnect_scratchpad_ptr(inter->scratchpad, address);
+    if (scratch) {
+        uint16_t value;
+        memcpy(&value, scratch, 2);
+        return value;
     }
 
-    // Interrupt Controller Registers
-    if (physical_addr == IRQ_STATUS_ADDR) { // 0x1f801070 (I_STAT)
-        printf("~ Read16 from IRQ_STATUS (0x1f801070): Returning 0x%04x\n", inter->irq_status);
-        return inter->irq_status;
+    // --- Fastmem: RAM (+mirrors) and BIOS pages resolve straight to host memory ---
+    uint8_t* host = interconnect_fastmem_ptr(inter->fastmem_read, physical_addr);
+    if (host) {
+        uint16_t value;
+        memcpy(&value, host, 2);
+        return value;
     }
-     if (physical_addr == IRQ_MASK_ADDR) { // 0x1f801074 (I_MASK)
-        printf("~ Read16 from IRQ_MASK (0x1f801074): Returning 0x%04x\n", inter->irq_mask);
-        return inter->irq_mask;
-     }
 
-    // SPU Region (Reads usually return 0 or specific status)
-    if (physical_addr >= SPU_START && physical_addr <= SPU_END) {
-         // printf("~ Read16 from SPU region: Address 0x%08x (Ignoring, returning 0)\n", physical_addr); // Often noisy
-         return 0; // SPU reads often ignored initially
-    }
-
-    // Timer Region (Check specific registers if needed)
-     if (physical_addr >= TIMERS_START && physical_addr <= TIMERS_END) {
-        // Handle specific 16-bit Timer reads (Counter, Mode, Target)
-        // Example:
-        // if (physical_addr == 0x1F801100) return timer0_get_count();
-        fprintf(stderr, "Warning: Unhandled Timer read16 at 0x%08x\n", physical_addr);
+    // --- Hardware Registers: one table lookup for the whole I/O window ---
+    const IoSlot* io = interconnect_io_slot(inter, physical_addr);
+    if (io) {
+        if (io->handler->read16) return io->handler->read16(io->device, physical_addr - io->base);
+        LOG_WARN(LOG_BUS, "Warning: Unhandled %s read16 at 0x%08x\n", io->handler->name, physical_addr);
         return 0;
     }
 
+    // --- Memory Regions (only reached here while fastmem is bypassed) ---
+
     // Main RAM Region
-    if (physical_addr <= RAM_END) {
+    if (physical_addr <= RAM_MIRROR_END) {
         // printf("~ Read16 from RAM region: Addr=0x%08x\n", physical_addr); // Can be noisy
-        return ram_load16(inter->ram, physical_addr);
+        return ram_load16(inter->ram, physical_addr & (RAM_SIZE - 1));
     }
 
     // BIOS Region (Unlikely, but check)
      if (physical_addr >= BIOS_START && physical_addr <= BIOS_END) {
-        fprintf(stderr, "Warning: Unhandled 16-bit read from BIOS at 0x%08x\n", physical_addr);
+        LOG_WARN(LOG_BUS, "Warning: Unhandled 16-bit read from BIOS at 0x%08x\n", physical_addr);
         // BIOS is typically read 32 bits at a time for instructions
         // Reading 16 bits might happen but isn't common.
         // We could implement bios_load16 if needed.
         return 0;
     }
 
-    // GPU Region (Unlikely 16-bit reads)
-    if (physical_addr >= GPU_START && physical_addr <= GPU_END) {
-         fprintf(stderr, "Warning: Unhandled GPU read16 at 0x%08x\n", physical_addr);
-         return 0;
-    }
-
-    // DMA Region (Unlikely 16-bit reads)
-     if (physical_addr >= DMA_START && physical_addr <= DMA_END) {
-        fprintf(stderr, "Warning: Unhandled DMA read16 at 0x%08x\n", physical_addr);
-        return 0;
-    }
-
     // Expansion 1 Region
     if (physical_addr >= EXPANSION_1_START && physical_addr <= EXPANSION_1_END) {
-         printf("~ Read16 from Expansion 1 region: Address 0x%08x (Returning 0xFFFF)\n", physical_addr);
+         LOG_TRACE(LOG_BUS, "~ Read16 from Expansion 1 region: Address 0x%08x (Returning 0xFFFF)\n", physical_addr);
          return 0xFFFF; // Expansion 1 returns all Fs when empty
     }
 
 
-    fprintf(stderr, "Unhandled physical memory read16 at address: 0x%08x (Mapped from 0x%08x)\n", physical_addr, address);
+    LOG_ERROR(LOG_BUS, "Unhandled physical memory read16 at address: 0x%08x (Mapped from 0x%08x)\n", physical_addr, address);
     return 0;
 }
 
@@ -282,20 +515,27 @@ uint16_t interconnect_load16(Interconnect* inter, uint32_t address) {
  * @param address Virtual address to read from.
  * @return The 8-bit value read.
  */
-uint8_t interconnect_load8(Interconnect* inter, uint32_t address) {
+static uint8_t interconnect_load8_untraced(Interconnect* inter, uint32_t address) {
     uint32_t physical_addr = mask_region(address);
 
-    // --- Check Timer Range --- <<< ADD THIS BLOCK
-    if (physical_addr >= TIMERS_START && physical_addr <= TIMERS_END) {
-        // 8-bit reads from timers are generally undefined or read partial registers.
-        fprintf(stderr, "Warning: Unhandled 8-bit read from Timer range: 0x%08x\n", physical_addr);
-        return 0; // Return 0 for safety
+    // --- Scratchpad: KUSEG/KSEG0 only (the KSEG1 alias falls through as unmapped) ---
+    uint8_t* scratch = interconnect_scratchpad_ptr(inter->scratchpad, address);
+    if (scratch) {
+        return *scratch;
     }
-    // CDROM Registers (Example)
-    if (physical_addr >= 0x1f801800 && physical_addr <= 0x1f801803) {
-        // printf("~ Read8 from CDROM Reg (0x%08x): Returning 0 (Placeholder)\n", physical_addr); // Often noisy
-        // TODO: Implement proper CDROM status/response reads
-        return 0; // Placeholder response
+
+    // --- Fastmem: RAM (+mirrors) and BIOS pages resolve straight to host memory ---
+    uint8_t* host = interconnect_fastmem_ptr(inter->fastmem_read, physical_addr);
+    if (host) {
+        return *host;
+    }
+
+    // --- Hardware Registers: one table lookup for the whole I/O window ---
+    const IoSlot* io = interconnect_io_slot(inter, physical_addr);
+    if (io) {
+        if (io->handler->read8) return io->handler->read8(io->device, physical_addr - io->base);
+        LOG_WARN(LOG_BUS, "Warning: Unhandled %s read8 at 0x%08x\n", io->handler->name, physical_addr);
+        return 0;
     }
 
     // Expansion 1 Region
@@ -305,6 +545,8 @@ uint8_t interconnect_load8(Interconnect* inter, uint32_t address) {
          return 0xFF;
      }
 
+    // --- Memory Regions (only reached here while fastmem is bypassed) ---
+
     // BIOS Region
      if (physical_addr >= BIOS_START && physical_addr <= BIOS_END) {
         uint32_t offset = physical_addr - BIOS_START;
@@ -313,20 +555,18 @@ uint8_t interconnect_load8(Interconnect* inter, uint32_t address) {
              // printf("~ Read8 from BIOS: Addr=0x%08x Offset=0x%x\n", physical_addr, offset); // Noisy
              return inter->bios->data[offset];
         } else {
-             fprintf(stderr, "BIOS Load8 out of bounds: offset 0x%x\n", offset);
+             LOG_ERROR(LOG_BUS, "BIOS Load8 out of bounds: offset 0x%x\n", offset);
              return 0; // Error
         }
     }
 
     // Main RAM Region
-    if (physical_addr <= RAM_END) {
+    if (physical_addr <= RAM_MIRROR_END) {
         // printf("~ Read8 from RAM: Addr=0x%08x\n", physical_addr); // Very noisy
-        return ram_load8(inter->ram, physical_addr);
+        return ram_load8(inter->ram, physical_addr & (RAM_SIZE - 1));
     }
 
-    // Other regions (SPU, Timers, GPU, DMA, Exp2, MemCtrl) are less likely for 8-bit reads
-
-    fprintf(stderr, "Unhandled physical memory read8 at address: 0x%08x (Mapped from 0x%08x)\n", physical_addr, address);
+    LOG_ERROR(LOG_BUS, "Unhandled physical memory read8 at address: 0x%08x (Mapped from 0x%08x)\n", physical_addr, address);
     return 0;
 }
 
@@ -339,141 +579,72 @@ uint8_t interconnect_load8(Interconnect* inter, uint32_t address) {
  * @param address Virtual address to write to.
  * @param value The 32-bit value to write.
  */
-void interconnect_store32(Interconnect* inter, uint32_t address, uint32_t value) {
+static void interconnect_store32_untraced(Interconnect* inter, uint32_t address, uint32_t value) {
     // Check alignment
     if (address % 4 != 0) {
         // TODO: Trigger Address Error Store exception
-        fprintf(stderr, "Unaligned store32 address: 0x%08x = 0x%08x\n", address, value);
+        LOG_ERROR(LOG_BUS, "Unaligned store32 address: 0x%08x = 0x%08x\n", address, value);
         return;
     }
 
     uint32_t physical_addr = mask_region(address);
 
-
-    // --- Check Timer Range --- <<< ADD THIS BLOCK
-    if (physical_addr >= TIMERS_START && physical_addr <= TIMERS_END) {
-        uint32_t timer_base_offset = physical_addr - TIMERS_START;
-        int timer_index = timer_base_offset / 0x10;
-        uint32_t register_offset = physical_addr & 0xF;
-
-        // printf("~ Write32 to Timer %d Offset 0x%x = 0x%08x\n", timer_index, register_offset, value);
-        timer_write32(&inter->timers_state, timer_index, register_offset, value);
-        return; // Handled
+    // --- Scratchpad: KUSEG/KSEG0 only (the KSEG1 alias falls through as unmapped) ---
+    uint8_t* scratch = interconnect_scratchpad_ptr(inter->scratchpad, address);
+    if (scratch) {
+        memcpy(scratch, &value, 4);
+        return;
     }
-    // --- Hardware Register Checks (Specific Addresses First) ---
 
-    // Interrupt Controller Registers
-    if (physical_addr == IRQ_STATUS_ADDR) { // 0x1f801070 (I_STAT)
-        // Writing acknowledges (clears) specified interrupt flags
-        uint16_t ack_mask = (uint16_t)(value & 0x7FF); // Only bits 0-10 matter
-        inter->irq_status &= ~ack_mask; // Clear bits that are set in value
-        printf("~ Write32 to IRQ_STATUS (Ack): Value=0x%08x -> I_STAT=0x%04x\n", value, inter->irq_status);
+    // --- Fastmem: RAM (+mirrors) and BIOS pages resolve straight to host memory ---
+    uint8_t* host = interconnect_fastmem_ptr(inter->fastmem_write, physical_addr);
+    if (host) {
+        memcpy(host, &value, 4);
+        interconnect_note_ram_write(inter, physical_addr);
         return;
     }
-    if (physical_addr == IRQ_MASK_ADDR) { // 0x1f801074 (I_MASK)
-        // Writing sets the interrupt mask
-        inter->irq_mask = (uint16_t)(value & 0x7FF); // Only bits 0-10 matter
-        printf("~ Write32 to IRQ_MASK: Value=0x%08x -> I_MASK=0x%04x\n", value, inter->irq_mask);
+
+    // --- Hardware Registers: one table lookup for the whole I/O window ---
+    const IoSlot* io = interconnect_io_slot(inter, physical_addr);
+    if (io) {
+        if (io->handler->write32) io->handler->write32(io->device, physical_addr - io->base, value);
+        else LOG_WARN(LOG_BUS, "Warning: Unhandled %s write32 at 0x%08x = 0x%08x\n", io->handler->name, physical_addr, value);
         return;
     }
 
     // Cache Control (KSEG2)
     if (physical_addr == CACHE_CONTROL_ADDR) {
-        printf("~ Write32 to CACHE_CONTROL register (0x%08x) = 0x%08x (Ignoring)\n", physical_addr, value);
+        LOG_TRACE(LOG_BUS, "~ Write32 to CACHE_CONTROL register (0x%08x) = 0x%08x (Ignoring)\n", physical_addr, value);
         // Cache not implemented yet
         return;
     }
 
-    // GPU Registers
-    if (physical_addr == GPU_GP0_ADDR) { // 0x1f801810 (Write = GP0)
-        // printf("~ Write32 GP0 = 0x%08x\n", value); // Can be noisy
-        gpu_gp0(&inter->gpu, value); // Delegate to GPU module
-        return;
-    }
-    if (physical_addr == GPU_GP1_ADDR) { // 0x1f801814 (Write = GP1)
-        // printf("~ Write32 GP1 = 0x%08x\n", value); // Can be noisy
-        gpu_gp1(&inter->gpu, value); // Delegate to GPU module
-        return;
-    }
-
-
-    // --- Region Checks (Broader Ranges) ---
-
-    // DMA Region
-    if (physical_addr >= DMA_START && physical_addr <= DMA_END) {
-        uint32_t offset = physical_addr - DMA_START;
-        printf("~ Write32 to DMA region: Addr=0x%08x Offset=0x%x = 0x%08x\n", physical_addr, offset, value);
-        bool channel_became_active = dma_write(&inter->dma, offset, value); // Delegate
-
-        // If the write activated a channel control register, start the DMA transfer
-        if (channel_became_active) {
-             uint32_t channel_index = (offset >> 4) & 0x7;
-             printf("  DMA Channel %d activated by write to offset 0x%x.\n", channel_index, offset);
-             interconnect_perform_dma(inter, channel_index);
-        }
-        return;
-    }
-
-    // Memory Control Region (Includes IRQ regs handled above, RAM_SIZE reg)
-    if (physical_addr >= MEM_CONTROL_START && physical_addr <= MEM_CONTROL_END) {
-        // Handle specific MemCtrl writes, ignore others silently for now
-        switch (physical_addr) {
-            case EXPANSION_1_BASE_ADDR: // 0x1f801000
-                if (value != 0x1f000000) fprintf(stderr, "Warning: Bad Expansion 1 base address write: 0x%08x\n", value);
-                else printf("~ Write32 to EXP1_BASE_ADDR = 0x%08x\n", value);
-                break;
-            case EXPANSION_2_BASE_ADDR: // 0x1f801004
-                 if (value != 0x1f802000) fprintf(stderr, "Warning: Bad Expansion 2 base address write: 0x%08x\n", value);
-                 else printf("~ Write32 to EXP2_BASE_ADDR = 0x%08x\n", value);
-                break;
-            case RAM_SIZE_ADDR: // 0x1f801060
-                printf("~ Write32 to RAM_SIZE register (0x1f801060) = 0x%08x (Ignoring)\n", value);
-                break;
-            // IRQ regs handled above
-            default:
-                printf("~ Write32 to Unknown MEM_CONTROL addr 0x%08x = 0x%08x (Ignoring)\n", physical_addr, value);
-                break;
-        }
-        return;
-    }
-
-    // Timer Region
-    if (physical_addr >= TIMERS_START && physical_addr <= TIMERS_END) {
-         printf("~ Write32 to TIMERS region: Addr 0x%08x = 0x%08x (Ignoring)\n", physical_addr, value);
-         // TODO: Implement Timer register writes
-         return;
-    }
-
-    // SPU Region
-    if (physical_addr >= SPU_START && physical_addr <= SPU_END) {
-         // printf("~ Write32 to SPU region: Address 0x%08x = 0x%08x (Ignoring)\n", physical_addr, value); // Noisy
-         return; // SPU not implemented
-    }
+    // --- Memory Regions (only reached here while fastmem is bypassed) ---
 
     // Main RAM Region
-    if (physical_addr <= RAM_END) {
+    if (physical_addr <= RAM_MIRROR_END) {
         // printf("~ Write32 to RAM region: Addr=0x%08x = 0x%08x\n", physical_addr, value); // Very noisy
-        ram_store32(inter->ram, physical_addr, value); // Delegate
+        ram_store32(inter->ram, physical_addr & (RAM_SIZE - 1), value); // Delegate
+        interconnect_note_ram_write(inter, physical_addr); // Keep the CPU block cache coherent
         return;
     }
 
     // BIOS Region (Read-Only)
     if (physical_addr >= BIOS_START && physical_addr <= BIOS_END) {
-        fprintf(stderr, "Error: Write attempt to BIOS ROM at address: 0x%08x = 0x%08x\n",
+        LOG_ERROR(LOG_BUS, "Error: Write attempt to BIOS ROM at address: 0x%08x = 0x%08x\n",
                 physical_addr, value);
         return; // Writes to BIOS are ignored/prohibited
     }
 
-    // Expansion Regions (Generally ignored)
-    if ((physical_addr >= EXPANSION_1_START && physical_addr <= EXPANSION_1_END) ||
-        (physical_addr >= EXPANSION_2_START && physical_addr <= EXPANSION_2_END)) {
-        printf("~ Write32 to Expansion region: Address 0x%08x = 0x%08x (Ignoring)\n", physical_addr, value);
+    // Expansion 1 Region (Generally ignored)
+    if (physical_addr >= EXPANSION_1_START && physical_addr <= EXPANSION_1_END) {
+        LOG_TRACE(LOG_BUS, "~ Write32 to Expansion region: Address 0x%08x = 0x%08x (Ignoring)\n", physical_addr, value);
         return;
     }
 
 
     // --- Fallback ---
-    fprintf(stderr, "Unhandled physical memory write32 at address: 0x%08x = 0x%08x (Mapped from 0x%08x)\n",
+    LOG_ERROR(LOG_BUS, "Unhandled physical memory write32 at address: 0x%08x = 0x%08x (Mapped from 0x%08x)\n",
             physical_addr, value, address);
 }
 
@@ -483,92 +654,63 @@ void interconnect_store32(Interconnect* inter, uint32_t address, uint32_t value)
  * @param address Virtual address to write to.
  * @param value The 16-bit value to write.
  */
-void interconnect_store16(Interconnect* inter, uint32_t address, uint16_t value) {
+static void interconnect_store16_untraced(Interconnect* inter, uint32_t address, uint16_t value) {
     // Check alignment
     if (address % 2 != 0) {
         // TODO: Trigger Address Error Store exception
-        fprintf(stderr, "Unaligned store16 address: 0x%08x = 0x%04x\n", address, value);
+        LOG_ERROR(LOG_BUS, "Unaligned store16 address: 0x%08x = 0x%04x\n", address, value);
         return;
     }
     uint32_t physical_addr = mask_region(address);
 
-    // --- Check Timer Range --- <<< ADD THIS BLOCK
-    if (physical_addr >= TIMERS_START && physical_addr <= TIMERS_END) {
-        uint32_t timer_base_offset = physical_addr - TIMERS_START;
-        int timer_index = timer_base_offset / 0x10;
-        uint32_t register_offset = physical_addr & 0xF;
-
-        // printf("~ Write16 to Timer %d Offset 0x%x = 0x%04x\n", timer_index, register_offset, value);
-        timer_write16(&inter->timers_state, timer_index, register_offset, value);
-        return; // Handled
-     }
-    // Interrupt Controller Registers
-    if (physical_addr == IRQ_STATUS_ADDR) { // 0x1f801070 (I_STAT)
-        uint16_t ack_mask = value & 0x7FF;
-        inter->irq_status &= ~ack_mask;
-        printf("~ Write16 to IRQ_STATUS (Ack): Value=0x%04x -> I_STAT=0x%04x\n", value, inter->irq_status);
+    // --- Scratchpad: KUSEG/KSEG0 only (the KSEG1 alias falls through as unmapped) ---
+    uint8_t* scratch = interconnect_scratchpad_ptr(inter->scratchpad, address);
+    if (scratch) {
+        memcpy(scratch, &value, 2);
         return;
     }
-     if (physical_addr == IRQ_MASK_ADDR) { // 0x1f801074 (I_MASK)
-        inter->irq_mask = value & 0x7FF;
-        printf("~ Write16 to IRQ_MASK: Value=0x%04x -> I_MASK=0x%04x\n", value, inter->irq_mask);
+
+    // --- Fastmem: RAM (+mirrors) and BIOS pages resolve straight to host memory ---
+    uint8_t* host = interconnect_fastmem_ptr(inter->fastmem_write, physical_addr);
+    if (host) {
+        memcpy(host, &value, 2);
+        interconnect_note_ram_write(inter, physical_addr);
         return;
-     }
+    }
 
-    // SPU Region
-    if (physical_addr >= SPU_START && physical_addr <= SPU_END) {
-         // printf("~ Write16 to SPU region: Address 0x%08x = 0x%04x (Ignoring)\n", physical_addr, value); // Noisy
-         return; // SPU not implemented
+    // --- Hardware Registers: one table lookup for the whole I/O window ---
+    const IoSlot* io = interconnect_io_slot(inter, physical_addr);
+    if (io) {
+        if (io->handler->write16) io->handler->write16(io->device, physical_addr - io->base, value);
+        else LOG_WARN(LOG_BUS, "Warning: Unhandled %s write16 at 0x%08x = 0x%04x\n", io->handler->name, physical_addr, value);
+        return;
     }
 
-    // Timer Region
-     if (physical_addr >= TIMERS_START && physical_addr <= TIMERS_END) {
-         printf("~ Write16 to TIMERS region: Addr 0x%08x = 0x%04x (Ignoring)\n", physical_addr, value);
-         // TODO: Implement Timer register writes (Mode, Target are 16-bit)
-         return;
-     }
+    // --- Memory Regions (only reached here while fastmem is bypassed) ---
 
     // Main RAM Region
-    if (physical_addr <= RAM_END) {
+    if (physical_addr <= RAM_MIRROR_END) {
         // printf("~ Write16 to RAM region: Addr=0x%08x = 0x%04x\n", physical_addr, value); // Noisy
-        ram_store16(inter->ram, physical_addr, value); // Delegate
+        ram_store16(inter->ram, physical_addr & (RAM_SIZE - 1), value); // Delegate
+        interconnect_note_ram_write(inter, physical_addr); // Keep the CPU block cache coherent
         return;
     }
 
-    // Memory Control Region (General - unlikely 16-bit writes)
-     if (physical_addr >= MEM_CONTROL_START && physical_addr <= MEM_CONTROL_END) {
-         printf("~ Write16 to MEM_CONTROL region: Addr 0x%08x = 0x%04x (Ignoring)\n", physical_addr, value);
-         return;
-     }
-
     // BIOS Region (Read-Only)
     if (physical_addr >= BIOS_START && physical_addr <= BIOS_END) {
-        fprintf(stderr, "Error: Write16 attempt to BIOS ROM at address: 0x%08x = 0x%04x\n",
+        LOG_ERROR(LOG_BUS, "Error: Write16 attempt to BIOS ROM at address: 0x%08x = 0x%04x\n",
                 physical_addr, value);
         return;
     }
 
-    // GPU Region (Unlikely 16-bit writes)
-    if (physical_addr >= GPU_START && physical_addr <= GPU_END) {
-         fprintf(stderr, "Warning: Unhandled GPU write16 at 0x%08x = 0x%04x\n", physical_addr, value);
-         return;
-    }
-
-    // DMA Region (Unlikely 16-bit writes)
-     if (physical_addr >= DMA_START && physical_addr <= DMA_END) {
-        fprintf(stderr, "Warning: Unhandled DMA write16 at 0x%08x = 0x%04x\n", physical_addr, value);
-        return;
-    }
-
-    // Expansion Regions
-    if ((physical_addr >= EXPANSION_1_START && physical_addr <= EXPANSION_1_END) ||
-        (physical_addr >= EXPANSION_2_START && physical_addr <= EXPANSION_2_END)) {
-        printf("~ Write16 to Expansion region: Address 0x%08x = 0x%04x (Ignoring)\n", physical_addr, value);
+    // Expansion 1 Region
+    if (physical_addr >= EXPANSION_1_START && physical_addr <= EXPANSION_1_END) {
+        LOG_TRACE(LOG_BUS, "~ Write16 to Expansion region: Address 0x%08x = 0x%04x (Ignoring)\n", physical_addr, value);
         return;
     }
 
     // --- Fallback ---
-    fprintf(stderr, "Unhandled physical memory write16 at address: 0x%08x = 0x%04x (Mapped from 0x%08x)\n",
+    LOG_ERROR(LOG_BUS, "Unhandled physical memory write16 at address: 0x%08x = 0x%04x (Mapped from 0x%08x)\n",
             physical_addr, value, address);
 }
 
@@ -578,66 +720,98 @@ void interconnect_store16(Interconnect* inter, uint32_t address, uint16_t value)
  * @param address Virtual address to write to.
  * @param value The 8-bit value to write.
  */
-void interconnect_store8(Interconnect* inter, uint32_t address, uint8_t value) {
+static void interconnect_store8_untraced(Interconnect* inter, uint32_t address, uint8_t value) {
     uint32_t physical_addr = mask_region(address);
 
-    // --- Check Timer Range --- <<< ADD THIS BLOCK
-    if (physical_addr >= TIMERS_START && physical_addr <= TIMERS_END) {
-        // 8-bit writes to timers are generally undefined or write partial registers.
-        fprintf(stderr, "Warning: Unhandled 8-bit write to Timer range: 0x%08x = 0x%02x\n", physical_addr, value);
-        // Ignoring is safest for now.
+    // --- Scratchpad: KUSEG/KSEG0 only (the KSEG1 alias falls through as unmapped) ---
+    uint8_t* scratch = interconnect_scratchpad_ptr(inter->scratchpad, address);
+    if (scratch) {
+        *scratch = value;
         return;
     }
-    // CDROM Registers
-    if (physical_addr >= 0x1f801800 && physical_addr <= 0x1f801803) {
-        printf("~ Write8 to CDROM Reg (0x%08x) = 0x%02x (Ignoring)\n", physical_addr, value);
-        // TODO: Implement CDROM register writes
+
+    // --- Fastmem: RAM (+mirrors) and BIOS pages resolve straight to host memory ---
+    uint8_t* host = interconnect_fastmem_ptr(inter->fastmem_write, physical_addr);
+    if (host) {
+        *host = value;
+        interconnect_note_ram_write(inter, physical_addr);
         return;
     }
 
-     // Expansion 2 Region
-    if (physical_addr >= EXPANSION_2_START && physical_addr <= EXPANSION_2_END) {
-         // printf("~ Write8 to Expansion 2 region: 0x%08x = 0x%02x (Ignoring)\n", physical_addr, value); // Noisy
-         return; // Expansion 2 typically unused/debug
+    // --- Hardware Registers: one table lookup for the whole I/O window ---
+    const IoSlot* io = interconnect_io_slot(inter, physical_addr);
+    if (io) {
+        if (io->handler->write8) io->handler->write8(io->device, physical_addr - io->base, value);
+        else LOG_WARN(LOG_BUS, "Warning: Unhandled %s write8 at 0x%08x = 0x%02x\n", io->handler->name, physical_addr, value);
+        return;
     }
 
-    // SPU Region
-    if (physical_addr >= SPU_START && physical_addr <= SPU_END) {
-         // printf("~ Write8 to SPU region: Address 0x%08x = 0x%02x (Ignoring)\n", physical_addr, value); // Noisy
-         return; // SPU not implemented
-    }
+    // --- Memory Regions (only reached here while fastmem is bypassed) ---
 
-     // Main RAM Region
-    if (physical_addr <= RAM_END) {
+    // Main RAM Region
+    if (physical_addr <= RAM_MIRROR_END) {
         // printf("~ Write8 to RAM: Addr=0x%08x = 0x%02x\n", physical_addr, value); // Very noisy
-        ram_store8(inter->ram, physical_addr, value); // Delegate
+        ram_store8(inter->ram, physical_addr & (RAM_SIZE - 1), value); // Delegate
+        interconnect_note_ram_write(inter, physical_addr); // Keep the CPU block cache coherent
         return;
     }
 
-    // Memory Control Region
-    if (physical_addr >= MEM_CONTROL_START && physical_addr <= MEM_CONTROL_END) {
-         printf("~ Write8 to MEM_CONTROL region: 0x%08x = 0x%02x (Ignoring)\n", physical_addr, value);
-         return; // Unlikely target for 8-bit writes
-    }
-
     // BIOS Region (Read-Only)
     if (physical_addr >= BIOS_START && physical_addr <= BIOS_END) {
-        fprintf(stderr, "Error: Write8 attempt to BIOS ROM at address: 0x%08x = 0x%02x\n", physical_addr, value);
+        LOG_ERROR(LOG_BUS, "Error: Write8 attempt to BIOS ROM at address: 0x%08x = 0x%02x\n", physical_addr, value);
         return;
     }
 
     // Expansion 1 Region
     if (physical_addr >= EXPANSION_1_START && physical_addr <= EXPANSION_1_END) {
-        printf("~ Write8 to Expansion 1 region: Address 0x%08x = 0x%02x (Ignoring)\n", physical_addr, value);
+        LOG_TRACE(LOG_BUS, "~ Write8 to Expansion 1 region: Address 0x%08x = 0x%02x (Ignoring)\n", physical_addr, value);
         return;
     }
 
     // --- Fallback ---
-    fprintf(stderr, "Unhandled physical memory write8 at address: 0x%08x = 0x%02x (Mapped from 0x%08x)\n",
+    LOG_ERROR(LOG_BUS, "Unhandled physical memory write8 at address: 0x%08x = 0x%02x (Mapped from 0x%08x)\n",
             physical_addr, value, address);
 }
 
 
+// --- Bus Entry Points ---
+// Public load/store functions: the untraced handlers above plus the bus trace hook.
+// DMA transfers use the untraced handlers directly (they are traced as one DMA start).
+
+uint32_t interconnect_load32(Interconnect* inter, uint32_t address) {
+    uint32_t value = interconnect_load32_untraced(inter, address);
+    if (trace_on(TRACE_BUS)) trace_bus(false, address, 4, value);
+    return value;
+}
+
+uint16_t interconnect_load16(Interconnect* inter, uint32_t address) {
+    uint16_t value = interconnect_load16_untraced(inter, address);
+    if (trace_on(TRACE_BUS)) trace_bus(false, address, 2, value);
+    return value;
+}
+
+uint8_t interconnect_load8(Interconnect* inter, uint32_t address) {
+    uint8_t value = interconnect_load8_untraced(inter, address);
+    if (trace_on(TRACE_BUS)) trace_bus(false, address, 1, value);
+    return value;
+}
+
+void interconnect_store32(Interconnect* inter, uint32_t address, uint32_t value) {
+    if (trace_on(TRACE_BUS)) trace_bus(true, address, 4, value);
+    interconnect_store32_untraced(inter, address, value);
+}
+
+void interconnect_store16(Interconnect* inter, uint32_t address, uint16_t value) {
+    if (trace_on(TRACE_BUS)) trace_bus(true, address, 2, value);
+    interconnect_store16_untraced(inter, address, value);
+}
+
+void interconnect_store8(Interconnect* inter, uint32_t address, uint8_t value) {
+    if (trace_on(TRACE_BUS)) trace_bus(true, address, 1, value);
+    interconnect_store8_untraced(inter, address, value);
+}
+
+
 // --- DMA Transfer Logic ---
 // (Based on Guide Section 3.7, 3.8, 3.9, 3.10)
 
@@ -655,7 +829,7 @@ static uint32_t dma_get_transfer_size_words(DmaChannel* ch) {
     // In Request mode (Sync=1), size is BlockCount * BlockSize
     uint32_t bc = (uint32_t)ch->block_count;
     if (bs == 0 || bc == 0) {
-        fprintf(stderr, "Warning: DMA Request sync with zero size/count (BS=%u, BC=%u)\n", bs, bc);
+        LOG_WARN(LOG_DMA, "Warning: DMA Request sync with zero size/count (BS=%u, BC=%u)\n", bs, bc);
         return 0; // Invalid size for Request mode
     }
     return bs * bc;
@@ -670,69 +844,87 @@ static uint32_t dma_get_transfer_size_words(DmaChannel* ch) {
  */
 static void interconnect_perform_dma(Interconnect* inter, uint32_t channel_index) {
     if (channel_index >= 7) {
-        fprintf(stderr, "Error: interconnect_perform_dma called with invalid channel index %u\n", channel_index);
+        LOG_ERROR(LOG_DMA, "Error: interconnect_perform_dma called with invalid channel index %u\n", channel_index);
         return;
     }
 
-    printf("--- Starting DMA Transfer for Channel %d ---\n", channel_index);
+    // A restart while the previous transfer is still "in flight" completes that one first
+    SchedulerEvent done_event = (SchedulerEvent)(SCHED_EVENT_DMA0 + channel_index);
+    if (scheduler_is_pending(&inter->scheduler, done_event)) {
+        scheduler_cancel(&inter->scheduler, done_event);
+        interconnect_dma_event(inter, done_event);
+    }
+
+    LOG_DEBUG(LOG_DMA, "--- Starting DMA Transfer for Channel %d ---\n", channel_index);
     DmaChannel* ch = &inter->dma.channels[channel_index];
+    if (trace_on(TRACE_DMA)) {
+        uint32_t block_control = ((uint32_t)ch->block_count << 16) | ch->block_size;
+        trace_dma_start(channel_index, (uint32_t)ch->sync | ((uint32_t)ch->direction << 4), ch->base_addr, block_control);
+    }
     DmaSync sync_mode = ch->sync;
+    uint32_t words_moved = 0; // Transfer time estimate: one word per CPU cycle
 
     switch (sync_mode) {
         case LINKED_LIST:
             // Primarily used for GPU Channel 2
             if (channel_index == 2 && ch->direction == FROM_RAM) {
                 uint32_t addr = ch->base_addr & 0x00FFFFFC; // Start address from MADR
-                printf("DMA GPU Linked List: Starting at 0x%08x\n", addr);
+                LOG_DEBUG(LOG_DMA, "DMA GPU Linked List: Starting at 0x%08x\n", addr);
                 while(1) {
                     // Check address bounds before reading header
                     if (addr >= RAM_SIZE) {
-                        fprintf(stderr, "DMA GPU LL Error: Header address 0x%08x out of RAM bounds.\n", addr);
+                        LOG_ERROR(LOG_DMA, "DMA GPU LL Error: Header address 0x%08x out of RAM bounds.\n", addr);
                         break;
                     }
                     // Read header: size in high byte, next address in low 24 bits
-                    uint32_t header = interconnect_load32(inter, addr); // Use interconnect load
+                    uint32_t header = interconnect_load32_untraced(inter, addr); // Use interconnect load
+                    words_moved++;
                     uint32_t num_words = header >> 24;
                     uint32_t next_addr = header & 0x00FFFFFC; // Mask to word boundary
                     // printf("  LL Header @ 0x%08x: Value=0x%08x, Size=%u words, Next=0x%08x\n", addr, header, num_words, next_addr); // Debug
 
-                    // Transfer packet words (if any)
-                    if (num_words > 0) {
+                    // Transfer packet words (if any): a packet inside RAM goes to GP0 in one call
+                    if (DMA_BULK_RAM_WORDS && num_words > 0 && addr + 4 * (num_words + 1) <= RAM_SIZE) {
+                        gpu_gp0_block(&inter->gpu, (const uint32_t*)(inter->ram->data + addr + 4), num_words);
+                        addr += 4 * num_words;
+                        words_moved += num_words;
+                    } else if (num_words > 0) {
                          for (uint32_t i = 0; i < num_words; ++i) {
                             addr = (addr + 4) & 0x00FFFFFC; // Advance address for command word
                             if (addr >= RAM_SIZE) { // Check bounds before reading command
-                                fprintf(stderr, "DMA GPU LL Error: Command address 0x%08x out of RAM bounds.\n", addr);
+                                LOG_ERROR(LOG_DMA, "DMA GPU LL Error: Command address 0x%08x out of RAM bounds.\n", addr);
                                 next_addr = 0xFFFFFF; // Force stop after this packet
                                 break; // Exit inner loop
                             }
-                            uint32_t command_word = interconnect_load32(inter, addr); // Read command
+                            uint32_t command_word = interconnect_load32_untraced(inter, addr); // Read command
                             gpu_gp0(&inter->gpu, command_word); // Send command to GPU GP0 port
+                            words_moved++;
                         }
                         if (next_addr == 0xFFFFFF) break; // Break outer loop if error occurred
                     }
 
                     // Check for end-of-list marker (Top bit of next_addr usually, or 0xFFFFFF) [cite: 1808]
                     if ((header & 0x800000) != 0) { // Check MSB of address field as per Mednafen comment
-                        printf("DMA GPU Linked List: End marker (0x800000) found in header 0x%08x.\n", header);
+                        LOG_DEBUG(LOG_DMA, "DMA GPU Linked List: End marker (0x800000) found in header 0x%08x.\n", header);
                         break;
                     }
                     // Check for explicit 0xFFFFFF marker (safer)
                     if (next_addr == 0xFFFFFF) {
-                        printf("DMA GPU Linked List: End marker (0xFFFFFF) found.\n");
+                        LOG_DEBUG(LOG_DMA, "DMA GPU Linked List: End marker (0xFFFFFF) found.\n");
                          break;
                     }
 
                     // Check next address validity before proceeding
                      if (next_addr >= RAM_SIZE) {
-                         fprintf(stderr, "DMA GPU LL Error: Next header address 0x%08x out of RAM bounds.\n", next_addr);
+                         LOG_ERROR(LOG_DMA, "DMA GPU LL Error: Next header address 0x%08x out of RAM bounds.\n", next_addr);
                          break;
                      }
                     // Move to the next header address
                     addr = next_addr;
                 }
-                printf("DMA GPU Linked List: Finished.\n");
+                LOG_DEBUG(LOG_DMA, "DMA GPU Linked List: Finished.\n");
             } else {
-                 fprintf(stderr, "Error: Linked List DMA mode attempted on unsupported channel (%d) or direction (%d).\n", channel_index, ch->direction);
+                 LOG_ERROR(LOG_DMA, "Error: Linked List DMA mode attempted on unsupported channel (%d) or direction (%d).\n", channel_index, ch->direction);
             }
             break;
 
@@ -741,34 +933,70 @@ static void interconnect_perform_dma(Interconnect* inter, uint32_t channel_index
             {
                 uint32_t words_to_transfer = dma_get_transfer_size_words(ch);
                 if (words_to_transfer == 0) {
-                    printf("Warning: DMA Block/Request transfer started with zero size for channel %d.\n", channel_index);
+                    LOG_WARN(LOG_DMA, "Warning: DMA Block/Request transfer started with zero size for channel %d.\n", channel_index);
                     break; // Nothing to do
                 }
 
                 uint32_t addr = ch->base_addr & 0x00FFFFFC; // Start address
                 int32_t step = (ch->step == INCREMENT) ? 4 : -4;
-                printf("DMA Block/Request: Chan=%d, Dir=%s, Sync=%s, Step=%d, Addr=0x%08x, Size=%u words\n",
+                LOG_DEBUG(LOG_DMA, "DMA Block/Request: Chan=%d, Dir=%s, Sync=%s, Step=%d, Addr=0x%08x, Size=%u words\n",
                        channel_index, (ch->direction == FROM_RAM ? "FROM_RAM" : "TO_RAM"),
                        (sync_mode == MANUAL ? "MANUAL" : "REQUEST"), step, addr, words_to_transfer);
 
+                if (DMA_BULK_RAM_WORDS && channel_index == 2 && ch->direction == FROM_RAM && step > 0) {
+                    // RAM -> GPU (image uploads): hand GP0 whole runs of RAM, split where the address wraps
+                    uint32_t done = 0;
+                    while (done < words_to_transfer) {
+                        uint32_t current_addr_masked = addr & 0x001FFFFC;
+                        uint32_t run = (RAM_SIZE - current_addr_masked) / 4;
+                        if (run > words_to_transfer - done) run = words_to_transfer - done;
+                        gpu_gp0_block(&inter->gpu, (const uint32_t*)(inter->ram->data + current_addr_masked), run);
+                        addr += run * 4;
+                        done += run;
+                    }
+                    words_moved += words_to_transfer;
+                    LOG_DEBUG(LOG_DMA, "DMA Block/Request: Finished transfer for channel %d.\n", channel_index);
+                    break;
+                }
+
+                if (DMA_BULK_RAM_WORDS && channel_index == 2 && ch->direction == TO_RAM && step > 0) {
+                    // GPU -> RAM (GP0(C0) readback): GPUREAD packs whole runs straight into RAM
+                    uint32_t done = 0;
+                    while (done < words_to_transfer) {
+                        uint32_t current_addr_masked = addr & 0x001FFFFC;
+                        uint32_t run = (RAM_SIZE - current_addr_masked) / 4;
+                        if (run > words_to_transfer - done) run = words_to_transfer - done;
+                        gpu_read_data_block(&inter->gpu, (uint32_t*)(inter->ram->data + current_addr_masked), run);
+                        uint32_t last_page = (current_addr_masked + run * 4 - 1) >> CODE_PAGE_SHIFT;
+                        for (uint32_t page = current_addr_masked >> CODE_PAGE_SHIFT; page <= last_page; ++page) {
+                            interconnect_note_ram_write(inter, page << CODE_PAGE_SHIFT);
+                        }
+                        addr += run * 4;
+                        done += run;
+                    }
+                    words_moved += words_to_transfer;
+                    LOG_DEBUG(LOG_DMA, "DMA Block/Request: Finished transfer for channel %d.\n", channel_index);
+                    break;
+                }
+
                 for (uint32_t i = 0; i < words_to_transfer; ++i) {
                     // Ensure address stays within RAM bounds (mask low bits, check high bits)
                     uint32_t current_addr_masked = addr & 0x001FFFFC; // Mask address to stay within 2MB and word aligned
                     if (current_addr_masked >= RAM_SIZE) {
-                         fprintf(stderr, "DMA Block Error: Address 0x%08x (masked 0x%08x) out of RAM bounds on channel %d.\n", addr, current_addr_masked, channel_index);
+                         LOG_ERROR(LOG_DMA, "DMA Block Error: Address 0x%08x (masked 0x%08x) out of RAM bounds on channel %d.\n", addr, current_addr_masked, channel_index);
                          break; // Stop transfer if address goes out of bounds
                     }
 
                     if (ch->direction == FROM_RAM) {
                         // RAM -> Peripheral
-                        uint32_t data_word = interconnect_load32(inter, current_addr_masked); // Read from RAM
+                        uint32_t data_word = interconnect_load32_untraced(inter, current_addr_masked); // Read from RAM
                         switch (channel_index) {
                             case 2: // GPU
                                 gpu_gp0(&inter->gpu, data_word); // Send data word to GP0 (for Image Load etc.)
                                 break;
                             // Add cases for other peripherals (CDROM, SPU, MDEC) here
                             default:
-                                printf("Warning: Unhandled DMA Block FROM_RAM transfer for channel %d, Addr=0x%08x, Data=0x%08x\n",
+                                LOG_WARN(LOG_DMA, "Warning: Unhandled DMA Block FROM_RAM transfer for channel %d, Addr=0x%08x, Data=0x%08x\n",
                                        channel_index, current_addr_masked, data_word);
                                 break;
                         }
@@ -776,6 +1004,9 @@ static void interconnect_perform_dma(Interconnect* inter, uint32_t channel_index
                         // Peripheral -> RAM
                         uint32_t data_word = 0; // Default value if peripheral not handled
                         switch (channel_index) {
+                            case 2: // GPU (GPUREAD) - bulk path above unless decrementing or big-endian
+                                data_word = gpu_read_data(&inter->gpu);
+                                break;
                             case 6: // OTC - Ordering Table Clear
                                 // Value depends on position in transfer
                                 data_word = (i == (words_to_transfer - 1)) // Is it the last word?
@@ -784,28 +1015,28 @@ static void interconnect_perform_dma(Interconnect* inter, uint32_t channel_index
                                 break;
                             // Add cases for other peripherals reading TO RAM (CDROM, SPU, MDEC)
                             default:
-                                printf("Warning: Unhandled DMA Block TO_RAM transfer for channel %d, Addr=0x%08x\n",
+                                LOG_WARN(LOG_DMA, "Warning: Unhandled DMA Block TO_RAM transfer for channel %d, Addr=0x%08x\n",
                                        channel_index, current_addr_masked);
                                 break;
                         }
-                        interconnect_store32(inter, current_addr_masked, data_word); // Write to RAM
+                        interconnect_store32_untraced(inter, current_addr_masked, data_word); // Write to RAM
                     }
 
                     // Advance address for next word
                     addr = (uint32_t)((int32_t)addr + step); // Apply step
+                    words_moved++;
                 }
-                 printf("DMA Block/Request: Finished transfer for channel %d.\n", channel_index);
+                 LOG_DEBUG(LOG_DMA, "DMA Block/Request: Finished transfer for channel %d.\n", channel_index);
             }
             break;
 
         default: // Should not happen if sync enum is correct
-            fprintf(stderr, "Error: Unknown DMA Sync mode %d encountered for channel %d.\n", sync_mode, channel_index);
+            LOG_ERROR(LOG_DMA, "Error: Unknown DMA Sync mode %d encountered for channel %d.\n", sync_mode, channel_index);
             break;
     }
 
-    // Mark the channel as finished (clears enable/trigger bits)
-    dma_channel_done(ch);
-    printf("--- Finished DMA Transfer Processing for Channel %d ---\n", channel_index);
-
-    // TODO: Trigger DMA interrupt here if enabled in DICR and channel IRQ was set
+    // The data has moved; the channel keeps reporting busy (CHCR bit 24) until the
+    // transfer time has elapsed, then interconnect_dma_event() finishes it
+    scheduler_schedule(&inter->scheduler, done_event, words_moved > 0 ? words_moved : 1);
+    LOG_DEBUG(LOG_DMA, "--- Finished DMA Transfer Processing for Channel %d (%u words) ---\n", channel_index, words_moved);
 }
\ No newline at end of file
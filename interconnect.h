@@ -3,6 +3,7 @@
 
 #include <stdint.h>       // For uint32_t, uint16_t etc.
 #include <stdbool.h>      // For bool type
+#include <string.h>       // For memcpy (fastmem accessors)
 
 // Include headers for components accessed via the interconnect
 #include "bios.h"
@@ -11,6 +12,8 @@
 #include "gpu.h"
 #include "timers.h"
 #include "cdrom.h"
+#include "fastmem.h"
+#include "scheduler.h"
 
 
 /* --- Memory Map Definitions (Physical Addresses) ---
@@ -25,6 +28,7 @@
 #define RAM_START 0x00000000
 #define RAM_SIZE  (2 * 1024 * 1024)
 #define RAM_END   (RAM_START + RAM_SIZE - 1)
+#define RAM_MIRROR_END 0x007fffff // The 2MB are mirrored four times over the first 8MB
 
 // BIOS ROM (512 Kilobytes)
 #define BIOS_START 0x1fc00000 // Physical start address
@@ -35,6 +39,9 @@
 #define SCRATCHPAD_START 0x1f800000
 #define SCRATCHPAD_SIZE  1024
 #define SCRATCHPAD_END   (SCRATCHPAD_START + SCRATCHPAD_SIZE - 1)
+// The data cache used as RAM is decoded from the virtual address: only the KUSEG and KSEG0
+// views (0x1F800000 / 0x9F800000) reach it. KSEG1 and DMA (RAM-only addresses) do not.
+#define SCRATCHPAD_VADDR_MASK 0x7FFFFC00u
 
 // Memory Control Registers (Expansion Base, RAM Size)
 #define MEM_CONTROL_START 0x1f801000
@@ -74,6 +81,11 @@
 #define GPU_GP1_ADDR     0x1f801814 // Write address for GP1 commands
 #define GPU_GPUSTAT_ADDR 0x1f801814 // Read address for GPUSTAT register
 
+// CD-ROM Controller Registers (four byte-wide ports, banked by the index register)
+#define CDROM_START 0x1f801800
+#define CDROM_SIZE  4
+#define CDROM_END   (CDROM_START + CDROM_SIZE - 1)
+
 // Expansion Region 1 (Parallel Port)
 #define EXPANSION_1_START 0x1f000000
 #define EXPANSION_1_SIZE  (8 * 1024 * 1024)
@@ -84,9 +96,59 @@
 #define EXPANSION_2_SIZE  66
 #define EXPANSION_2_END   (EXPANSION_2_START + EXPANSION_2_SIZE - 1)
 
+// Hardware register window (memory control, IRQ, DMA, timers, CD-ROM, GPU, MDEC, SPU, expansion 2)
+#define IO_PORTS_START 0x1f801000
+#define IO_PORTS_SIZE  0x2000
+#define IO_PORTS_END   (IO_PORTS_START + IO_PORTS_SIZE - 1)
+
+// Physical window the host arena fast path skips: scratchpad (never mapped in the arena,
+// since its KSEG1 alias must not reach it) and the hardware registers
+#define ARENA_SKIP_START SCRATCHPAD_START
+#define ARENA_SKIP_SIZE  (IO_PORTS_END + 1 - SCRATCHPAD_START)
+
 // Cache Control Register (KSEG2)
 #define CACHE_CONTROL_ADDR 0xfffe0130
 
+// Fastmem page table: host pointers for 4 KiB pages of the masked physical space
+// (KUSEG/KSEG0/KSEG1 all land below 0x20000000). NULL entries go through the I/O handlers.
+#define FASTMEM_PAGE_SHIFT 12
+#define FASTMEM_PAGE_MASK  ((1u << FASTMEM_PAGE_SHIFT) - 1)
+#define FASTMEM_SPACE_SIZE 0x20000000u
+#define FASTMEM_PAGE_COUNT (FASTMEM_SPACE_SIZE >> FASTMEM_PAGE_SHIFT)
+
+// Code page granularity used to invalidate the CPU block cache on RAM writes (1 KiB pages)
+#define CODE_PAGE_SHIFT 10
+#define CODE_PAGE_COUNT (RAM_SIZE >> CODE_PAGE_SHIFT)
+
+/* --- I/O Register Dispatch ---
+ * The hardware register window (IO_PORTS_START..IO_PORTS_END) is decoded with a single
+ * table lookup: every 16-byte slot points at the handler of the device that owns it.
+ * Devices register their callbacks with interconnect_register_io(); a NULL callback
+ * means the device does not support that access width (logged, reads return 0), and
+ * an unregistered slot is reported as an unhandled address.
+ */
+#define IO_SLOT_SHIFT 4
+#define IO_SLOT_SIZE  (1u << IO_SLOT_SHIFT)
+#define IO_SLOT_COUNT (IO_PORTS_SIZE >> IO_SLOT_SHIFT)
+
+// Callbacks get the device pointer passed at registration and the offset of the
+// access from the registered start address
+typedef struct IoHandler {
+    const char* name; // Device name used in the "unhandled width" warnings
+    uint32_t (*read32)(void* device, uint32_t offset);
+    uint16_t (*read16)(void* device, uint32_t offset);
+    uint8_t  (*read8)(void* device, uint32_t offset);
+    void (*write32)(void* device, uint32_t offset, uint32_t value);
+    void (*write16)(void* device, uint32_t offset, uint16_t value);
+    void (*write8)(void* device, uint32_t offset, uint8_t value);
+} IoHandler;
+
+typedef struct {
+    const IoHandler* handler; // NULL if no device owns the slot
+    void* device;
+    uint32_t base;            // Physical start address the device registered
+} IoSlot;
+
 /* --- Interrupt Line Definitions ---
  * Defines symbolic names for the PSX hardware interrupt request lines (0-10).
  * These correspond to bits in the I_STAT and I_MASK registers.
@@ -103,6 +165,29 @@
 #define IRQ_SPU       9  // Sound Processing Unit interrupt
 #define IRQ_PIO      10 // PIO (Controller?) interrupt (Lightpen?)
 
+/* --- Controller Input ---
+ * Digital pad buttons in the bit order the pad reports them (active low on the wire,
+ * stored here as 1 = pressed). The frontend (or a movie being replayed) sets them
+ * once per frame; the controller port itself is not emulated yet.
+ */
+#define PAD_SELECT   (1u << 0)
+#define PAD_START    (1u << 3)
+#define PAD_UP       (1u << 4)
+#define PAD_RIGHT    (1u << 5)
+#define PAD_DOWN     (1u << 6)
+#define PAD_LEFT     (1u << 7)
+#define PAD_L2       (1u << 8)
+#define PAD_R2       (1u << 9)
+#define PAD_L1       (1u << 10)
+#define PAD_R1       (1u << 11)
+#define PAD_TRIANGLE (1u << 12)
+#define PAD_CIRCLE   (1u << 13)
+#define PAD_CROSS    (1u << 14)
+#define PAD_SQUARE   (1u << 15)
+
+
+// Forward declaration: the CPU owns the decoded-block cache invalidated on RAM writes
+struct Cpu;
 
 /* --- Interconnect Structure Definition ---
  * Holds pointers/instances of all main system components accessed via the bus.
@@ -119,7 +204,25 @@ typedef struct Interconnect {
     uint16_t irq_mask;   // I_MASK Register state (enables/disables IRQs)
     // --------------------------------
     Timers timers_state; // <<< ADD THIS MEMBER
+    Scheduler scheduler; // Global clock and device event deadlines
     Cdrom cdrom;
+    uint8_t scratchpad[SCRATCHPAD_SIZE]; // 1 KiB data cache used as fast RAM
+    uint16_t pad_buttons; // Port 1 digital pad, PAD_* bits (1 = pressed)
+
+    // --- Code Cache Coherency ---
+    struct Cpu* cpu;                           // Set by cpu_init; receives code page invalidations
+    uint8_t ram_code_pages[CODE_PAGE_COUNT];   // Non-zero if the 1 KiB RAM page holds cached code
+
+    // --- Fastmem Page Tables ---
+    uint8_t* fastmem_read[FASTMEM_PAGE_COUNT];  // RAM (+mirrors) and BIOS pages
+    uint8_t* fastmem_write[FASTMEM_PAGE_COUNT]; // RAM (+mirrors) pages only
+    uint8_t* fastmem_arena;                     // Host VM arena base (NULL unless fastmem_arena_init succeeded)
+    uint8_t* fastmem_arena_fast;                // Arena base used by the fast paths (NULL while bypassed)
+    uint8_t* scratchpad_fast;                   // == scratchpad for the fast paths (NULL while bypassed)
+    bool fastmem_bypass;                        // Route every access through interconnect_load/store (bus tracing)
+
+    // --- I/O Register Dispatch ---
+    IoSlot io_slots[IO_SLOT_COUNT]; // One entry per 16-byte slot of the hardware register window
 
     // Add pointers/state for other peripherals here later (Timers, SPU, CDROM, etc.)
 
@@ -137,13 +240,18 @@ typedef struct Interconnect {
  */
 void interconnect_init(Interconnect* inter, Bios* bios, Ram* ram);
 
+// Region masks indexed by the top 3 address bits (defined in interconnect.c)
+extern const uint32_t REGION_MASK[8];
+
 /**
  * @brief Maps a CPU virtual address (KUSEG/KSEG0/KSEG1) to a physical address.
- * Based on Guide Section 2.38.
+ * Based on Guide Section 2.38. Inline: it sits on every memory access.
  * @param addr The 32-bit virtual address from the CPU.
  * @return The corresponding 32-bit physical address.
  */
-uint32_t mask_region(uint32_t addr);
+static inline uint32_t mask_region(uint32_t addr) {
+    return addr & REGION_MASK[addr >> 29];
+}
 
 /**
  * @brief Reads a 32-bit word from the emulated system memory space.
@@ -207,5 +315,198 @@ void interconnect_store8(Interconnect* inter, uint32_t address, uint8_t value);
  */
 void interconnect_request_irq(Interconnect* inter, uint32_t irq_line);
 
+/**
+ * @brief Rebuilds the fastmem page tables from the current Ram.data / Bios.data buffers.
+ * @param inter Pointer to the Interconnect instance.
+ */
+void interconnect_map_fastmem(Interconnect* inter);
+
+/**
+ * @brief Sends every CPU access through interconnect_load/store (page tables emptied,
+ * host arena skipped) or restores the fast paths. Used while bus accesses are traced.
+ * @param inter Pointer to the Interconnect instance.
+ * @param bypass true to disable the fast paths.
+ */
+void interconnect_set_fastmem_bypass(Interconnect* inter, bool bypass);
+
+/**
+ * @brief Hands the slots covering [start, start + size) of the I/O window to a device.
+ * Later registrations replace earlier ones slot by slot, so a device can claim part of a
+ * range registered before it (e.g. the IRQ registers inside memory control).
+ * @param inter Pointer to the Interconnect instance.
+ * @param start Physical start address (inside IO_PORTS_START..IO_PORTS_END).
+ * @param size Size of the range in bytes (rounded up to whole slots).
+ * @param handler Callbacks of the device (static storage: only the pointer is kept).
+ * @param device Opaque pointer passed back to every callback.
+ */
+void interconnect_register_io(Interconnect* inter, uint32_t start, uint32_t size,
+                              const IoHandler* handler, void* device);
+
+/**
+ * @brief Implemented in cpu.c: drops cached blocks decoded from a RAM page.
+ * @param cpu Pointer to the CPU registered in Interconnect.cpu.
+ * @param page RAM page index (physical address >> CODE_PAGE_SHIFT).
+ */
+void cpu_invalidate_code_page(struct Cpu* cpu, uint32_t page);
+
+/**
+ * @brief Implemented in cpu.c: recomputes Cpu.irq_pending after I_STAT, I_MASK or SR changed.
+ * @param cpu Pointer to the CPU registered in Interconnect.cpu.
+ */
+void cpu_update_irq_pending(struct Cpu* cpu);
+
+/**
+ * @brief Records a RAM write: marks the page in the Ram dirty bitmap and notifies the
+ * CPU block cache. Only pages that hold cached code cost more than a table lookup.
+ * Every RAM write path (fast paths, host arena, I/O path, DMA) goes through here.
+ * @param inter Pointer to the Interconnect instance.
+ * @param physical_addr Physical RAM address that was written.
+ */
+static inline void interconnect_note_ram_write(Interconnect* inter, uint32_t physical_addr) {
+    ram_mark_dirty(inter->ram, physical_addr);
+    uint32_t page = (physical_addr & (RAM_SIZE - 1)) >> CODE_PAGE_SHIFT;
+    if (inter->ram_code_pages[page]) {
+        cpu_invalidate_code_page(inter->cpu, page);
+    }
+}
+
+
+// --- Fastmem Accessors ---
+// Inline page-table fast paths used by the CPU. Anything not mapped (I/O, unaligned,
+// KSEG2) falls through to the regular interconnect_load/store functions.
+// With the host arena active, aligned accesses are a single base + offset host access
+// instead; unmapped pages fault and are replayed by the SIGSEGV handler in fastmem.c.
+// The hardware register window is polled constantly (GPUSTAT, I_STAT, timers), so it
+// skips the arena rather than paying for a fault on every access; so does scratchpad,
+// which is served from Interconnect.scratchpad right after the page-table lookup.
+#if FASTMEM_ARENA_SUPPORTED
+#define FASTMEM_ARENA_LOAD(inter, address, bits, align_mask) \
+    if ((inter)->fastmem_arena_fast && ((address) & (align_mask)) == 0 && \
+        mask_region(address) - ARENA_SKIP_START >= ARENA_SKIP_SIZE) \
+        return fastmem_arena_load##bits((inter)->fastmem_arena_fast + mask_region(address))
+#define FASTMEM_ARENA_STORE(inter, address, value, bits, align_mask) \
+    if ((inter)->fastmem_arena_fast && ((address) & (align_mask)) == 0 && \
+        mask_region(address) - ARENA_SKIP_START >= ARENA_SKIP_SIZE) { \
+        uint32_t arena_addr = mask_region(address); \
+        fastmem_arena_store##bits((inter)->fastmem_arena_fast + arena_addr, (value)); \
+        if (arena_addr <= RAM_MIRROR_END) interconnect_note_ram_write((inter), arena_addr); \
+        return; \
+    }
+#else
+#define FASTMEM_ARENA_LOAD(inter, address, bits, align_mask)
+#define FASTMEM_ARENA_STORE(inter, address, value, bits, align_mask)
+#endif
+
+/**
+ * @brief Returns the host pointer for a scratchpad access, or NULL if the virtual address
+ * is not a KUSEG/KSEG0 scratchpad address (or scratchpad is NULL).
+ */
+static inline uint8_t* interconnect_scratchpad_ptr(uint8_t* scratchpad, uint32_t address) {
+    if (scratchpad == NULL || (address & SCRATCHPAD_VADDR_MASK) != SCRATCHPAD_START) return NULL;
+    return scratchpad + (address & (SCRATCHPAD_SIZE - 1));
+}
+
+/**
+ * @brief Returns the host pointer for a physical address, or NULL if it is not fastmem-mapped.
+ */
+static inline uint8_t* interconnect_fastmem_ptr(uint8_t* const* table, uint32_t physical_addr) {
+    if (physical_addr >= FASTMEM_SPACE_SIZE) return NULL;
+    uint8_t* page = table[physical_addr >> FASTMEM_PAGE_SHIFT];
+    return page ? page + (physical_addr & FASTMEM_PAGE_MASK) : NULL;
+}
+
+static inline uint32_t interconnect_fast_load32(Interconnect* inter, uint32_t address) {
+    FASTMEM_ARENA_LOAD(inter, address, 32, 3);
+    uint8_t* p = interconnect_fastmem_ptr(inter->fastmem_read, mask_region(address));
+    if (p && (address & 3) == 0) {
+        uint32_t value;
+        memcpy(&value, p, 4); // Host is little-endian when the table is populated
+        return value;
+    }
+    p = interconnect_scratchpad_ptr(inter->scratchpad_fast, address);
+    if (p && (address & 3) == 0) {
+        uint32_t value;
+        memcpy(&value, p, 4);
+        return value;
+    }
+    return interconnect_load32(inter, address);
+}
+
+static inline uint16_t interconnect_fast_load16(Interconnect* inter, uint32_t address) {
+    FASTMEM_ARENA_LOAD(inter, address, 16, 1);
+    uint8_t* p = interconnect_fastmem_ptr(inter->fastmem_read, mask_region(address));
+    if (p && (address & 1) == 0) {
+        uint16_t value;
+        memcpy(&value, p, 2);
+        return value;
+    }
+    p = interconnect_scratchpad_ptr(inter->scratchpad_fast, address);
+    if (p && (address & 1) == 0) {
+        uint16_t value;
+        memcpy(&value, p, 2);
+        return value;
+    }
+    return interconnect_load16(inter, address);
+}
+
+static inline uint8_t interconnect_fast_load8(Interconnect* inter, uint32_t address) {
+    FASTMEM_ARENA_LOAD(inter, address, 8, 0);
+    uint8_t* p = interconnect_fastmem_ptr(inter->fastmem_read, mask_region(address));
+    if (p) return *p;
+    p = interconnect_scratchpad_ptr(inter->scratchpad_fast, address);
+    return p ? *p : interconnect_load8(inter, address);
+}
+
+static inline void interconnect_fast_store32(Interconnect* inter, uint32_t address, uint32_t value) {
+    FASTMEM_ARENA_STORE(inter, address, value, 32, 3)
+    uint32_t physical_addr = mask_region(address);
+    uint8_t* p = interconnect_fastmem_ptr(inter->fastmem_write, physical_addr);
+    if (p && (address & 3) == 0) {
+        memcpy(p, &value, 4);
+        interconnect_note_ram_write(inter, physical_addr);
+        return;
+    }
+    p = interconnect_scratchpad_ptr(inter->scratchpad_fast, address);
+    if (p && (address & 3) == 0) {
+        memcpy(p, &value, 4); // Never holds code: no invalidation
+        return;
+    }
+    interconnect_store32(inter, address, value);
+}
+
+static inline void interconnect_fast_store16(Interconnect* inter, uint32_t address, uint16_t value) {
+    FASTMEM_ARENA_STORE(inter, address, value, 16, 1)
+    uint32_t physical_addr = mask_region(address);
+    uint8_t* p = interconnect_fastmem_ptr(inter->fastmem_write, physical_addr);
+    if (p && (address & 1) == 0) {
+        memcpy(p, &value, 2);
+        interconnect_note_ram_write(inter, physical_addr);
+        return;
+    }
+    p = interconnect_scratchpad_ptr(inter->scratchpad_fast, address);
+    if (p && (address & 1) == 0) {
+        memcpy(p, &value, 2);
+        return;
+    }
+    interconnect_store16(inter, address, value);
+}
+
+static inline void interconnect_fast_store8(Interconnect* inter, uint32_t address, uint8_t value) {
+    FASTMEM_ARENA_STORE(inter, address, value, 8, 0)
+    uint32_t physical_addr = mask_region(address);
+    uint8_t* p = interconnect_fastmem_ptr(inter->fastmem_write, physical_addr);
+    if (p) {
+        *p = value;
+        interconnect_note_ram_write(inter, physical_addr);
+        return;
+    }
+    p = interconnect_scratchpad_ptr(inter->scratchpad_fast, address);
+    if (p) {
+        *p = value;
+        return;
+    }
+    interconnect_store8(inter, address, value);
+}
+
 
 #endif // INTERCONNECT_H
\ No newline at end of file
@@ -0,0 +1,207 @@
+// logger.c
+// Lock-free multi-producer ring buffer of formatted records, drained by one writer thread.
+#include "logger.h"
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h> // For strcasecmp
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define LOG_RING_SLOTS   4096 // Must be a power of two
+#define LOG_MESSAGE_MAX  240  // Longer messages are truncated
+#define LOG_IDLE_SLEEP_NS 1000000L // Writer poll interval when the ring is empty (1 ms)
+
+/* --- Ring Record ---
+ * Bounded MPMC queue slot (sequence-numbered): a producer owns slot 'pos' once
+ * sequence == pos and publishes it with sequence = pos + 1; the writer releases it
+ * for the next lap with sequence = pos + LOG_RING_SLOTS.
+ */
+typedef struct {
+    _Atomic uint32_t sequence;
+    uint8_t category;
+    uint8_t level;
+    uint16_t length;
+    char text[LOG_MESSAGE_MAX];
+} LogRecord;
+
+uint8_t logger_category_level[LOG_CATEGORY_COUNT] = {
+    LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL,
+    LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL,
+};
+
+static const char* const category_names[LOG_CATEGORY_COUNT] = {
+    "CPU", "BUS", "GPU", "DMA", "CDROM", "TIMERS", "RENDERER",
+};
+static const char* const level_names[] = { "off", "error", "warn", "info", "debug", "trace" };
+
+static LogRecord ring[LOG_RING_SLOTS];
+static _Atomic uint32_t write_pos; // Next slot to claim (producers)
+static uint32_t read_pos;          // Next slot to drain (writer thread only)
+
+static FILE* log_out = NULL;
+static pthread_t writer_thread;
+static atomic_bool writer_running = false;
+static atomic_bool writer_stop = false;
+
+
+// --- Writer Thread ---
+static void logger_emit(FILE* out, const LogRecord* record) {
+    fprintf(out, "[%s] %.*s", category_names[record->category], (int)record->length, record->text);
+}
+
+/**
+ * @brief Writes every published record to the stream.
+ * @return Number of records written.
+ */
+static uint32_t logger_drain(void) {
+    uint32_t drained = 0;
+    for (;;) {
+        LogRecord* record = &ring[read_pos & (LOG_RING_SLOTS - 1)];
+        if (atomic_load_explicit(&record->sequence, memory_order_acquire) != read_pos + 1) break;
+        logger_emit(log_out, record);
+        atomic_store_explicit(&record->sequence, read_pos + LOG_RING_SLOTS, memory_order_release);
+        read_pos++;
+        drained++;
+    }
+    return drained;
+}
+
+static void* logger_writer_main(void* arg) {
+    (void)arg;
+    const struct timespec idle = { 0, LOG_IDLE_SLEEP_NS };
+    for (;;) {
+        bool stopping = atomic_load_explicit(&writer_stop, memory_order_acquire);
+        if (logger_drain() > 0) {
+            fflush(log_out); // One flush per batch instead of one write per line
+        } else if (stopping) {
+            break; // Stop was requested before this (empty) pass: nothing is left
+        } else {
+            nanosleep(&idle, NULL);
+        }
+    }
+    return NULL;
+}
+
+
+// --- Public API ---
+bool logger_init(FILE* out) {
+    if (atomic_load(&writer_running)) return true;
+
+    for (uint32_t i = 0; i < LOG_RING_SLOTS; ++i) {
+        atomic_store_explicit(&ring[i].sequence, i, memory_order_relaxed);
+    }
+    atomic_store(&write_pos, 0);
+    read_pos = 0;
+    log_out = out;
+    atomic_store(&writer_stop, false);
+
+    if (pthread_create(&writer_thread, NULL, logger_writer_main, NULL) != 0) {
+        fprintf(stderr, "Logger: failed to start the writer thread, logging synchronously.\n");
+        return false;
+    }
+    atomic_store(&writer_running, true);
+    atexit(logger_shutdown);
+    return true;
+}
+
+void logger_shutdown(void) {
+    if (!atomic_exchange(&writer_running, false)) return;
+    atomic_store_explicit(&writer_stop, true, memory_order_release);
+    pthread_join(writer_thread, NULL);
+    fflush(log_out);
+}
+
+static int logger_parse_level(const char* name, size_t length) {
+    for (int level = LOG_LEVEL_OFF; level <= LOG_LEVEL_TRACE; ++level) {
+        if (strlen(level_names[level]) == length && strncasecmp(name, level_names[level], length) == 0) {
+            return level;
+        }
+    }
+    return -1;
+}
+
+bool logger_parse_option(const char* spec) {
+    bool ok = true;
+    while (*spec) {
+        size_t entry_length = strcspn(spec, ",");
+        const char* colon = memchr(spec, ':', entry_length);
+        if (colon == NULL) {
+            // "<level>": every category
+            int level = logger_parse_level(spec, entry_length);
+            if (level < 0) {
+                ok = false;
+            } else {
+                memset(logger_category_level, level, sizeof(logger_category_level));
+            }
+        } else {
+            // "<category>:<level>"
+            size_t name_length = (size_t)(colon - spec);
+            int level = logger_parse_level(colon + 1, entry_length - name_length - 1);
+            int category = -1;
+            for (int i = 0; i < LOG_CATEGORY_COUNT; ++i) {
+                if (strlen(category_names[i]) == name_length && strncasecmp(spec, category_names[i], name_length) == 0) {
+                    category = i;
+                }
+            }
+            if (level < 0 || category < 0) {
+                ok = false;
+            } else {
+                logger_category_level[category] = (uint8_t)level;
+            }
+        }
+        spec += entry_length;
+        if (*spec == ',') spec++;
+    }
+    return ok;
+}
+
+void logger_write(LogCategory category, int level, const char* format, ...) {
+    LogRecord local;
+    LogRecord* record = &local;
+    uint32_t pos = 0;
+    bool queued = atomic_load_explicit(&writer_running, memory_order_acquire);
+
+    if (queued) {
+        // Claim a slot; when the ring is full, wait for the writer instead of losing lines
+        pos = atomic_load_explicit(&write_pos, memory_order_relaxed);
+        for (;;) {
+            record = &ring[pos & (LOG_RING_SLOTS - 1)];
+            uint32_t sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+            int32_t lag = (int32_t)(sequence - pos);
+            if (lag == 0) {
+                if (atomic_compare_exchange_weak_explicit(&write_pos, &pos, pos + 1,
+                                                          memory_order_relaxed, memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                sched_yield(); // Full
+                pos = atomic_load_explicit(&write_pos, memory_order_relaxed);
+            } else {
+                pos = atomic_load_explicit(&write_pos, memory_order_relaxed); // Another producer won
+            }
+        }
+    }
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(record->text, LOG_MESSAGE_MAX, format, args);
+    va_end(args);
+    if (length < 0) length = 0;
+    if (length >= LOG_MESSAGE_MAX) {
+        // Truncated: keep the line terminated
+        length = LOG_MESSAGE_MAX - 1;
+        record->text[length - 1] = '\n';
+    }
+    record->category = (uint8_t)category;
+    record->level = (uint8_t)level;
+    record->length = (uint16_t)length;
+
+    if (queued) {
+        atomic_store_explicit(&record->sequence, pos + 1, memory_order_release);
+    } else {
+        logger_emit(stderr, record);
+    }
+}
@@ -0,0 +1,96 @@
+// logger.h
+// Leveled, per-category logging drained to the log file by a background thread.
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// --- Levels ---
+// A message is kept if its level is <= the threshold (compile-time and per category).
+#define LOG_LEVEL_OFF   0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4 // Per-command/per-transfer chatter (GP0, DMA, IRQs, renderer pushes)
+#define LOG_LEVEL_TRACE 5 // Per-register-access chatter ("~ Write32 to ...")
+
+// Levels above this are removed by the compiler, arguments included.
+// Build with -DLOG_COMPILE_LEVEL=LOG_LEVEL_TRACE to get the register-access trace back.
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+// Runtime threshold of every category until changed with logger_parse_option()
+#define LOG_DEFAULT_LEVEL LOG_LEVEL_INFO
+
+// --- Categories ---
+typedef enum {
+    LOG_CPU = 0,
+    LOG_BUS,      // Interconnect: register accesses, IRQ controller
+    LOG_GPU,
+    LOG_DMA,
+    LOG_CDROM,
+    LOG_TIMERS,
+    LOG_RENDERER,
+    LOG_CATEGORY_COUNT
+} LogCategory;
+
+// Runtime threshold per category (read on every enabled log statement, so kept public)
+extern uint8_t logger_category_level[LOG_CATEGORY_COUNT];
+
+/**
+ * @brief Returns true if a message of this level/category would be recorded.
+ */
+static inline bool logger_enabled(LogCategory category, int level) {
+    return level <= logger_category_level[category];
+}
+
+/**
+ * @brief Starts the background writer thread.
+ * Until this is called (and after logger_shutdown), messages are written synchronously
+ * to stderr, so tools that never start the logger still see them.
+ * @param out Stream the writer thread appends to (e.g. the redirected stdout).
+ * @return true if the writer thread is running.
+ */
+bool logger_init(FILE* out);
+
+/**
+ * @brief Drains every queued message, flushes the stream and stops the writer thread.
+ * Safe to call more than once (also registered with atexit by logger_init).
+ */
+void logger_shutdown(void);
+
+/**
+ * @brief Parses a --log option value: "<level>" or "<category>:<level>", comma separated.
+ * Levels: off, error, warn, info, debug, trace. Categories: cpu, bus, gpu, dma, cdrom,
+ * timers, renderer.
+ * @param spec The option value.
+ * @return false if any entry was not recognised.
+ */
+bool logger_parse_option(const char* spec);
+
+/**
+ * @brief Formats a message into the ring buffer. Use the LOG_* macros instead.
+ */
+void logger_write(LogCategory category, int level, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// --- Logging Macros ---
+// The level test is a constant when the level is compiled out, so the whole statement
+// (formatting and argument evaluation) disappears; otherwise it costs one byte compare
+// before any formatting happens.
+#define LOG_AT(level, category, ...) do { \
+        if ((level) <= LOG_COMPILE_LEVEL && logger_enabled((category), (level))) { \
+            logger_write((category), (level), __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_ERROR(category, ...) LOG_AT(LOG_LEVEL_ERROR, category, __VA_ARGS__)
+#define LOG_WARN(category, ...)  LOG_AT(LOG_LEVEL_WARN, category, __VA_ARGS__)
+#define LOG_INFO(category, ...)  LOG_AT(LOG_LEVEL_INFO, category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) LOG_AT(LOG_LEVEL_DEBUG, category, __VA_ARGS__)
+#define LOG_TRACE(category, ...) LOG_AT(LOG_LEVEL_TRACE, category, __VA_ARGS__)
+
+#endif // LOGGER_H
@@ -0,0 +1,144 @@
+// lz.c
+// Greedy single-probe LZ77 compressor and its decoder (see lz.h for the block format).
+// Tuned for snapshot deltas: long zero runs become offset-1 matches that decode as memset.
+#include "lz.h"
+#include <string.h>
+
+#define LZ_HASH_BITS 14
+
+static inline uint32_t lz_read32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t lz_read64(const uint8_t* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint32_t lz_hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+
+// --- Compression ---
+static uint8_t* lz_put_length(uint8_t* op, size_t length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (uint8_t)length;
+    return op;
+}
+
+/**
+ * @brief Writes one sequence. A match_length of 0 writes the final literal-only sequence.
+ */
+static uint8_t* lz_put_sequence(uint8_t* op, const uint8_t* literals, size_t literal_count,
+                                size_t match_length, uint32_t offset) {
+    size_t match_code = match_length ? match_length - LZ_MIN_MATCH : 0;
+    uint8_t* token = op++;
+    *token = (uint8_t)(((literal_count < 15 ? literal_count : 15) << 4) | (match_code < 15 ? match_code : 15));
+    if (literal_count >= 15) op = lz_put_length(op, literal_count - 15);
+    memcpy(op, literals, literal_count);
+    op += literal_count;
+    if (match_length) {
+        *op++ = (uint8_t)offset;
+        *op++ = (uint8_t)(offset >> 8);
+        if (match_code >= 15) op = lz_put_length(op, match_code - 15);
+    }
+    return op;
+}
+
+size_t lz_compress(const uint8_t* src, size_t size, uint8_t* dst) {
+    uint32_t table[1 << LZ_HASH_BITS]; // Last position seen per 4-byte hash
+    uint8_t* op = dst;
+    size_t anchor = 0; // Start of the pending literals
+
+    if (size > LZ_MIN_MATCH) {
+        memset(table, 0, sizeof(table));
+        size_t limit = size - LZ_MIN_MATCH; // Last position a 4-byte read fits at
+        size_t ip = 1;
+        while (ip <= limit) {
+            uint32_t sequence = lz_read32(src + ip);
+            uint32_t hash = lz_hash(sequence);
+            size_t ref = table[hash];
+            table[hash] = (uint32_t)ip;
+
+            if (ip - ref > LZ_MAX_OFFSET || lz_read32(src + ref) != sequence) {
+                ip += 1 + ((ip - anchor) >> 6); // Skip faster through incompressible data
+                continue;
+            }
+            size_t length = LZ_MIN_MATCH;
+            while (ip + length + 8 <= size && lz_read64(src + ref + length) == lz_read64(src + ip + length)) {
+                length += 8;
+            }
+            while (ip + length < size && src[ref + length] == src[ip + length]) length++;
+
+            op = lz_put_sequence(op, src + anchor, ip - anchor, length, (uint32_t)(ip - ref));
+            ip += length;
+            anchor = ip;
+        }
+    }
+    op = lz_put_sequence(op, src + anchor, size - anchor, 0, 0);
+    return (size_t)(op - dst);
+}
+
+
+// --- Decompression ---
+static bool lz_get_length(const uint8_t** ip, const uint8_t* end, size_t* length) {
+    uint8_t byte;
+    do {
+        if (*ip >= end) return false;
+        byte = *(*ip)++;
+        *length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+bool lz_decompress(const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size) {
+    const uint8_t* ip = src;
+    const uint8_t* end = src + src_size;
+    size_t op = 0;
+
+    for (;;) {
+        if (ip >= end) return false;
+        uint8_t token = *ip++;
+
+        size_t literal_count = token >> 4;
+        if (literal_count == 15 && !lz_get_length(&ip, end, &literal_count)) return false;
+        if ((size_t)(end - ip) < literal_count || dst_size - op < literal_count) return false;
+        memcpy(dst + op, ip, literal_count);
+        ip += literal_count;
+        op += literal_count;
+        if (op == dst_size) return ip == end; // Final sequence
+
+        if (end - ip < 2) return false;
+        size_t offset = ip[0] | (size_t)ip[1] << 8;
+        ip += 2;
+        size_t length = token & 15;
+        if (length == 15 && !lz_get_length(&ip, end, &length)) return false;
+        length += LZ_MIN_MATCH;
+        if (offset == 0 || offset > op || dst_size - op < length) return false;
+
+        uint8_t* out = dst + op;
+        const uint8_t* from = out - offset;
+        if (offset == 1) {
+            memset(out, *from, length);
+        } else if (offset >= length) {
+            memcpy(out, from, length);
+        } else {
+            // Overlapping match: the output repeats every 'offset' bytes, so copy the
+            // period, then twice as much, and so on (each copy reads finished bytes only)
+            size_t done = 0;
+            while (done < length) {
+                size_t chunk = done + offset < length - done ? done + offset : length - done;
+                memcpy(out + done, from, chunk);
+                done += chunk;
+            }
+        }
+        op += length;
+    }
+}
@@ -0,0 +1,46 @@
+// lz.h
+// Small byte-oriented LZ77 codec (LZ4-style sequences) for in-memory snapshots.
+#ifndef LZ_H
+#define LZ_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* --- Block Format ---
+ * A block is a list of sequences. Each one is a token byte (high nibble: literal count,
+ * low nibble: match length - LZ_MIN_MATCH; 15 means "more length bytes follow", each
+ * added until one is < 255), the literals, then a 16-bit little-endian match offset and
+ * the extra match length bytes. The last sequence has literals only; the decoder knows
+ * where it ends from the expected output size.
+ */
+#define LZ_MIN_MATCH  4
+#define LZ_MAX_OFFSET 65535
+
+/**
+ * @brief Worst-case compressed size of 'size' input bytes.
+ */
+static inline size_t lz_compress_bound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+/**
+ * @brief Compresses a block.
+ * @param src Input bytes.
+ * @param size Input size.
+ * @param dst Output, at least lz_compress_bound(size) bytes.
+ * @return Compressed size.
+ */
+size_t lz_compress(const uint8_t* src, size_t size, uint8_t* dst);
+
+/**
+ * @brief Decompresses a block produced by lz_compress.
+ * @param src Compressed bytes.
+ * @param src_size Compressed size.
+ * @param dst Output buffer.
+ * @param dst_size Exact decompressed size.
+ * @return false if the block is malformed (dst contents are then unspecified).
+ */
+bool lz_decompress(const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size);
+
+#endif // LZ_H
@@ -8,6 +8,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h> // sysconf
 
 // --- Graphics/Windowing Includes ---
 #include <SDL2/SDL.h>
@@ -17,39 +20,40 @@
 // --- Emulator Core Components ---
 #include "cpu.h"
 #include "interconnect.h"
+#include "fastmem.h"
 #include "bios.h"
 #include "ram.h"
 #include "renderer.h"
 #include "cdrom.h"
+#include "logger.h"
+#include "trace.h"
+#include "savestate.h"
+#include "rewind.h"
+#include "movie.h"
+#include "gpu_thread.h"
+#include "rasterizer.h"
+#include "gpu_bench.h"
+#include "cpu_bench.h"
 
-int main(int argc, char *argv[]) {
-    // --- File Logging Setup ---
-    FILE *log_file = freopen("emulator_log.txt", "w", stdout);
-    if (log_file == NULL) {
-        perror("Failed to open log file for stdout");
-        return 1;
-    }
-    freopen("emulator_log.txt", "a", stderr);
-    setbuf(stdout, NULL);
-    setbuf(stderr, NULL);
-    printf("--- Log Started ---\n");
-
-    // --- Configuration ---
-    const char* bios_path = (argc > 1) ? argv[1] : "roms/SCPH1001.BIN";
-    // --- MODIFICATION: More accurate cycles per frame calculation ---
-    // The PSX CPU runs at 33,868,800 Hz.
-    // For a 60 FPS target (NTSC), we run this many cycles per frame.
-    const uint32_t cycles_per_frame = 33868800 / 60;
-
-    printf("--- ZoniStation One Emulator ---\n");
-    printf("Attempting to load BIOS from: %s\n", bios_path);
+/**
+ * @brief Starts or pauses the binary trace. Bus tracing needs every access to go
+ * through interconnect_load/store, so the fastmem paths are bypassed meanwhile.
+ */
+static void set_tracing(Interconnect* inter, bool enabled) {
+    trace_set_enabled(enabled);
+    interconnect_set_fastmem_bypass(inter, trace_is_enabled() && (trace_mask() & TRACE_BUS) != 0);
+    printf("Trace: %s.\n", trace_is_enabled() ? "recording" : "paused");
+}
 
-    // --- SDL & OpenGL Initialization ---
-    // (No changes needed in this section, your SDL/GLEW setup is correct)
+/**
+ * @brief Creates the window and its OpenGL 3.3 core context and loads GLEW.
+ * @return false (with everything released) on failure.
+ */
+static bool create_window(SDL_Window** window_out, SDL_GLContext* context_out) {
     printf("Initializing SDL Video...\n");
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         fprintf(stderr, "SDL_Init Error: %s\n", SDL_GetError());
-        return 1;
+        return false;
     }
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
@@ -59,7 +63,7 @@ int main(int argc, char *argv[]) {
     if (!window) {
         fprintf(stderr, "SDL_CreateWindow Error: %s\n", SDL_GetError());
         SDL_Quit();
-        return 1;
+        return false;
     }
     printf("Creating OpenGL Context...\n");
     SDL_GLContext gl_context = SDL_GL_CreateContext(window);
@@ -67,7 +71,7 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "SDL_GL_CreateContext Error: %s\n", SDL_GetError());
         SDL_DestroyWindow(window);
         SDL_Quit();
-        return 1;
+        return false;
     }
     printf("Initializing GLEW...\n");
     glewExperimental = GL_TRUE;
@@ -77,10 +81,252 @@ int main(int argc, char *argv[]) {
         SDL_GL_DeleteContext(gl_context);
         SDL_DestroyWindow(window);
         SDL_Quit();
-        return 1;
+        return false;
     }
     printf("GLEW Initialized. OpenGL Version: %s\n", glGetString(GL_VERSION));
     check_gl_error("After GLEW Init");
+    *window_out = window;
+    *context_out = gl_context;
+    return true;
+}
+
+/**
+ * @brief Maps the keyboard to the port 1 digital pad: arrows, Z/X/A/S for
+ * Cross/Circle/Square/Triangle, Enter for Start, right Shift for Select and
+ * Q/W/E/R for L1/R1/L2/R2.
+ */
+static uint16_t read_pad_buttons(void) {
+    static const struct { int scancode; uint16_t button; } keymap[] = {
+        { SDL_SCANCODE_UP, PAD_UP },         { SDL_SCANCODE_DOWN, PAD_DOWN },
+        { SDL_SCANCODE_LEFT, PAD_LEFT },     { SDL_SCANCODE_RIGHT, PAD_RIGHT },
+        { SDL_SCANCODE_Z, PAD_CROSS },       { SDL_SCANCODE_X, PAD_CIRCLE },
+        { SDL_SCANCODE_A, PAD_SQUARE },      { SDL_SCANCODE_S, PAD_TRIANGLE },
+        { SDL_SCANCODE_RETURN, PAD_START },  { SDL_SCANCODE_RSHIFT, PAD_SELECT },
+        { SDL_SCANCODE_Q, PAD_L1 },          { SDL_SCANCODE_W, PAD_R1 },
+        { SDL_SCANCODE_E, PAD_L2 },          { SDL_SCANCODE_R, PAD_R2 },
+    };
+    const Uint8* keys = SDL_GetKeyboardState(NULL);
+    uint16_t buttons = 0;
+    for (size_t i = 0; i < sizeof(keymap) / sizeof(keymap[0]); ++i) {
+        if (keys[keymap[i].scancode]) buttons |= keymap[i].button;
+    }
+    return buttons;
+}
+
+/**
+ * @brief Uploads VRAM, draws the primitives batched during the frame and swaps buffers.
+ * With the software backend the frame is already in VRAM and is copied to the window.
+ */
+static void present_frame(Interconnect* inter, SDL_Window* window) {
+    bool software = inter->gpu.backend == GPU_BACKEND_SOFTWARE;
+    gpu_flush(&inter->gpu); // VRAM must hold every command of the frame
+
+    // 1. UPLOAD VRAM TO TEXTURE:
+    //    Upload what changed in our emulated VRAM since the last frame to the OpenGL
+    //    texture object. This makes the VRAM content available to our shader. The software
+    //    backend displays VRAM as is, so its pixels go up in their native 1555 BGR layout.
+    renderer_upload_vram(&inter->gpu.renderer, &inter->gpu.vram, software);
+
+    // 2. DRAW THE RENDERER'S BUFFER: (THIS IS THE MISSING CALL)
+    //    Now, tell the renderer to draw everything that was buffered during this frame's CPU execution.
+    //    This calls renderer_draw(), which uploads the vertex data and calls glDrawArrays.
+    if (software) {
+        renderer_blit_vram(&inter->gpu.renderer);
+    } else {
+        renderer_display(&inter->gpu.renderer);
+    }
+    
+    // 3. SWAP THE WINDOW:
+    //    Finally, swap the back buffer (which we just drew on) to the front to display the rendered frame.
+    SDL_GL_SwapWindow(window);
+    check_gl_error("After SwapWindow");
+}
+
+/**
+ * @brief Emulates one frame. Hidden frames (run-ahead) and headless runs (no window)
+ * skip the presentation and drop the primitives batched while they ran.
+ */
+static void run_frame(Cpu* cpu, uint32_t cycles, SDL_Window* window, bool present) {
+    // cpu_run stops at every scheduled device deadline (timers, CD-ROM, DMA, VBlank)
+    // and dispatches the due events itself, so one call covers the whole frame.
+    cpu_run(cpu, cycles);
+    if (present && window != NULL) {
+        present_frame(cpu->inter, window);
+    } else {
+        cpu->inter->gpu.renderer.vertex_count = 0;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // --- File Logging Setup ---
+    FILE *log_file = freopen("emulator_log.txt", "w", stdout);
+    if (log_file == NULL) {
+        perror("Failed to open log file for stdout");
+        return 1;
+    }
+    freopen("emulator_log.txt", "a", stderr);
+    // Module logs are queued and written by the logger thread, which flushes once per
+    // batch, so stdout no longer needs to be unbuffered. stderr stays unbuffered.
+    setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+    setbuf(stderr, NULL);
+    logger_init(stdout);
+    printf("--- Log Started ---\n");
+
+    // --- Configuration ---
+    // Usage: myps1_emu [--cpu=interp|cached|jit] [--gpu=gl|soft] [--fastmem=arena] [--log=<spec>]
+    //                  [--trace=<file>] [--trace-events=<list>]
+    //                  [--state=<file>] [--load-state=<file>]
+    //                  [--rewind[=<MiB>]] [--rewind-interval=<frames>]
+    //                  [--run-ahead=<frames>] [--record=<file> | --play=<file>]
+    //                  [--headless] [--frames=<count>] [bios_path]
+    //   --gpu: OpenGL renderer (default) or software rasterizer into VRAM (default when headless)
+    //   --gpu-thread: run GP0 on a worker thread (software rasterizer only)
+    //   --raster-threads: draw software polygons by tiles on this many threads; --raster-tile: tile size
+    //   --bench-gpu: time the rasterizer on a --trace file's GPU words with 1..--raster-threads threads
+    //   --bench-vram: time the VRAM fill, copy and readback commands
+    //   --bench-cpu: time a fixed instruction loop stepped one instruction at a time and in each --cpu mode
+    //   --bench-idle: check that an I_STAT polling loop is skipped as idle (exit code 1 if not)
+    //   --log=debug / --log=gpu:trace,dma:debug  (levels: off error warn info debug trace)
+    //   --trace-events=cpu,bus,irq,dma,gpu (default: all); F9 pauses/resumes the trace
+    //   --state: quick save file (F5 saves, F7 loads); --load-state also restores it at startup
+    //   --rewind: keep a rewind history (default 256 MiB); hold Backspace to rewind
+    //   --run-ahead: show the frame this many frames ahead, rolled back every frame
+    //   --record: record the pad input from power-on (or from --load-state's state);
+    //   --play: replay a movie and check that it ends in the recorded state
+    //   --headless: no window, unthrottled (with --play it stops when the movie ends)
+    //   --frames: stop after this many frames (--headless --frames=N --cpu=<mode> is the CPU
+    //     benchmark: the exit log reports the guest instructions executed per second)
+    const char* bios_path = "roms/SCPH1001.BIN";
+    CpuExecMode cpu_mode = CPU_EXEC_CACHED;
+    int gpu_backend = -1; // GpuBackend, or -1 for the default (software when headless)
+    bool gpu_threaded = false;
+    uint32_t raster_threads = 0; // 0 = draw each polygon as it arrives
+    uint32_t raster_tile = RASTER_DEFAULT_TILE_SIZE;
+    const char* bench_gpu_path = NULL;
+    bool bench_vram = false;
+    bool bench_cpu = false;
+    bool bench_idle = false;
+    bool use_fastmem_arena = false; // Host VM arena instead of the page tables
+    const char* trace_path = NULL;   // Binary trace output (decode with tools/psxtrace)
+    uint32_t trace_events = TRACE_ALL;
+    const char* state_path = "quicksave.state";
+    bool load_state = false;
+    size_t rewind_capacity = 0; // 0 = rewind disabled
+    uint32_t rewind_interval = REWIND_DEFAULT_INTERVAL;
+    uint32_t run_ahead = 0; // Hidden frames emulated ahead of the presented one
+    const char* record_path = NULL;
+    const char* play_path = NULL;
+    bool headless = false;
+    uint64_t max_frames = 0; // 0 = run until quit
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--cpu=interp") == 0) {
+            cpu_mode = CPU_EXEC_INTERPRETER;
+        } else if (strcmp(argv[i], "--cpu=cached") == 0) {
+            cpu_mode = CPU_EXEC_CACHED;
+        } else if (strcmp(argv[i], "--cpu=jit") == 0) {
+            cpu_mode = CPU_EXEC_JIT;
+        } else if (strcmp(argv[i], "--gpu=gl") == 0) {
+            gpu_backend = GPU_BACKEND_OPENGL;
+        } else if (strcmp(argv[i], "--gpu=soft") == 0) {
+            gpu_backend = GPU_BACKEND_SOFTWARE;
+        } else if (strcmp(argv[i], "--gpu-thread") == 0) {
+            gpu_threaded = true;
+        } else if (strncmp(argv[i], "--raster-threads=", 17) == 0) {
+            raster_threads = (uint32_t)strtoul(argv[i] + 17, NULL, 10);
+        } else if (strncmp(argv[i], "--raster-tile=", 14) == 0) {
+            raster_tile = (uint32_t)strtoul(argv[i] + 14, NULL, 10);
+        } else if (strncmp(argv[i], "--bench-gpu=", 12) == 0) {
+            bench_gpu_path = argv[i] + 12;
+        } else if (strcmp(argv[i], "--bench-vram") == 0) {
+            bench_vram = true;
+        } else if (strcmp(argv[i], "--bench-cpu") == 0) {
+            bench_cpu = true;
+        } else if (strcmp(argv[i], "--bench-idle") == 0) {
+            bench_idle = true;
+        } else if (strcmp(argv[i], "--fastmem=arena") == 0) {
+            use_fastmem_arena = true;
+        } else if (strncmp(argv[i], "--log=", 6) == 0) {
+            if (!logger_parse_option(argv[i] + 6)) {
+                fprintf(stderr, "Warning: Invalid log specification '%s'.\n", argv[i] + 6);
+            }
+        } else if (strncmp(argv[i], "--trace=", 8) == 0) {
+            trace_path = argv[i] + 8;
+        } else if (strncmp(argv[i], "--trace-events=", 15) == 0) {
+            trace_events = trace_parse_mask(argv[i] + 15);
+            if (trace_events == 0) {
+                fprintf(stderr, "Warning: Invalid trace event list '%s', tracing everything.\n", argv[i] + 15);
+                trace_events = TRACE_ALL;
+            }
+        } else if (strncmp(argv[i], "--state=", 8) == 0) {
+            state_path = argv[i] + 8;
+        } else if (strncmp(argv[i], "--load-state=", 13) == 0) {
+            state_path = argv[i] + 13;
+            load_state = true;
+        } else if (strcmp(argv[i], "--rewind") == 0) {
+            rewind_capacity = REWIND_DEFAULT_CAPACITY;
+        } else if (strncmp(argv[i], "--rewind=", 9) == 0) {
+            rewind_capacity = (size_t)strtoul(argv[i] + 9, NULL, 10) << 20;
+        } else if (strncmp(argv[i], "--rewind-interval=", 18) == 0) {
+            rewind_interval = (uint32_t)strtoul(argv[i] + 18, NULL, 10);
+        } else if (strncmp(argv[i], "--run-ahead=", 12) == 0) {
+            run_ahead = (uint32_t)strtoul(argv[i] + 12, NULL, 10);
+        } else if (strncmp(argv[i], "--record=", 9) == 0) {
+            record_path = argv[i] + 9;
+        } else if (strncmp(argv[i], "--play=", 7) == 0) {
+            play_path = argv[i] + 7;
+        } else if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (strncmp(argv[i], "--frames=", 9) == 0) {
+            max_frames = strtoull(argv[i] + 9, NULL, 10);
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            fprintf(stderr, "Warning: Unknown option '%s' ignored.\n", argv[i]);
+        } else {
+            bios_path = argv[i];
+        }
+    }
+    if (gpu_backend < 0) {
+        gpu_backend = headless ? GPU_BACKEND_SOFTWARE : GPU_BACKEND_OPENGL;
+    } else if (headless && gpu_backend == GPU_BACKEND_OPENGL) {
+        fprintf(stderr, "Warning: --headless has no GL context, draw commands will be dropped.\n");
+    }
+    if (play_path && (record_path || load_state)) {
+        fprintf(stderr, "Warning: --play starts from the movie's own state, ignoring --record/--load-state.\n");
+        record_path = NULL;
+        load_state = false;
+    }
+    if (bench_gpu_path) {
+        // Standalone: no machine, no window
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        uint32_t max_threads = raster_threads ? raster_threads : (cores > 0 ? (uint32_t)cores : 1);
+        return gpu_bench_run(bench_gpu_path, max_threads, raster_tile) ? 0 : 1;
+    }
+    if (bench_vram) {
+        return gpu_bench_vram() ? 0 : 1;
+    }
+    if (bench_cpu) {
+        return cpu_bench_run() ? 0 : 1;
+    }
+    if (bench_idle) {
+        return cpu_bench_idle() ? 0 : 1;
+    }
+    // --- MODIFICATION: More accurate cycles per frame calculation ---
+    // The PSX CPU runs at 33,868,800 Hz.
+    // For a 60 FPS target (NTSC), we run this many cycles per frame.
+    const uint32_t cycles_per_frame = VBLANK_PERIOD_CYCLES;
+
+    printf("--- ZoniStation One Emulator ---\n");
+    printf("Attempting to load BIOS from: %s\n", bios_path);
+
+    // --- SDL & OpenGL Initialization ---
+    // Headless runs (movie replays, benchmarks) emulate without a window or renderer
+    SDL_Window* window = NULL;
+    SDL_GLContext gl_context = NULL;
+    if (headless) {
+        printf("Running headless (no window, no GL renderer).\n");
+        logger_category_level[LOG_RENDERER] = LOG_LEVEL_OFF; // Every draw would report the missing renderer
+    } else if (!create_window(&window, &gl_context)) {
+        return 1;
+    }
 
     // --- Emulator Component Initialization ---
     printf("Initializing Emulator Components...\n");
@@ -107,9 +353,13 @@ int main(int argc, char *argv[]) {
     
     printf("  Initializing Interconnect...\n");
     interconnect_init(interconnect_state, bios_data, ram_memory);
+    gpu_set_backend(&interconnect_state->gpu, (GpuBackend)gpu_backend);
+    if (use_fastmem_arena && !fastmem_arena_init(interconnect_state)) {
+        printf("Warning: Fastmem arena unavailable, using the page tables.\n");
+    }
 
     printf("  Initializing Renderer...\n");
-    if (!renderer_init(&interconnect_state->gpu.renderer)) {
+    if (!headless && !renderer_init(&interconnect_state->gpu.renderer)) {
         fprintf(stderr, "Failed to initialize renderer!\n");
         return 1; // Cleanup is handled later
     }
@@ -121,92 +371,177 @@ int main(int argc, char *argv[]) {
 
     printf("  Initializing CPU...\n");
     cpu_init(cpu_state, interconnect_state);
+    cpu_set_exec_mode(cpu_state, cpu_mode);
+    if (load_state && !savestate_load_file(cpu_state, state_path)) {
+        printf("Warning: Could not load save state '%s'. Starting from power-on.\n", state_path);
+    }
+
+    if (trace_path && trace_open(trace_path, trace_events, &interconnect_state->scheduler.now)) {
+        set_tracing(interconnect_state, true);
+    }
+
+    Rewind rewind_state;
+    bool rewind_enabled = rewind_capacity > 0 && rewind_init(&rewind_state, rewind_capacity, rewind_interval);
+
+    // Movies start from the state reached so far: power-on, or the state just loaded
+    Movie movie = { 0 };
+    int exit_code = 0;
+    if (play_path && !movie_play(&movie, play_path, cpu_state)) {
+        fprintf(stderr, "Failed to play movie '%s'.\n", play_path);
+        exit_code = 1;
+    } else if (record_path && !movie_record(&movie, record_path, cpu_state, load_state)) {
+        fprintf(stderr, "Failed to record movie '%s'.\n", record_path);
+        exit_code = 1;
+    }
+
+    // Started last: movie_play may have switched the backend
+    if (raster_threads > 0) {
+        if (interconnect_state->gpu.backend != GPU_BACKEND_SOFTWARE) {
+            printf("Warning: --raster-threads only applies to --gpu=soft.\n");
+        } else if (!raster_pool_start(&interconnect_state->gpu, raster_threads, raster_tile)) {
+            printf("Warning: Tiled rasterization unavailable, drawing polygons immediately.\n");
+        }
+    }
+    if (gpu_threaded && !gpu_thread_start(&interconnect_state->gpu)) {
+        printf("Warning: GPU thread unavailable (needs --gpu=soft), GP0 runs on the CPU thread.\n");
+    }
 
     printf("All Emulator Components Initialized.\n");
 
     // --- Main Emulation Loop ---
     printf("Starting Emulation Loop...\n");
-    bool should_quit = false;
+    bool should_quit = exit_code != 0;
+    bool rewinding = false; // Backspace held
+    SaveStateBuffer run_ahead_state = { NULL, 0, 0 }; // Rollback point of the run-ahead frames
     SDL_Event event;
+    uint64_t frames_run = 0;
+    struct timespec loop_start, loop_end;
+    // One cycle per instruction: the instructions executed are the cycles not skipped as idle
+    uint64_t cycles_start = interconnect_state->scheduler.now;
+    uint64_t idle_start = cpu_state->idle_cycles_skipped;
+    clock_gettime(CLOCK_MONOTONIC, &loop_start);
 
     while (!should_quit) {
         // --- Handle Input/Window Events ---
-        while (SDL_PollEvent(&event)) {
+        // (F7 and rewinding would break the timeline a movie is recording or replaying)
+        while (!headless && SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) {
                 should_quit = true;
             } else if (event.type == SDL_KEYDOWN) {
                 if (event.key.keysym.sym == SDLK_ESCAPE) {
                     should_quit = true;
+                } else if (event.key.keysym.sym == SDLK_F9 && trace_mask() != 0) {
+                    set_tracing(interconnect_state, !trace_is_enabled());
+                } else if (event.key.keysym.sym == SDLK_F5) {
+                    savestate_save_file(cpu_state, state_path);
+                } else if (event.key.keysym.sym == SDLK_F7 && movie.mode == MOVIE_IDLE) {
+                    savestate_load_file(cpu_state, state_path);
+                } else if (event.key.keysym.sym == SDLK_BACKSPACE) {
+                    rewinding = rewind_enabled && movie.mode == MOVIE_IDLE;
                 }
+            } else if (event.type == SDL_KEYUP && event.key.keysym.sym == SDLK_BACKSPACE) {
+                rewinding = false;
             }
         }
 
-        // --- Run Emulation for One Frame ---
-        
-        // Loop through cycles, but also step components at a finer grain.
-        // This improves timing accuracy for interrupts and peripherals.
-        // We will step timers every ~256 cycles for better resolution.
-        for (uint32_t cycles_done = 0; cycles_done < cycles_per_frame; ) {
-            // Define a number of cycles for this "step"
-            uint32_t cycles_to_run = 256; 
-
-            // Execute a small batch of CPU instructions
-            for(int i = 0; i < cycles_to_run; i++) {
-                 cpu_run_next_instruction(cpu_state);
-            }
-
-            // --- MODIFICATION: Step timers more frequently ---
-            // After running a small batch of CPU cycles, we step the timers.
-            // This ensures timer interrupts are more accurately timed relative to the CPU.
-            timers_step(&interconnect_state->timers_state, cycles_to_run);
+        if (max_frames && frames_run >= max_frames) break;
 
-            cycles_done += cycles_to_run;
+        // --- Sample the Pad ---
+        // Once per emulated frame; a movie records it or replaces it with the recorded input
+        if (!rewinding) {
+            uint16_t buttons = headless ? 0 : read_pad_buttons();
+            if (!movie_frame_input(&movie, &buttons)) {
+                // Replay finished: verify it, then stop (headless) or carry on live
+                if (!movie_close(&movie, cpu_state)) exit_code = 1;
+                printf("Movie: replay of %llu frames %s.\n", (unsigned long long)frames_run,
+                       exit_code ? "DIVERGED from the recording" : "matches the recording");
+                if (headless) break;
+            }
+            interconnect_state->pad_buttons = buttons;
         }
 
-        // --- MODIFICATION: Step the CD-ROM drive once per frame ---
-        // This is for longer-term actions, like the delay in the Init command.
-        cdrom_step(&interconnect_state->cdrom, cycles_per_frame);
-
-        // --- Render and Display Frame ---
-        // --- PROPOSED MODIFICATION START ---
-        // This is the sequence that connects everything together.
-
-        // 1. UPLOAD VRAM TO TEXTURE:
-        //    Upload the current state of our emulated VRAM to the OpenGL texture object.
-        //    This makes the VRAM content available to our shader.
-        glBindTexture(GL_TEXTURE_2D, interconnect_state->gpu.renderer.vram_texture_id);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1024, 512, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, interconnect_state->gpu.vram.data);
-        glBindTexture(GL_TEXTURE_2D, 0); // Unbind to be safe
-        check_gl_error("After VRAM Texture Upload");
-
-        // 2. DRAW THE RENDERER'S BUFFER: (THIS IS THE MISSING CALL)
-        //    Now, tell the renderer to draw everything that was buffered during this frame's CPU execution.
-        //    This calls renderer_draw(), which uploads the vertex data and calls glDrawArrays.
-        renderer_display(&interconnect_state->gpu.renderer);
-        
-        // 3. SWAP THE WINDOW:
-        //    Finally, swap the back buffer (which we just drew on) to the front to display the rendered frame.
-        SDL_GL_SwapWindow(window);
-        check_gl_error("After SwapWindow");
-        // --- PROPOSED MODIFICATION END ---
+        // --- Run Emulation for One Frame ---
+        if (rewinding) {
+            // Each displayed frame steps back one snapshot
+            rewind_step_back(&rewind_state, cpu_state, 1);
+            present_frame(interconnect_state, window);
+        } else if (run_ahead == 0) {
+            run_frame(cpu_state, cycles_per_frame, window, true);
+            if (rewind_enabled) rewind_frame(&rewind_state, cpu_state);
+        } else {
+            // Run-ahead: advance the real timeline by one hidden frame and snapshot it, run
+            // 'run_ahead' frames further, show the last one, then roll back to the snapshot.
+            run_frame(cpu_state, cycles_per_frame, window, false);
+            if (rewind_enabled) rewind_frame(&rewind_state, cpu_state);
+            savestate_save(cpu_state, &run_ahead_state);
+            for (uint32_t i = 1; i < run_ahead; ++i) {
+                run_frame(cpu_state, cycles_per_frame, window, false);
+            }
+            run_frame(cpu_state, cycles_per_frame, window, true);
+            savestate_load(cpu_state, run_ahead_state.data, run_ahead_state.size);
+        }
+        if (!rewinding) frames_run++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &loop_end);
+    double elapsed = (double)(loop_end.tv_sec - loop_start.tv_sec) + (loop_end.tv_nsec - loop_start.tv_nsec) / 1e9;
+    printf("Emulated %llu frames in %.3f s (%.1f fps).\n", (unsigned long long)frames_run, elapsed,
+           elapsed > 0 ? frames_run / elapsed : 0.0);
+    if (run_ahead == 0 && !rewind_enabled && interconnect_state->scheduler.now >= cycles_start) {
+        // (Run-ahead and rewind load older states, which would make the count meaningless)
+        uint64_t instructions = (interconnect_state->scheduler.now - cycles_start) - (cpu_state->idle_cycles_skipped - idle_start);
+        printf("CPU: %llu instructions executed (%.2f M instructions/s).\n", (unsigned long long)instructions,
+               elapsed > 0 ? instructions / elapsed / 1e6 : 0.0);
+    }
+    if (movie.mode == MOVIE_RECORDING) {
+        if (!movie_close(&movie, cpu_state)) exit_code = 1;
+        printf("Movie: recorded %llu frames to '%s'.\n", (unsigned long long)frames_run, record_path);
+    } else if (movie.mode == MOVIE_PLAYING) {
+        movie_close(&movie, cpu_state); // Stopped before the end: nothing to verify
+        printf("Movie: replay stopped after %llu frames.\n", (unsigned long long)frames_run);
     }
 
     // --- Cleanup ---
     printf("Emulation loop finished. Cleaning up...\n");
 
-    renderer_destroy(&interconnect_state->gpu.renderer);
-    SDL_GL_DeleteContext(gl_context);
-    SDL_DestroyWindow(window);
-    SDL_Quit();
-    printf("SDL Quit.\n");
+    gpu_thread_stop(&interconnect_state->gpu);
+    raster_pool_stop(&interconnect_state->gpu);
+    Renderer* renderer = &interconnect_state->gpu.renderer;
+    if (renderer->upload_frames) {
+        printf("Renderer: %.0f VRAM bytes uploaded per frame on average (%.1f rectangles, %llu frames, %u last frame).\n",
+               (double)renderer->upload_bytes / renderer->upload_frames,
+               (double)renderer->upload_rects / renderer->upload_frames,
+               (unsigned long long)renderer->upload_frames, renderer->upload_last_bytes);
+    }
+    renderer_destroy(renderer);
+    if (window) {
+        SDL_GL_DeleteContext(gl_context);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        printf("SDL Quit.\n");
+    }
     
     // --- MODIFICATION: Free allocated memory ---
+    printf("CPU: %llu cycles skipped in idle loops.\n", (unsigned long long)cpu_state->idle_cycles_skipped);
+    savestate_buffer_free(&run_ahead_state);
+    if (rewind_enabled) {
+        if (rewind_state.captures) {
+            printf("Rewind: %llu snapshots, %.0f bytes and %.3f ms each on average.\n",
+                   (unsigned long long)rewind_state.captures,
+                   (double)rewind_state.capture_bytes / rewind_state.captures,
+                   rewind_state.capture_ns / 1e6 / rewind_state.captures);
+        }
+        rewind_destroy(&rewind_state);
+    }
+    trace_close();
+    cpu_destroy(cpu_state);
+    fastmem_arena_destroy(interconnect_state);
     free(cpu_state);
     free(interconnect_state);
     free(ram_memory);
     free(bios_data);
 
     printf("--- ZoniStation One Emulator Finished ---\n");
+    logger_shutdown();
     fclose(log_file);
-    return 0;
+    return exit_code;
 }
\ No newline at end of file
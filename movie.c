@@ -0,0 +1,209 @@
+// movie.c
+// Input movie recording and replay (see movie.h for the file layout).
+#include "movie.h"
+#include "interconnect.h"
+#include "savestate.h"
+#include "logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MOVIE_DISC_HASH_SECTORS 32 // Raw sectors hashed at the start of the disc image
+#define MOVIE_SECTOR_SIZE       2352
+
+#define FNV_OFFSET 1469598103934665603ull
+#define FNV_PRIME  1099511628211ull
+
+static uint64_t movie_fnv(const void* data, size_t length, uint64_t hash) {
+    const uint8_t* bytes = data;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Hashes the size and the first sectors of the mounted disc image, leaving the
+ * file position where it was. Hashing the whole image would cost seconds on a CD.
+ */
+static uint64_t movie_disc_hash(Cdrom* cdrom) {
+    FILE* file = cdrom->disc_file;
+    if (!cdrom->disc_present || file == NULL) return 0;
+
+    long position = ftell(file);
+    uint64_t hash = FNV_OFFSET;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        int64_t size = ftell(file);
+        hash = movie_fnv(&size, sizeof(size), hash);
+    }
+    uint8_t sector[MOVIE_SECTOR_SIZE];
+    if (fseek(file, 0, SEEK_SET) == 0) {
+        for (int i = 0; i < MOVIE_DISC_HASH_SECTORS; ++i) {
+            size_t length = fread(sector, 1, sizeof(sector), file);
+            hash = movie_fnv(sector, length, hash);
+            if (length < sizeof(sector)) break;
+        }
+    }
+    clearerr(file);
+    fseek(file, position, SEEK_SET);
+    return hash;
+}
+
+/**
+ * @brief Hash of the whole machine state, as serialized by savestate_save.
+ */
+static bool movie_state_hash(Cpu* cpu, uint64_t* hash) {
+    SaveStateBuffer buffer = { NULL, 0, 0 };
+    bool ok = savestate_save(cpu, &buffer);
+    if (ok) *hash = movie_fnv(buffer.data, buffer.size, FNV_OFFSET);
+    savestate_buffer_free(&buffer);
+    return ok;
+}
+
+static void movie_reset(Movie* movie) {
+    if (movie->file) fclose(movie->file);
+    free(movie->inputs);
+    memset(movie, 0, sizeof(*movie));
+}
+
+
+// --- Recording ---
+bool movie_record(Movie* movie, const char* path, Cpu* cpu, bool from_state) {
+    memset(movie, 0, sizeof(*movie));
+    MovieHeader* header = &movie->header;
+    memcpy(header->magic, MOVIE_MAGIC, sizeof(header->magic));
+    header->version = MOVIE_VERSION;
+    header->bios_hash = movie_fnv(cpu->inter->bios->data, BIOS_SIZE, FNV_OFFSET);
+    header->disc_hash = movie_disc_hash(&cpu->inter->cdrom);
+    header->exec_mode = (uint32_t)cpu->exec_mode;
+    if (cpu->inter->gpu.backend == GPU_BACKEND_SOFTWARE) header->flags |= MOVIE_SOFTWARE_GPU;
+
+    SaveStateBuffer state = { NULL, 0, 0 };
+    if (from_state) {
+        if (!savestate_save(cpu, &state)) return false;
+        header->flags |= MOVIE_FROM_STATE;
+        header->state_size = state.size;
+    }
+
+    movie->file = fopen(path, "wb");
+    if (!movie->file) {
+        perror("Movie: failed to create the movie file");
+        savestate_buffer_free(&state);
+        return false;
+    }
+    // The header is written again with the frame count and final hash by movie_close
+    bool ok = fwrite(header, sizeof(*header), 1, movie->file) == 1 &&
+              fwrite(state.data, 1, state.size, movie->file) == state.size;
+    savestate_buffer_free(&state);
+    if (!ok) {
+        LOG_ERROR(LOG_CPU, "Movie: failed to write '%s'\n", path);
+        movie_reset(movie);
+        return false;
+    }
+    movie->mode = MOVIE_RECORDING;
+    LOG_INFO(LOG_CPU, "Movie: recording to '%s' from %s\n", path, from_state ? "a save state" : "power-on");
+    return true;
+}
+
+
+// --- Playback ---
+bool movie_play(Movie* movie, const char* path, Cpu* cpu) {
+    memset(movie, 0, sizeof(*movie));
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        perror("Movie: failed to open the movie file");
+        return false;
+    }
+
+    MovieHeader* header = &movie->header;
+    uint8_t* state = NULL;
+    bool ok = false;
+    if (fread(header, sizeof(*header), 1, file) != 1 ||
+        memcmp(header->magic, MOVIE_MAGIC, sizeof(header->magic)) != 0) {
+        LOG_ERROR(LOG_CPU, "Movie: '%s' is not a movie file\n", path);
+    } else if (header->version != MOVIE_VERSION) {
+        LOG_ERROR(LOG_CPU, "Movie: unsupported version %u\n", header->version);
+    } else if (header->bios_hash != movie_fnv(cpu->inter->bios->data, BIOS_SIZE, FNV_OFFSET)) {
+        LOG_ERROR(LOG_CPU, "Movie: recorded with a different BIOS\n");
+    } else if (header->disc_hash != movie_disc_hash(&cpu->inter->cdrom)) {
+        LOG_ERROR(LOG_CPU, "Movie: recorded with a different disc (or without one)\n");
+    } else if (header->exec_mode > CPU_EXEC_JIT) {
+        LOG_ERROR(LOG_CPU, "Movie: invalid CPU mode %u\n", header->exec_mode);
+    } else {
+        state = header->state_size ? malloc((size_t)header->state_size) : NULL;
+        movie->inputs = malloc(((size_t)header->frame_count + 1) * sizeof(uint16_t));
+        ok = movie->inputs != NULL && (header->state_size == 0 || state != NULL) &&
+             fread(state, 1, (size_t)header->state_size, file) == header->state_size &&
+             fread(movie->inputs, sizeof(uint16_t), header->frame_count, file) == header->frame_count;
+        if (!ok) LOG_ERROR(LOG_CPU, "Movie: '%s' is truncated\n", path);
+    }
+    fclose(file);
+
+    if (ok) {
+        cpu_set_exec_mode(cpu, (CpuExecMode)header->exec_mode);
+        gpu_set_backend(&cpu->inter->gpu, (header->flags & MOVIE_SOFTWARE_GPU) ? GPU_BACKEND_SOFTWARE : GPU_BACKEND_OPENGL);
+        if ((header->flags & MOVIE_FROM_STATE) && !savestate_load(cpu, state, (size_t)header->state_size)) {
+            LOG_ERROR(LOG_CPU, "Movie: the embedded save state was rejected\n");
+            ok = false;
+        }
+    }
+    free(state);
+    if (!ok) {
+        movie_reset(movie);
+        return false;
+    }
+    if (cpu->exec_mode != (CpuExecMode)header->exec_mode) {
+        LOG_WARN(LOG_CPU, "Movie: recorded CPU mode %u is unavailable, the replay may diverge\n", header->exec_mode);
+    }
+    movie->mode = MOVIE_PLAYING;
+    LOG_INFO(LOG_CPU, "Movie: playing '%s' (%u frames)\n", path, header->frame_count);
+    return true;
+}
+
+
+// --- Per Frame ---
+bool movie_frame_input(Movie* movie, uint16_t* buttons) {
+    if (movie->mode == MOVIE_RECORDING) {
+        if (fwrite(buttons, sizeof(*buttons), 1, movie->file) != 1) {
+            LOG_ERROR(LOG_CPU, "Movie: failed to write frame %u\n", movie->frame);
+        }
+        movie->frame++;
+    } else if (movie->mode == MOVIE_PLAYING) {
+        if (movie->frame >= movie->header.frame_count) return false;
+        *buttons = movie->inputs[movie->frame++];
+    }
+    return true;
+}
+
+bool movie_close(Movie* movie, Cpu* cpu) {
+    bool ok = true;
+    if (movie->mode == MOVIE_RECORDING) {
+        MovieHeader* header = &movie->header;
+        header->frame_count = movie->frame;
+        ok = movie_state_hash(cpu, &header->final_hash) &&
+             fseek(movie->file, 0, SEEK_SET) == 0 &&
+             fwrite(header, sizeof(*header), 1, movie->file) == 1;
+        if (fclose(movie->file) != 0) ok = false;
+        movie->file = NULL;
+        if (ok) {
+            LOG_INFO(LOG_CPU, "Movie: recorded %u frames, final state %016llx\n",
+                     header->frame_count, (unsigned long long)header->final_hash);
+        } else {
+            LOG_ERROR(LOG_CPU, "Movie: failed to finish the movie file\n");
+        }
+    } else if (movie->mode == MOVIE_PLAYING) {
+        uint64_t hash = 0;
+        if (movie->frame < movie->header.frame_count) {
+            LOG_INFO(LOG_CPU, "Movie: replay stopped at frame %u of %u, not verified\n",
+                     movie->frame, movie->header.frame_count);
+        } else if (!movie_state_hash(cpu, &hash) || hash != movie->header.final_hash) {
+            LOG_ERROR(LOG_CPU, "Movie: replay DIVERGED, final state %016llx, recorded %016llx\n",
+                      (unsigned long long)hash, (unsigned long long)movie->header.final_hash);
+            ok = false;
+        } else {
+            LOG_INFO(LOG_CPU, "Movie: replay matches the recording (%016llx)\n", (unsigned long long)hash);
+        }
+    }
+    movie_reset(movie);
+    return ok;
+}
@@ -0,0 +1,95 @@
+// movie.h
+// Input movies: per-frame controller input recorded from a known starting point, replayed bit-exactly.
+#ifndef MOVIE_H
+#define MOVIE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "cpu.h"
+
+#define MOVIE_MAGIC   "PSXMOVIE"
+#define MOVIE_VERSION 1
+
+#define MOVIE_FROM_STATE   (1u << 0) // Starts from the embedded save state instead of power-on
+#define MOVIE_SOFTWARE_GPU (1u << 1) // Drawn by the software rasterizer (which writes VRAM)
+
+/* --- File Layout ---
+ * One MovieHeader, then 'state_size' bytes of save state (MOVIE_FROM_STATE only), then
+ * one uint16_t of PAD_* buttons per frame (host byte order, like save states).
+ *
+ * A frame is exactly VBLANK_PERIOD_CYCLES of emulation with the buttons set before it
+ * starts, so a replay does not depend on wall-clock time or on how fast the host runs.
+ * The BIOS and disc hashes make sure the replay runs against the same images, and the
+ * recorded CPU mode is forced because the interpreter dispatches device events at a
+ * finer granularity than the block modes. The GPU backend is forced too: only the
+ * software one draws into VRAM (without a GL context the OpenGL one simply drops the
+ * draws, which is what VRAM looked like while recording with it). 'final_hash'
+ * covers the save state taken after the last frame: a replay that reaches the same
+ * hash reproduced the machine bit for bit.
+ */
+typedef struct {
+    char magic[8];        // MOVIE_MAGIC (not NUL terminated)
+    uint32_t version;     // MOVIE_VERSION
+    uint32_t flags;       // MOVIE_* flags
+    uint64_t bios_hash;   // FNV-1a of the BIOS image
+    uint64_t disc_hash;   // FNV-1a of the disc image size and first sectors (0: no disc)
+    uint32_t exec_mode;   // CpuExecMode the movie was recorded with
+    uint32_t frame_count; // Frames of input following the state
+    uint64_t final_hash;  // FNV-1a of the save state after the last frame
+    uint64_t state_size;  // Embedded save state bytes (0 unless MOVIE_FROM_STATE)
+} MovieHeader;
+
+typedef enum {
+    MOVIE_IDLE,
+    MOVIE_RECORDING,
+    MOVIE_PLAYING
+} MovieMode;
+
+typedef struct {
+    MovieMode mode;
+    FILE* file;          // Output file while recording
+    MovieHeader header;
+    uint16_t* inputs;    // Every frame's buttons while playing
+    uint32_t frame;      // Frames recorded or replayed so far
+} Movie;
+
+/**
+ * @brief Starts recording to 'path' from the machine's current state.
+ * @param movie The movie (any previous contents are discarded).
+ * @param path Output file.
+ * @param cpu The machine being recorded.
+ * @param from_state Embed a save state of the current machine; otherwise the machine
+ *        must be freshly powered on and replays start from power-on too.
+ * @return false if the file could not be written.
+ */
+bool movie_record(Movie* movie, const char* path, Cpu* cpu, bool from_state);
+
+/**
+ * @brief Loads a movie for replay: checks the BIOS and disc, switches the CPU and the
+ * GPU backend to the recorded modes and, for MOVIE_FROM_STATE movies, loads the
+ * embedded state. Power-on movies expect a freshly initialized machine.
+ * @return false if the movie is malformed or was recorded against other images.
+ */
+bool movie_play(Movie* movie, const char* path, Cpu* cpu);
+
+/**
+ * @brief Call once per frame, before emulating it. Recording appends 'buttons';
+ * playing replaces them with the recorded ones.
+ * @param movie The movie.
+ * @param buttons In: the live input. Out: the input to emulate the frame with.
+ * @return false once a replay has run out of frames ('buttons' is left untouched).
+ */
+bool movie_frame_input(Movie* movie, uint16_t* buttons);
+
+/**
+ * @brief Ends recording or playing. A recording gets its frame count and final hash;
+ * a replay that reached its last frame compares its final hash with the recorded one.
+ * @param movie The movie (left idle).
+ * @param cpu The machine, in its state after the last frame.
+ * @return false if writing failed or the replay diverged.
+ */
+bool movie_close(Movie* movie, Cpu* cpu);
+
+#endif // MOVIE_H
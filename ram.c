@@ -7,7 +7,10 @@
 void ram_init(Ram* ram) {
     // Fill RAM with a "garbage" value (0xCA) to simulate uninitialized state
     // and potentially help catch reads from uninitialized memory.
+    ram->data = ram->storage;
     memset(ram->data, 0xCA, RAM_SIZE);
+    // Everything starts dirty: no consumer has seen the content yet
+    memset(ram->dirty, 0xFF, sizeof(ram->dirty));
     printf("RAM Initialized (%d bytes, filled with 0xCA).\n", RAM_SIZE);
 }
 
@@ -43,6 +46,7 @@ void ram_store32(Ram* ram, uint32_t offset, uint32_t value) {
     ram->data[offset + 1] = (uint8_t)((value >> 8) & 0xFF);
     ram->data[offset + 2] = (uint8_t)((value >> 16) & 0xFF);
     ram->data[offset + 3] = (uint8_t)((value >> 24) & 0xFF);
+    ram_mark_dirty(ram, offset);
 }
 
 // Reads a 16-bit value from RAM (Little-Endian)
@@ -66,6 +70,7 @@ void ram_store16(Ram* ram, uint32_t offset, uint16_t value) {
     }
     ram->data[offset + 0] = (uint8_t)(value & 0xFF);
     ram->data[offset + 1] = (uint8_t)((value >> 8) & 0xFF);
+    ram_mark_dirty(ram, offset);
 }
 
 // Reads an 8-bit value from RAM
@@ -86,4 +91,33 @@ void ram_store8(Ram* ram, uint32_t offset, uint8_t value) {
         return;
     }
     ram->data[offset] = value;
-}
\ No newline at end of file
+    ram_mark_dirty(ram, offset);
+}
+
+// Marks every page overlapping [offset, offset + size)
+void ram_mark_dirty_range(Ram* ram, uint32_t offset, uint32_t size) {
+    if (size == 0) return;
+    uint32_t first = offset >> RAM_DIRTY_PAGE_SHIFT;
+    uint32_t last = (offset + size - 1) >> RAM_DIRTY_PAGE_SHIFT;
+    if (last - first >= RAM_DIRTY_PAGE_COUNT - 1) {
+        memset(ram->dirty, 0xFF, sizeof(ram->dirty));
+        return;
+    }
+    for (uint32_t page = first; page <= last; ++page) {
+        ram_mark_dirty(ram, page << RAM_DIRTY_PAGE_SHIFT);
+    }
+}
+
+void ram_clear_dirty(Ram* ram) {
+    memset(ram->dirty, 0, sizeof(ram->dirty));
+}
+
+uint32_t ram_take_dirty(Ram* ram, uint64_t out[RAM_DIRTY_WORDS]) {
+    uint32_t count = 0;
+    for (int i = 0; i < RAM_DIRTY_WORDS; ++i) {
+        out[i] = ram->dirty[i];
+        count += (uint32_t)__builtin_popcountll(ram->dirty[i]);
+        ram->dirty[i] = 0;
+    }
+    return count;
+}
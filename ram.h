@@ -2,13 +2,22 @@
 #define RAM_H
 
 #include <stdint.h> // For uint8_t, uint16_t, uint32_t
+#include <stdbool.h>
 
 // Define the size of the PlayStation's main RAM (2 Megabytes)
 #define RAM_SIZE (2 * 1024 * 1024)
 
+// Dirty tracking granularity: one bit per 1 KiB page (2048 pages, 32 x 64-bit words)
+#define RAM_DIRTY_PAGE_SHIFT 10
+#define RAM_DIRTY_PAGE_SIZE  (1u << RAM_DIRTY_PAGE_SHIFT)
+#define RAM_DIRTY_PAGE_COUNT (RAM_SIZE >> RAM_DIRTY_PAGE_SHIFT)
+#define RAM_DIRTY_WORDS      (RAM_DIRTY_PAGE_COUNT / 64)
+
 // Structure to hold the RAM data
 typedef struct {
-    uint8_t data[RAM_SIZE]; // Buffer for the 2MB RAM content
+    uint8_t* data;              // Active 2MB RAM buffer (storage, or the fastmem arena mapping)
+    uint64_t dirty[RAM_DIRTY_WORDS]; // Pages written since the last ram_clear_dirty/ram_take_dirty
+    uint8_t storage[RAM_SIZE];  // Default backing buffer for the RAM content
 } Ram;
 
 // Initializes the RAM memory (e.g., fills with a default pattern).
@@ -32,5 +41,30 @@ uint8_t ram_load8(Ram* ram, uint32_t offset);
 // Writes an 8-bit value to RAM at the specified offset.
 void ram_store8(Ram* ram, uint32_t offset, uint8_t value);
 
+// --- Dirty Page Tracking ---
+// Every write path (ram_store*, the interconnect fast paths, DMA) marks the page it
+// touched. Marking is one OR into the bitmap; the offset is wrapped to the 2MB, so
+// physical addresses in the RAM mirrors can be passed as is.
+
+// Marks the page containing 'offset' as written.
+static inline void ram_mark_dirty(Ram* ram, uint32_t offset) {
+    uint32_t page = (offset >> RAM_DIRTY_PAGE_SHIFT) & (RAM_DIRTY_PAGE_COUNT - 1);
+    ram->dirty[page >> 6] |= 1ull << (page & 63);
+}
+
+// Returns true if the page was written since the bitmap was last cleared.
+static inline bool ram_page_is_dirty(const Ram* ram, uint32_t page) {
+    return (ram->dirty[page >> 6] >> (page & 63)) & 1;
+}
+
+// Marks every page overlapping [offset, offset + size) (bulk writers, e.g. state loads).
+void ram_mark_dirty_range(Ram* ram, uint32_t offset, uint32_t size);
+
+// Clears the whole bitmap.
+void ram_clear_dirty(Ram* ram);
+
+// Copies the bitmap to 'out' and clears it. Returns the number of dirty pages.
+uint32_t ram_take_dirty(Ram* ram, uint64_t out[RAM_DIRTY_WORDS]);
+
 
 #endif // RAM_H
\ No newline at end of file
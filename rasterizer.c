@@ -0,0 +1,731 @@
+// rasterizer.c
+// Software polygon rasterizer writing 15-bit pixels into VRAM (see rasterizer.h).
+#include "rasterizer.h"
+#include "logger.h"
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <stdlib.h> // For abs()
+#include <string.h>
+#include <pthread.h>
+
+#define RASTER_MAX_WIDTH  1023 // Larger polygons are not drawn by the GPU
+#define RASTER_MAX_HEIGHT 511
+#define RASTER_FRAC_BITS  16   // Fraction bits of the interpolated attributes
+
+#define RASTER_BATCH_TRIANGLES     4096  // Triangles binned before a flush is forced
+#define RASTER_PARALLEL_MIN_PIXELS 16384 // Smaller batches are drawn by the flushing thread alone
+
+// Added to the 8-bit color before the 8 -> 5 bit reduction, indexed [y & 3][x & 3]
+static const int8_t raster_dither_matrix[4][4] = {
+    { -4,  0, -3,  1 },
+    {  2, -2,  3, -1 },
+    { -3,  1, -4,  0 },
+    {  3, -1,  2, -2 },
+};
+
+// Everything a pixel needs, resolved once per primitive
+typedef struct {
+    uint16_t* vram;
+    uint32_t flags;
+    bool dither;
+    uint32_t semi_mode;        // 0: B/2+F/2, 1: B+F, 2: B-F, 3: B+F/4
+    uint16_t mask_or;          // 0x8000 if the mask bit is forced on
+    bool check_mask;           // Leave pixels with the mask bit set alone
+
+    // Texture
+    uint32_t depth;            // TextureDepth (3 is treated as 15-bit)
+    uint32_t page_x, page_y;   // Texture page origin in VRAM
+    const uint16_t* clut_row;  // VRAM line holding the CLUT
+    uint32_t clut_x;
+    uint8_t u_and, u_or;       // Texture window
+    uint8_t v_and, v_or;
+} RasterState;
+
+static void raster_setup(RasterState* rs, Gpu* gpu, uint32_t flags, uint16_t clut, uint16_t tpage) {
+    rs->vram = (uint16_t*)gpu->vram.data;
+    rs->flags = flags;
+    rs->dither = gpu->dithering &&
+                 ((flags & RASTER_SHADED) || (flags & (RASTER_TEXTURED | RASTER_RAW_TEXTURE)) == RASTER_TEXTURED);
+    rs->semi_mode = (flags & RASTER_TEXTURED) ? (tpage >> 5) & 3u : gpu->semi_transparency;
+    rs->mask_or = gpu->force_set_mask_bit ? 0x8000 : 0;
+    rs->check_mask = gpu->preserve_masked_pixels;
+
+    rs->depth = (tpage >> 7) & 3u;
+    rs->page_x = (tpage & 0xFu) * 64;
+    rs->page_y = ((tpage >> 4) & 1u) * 256;
+    rs->clut_row = rs->vram + (((clut >> 6) & 0x1FFu) * VRAM_WIDTH);
+    rs->clut_x = (clut & 0x3Fu) * 16;
+    // Window: u = (u AND NOT(mask*8)) OR ((offset AND mask)*8)
+    rs->u_and = (uint8_t)~(gpu->texture_window_x_mask * 8);
+    rs->u_or = (uint8_t)((gpu->texture_window_x_offset & gpu->texture_window_x_mask) * 8);
+    rs->v_and = (uint8_t)~(gpu->texture_window_y_mask * 8);
+    rs->v_or = (uint8_t)((gpu->texture_window_y_offset & gpu->texture_window_y_mask) * 8);
+}
+
+
+// --- Pixel Pipeline ---
+static inline uint16_t raster_texel(const RasterState* rs, uint32_t u, uint32_t v) {
+    u = (u & rs->u_and) | rs->u_or;
+    v = (v & rs->v_and) | rs->v_or;
+    const uint16_t* row = rs->vram + ((rs->page_y + v) & (VRAM_HEIGHT - 1)) * VRAM_WIDTH;
+    switch (rs->depth) {
+        case T4Bit: {
+            uint16_t word = row[(rs->page_x + (u >> 2)) & (VRAM_WIDTH - 1)];
+            return rs->clut_row[(rs->clut_x + ((word >> ((u & 3) * 4)) & 0xF)) & (VRAM_WIDTH - 1)];
+        }
+        case T8Bit: {
+            uint16_t word = row[(rs->page_x + (u >> 1)) & (VRAM_WIDTH - 1)];
+            return rs->clut_row[(rs->clut_x + ((word >> ((u & 1) * 8)) & 0xFF)) & (VRAM_WIDTH - 1)];
+        }
+        default:
+            return row[(rs->page_x + u) & (VRAM_WIDTH - 1)];
+    }
+}
+
+static inline uint32_t raster_reduce(int32_t channel, int32_t dither) {
+    channel += dither;
+    if (channel < 0) channel = 0;
+    if (channel > 255) channel = 255;
+    return (uint32_t)channel >> 3;
+}
+
+static inline uint16_t raster_blend(uint32_t mode, uint16_t back, uint16_t front) {
+    uint16_t out = 0;
+    for (int shift = 0; shift < 15; shift += 5) {
+        int32_t b = (back >> shift) & 31, f = (front >> shift) & 31, c;
+        switch (mode) {
+            case 0:  c = (b + f) >> 1; break;
+            case 1:  c = b + f; break;
+            case 2:  c = b - f; break;
+            default: c = b + (f >> 2); break;
+        }
+        if (c < 0) c = 0;
+        if (c > 31) c = 31;
+        out |= (uint16_t)(c << shift);
+    }
+    return out;
+}
+
+/**
+ * @brief Shades and writes one pixel. r/g/b/u/v are the interpolated 8-bit attributes.
+ */
+static inline void raster_pixel(const RasterState* rs, int32_t x, int32_t y,
+                                int32_t r, int32_t g, int32_t b, uint32_t u, uint32_t v) {
+    uint16_t* dst = rs->vram + y * VRAM_WIDTH + x;
+    if (rs->check_mask && (*dst & 0x8000)) return;
+
+    int32_t dither = rs->dither ? raster_dither_matrix[y & 3][x & 3] : 0;
+    uint16_t color;
+    bool semi = (rs->flags & RASTER_SEMI_TRANSPARENT) != 0;
+    if (rs->flags & RASTER_TEXTURED) {
+        uint16_t texel = raster_texel(rs, u, v);
+        if (texel == 0) return; // Fully transparent
+        semi = semi && (texel & 0x8000);
+        if (rs->flags & RASTER_RAW_TEXTURE) {
+            color = texel;
+        } else {
+            // texel * color / 128, computed on the 8-bit scale so dithering can apply
+            color = (uint16_t)(raster_reduce((int32_t)(texel & 31) * r >> 4, dither) |
+                               raster_reduce((int32_t)((texel >> 5) & 31) * g >> 4, dither) << 5 |
+                               raster_reduce((int32_t)((texel >> 10) & 31) * b >> 4, dither) << 10 |
+                               (texel & 0x8000));
+        }
+    } else {
+        color = (uint16_t)(raster_reduce(r, dither) | raster_reduce(g, dither) << 5 | raster_reduce(b, dither) << 10);
+    }
+    if (semi) color = (uint16_t)((color & 0x8000) | raster_blend(rs->semi_mode, *dst, color));
+    *dst = color | rs->mask_or;
+}
+
+
+// --- Triangle Setup ---
+
+// Attribute plane: value(x, y) = base + dx * (x - x0) + dy * (y - y0), RASTER_FRAC_BITS fraction
+typedef struct {
+    int64_t dx, dy;
+} RasterGradient;
+
+static RasterGradient raster_gradient(const RasterVertex* a, const RasterVertex* b, const RasterVertex* c,
+                                      int32_t va, int32_t vb, int32_t vc, int64_t area) {
+    int64_t dab = vb - va, dac = vc - va;
+    RasterGradient gradient;
+    gradient.dx = ((dab * (c->y - a->y) - dac * (b->y - a->y)) << RASTER_FRAC_BITS) / area;
+    gradient.dy = ((dac * (b->x - a->x) - dab * (c->x - a->x)) << RASTER_FRAC_BITS) / area;
+    return gradient;
+}
+
+static inline int32_t raster_clamp8(int64_t value) {
+    int64_t v = value >> RASTER_FRAC_BITS;
+    return v < 0 ? 0 : (v > 255 ? 255 : (int32_t)v);
+}
+
+// Edge function of a->b at p: positive on the inside of a counter-clockwise (in VRAM
+// coordinates, y down) triangle
+static inline int32_t raster_edge(const RasterVertex* a, const RasterVertex* b, int32_t px, int32_t py) {
+    return (b->x - a->x) * (py - a->y) - (b->y - a->y) * (px - a->x);
+}
+
+// Top-left rule: pixels exactly on a top or left edge belong to the triangle
+static inline int32_t raster_edge_bias(const RasterVertex* a, const RasterVertex* b) {
+    int32_t dy = b->y - a->y;
+    bool top_left = dy < 0 || (dy == 0 && b->x > a->x);
+    return top_left ? 0 : -1;
+}
+
+// A triangle ready to be drawn, possibly in pieces (one per tile). Rectangles use the
+// same record: v0 is the top-left corner, the box is the clipped rectangle and the
+// texture coordinates step by u_step/v_step per pixel.
+typedef struct {
+    RasterState rs;
+    RasterVertex v0, v1, v2;            // Counter-clockwise
+    int32_t min_x, min_y, max_x, max_y; // Bounding box clipped to the drawing area (inclusive)
+    int32_t bias0, bias1, bias2;        // Fill rule bias of the edges opposite v0, v1, v2
+    RasterGradient gr, gg, gb, gu, gv;
+    bool rectangle;
+    int32_t u_step, v_step;             // Rectangles: +1, or -1 when flipped (GP0(E1) bits 12-13)
+} RasterTriangle;
+
+/**
+ * @brief Clips a box to the drawing area (and VRAM).
+ * @return false if nothing is left.
+ */
+static bool raster_clip(const Gpu* gpu, int32_t* min_x, int32_t* min_y, int32_t* max_x, int32_t* max_y) {
+    int32_t clip_right = gpu->drawing_area_right < VRAM_WIDTH ? gpu->drawing_area_right : VRAM_WIDTH - 1;
+    int32_t clip_bottom = gpu->drawing_area_bottom < VRAM_HEIGHT ? gpu->drawing_area_bottom : VRAM_HEIGHT - 1;
+    if (*min_x < gpu->drawing_area_left) *min_x = gpu->drawing_area_left;
+    if (*min_y < gpu->drawing_area_top) *min_y = gpu->drawing_area_top;
+    if (*max_x > clip_right) *max_x = clip_right;
+    if (*max_y > clip_bottom) *max_y = clip_bottom;
+    return *min_x <= *max_x && *min_y <= *max_y;
+}
+
+/**
+ * @brief Fixes the winding, clips the bounding box and computes the edge and attribute
+ * planes. Everything per pixel is derived from these exactly (integer planes), so any
+ * part of the triangle can be drawn on its own with the same result.
+ * @return false if nothing is drawn (oversized, degenerate or outside the drawing area).
+ */
+static bool raster_triangle_setup(RasterTriangle* tri, const Gpu* gpu, const RasterState* rs,
+                                  const RasterVertex* v0, const RasterVertex* v1, const RasterVertex* v2) {
+    const RasterVertex* vertices[3] = { v0, v1, v2 };
+    for (int i = 0; i < 3; ++i) {
+        const RasterVertex* a = vertices[i];
+        const RasterVertex* b = vertices[(i + 1) % 3];
+        if (abs(a->x - b->x) > RASTER_MAX_WIDTH || abs(a->y - b->y) > RASTER_MAX_HEIGHT) return false;
+    }
+    int64_t area = raster_edge(v0, v1, v2->x, v2->y);
+    if (area == 0) return false;
+    if (area < 0) { // Make the winding counter-clockwise
+        const RasterVertex* swap = v1;
+        v1 = v2;
+        v2 = swap;
+        area = -area;
+    }
+
+    // Bounding box clipped to the drawing area (inclusive on both ends)
+    int32_t min_x = v0->x, max_x = v0->x, min_y = v0->y, max_y = v0->y;
+    if (v1->x < min_x) min_x = v1->x;
+    if (v2->x < min_x) min_x = v2->x;
+    if (v1->x > max_x) max_x = v1->x;
+    if (v2->x > max_x) max_x = v2->x;
+    if (v1->y < min_y) min_y = v1->y;
+    if (v2->y < min_y) min_y = v2->y;
+    if (v1->y > max_y) max_y = v1->y;
+    if (v2->y > max_y) max_y = v2->y;
+    if (!raster_clip(gpu, &min_x, &min_y, &max_x, &max_y)) return false;
+
+    tri->rs = *rs;
+    tri->rectangle = false;
+    tri->v0 = *v0;
+    tri->v1 = *v1;
+    tri->v2 = *v2;
+    tri->min_x = min_x;
+    tri->min_y = min_y;
+    tri->max_x = max_x;
+    tri->max_y = max_y;
+    tri->bias0 = raster_edge_bias(v1, v2);
+    tri->bias1 = raster_edge_bias(v2, v0);
+    tri->bias2 = raster_edge_bias(v0, v1);
+
+    // Attribute planes (flat polygons use v0's color: the decoder gives every vertex the same one)
+    RasterGradient none = { 0, 0 };
+    tri->gr = tri->gg = tri->gb = tri->gu = tri->gv = none;
+    if (rs->flags & RASTER_SHADED) {
+        tri->gr = raster_gradient(v0, v1, v2, v0->r, v1->r, v2->r, area);
+        tri->gg = raster_gradient(v0, v1, v2, v0->g, v1->g, v2->g, area);
+        tri->gb = raster_gradient(v0, v1, v2, v0->b, v1->b, v2->b, area);
+    }
+    if (rs->flags & RASTER_TEXTURED) {
+        tri->gu = raster_gradient(v0, v1, v2, v0->u, v1->u, v2->u, area);
+        tri->gv = raster_gradient(v0, v1, v2, v0->v, v1->v, v2->v, area);
+    }
+    return true;
+}
+
+/**
+ * @brief Draws the pixels of a set-up triangle that fall inside a clip rectangle.
+ */
+static void raster_triangle_draw(const RasterTriangle* tri, int32_t min_x, int32_t min_y,
+                                 int32_t max_x, int32_t max_y) {
+    if (min_x < tri->min_x) min_x = tri->min_x;
+    if (min_y < tri->min_y) min_y = tri->min_y;
+    if (max_x > tri->max_x) max_x = tri->max_x;
+    if (max_y > tri->max_y) max_y = tri->max_y;
+    if (min_x > max_x || min_y > max_y) return;
+    const RasterState* rs = &tri->rs;
+    const RasterVertex* v0 = &tri->v0;
+    const RasterVertex* v1 = &tri->v1;
+    const RasterVertex* v2 = &tri->v2;
+
+    // Edge functions, stepped per pixel (w0 is the edge opposite v0, and so on)
+    int32_t w0_row = raster_edge(v1, v2, min_x, min_y) + tri->bias0;
+    int32_t w1_row = raster_edge(v2, v0, min_x, min_y) + tri->bias1;
+    int32_t w2_row = raster_edge(v0, v1, min_x, min_y) + tri->bias2;
+    int32_t w0_dx = -(v2->y - v1->y), w0_dy = v2->x - v1->x;
+    int32_t w1_dx = -(v0->y - v2->y), w1_dy = v0->x - v2->x;
+    int32_t w2_dx = -(v1->y - v0->y), w2_dy = v1->x - v0->x;
+
+    // Values at (min_x, min_y), rounded to nearest
+    RasterGradient gr = tri->gr, gg = tri->gg, gb = tri->gb, gu = tri->gu, gv = tri->gv;
+    int64_t half = (int64_t)1 << (RASTER_FRAC_BITS - 1);
+    int64_t ox = min_x - v0->x, oy = min_y - v0->y;
+    int64_t r_row = ((int64_t)v0->r << RASTER_FRAC_BITS) + gr.dx * ox + gr.dy * oy + half;
+    int64_t g_row = ((int64_t)v0->g << RASTER_FRAC_BITS) + gg.dx * ox + gg.dy * oy + half;
+    int64_t b_row = ((int64_t)v0->b << RASTER_FRAC_BITS) + gb.dx * ox + gb.dy * oy + half;
+    int64_t u_row = ((int64_t)v0->u << RASTER_FRAC_BITS) + gu.dx * ox + gu.dy * oy + half;
+    int64_t v_row = ((int64_t)v0->v << RASTER_FRAC_BITS) + gv.dx * ox + gv.dy * oy + half;
+
+    for (int32_t y = min_y; y <= max_y; ++y) {
+        int32_t w0 = w0_row, w1 = w1_row, w2 = w2_row;
+        int64_t r = r_row, g = g_row, b = b_row, u = u_row, v = v_row;
+        bool inside = false;
+        for (int32_t x = min_x; x <= max_x; ++x) {
+            if ((w0 | w1 | w2) >= 0) {
+                inside = true;
+                raster_pixel(rs, x, y, raster_clamp8(r), raster_clamp8(g), raster_clamp8(b),
+                             (uint32_t)raster_clamp8(u), (uint32_t)raster_clamp8(v));
+            } else if (inside) {
+                break; // Triangles are convex: the span of this line is over
+            }
+            w0 += w0_dx; w1 += w1_dx; w2 += w2_dx;
+            r += gr.dx; g += gg.dx; b += gb.dx; u += gu.dx; v += gv.dx;
+        }
+        w0_row += w0_dy; w1_row += w1_dy; w2_row += w2_dy;
+        r_row += gr.dy; g_row += gg.dy; b_row += gb.dy; u_row += gu.dy; v_row += gv.dy;
+    }
+}
+
+/**
+ * @brief Draws the pixels of a set-up rectangle that fall inside a clip rectangle.
+ * Texture coordinates wrap within the page like on hardware.
+ */
+static void raster_rectangle_draw(const RasterTriangle* rect, int32_t min_x, int32_t min_y,
+                                  int32_t max_x, int32_t max_y) {
+    if (min_x < rect->min_x) min_x = rect->min_x;
+    if (min_y < rect->min_y) min_y = rect->min_y;
+    if (max_x > rect->max_x) max_x = rect->max_x;
+    if (max_y > rect->max_y) max_y = rect->max_y;
+    const RasterVertex* origin = &rect->v0;
+    for (int32_t y = min_y; y <= max_y; ++y) {
+        uint32_t v = (uint32_t)(origin->v + (y - origin->y) * rect->v_step) & 0xFF;
+        uint32_t u = (uint32_t)(origin->u + (min_x - origin->x) * rect->u_step);
+        for (int32_t x = min_x; x <= max_x; ++x) {
+            raster_pixel(&rect->rs, x, y, origin->r, origin->g, origin->b, u & 0xFF, v);
+            u += (uint32_t)rect->u_step;
+        }
+    }
+}
+
+static void raster_primitive_draw(const RasterTriangle* tri, int32_t min_x, int32_t min_y,
+                                  int32_t max_x, int32_t max_y) {
+    if (tri->rectangle) {
+        raster_rectangle_draw(tri, min_x, min_y, max_x, max_y);
+    } else {
+        raster_triangle_draw(tri, min_x, min_y, max_x, max_y);
+    }
+}
+
+
+/* --- Tiled Rendering ---
+ * With a pool, triangles are set up as they arrive and binned into square tiles of
+ * VRAM; raster_flush then draws the tiles on the pool threads, each tile going through
+ * its triangles in arrival order. A pixel belongs to one tile and only depends on
+ * earlier writes to itself (blending, mask bit), so the result is the one of drawing
+ * the triangles in order, except when a triangle samples a texture the batch draws to
+ * (or draws to a texture an earlier triangle of the batch samples): those flush the
+ * batch first. Anything else that touches VRAM goes through gpu_flush.
+ */
+typedef struct RasterPool {
+    uint32_t tile_shift;          // Tiles are (1 << tile_shift) pixels square
+    uint32_t tiles_x, tiles_y;
+    uint32_t helper_count;        // Pool threads besides the one calling raster_flush
+    pthread_t* helpers;
+
+    // Batch (owned by the thread issuing GP0 commands)
+    RasterTriangle* triangles;
+    uint32_t triangle_count;
+    uint32_t** tile_lists;        // Per tile: indices into 'triangles', in arrival order
+    uint32_t* tile_counts;
+    uint32_t* tile_capacity;
+    uint32_t* active_tiles;       // Tiles with at least one triangle
+    uint32_t active_count;
+    uint64_t pixels;              // Bounding box area of the batch (decides whether to go parallel)
+    uint16_t reads[VRAM_DIRTY_BANDS];  // Blocks the batch samples textures/CLUTs from
+    uint16_t writes[VRAM_DIRTY_BANDS]; // Blocks the batch draws to
+
+    // Dispatch
+    atomic_uint next_tile;        // Next index into active_tiles to draw
+    pthread_mutex_t lock;
+    pthread_cond_t start;         // generation changed (or stop)
+    pthread_cond_t done;          // busy reached 0
+    uint32_t generation;
+    uint32_t busy;                // Helpers still drawing this generation
+    bool stop;
+} RasterPool;
+
+static bool raster_blocks_overlap(const uint16_t a[VRAM_DIRTY_BANDS], const uint16_t b[VRAM_DIRTY_BANDS]) {
+    uint16_t any = 0;
+    for (int band = 0; band < VRAM_DIRTY_BANDS; ++band) any |= a[band] & b[band];
+    return any != 0;
+}
+
+/**
+ * @brief Adds the VRAM a triangle can sample (its texture page and CLUT) to 'blocks'.
+ */
+static void raster_texture_blocks(const RasterState* rs, uint16_t blocks[VRAM_DIRTY_BANDS]) {
+    if (!(rs->flags & RASTER_TEXTURED)) return;
+    uint32_t width = rs->depth == T4Bit ? 64 : (rs->depth == T8Bit ? 128 : 256); // 256 texels
+    vram_blocks_add_rect(blocks, rs->page_x, rs->page_y, width, 256);
+    if (rs->depth == T4Bit || rs->depth == T8Bit) {
+        uint32_t clut_y = (uint32_t)((rs->clut_row - rs->vram) / VRAM_WIDTH);
+        vram_blocks_add_rect(blocks, rs->clut_x, clut_y, rs->depth == T4Bit ? 16 : 256, 1);
+    }
+}
+
+static void raster_draw_tile(RasterPool* pool, uint32_t tile) {
+    int32_t size = 1 << pool->tile_shift;
+    int32_t x0 = (int32_t)(tile % pool->tiles_x) * size;
+    int32_t y0 = (int32_t)(tile / pool->tiles_x) * size;
+    const uint32_t* list = pool->tile_lists[tile];
+    for (uint32_t i = 0; i < pool->tile_counts[tile]; ++i) {
+        raster_primitive_draw(&pool->triangles[list[i]], x0, y0, x0 + size - 1, y0 + size - 1);
+    }
+}
+
+// Draws active tiles until none is left (called by every pool thread at once)
+static void raster_draw_tiles(RasterPool* pool) {
+    for (;;) {
+        uint32_t index = atomic_fetch_add_explicit(&pool->next_tile, 1, memory_order_relaxed);
+        if (index >= pool->active_count) break;
+        raster_draw_tile(pool, pool->active_tiles[index]);
+    }
+}
+
+static void* raster_helper_main(void* arg) {
+    RasterPool* pool = arg;
+    uint32_t seen = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->generation == seen && !pool->stop) pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->stop) break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+        raster_draw_tiles(pool);
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0) pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// Edge function at the corner of a box where it is largest
+static inline int32_t raster_edge_max(const RasterVertex* a, const RasterVertex* b, int32_t bias,
+                                      int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    int32_t x = (b->y - a->y) < 0 ? x1 : x0; // d/dx = -(b.y - a.y)
+    int32_t y = (b->x - a->x) > 0 ? y1 : y0; // d/dy = b.x - a.x
+    return raster_edge(a, b, x, y) + bias;
+}
+
+/**
+ * @brief false if no pixel of the tile (within the bounding box) can be inside the
+ * triangle: some edge is negative over the whole box. Large triangles skip most of the
+ * empty tiles their bounding box covers this way.
+ */
+static bool raster_tile_touched(const RasterTriangle* tri, int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    if (tri->rectangle) return true; // Fills its whole box
+    if (x0 < tri->min_x) x0 = tri->min_x;
+    if (y0 < tri->min_y) y0 = tri->min_y;
+    if (x1 > tri->max_x) x1 = tri->max_x;
+    if (y1 > tri->max_y) y1 = tri->max_y;
+    return raster_edge_max(&tri->v1, &tri->v2, tri->bias0, x0, y0, x1, y1) >= 0 &&
+           raster_edge_max(&tri->v2, &tri->v0, tri->bias1, x0, y0, x1, y1) >= 0 &&
+           raster_edge_max(&tri->v0, &tri->v1, tri->bias2, x0, y0, x1, y1) >= 0;
+}
+
+/**
+ * @brief Appends a set-up triangle to the tiles it touches.
+ * @return false if a tile list could not grow (nothing was appended).
+ */
+static bool raster_bin(RasterPool* pool, const RasterTriangle* tri) {
+    uint32_t tx0 = (uint32_t)tri->min_x >> pool->tile_shift, tx1 = (uint32_t)tri->max_x >> pool->tile_shift;
+    uint32_t ty0 = (uint32_t)tri->min_y >> pool->tile_shift, ty1 = (uint32_t)tri->max_y >> pool->tile_shift;
+    for (uint32_t ty = ty0; ty <= ty1; ++ty) {
+        for (uint32_t tx = tx0; tx <= tx1; ++tx) {
+            uint32_t tile = ty * pool->tiles_x + tx;
+            if (pool->tile_counts[tile] < pool->tile_capacity[tile]) continue;
+            uint32_t capacity = pool->tile_capacity[tile] ? pool->tile_capacity[tile] * 2 : 64;
+            uint32_t* list = realloc(pool->tile_lists[tile], capacity * sizeof(uint32_t));
+            if (list == NULL) return false;
+            pool->tile_lists[tile] = list;
+            pool->tile_capacity[tile] = capacity;
+        }
+    }
+
+    uint32_t index = pool->triangle_count++;
+    pool->triangles[index] = *tri;
+    int32_t size = 1 << pool->tile_shift;
+    for (uint32_t ty = ty0; ty <= ty1; ++ty) {
+        for (uint32_t tx = tx0; tx <= tx1; ++tx) {
+            uint32_t tile = ty * pool->tiles_x + tx;
+            int32_t x0 = (int32_t)tx * size, y0 = (int32_t)ty * size;
+            if (!raster_tile_touched(tri, x0, y0, x0 + size - 1, y0 + size - 1)) continue;
+            if (pool->tile_counts[tile] == 0) pool->active_tiles[pool->active_count++] = tile;
+            pool->tile_lists[tile][pool->tile_counts[tile]++] = index;
+        }
+    }
+    return true;
+}
+
+static void raster_primitive_batched(Gpu* gpu, RasterPool* pool, const RasterTriangle* tri) {
+    uint32_t w = (uint32_t)(tri->max_x - tri->min_x + 1), h = (uint32_t)(tri->max_y - tri->min_y + 1);
+    uint16_t reads[VRAM_DIRTY_BANDS] = { 0 }, writes[VRAM_DIRTY_BANDS] = { 0 };
+    raster_texture_blocks(&tri->rs, reads);
+    vram_blocks_add_rect(writes, (uint32_t)tri->min_x, (uint32_t)tri->min_y, w, h);
+
+    if (pool->triangle_count == RASTER_BATCH_TRIANGLES ||
+        raster_blocks_overlap(reads, pool->writes) || raster_blocks_overlap(writes, pool->reads)) {
+        raster_flush(gpu);
+    }
+    if (raster_blocks_overlap(reads, writes) || !raster_bin(pool, tri)) {
+        // Samples what it draws: only the plain raster order gives the right pixels
+        raster_flush(gpu);
+        raster_primitive_draw(tri, tri->min_x, tri->min_y, tri->max_x, tri->max_y);
+    } else {
+        for (int band = 0; band < VRAM_DIRTY_BANDS; ++band) {
+            pool->reads[band] |= reads[band];
+            pool->writes[band] |= writes[band];
+        }
+        pool->pixels += (uint64_t)w * h;
+    }
+    vram_mark_dirty_rect(&gpu->vram, (uint32_t)tri->min_x, (uint32_t)tri->min_y, w, h);
+}
+
+// Draws a set-up triangle or rectangle now, or bins it when a pool is running
+static void raster_submit(Gpu* gpu, const RasterTriangle* tri) {
+    if (gpu->raster_pool != NULL) {
+        raster_primitive_batched(gpu, gpu->raster_pool, tri);
+        return;
+    }
+    raster_primitive_draw(tri, tri->min_x, tri->min_y, tri->max_x, tri->max_y);
+    vram_mark_dirty_rect(&gpu->vram, (uint32_t)tri->min_x, (uint32_t)tri->min_y,
+                         (uint32_t)(tri->max_x - tri->min_x + 1), (uint32_t)(tri->max_y - tri->min_y + 1));
+}
+
+static void raster_triangle_state(Gpu* gpu, const RasterState* rs, const RasterVertex* v0,
+                                  const RasterVertex* v1, const RasterVertex* v2) {
+    RasterTriangle tri;
+    if (raster_triangle_setup(&tri, gpu, rs, v0, v1, v2)) raster_submit(gpu, &tri);
+}
+
+
+// --- Lines ---
+/**
+ * @brief Draws a line pixel by pixel: positions and colors step in 16.16 fixed point
+ * along the longer axis, both ends included.
+ */
+static void raster_line_draw(Gpu* gpu, const RasterState* rs, const RasterVertex* a, const RasterVertex* b) {
+    int32_t dx = b->x - a->x, dy = b->y - a->y;
+    int32_t steps = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+    int64_t half = (int64_t)1 << (RASTER_FRAC_BITS - 1);
+    int64_t x = ((int64_t)a->x << RASTER_FRAC_BITS) + half, y = ((int64_t)a->y << RASTER_FRAC_BITS) + half;
+    int64_t r = ((int64_t)a->r << RASTER_FRAC_BITS) + half;
+    int64_t g = ((int64_t)a->g << RASTER_FRAC_BITS) + half;
+    int64_t bl = ((int64_t)a->b << RASTER_FRAC_BITS) + half;
+    int64_t x_step = 0, y_step = 0, r_step = 0, g_step = 0, b_step = 0;
+    if (steps > 0) {
+        x_step = ((int64_t)dx << RASTER_FRAC_BITS) / steps;
+        y_step = ((int64_t)dy << RASTER_FRAC_BITS) / steps;
+        if (rs->flags & RASTER_SHADED) {
+            r_step = ((int64_t)(b->r - a->r) << RASTER_FRAC_BITS) / steps;
+            g_step = ((int64_t)(b->g - a->g) << RASTER_FRAC_BITS) / steps;
+            b_step = ((int64_t)(b->b - a->b) << RASTER_FRAC_BITS) / steps;
+        }
+    }
+
+    int32_t min_x = 0, min_y = 0, max_x = VRAM_WIDTH - 1, max_y = VRAM_HEIGHT - 1;
+    if (!raster_clip(gpu, &min_x, &min_y, &max_x, &max_y)) return;
+    for (int32_t i = 0; i <= steps; ++i) {
+        int32_t px = (int32_t)(x >> RASTER_FRAC_BITS), py = (int32_t)(y >> RASTER_FRAC_BITS);
+        if (px >= min_x && px <= max_x && py >= min_y && py <= max_y) {
+            raster_pixel(rs, px, py, raster_clamp8(r), raster_clamp8(g), raster_clamp8(bl), 0, 0);
+        }
+        x += x_step; y += y_step;
+        r += r_step; g += g_step; bl += b_step;
+    }
+
+    // Dirty area: the line's box within the drawing area
+    int32_t box_x0 = a->x < b->x ? a->x : b->x, box_x1 = a->x < b->x ? b->x : a->x;
+    int32_t box_y0 = a->y < b->y ? a->y : b->y, box_y1 = a->y < b->y ? b->y : a->y;
+    if (box_x0 < min_x) box_x0 = min_x;
+    if (box_y0 < min_y) box_y0 = min_y;
+    if (box_x1 > max_x) box_x1 = max_x;
+    if (box_y1 > max_y) box_y1 = max_y;
+    if (box_x0 <= box_x1 && box_y0 <= box_y1) {
+        vram_mark_dirty_rect(&gpu->vram, (uint32_t)box_x0, (uint32_t)box_y0,
+                             (uint32_t)(box_x1 - box_x0 + 1), (uint32_t)(box_y1 - box_y0 + 1));
+    }
+}
+
+
+// --- Public API ---
+void raster_triangle(Gpu* gpu, const RasterVertex v[3], uint32_t flags, uint16_t clut, uint16_t tpage) {
+    RasterState rs;
+    raster_setup(&rs, gpu, flags, clut, tpage);
+    raster_triangle_state(gpu, &rs, &v[0], &v[1], &v[2]);
+}
+
+void raster_quad(Gpu* gpu, const RasterVertex v[4], uint32_t flags, uint16_t clut, uint16_t tpage) {
+    RasterState rs;
+    raster_setup(&rs, gpu, flags, clut, tpage);
+    raster_triangle_state(gpu, &rs, &v[0], &v[1], &v[2]);
+    raster_triangle_state(gpu, &rs, &v[1], &v[2], &v[3]);
+}
+
+void raster_rectangle(Gpu* gpu, const RasterVertex* origin, uint32_t width, uint32_t height,
+                      uint32_t flags, uint16_t clut, uint16_t tpage) {
+    if (width == 0 || height == 0) return;
+    RasterTriangle rect;
+    raster_setup(&rect.rs, gpu, flags & ~RASTER_SHADED, clut, tpage);
+    rect.rs.dither = false; // Rectangles are never dithered
+    rect.v0 = *origin;
+    rect.min_x = origin->x;
+    rect.min_y = origin->y;
+    rect.max_x = origin->x + (int32_t)width - 1;
+    rect.max_y = origin->y + (int32_t)height - 1;
+    if (!raster_clip(gpu, &rect.min_x, &rect.min_y, &rect.max_x, &rect.max_y)) return;
+    rect.rectangle = true;
+    rect.u_step = gpu->rectangle_texture_x_flip ? -1 : 1;
+    rect.v_step = gpu->rectangle_texture_y_flip ? -1 : 1;
+    raster_submit(gpu, &rect);
+}
+
+void raster_line(Gpu* gpu, const RasterVertex v[2], uint32_t flags) {
+    if (abs(v[1].x - v[0].x) > RASTER_MAX_WIDTH || abs(v[1].y - v[0].y) > RASTER_MAX_HEIGHT) return;
+    raster_flush(gpu); // Lines are not binned: the batch before them is drawn first
+    RasterState rs;
+    raster_setup(&rs, gpu, flags & (RASTER_SHADED | RASTER_SEMI_TRANSPARENT), 0, 0);
+    raster_line_draw(gpu, &rs, &v[0], &v[1]);
+}
+
+void raster_flush(Gpu* gpu) {
+    RasterPool* pool = gpu->raster_pool;
+    if (pool == NULL || pool->triangle_count == 0) return;
+
+    atomic_store_explicit(&pool->next_tile, 0, memory_order_relaxed);
+    if (pool->helper_count == 0 || pool->active_count == 1 || pool->pixels < RASTER_PARALLEL_MIN_PIXELS) {
+        raster_draw_tiles(pool); // Waking the helpers would cost more than the drawing
+    } else {
+        pthread_mutex_lock(&pool->lock);
+        pool->generation++;
+        pool->busy = pool->helper_count;
+        pthread_cond_broadcast(&pool->start);
+        pthread_mutex_unlock(&pool->lock);
+
+        raster_draw_tiles(pool);
+
+        pthread_mutex_lock(&pool->lock);
+        while (pool->busy > 0) pthread_cond_wait(&pool->done, &pool->lock);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    for (uint32_t i = 0; i < pool->active_count; ++i) pool->tile_counts[pool->active_tiles[i]] = 0;
+    pool->active_count = 0;
+    pool->triangle_count = 0;
+    pool->pixels = 0;
+    memset(pool->reads, 0, sizeof(pool->reads));
+    memset(pool->writes, 0, sizeof(pool->writes));
+}
+
+static void raster_pool_free(RasterPool* pool) {
+    if (pool->tile_lists != NULL) {
+        for (uint32_t i = 0; i < pool->tiles_x * pool->tiles_y; ++i) free(pool->tile_lists[i]);
+    }
+    free(pool->tile_lists);
+    free(pool->tile_counts);
+    free(pool->tile_capacity);
+    free(pool->active_tiles);
+    free(pool->triangles);
+    free(pool->helpers);
+    free(pool);
+}
+
+bool raster_pool_start(Gpu* gpu, uint32_t threads, uint32_t tile_size) {
+    if (gpu->raster_pool != NULL) raster_pool_stop(gpu);
+    if (threads == 0) threads = 1;
+    if (tile_size < RASTER_MIN_TILE_SIZE || tile_size > RASTER_MAX_TILE_SIZE || (tile_size & (tile_size - 1)) != 0) {
+        LOG_WARN(LOG_GPU, "Rasterizer: tile size %u is not a power of two in %u..%u, using %u\n",
+                 tile_size, RASTER_MIN_TILE_SIZE, RASTER_MAX_TILE_SIZE, RASTER_DEFAULT_TILE_SIZE);
+        tile_size = RASTER_DEFAULT_TILE_SIZE;
+    }
+
+    RasterPool* pool = calloc(1, sizeof(RasterPool));
+    if (pool == NULL) return false;
+    while ((1u << pool->tile_shift) < tile_size) pool->tile_shift++;
+    pool->tiles_x = VRAM_WIDTH / tile_size;
+    pool->tiles_y = VRAM_HEIGHT / tile_size;
+    uint32_t tile_count = pool->tiles_x * pool->tiles_y;
+    pool->triangles = malloc(RASTER_BATCH_TRIANGLES * sizeof(RasterTriangle));
+    pool->tile_lists = calloc(tile_count, sizeof(uint32_t*));
+    pool->tile_counts = calloc(tile_count, sizeof(uint32_t));
+    pool->tile_capacity = calloc(tile_count, sizeof(uint32_t));
+    pool->active_tiles = malloc(tile_count * sizeof(uint32_t));
+    pool->helpers = calloc(threads, sizeof(pthread_t));
+    if (!pool->triangles || !pool->tile_lists || !pool->tile_counts || !pool->tile_capacity ||
+        !pool->active_tiles || !pool->helpers) {
+        LOG_ERROR(LOG_GPU, "Rasterizer: failed to allocate the tile bins\n");
+        raster_pool_free(pool);
+        return false;
+    }
+    atomic_init(&pool->next_tile, 0);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    // The thread calling raster_flush draws too, so 'threads' - 1 helpers
+    for (uint32_t i = 0; i + 1 < threads; ++i) {
+        if (pthread_create(&pool->helpers[i], NULL, raster_helper_main, pool) != 0) {
+            LOG_WARN(LOG_GPU, "Rasterizer: could only start %u of %u threads\n", i + 1, threads);
+            break;
+        }
+        pool->helper_count++;
+    }
+    gpu->raster_pool = pool;
+    LOG_INFO(LOG_GPU, "Rasterizer: %u thread(s), %ux%u tiles\n", pool->helper_count + 1, tile_size, tile_size);
+    return true;
+}
+
+void raster_pool_stop(Gpu* gpu) {
+    RasterPool* pool = gpu->raster_pool;
+    if (pool == NULL) return;
+    raster_flush(gpu);
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (uint32_t i = 0; i < pool->helper_count; ++i) pthread_join(pool->helpers[i], NULL);
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    raster_pool_free(pool);
+    gpu->raster_pool = NULL; // Back to drawing every triangle as it arrives
+}
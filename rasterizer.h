@@ -0,0 +1,97 @@
+// rasterizer.h
+// Software rasterizer: draws GP0 polygons on the CPU straight into VRAM (no GL context needed).
+#ifndef RASTERIZER_H
+#define RASTERIZER_H
+
+#include <stdint.h>
+#include "gpu.h"
+
+/* --- Polygon Attributes ---
+ * The values match the GP0 polygon opcode bits (0x20-0x3F), so a decoder can pass
+ * 'opcode & RASTER_OPCODE_FLAGS' straight through. Bit 3 (quad) selects
+ * raster_quad over raster_triangle instead. Lines (0x40-0x5F) and rectangles (0x60-0x7F)
+ * use the same bits for the attributes they have.
+ */
+#define RASTER_RAW_TEXTURE      (1u << 0) // Texels are used as is, not modulated by the vertex color
+#define RASTER_SEMI_TRANSPARENT (1u << 1) // Blend with VRAM (mode from the texpage attribute)
+#define RASTER_TEXTURED         (1u << 2) // Sample the texture page through u/v
+#define RASTER_SHADED           (1u << 4) // Gouraud: interpolate the vertex colors (else vertex 0's)
+#define RASTER_OPCODE_FLAGS     (RASTER_RAW_TEXTURE | RASTER_SEMI_TRANSPARENT | RASTER_TEXTURED | RASTER_SHADED)
+
+// Tiled rendering (raster_pool_start): tile edge in pixels, a power of two
+#define RASTER_DEFAULT_TILE_SIZE 64
+#define RASTER_MIN_TILE_SIZE     16
+#define RASTER_MAX_TILE_SIZE     512
+
+typedef struct {
+    int32_t x, y;    // VRAM position, drawing offset already applied
+    uint8_t r, g, b; // 8-bit vertex color
+    uint8_t u, v;    // Texture coordinates within the texture page
+} RasterVertex;
+
+/**
+ * @brief Draws a triangle into gpu->vram.
+ * Pixels are sampled at integer coordinates with a top-left fill rule (left and top
+ * edges drawn, right and bottom edges not), colors and texture coordinates come from
+ * fixed-point plane equations, and the result is clipped to the drawing area. Polygons
+ * wider than 1023 or taller than 511 pixels are dropped like on hardware. The drawing
+ * mode (dithering, texture window, mask bits) comes from the GPU state; the written
+ * blocks are marked dirty.
+ * @param gpu The GPU whose VRAM and drawing state are used.
+ * @param v The three vertices.
+ * @param flags RASTER_* attributes.
+ * @param clut CLUT attribute (bits 0-5: X / 16, bits 6-14: Y) for 4/8-bit textures.
+ * @param tpage Texpage attribute (GP0(E1) bits 0-8: page, semi-transparency, depth).
+ */
+void raster_triangle(Gpu* gpu, const RasterVertex v[3], uint32_t flags, uint16_t clut, uint16_t tpage);
+
+/**
+ * @brief Draws a quad as the triangles v0-v1-v2 and v1-v2-v3 (the hardware order; the
+ * fill rule keeps the shared edge from being drawn twice).
+ */
+void raster_quad(Gpu* gpu, const RasterVertex v[4], uint32_t flags, uint16_t clut, uint16_t tpage);
+
+/**
+ * @brief Draws a GP0(60)-(7F) rectangle: no dithering, texture coordinates step by one
+ * texel per pixel from the origin's u/v (backwards with the GP0(E1) flip bits) and wrap
+ * within the page.
+ * @param origin Top-left corner, color and texture coordinates.
+ * @param width, height Size in pixels (nothing is drawn if either is 0).
+ * @param flags RASTER_* attributes (RASTER_SHADED is ignored).
+ * @param clut CLUT attribute for 4/8-bit textures.
+ * @param tpage Texpage bits of the current draw mode (rectangles have no attribute).
+ */
+void raster_rectangle(Gpu* gpu, const RasterVertex* origin, uint32_t width, uint32_t height,
+                      uint32_t flags, uint16_t clut, uint16_t tpage);
+
+/**
+ * @brief Draws a GP0(40)-(5F) line segment, both ends included, clipped to the drawing
+ * area. Lines longer than 1023 x 511 pixels are dropped.
+ * @param flags RASTER_SHADED and RASTER_SEMI_TRANSPARENT (the others do not apply).
+ */
+void raster_line(Gpu* gpu, const RasterVertex v[2], uint32_t flags);
+
+/**
+ * @brief Switches to tiled rendering: raster_triangle/raster_quad/raster_rectangle only
+ * set primitives up and bin them into tiles of VRAM (lines flush and draw at once), and raster_flush draws the tiles on 'threads'
+ * threads (the flushing one included), keeping the triangle order within each tile.
+ * The VRAM result is identical to drawing immediately.
+ * @param gpu The GPU whose polygons are batched.
+ * @param threads Drawing threads (1 still bins, which is the baseline for scaling).
+ * @param tile_size Tile edge in pixels (power of two, RASTER_MIN/MAX_TILE_SIZE).
+ * @return false if the bins could not be allocated (drawing stays immediate).
+ */
+bool raster_pool_start(Gpu* gpu, uint32_t threads, uint32_t tile_size);
+
+/**
+ * @brief Draws what is batched, stops the threads and goes back to immediate drawing.
+ */
+void raster_pool_stop(Gpu* gpu);
+
+/**
+ * @brief Draws every batched triangle into VRAM. Call before anything else reads or
+ * writes VRAM (gpu_flush does). No-op without a pool.
+ */
+void raster_flush(Gpu* gpu);
+
+#endif // RASTERIZER_H
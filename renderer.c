@@ -1,4 +1,5 @@
 #include "renderer.h"
+#include "logger.h"
 #include <stdio.h>
 #include <stdlib.h> // For malloc, free, exit
 #include <string.h> // For memcpy, memset
@@ -22,7 +23,7 @@ void check_gl_error(const char* location) {
             case GL_INVALID_FRAMEBUFFER_OPERATION: error_str = "INVALID_FRAMEBUFFER_OPERATION"; break;
             default: error_str = "UNKNOWN_ERROR"; break;
         }
-        fprintf(stderr, "OpenGL Error at %s: %s (0x%04x)\n", location, error_str, error);
+        LOG_ERROR(LOG_RENDERER, "OpenGL Error at %s: %s (0x%04x)\n", location, error_str, error);
     }
 }
 
@@ -98,19 +99,19 @@ static GLuint compile_shader(const char* source, GLenum shader_type) {
         if (log_buffer) {
             glGetShaderInfoLog(shader, log_len, NULL, log_buffer);
             log_buffer[log_len] = '\0';
-            fprintf(stderr, "Shader Compilation Error (%s):\n%s\n",
+            LOG_ERROR(LOG_RENDERER, "Shader Compilation Error (%s):\n%s\n",
                 (shader_type == GL_VERTEX_SHADER) ? "Vertex" : "Fragment",
                 log_buffer);
             free(log_buffer);
         } else {
-            fprintf(stderr, "Shader Compilation Error (%s) - Failed to allocate log buffer\n",
+            LOG_ERROR(LOG_RENDERER, "Shader Compilation Error (%s) - Failed to allocate log buffer\n",
                 (shader_type == GL_VERTEX_SHADER) ? "Vertex" : "Fragment");
         }
         glDeleteShader(shader); // Delete the failed shader object
         check_gl_error("compile_shader (error path)");
         return 0; // Return 0 on failure
     }
-    printf("Shader compiled successfully (Type: %s)\n", (shader_type == GL_VERTEX_SHADER) ? "Vertex" : "Fragment");
+    LOG_INFO(LOG_RENDERER, "Shader compiled successfully (Type: %s)\n", (shader_type == GL_VERTEX_SHADER) ? "Vertex" : "Fragment");
     check_gl_error("compile_shader (success path)");
     return shader;
 }
@@ -132,10 +133,10 @@ static GLuint link_program(GLuint vertex_shader, GLuint fragment_shader) {
         if (log_buffer) {
             glGetProgramInfoLog(program, log_len, NULL, log_buffer);
             log_buffer[log_len] = '\0';
-            fprintf(stderr, "Shader Program Linking Error:\n%s\n", log_buffer);
+            LOG_ERROR(LOG_RENDERER, "Shader Program Linking Error:\n%s\n", log_buffer);
             free(log_buffer);
         } else {
-            fprintf(stderr, "Shader Program Linking Error - Failed to allocate log buffer\n");
+            LOG_ERROR(LOG_RENDERER, "Shader Program Linking Error - Failed to allocate log buffer\n");
         }
         glDeleteProgram(program); // Delete the failed program object
         // Shaders are still attached if linking failed, detach and delete them
@@ -153,7 +154,7 @@ static GLuint link_program(GLuint vertex_shader, GLuint fragment_shader) {
     // glDeleteShader(vertex_shader); // Optional: Delete here if not needed elsewhere
     // glDeleteShader(fragment_shader);
 
-    printf("Shader program linked successfully (ID: %u)\n", program);
+    LOG_INFO(LOG_RENDERER, "Shader program linked successfully (ID: %u)\n", program);
     check_gl_error("link_program (success path)");
     return program;
 }
@@ -162,7 +163,7 @@ static GLuint link_program(GLuint vertex_shader, GLuint fragment_shader) {
 // --- Renderer Implementation ---
 
 bool renderer_init(Renderer* renderer) {
-    printf("Initializing Renderer...\n");
+    LOG_INFO(LOG_RENDERER, "Initializing Renderer...\n");
     renderer->initialized = false;
     renderer->vertex_count = 0;
     
@@ -172,22 +173,22 @@ bool renderer_init(Renderer* renderer) {
     memset(renderer->texcoords_data, 0, sizeof(renderer->texcoords_data));
 
     // --- 1. Compile and Link Shaders ---
-    printf("Compiling Shaders...\n");
+    LOG_INFO(LOG_RENDERER, "Compiling Shaders...\n");
     GLuint vs = compile_shader(vertex_shader_source, GL_VERTEX_SHADER);
     GLuint fs = compile_shader(fragment_shader_source, GL_FRAGMENT_SHADER);
     if (vs == 0 || fs == 0) {
-        fprintf(stderr, "Renderer Init Failed: Shader compilation error.\n");
+        LOG_ERROR(LOG_RENDERER, "Renderer Init Failed: Shader compilation error.\n");
         if (vs != 0) glDeleteShader(vs);
         if (fs != 0) glDeleteShader(fs);
         return false;
     }
 
-    printf("Linking shader program...\n");
+    LOG_INFO(LOG_RENDERER, "Linking shader program...\n");
     renderer->shader_program = link_program(vs, fs);
     glDeleteShader(vs);
     glDeleteShader(fs);
     if (renderer->shader_program == 0) {
-        fprintf(stderr, "Renderer Init Failed: Shader linking error.\n");
+        LOG_ERROR(LOG_RENDERER, "Renderer Init Failed: Shader linking error.\n");
         return false;
     }
     check_gl_error("After linking program");
@@ -198,17 +199,17 @@ bool renderer_init(Renderer* renderer) {
     
     renderer->uniform_offset_loc = glGetUniformLocation(renderer->shader_program, "offset");
     if (renderer->uniform_offset_loc < 0) {
-        fprintf(stderr, "Warning: Could not find uniform 'offset'.\n");
+        LOG_WARN(LOG_RENDERER, "Warning: Could not find uniform 'offset'.\n");
     } else {
-        printf("Found uniform 'offset' at location: %d\n", renderer->uniform_offset_loc);
+        LOG_INFO(LOG_RENDERER, "Found uniform 'offset' at location: %d\n", renderer->uniform_offset_loc);
         glUniform2i(renderer->uniform_offset_loc, 0, 0); // Set initial offset
     }
     
     GLint vram_texture_loc = glGetUniformLocation(renderer->shader_program, "vram_texture");
     if (vram_texture_loc < 0) {
-         fprintf(stderr, "Warning: Could not find uniform 'vram_texture'.\n");
+         LOG_WARN(LOG_RENDERER, "Warning: Could not find uniform 'vram_texture'.\n");
     } else {
-        printf("Found uniform 'vram_texture' at location: %d\n", vram_texture_loc);
+        LOG_INFO(LOG_RENDERER, "Found uniform 'vram_texture' at location: %d\n", vram_texture_loc);
         glUniform1i(vram_texture_loc, 0); // Tell shader sampler to use texture unit 0
     }
 
@@ -217,87 +218,100 @@ bool renderer_init(Renderer* renderer) {
 
     // --- 3. Create Vertex Array Object (VAO) ---
     // The VAO MUST be created and bound before configuring VBOs and attribute pointers.
-    printf("Creating VAO...\n");
+    LOG_INFO(LOG_RENDERER, "Creating VAO...\n");
     glGenVertexArrays(1, &renderer->vao);
     glBindVertexArray(renderer->vao);
-    printf("VAO created (ID: %u) and bound.\n", renderer->vao);
+    LOG_INFO(LOG_RENDERER, "VAO created (ID: %u) and bound.\n", renderer->vao);
     check_gl_error("After creating/binding VAO");
 
     // --- 4. Create and Configure ALL Vertex Buffer Objects (VBOs) ---
 
     // Position VBO (Location 0)
-    printf("Creating Position VBO...\n");
+    LOG_INFO(LOG_RENDERER, "Creating Position VBO...\n");
     glGenBuffers(1, &renderer->position_buffer);
     glBindBuffer(GL_ARRAY_BUFFER, renderer->position_buffer);
     glBufferData(GL_ARRAY_BUFFER, VERTEX_BUFFER_LEN * sizeof(RendererPosition), NULL, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribIPointer(0, 2, GL_SHORT, 0, (void*)0);
-    printf("Position VBO configured for attribute location 0.\n");
+    LOG_INFO(LOG_RENDERER, "Position VBO configured for attribute location 0.\n");
     check_gl_error("After configuring Position VBO");
 
     // Color VBO (Location 1)
-    printf("Creating Color VBO...\n");
+    LOG_INFO(LOG_RENDERER, "Creating Color VBO...\n");
     glGenBuffers(1, &renderer->color_buffer);
     glBindBuffer(GL_ARRAY_BUFFER, renderer->color_buffer);
     glBufferData(GL_ARRAY_BUFFER, VERTEX_BUFFER_LEN * sizeof(RendererColor), NULL, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(1);
     glVertexAttribIPointer(1, 3, GL_UNSIGNED_BYTE, 0, (void*)0);
-    printf("Color VBO configured for attribute location 1.\n");
+    LOG_INFO(LOG_RENDERER, "Color VBO configured for attribute location 1.\n");
     check_gl_error("After configuring Color VBO");
 
     // TexCoord VBO (Location 2)
-    printf("Creating TexCoord VBO...\n");
+    LOG_INFO(LOG_RENDERER, "Creating TexCoord VBO...\n");
     glGenBuffers(1, &renderer->texcoord_buffer);
     glBindBuffer(GL_ARRAY_BUFFER, renderer->texcoord_buffer);
     glBufferData(GL_ARRAY_BUFFER, VERTEX_BUFFER_LEN * sizeof(RendererTexCoord), NULL, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(2);
     glVertexAttribIPointer(2, 2, GL_SHORT, 0, (void*)0);
-    printf("TexCoord VBO configured for attribute location 2.\n");
+    LOG_INFO(LOG_RENDERER, "TexCoord VBO configured for attribute location 2.\n");
     check_gl_error("After configuring TexCoord VBO");
 
     // --- 5. Create VRAM Texture Object ---
-    printf("Creating VRAM texture object...\n");
+    LOG_INFO(LOG_RENDERER, "Creating VRAM texture object...\n");
     glGenTextures(1, &renderer->vram_texture_id);
     glBindTexture(GL_TEXTURE_2D, renderer->vram_texture_id);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB5_A1, 1024, 512, 0, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, NULL);
-    printf("VRAM texture created (ID: %u).\n", renderer->vram_texture_id);
+    LOG_INFO(LOG_RENDERER, "VRAM texture created (ID: %u).\n", renderer->vram_texture_id);
     check_gl_error("After creating VRAM texture");
 
+    glGenFramebuffers(1, &renderer->vram_framebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, renderer->vram_framebuffer);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderer->vram_texture_id, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    check_gl_error("After creating VRAM framebuffer");
+
+    glGenBuffers(1, &renderer->vram_upload_buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, renderer->vram_upload_buffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, VRAM_SIZE, NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    renderer->vram_upload_layout = -1; // The texture starts undefined: the first upload is complete
+    check_gl_error("After creating VRAM upload buffer");
+
     // --- 6. Unbind objects to clean up state ---
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
-    printf("VAO and VBOs unbound.\n");
+    LOG_INFO(LOG_RENDERER, "VAO and VBOs unbound.\n");
 
     // --- 7. Set Initial GL State ---
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     check_gl_error("After glClearColor");
 
     renderer->initialized = true;
-    printf("Renderer Initialized Successfully.\n");
+    LOG_INFO(LOG_RENDERER, "Renderer Initialized Successfully.\n");
     return true;
 }
 
 // Buffers a triangle's vertex data
 void renderer_push_triangle(Renderer* renderer, RendererPosition pos[3], RendererColor col[3]) {
     if (!renderer->initialized) {
-        fprintf(stderr, "Renderer Error: push_triangle called before initialization.\n");
+        LOG_ERROR(LOG_RENDERER, "Renderer Error: push_triangle called before initialization.\n");
         return;
     }
 
     if (renderer->vertex_count + 3 > VERTEX_BUFFER_LEN) {
-        printf("Renderer Info: Vertex buffer full (%u verts), forcing draw before push_triangle.\n", renderer->vertex_count);
+        LOG_DEBUG(LOG_RENDERER, "Renderer Info: Vertex buffer full (%u verts), forcing draw before push_triangle.\n", renderer->vertex_count);
         renderer_draw(renderer);
         if (renderer->vertex_count + 3 > VERTEX_BUFFER_LEN) {
-             fprintf(stderr,"Renderer Error: Cannot push triangle, buffer still full after draw.\n");
+             LOG_ERROR(LOG_RENDERER, "Renderer Error: Cannot push triangle, buffer still full after draw.\n");
              return;
         }
     }
 
     // Copy data to CPU-side buffers
-    printf("Renderer: Buffering Triangle (Start Index: %u)\n", renderer->vertex_count);
+    LOG_DEBUG(LOG_RENDERER, "Renderer: Buffering Triangle (Start Index: %u)\n", renderer->vertex_count);
     memcpy(&renderer->positions_data[renderer->vertex_count], pos, 3 * sizeof(RendererPosition));
     memcpy(&renderer->colors_data[renderer->vertex_count], col, 3 * sizeof(RendererColor));
 
@@ -307,20 +321,20 @@ void renderer_push_triangle(Renderer* renderer, RendererPosition pos[3], Rendere
 // Buffers a quad's vertex data (as two triangles)
 void renderer_push_quad(Renderer* renderer, RendererPosition pos[4], RendererColor col[4]) {
      if (!renderer->initialized) {
-        fprintf(stderr, "Renderer Error: push_quad called before initialization.\n");
+        LOG_ERROR(LOG_RENDERER, "Renderer Error: push_quad called before initialization.\n");
         return;
      }
 
      if (renderer->vertex_count + 6 > VERTEX_BUFFER_LEN) {
-        printf("Renderer Info: Vertex buffer full (%u verts), forcing draw before push_quad.\n", renderer->vertex_count);
+        LOG_DEBUG(LOG_RENDERER, "Renderer Info: Vertex buffer full (%u verts), forcing draw before push_quad.\n", renderer->vertex_count);
         renderer_draw(renderer);
         if (renderer->vertex_count + 6 > VERTEX_BUFFER_LEN) {
-            fprintf(stderr,"Renderer Error: Cannot push quad, buffer still full after draw.\n");
+            LOG_ERROR(LOG_RENDERER, "Renderer Error: Cannot push quad, buffer still full after draw.\n");
             return;
         }
      }
 
-    printf("Renderer: Buffering Quad (Start Index: %u)\n", renderer->vertex_count);
+    LOG_DEBUG(LOG_RENDERER, "Renderer: Buffering Quad (Start Index: %u)\n", renderer->vertex_count);
     // Decompose quad into two triangles (using the order that seemed correct for the logo)
     // Triangle 1: V0, V1, V2
     renderer->positions_data[renderer->vertex_count + 0] = pos[0];
@@ -345,7 +359,7 @@ void renderer_push_quad(Renderer* renderer, RendererPosition pos[4], RendererCol
 // Uploads buffered data and performs the OpenGL draw call.
 void renderer_draw(Renderer* renderer) {
     if (!renderer->initialized) {
-        fprintf(stderr, "Renderer Error: Draw called before initialization.\n");
+        LOG_ERROR(LOG_RENDERER, "Renderer Error: Draw called before initialization.\n");
         return;
     }
     if (renderer->vertex_count == 0) {
@@ -353,7 +367,7 @@ void renderer_draw(Renderer* renderer) {
         return;
     }
 
-    printf("Renderer: Drawing %u vertices...\n", renderer->vertex_count);
+    LOG_DEBUG(LOG_RENDERER, "Renderer: Drawing %u vertices...\n", renderer->vertex_count);
 
     glUseProgram(renderer->shader_program); check_gl_error("draw - glUseProgram");
     glBindVertexArray(renderer->vao); check_gl_error("draw - glBindVertexArray");
@@ -361,13 +375,13 @@ void renderer_draw(Renderer* renderer) {
     // --- Upload Buffered Vertex Data via glBufferSubData ---
     
     // Upload position data (no change)
-    printf("  Uploading position data (%lu bytes)...\n", renderer->vertex_count * sizeof(RendererPosition));
+    LOG_DEBUG(LOG_RENDERER, "  Uploading position data (%lu bytes)...\n", renderer->vertex_count * sizeof(RendererPosition));
     glBindBuffer(GL_ARRAY_BUFFER, renderer->position_buffer); check_gl_error("draw - glBindBuffer pos");
     glBufferSubData(GL_ARRAY_BUFFER, 0, renderer->vertex_count * sizeof(RendererPosition), renderer->positions_data);
     check_gl_error("draw - glBufferSubData pos");
 
     // Upload color data (no change)
-    printf("  Uploading color data (%lu bytes)...\n", renderer->vertex_count * sizeof(RendererColor));
+    LOG_DEBUG(LOG_RENDERER, "  Uploading color data (%lu bytes)...\n", renderer->vertex_count * sizeof(RendererColor));
     glBindBuffer(GL_ARRAY_BUFFER, renderer->color_buffer); check_gl_error("draw - glBindBuffer col");
     glBufferSubData(GL_ARRAY_BUFFER, 0, renderer->vertex_count * sizeof(RendererColor), renderer->colors_data);
     check_gl_error("draw - glBufferSubData col");
@@ -376,7 +390,7 @@ void renderer_draw(Renderer* renderer) {
     // --- PROPOSED MODIFICATION START ---
     // Add this block to upload the new texture coordinate data.
     // It's identical to the blocks for position and color.
-    printf("  Uploading texcoord data (%lu bytes)...\n", renderer->vertex_count * sizeof(RendererTexCoord));
+    LOG_DEBUG(LOG_RENDERER, "  Uploading texcoord data (%lu bytes)...\n", renderer->vertex_count * sizeof(RendererTexCoord));
     glBindBuffer(GL_ARRAY_BUFFER, renderer->texcoord_buffer); check_gl_error("draw - glBindBuffer tex");
     glBufferSubData(GL_ARRAY_BUFFER, 0, renderer->vertex_count * sizeof(RendererTexCoord), renderer->texcoords_data);
     check_gl_error("draw - glBufferSubData tex");
@@ -387,7 +401,7 @@ void renderer_draw(Renderer* renderer) {
     // ------------------------------------------------------
 
     // Draw the buffered primitives (interpreted as triangles)
-    printf("  Issuing glDrawArrays...\n");
+    LOG_DEBUG(LOG_RENDERER, "  Issuing glDrawArrays...\n");
     glDrawArrays(GL_TRIANGLES, 0, renderer->vertex_count);
     check_gl_error("draw - glDrawArrays");
 
@@ -397,13 +411,13 @@ void renderer_draw(Renderer* renderer) {
 
     // Reset the CPU buffer count for the next batch
     renderer->vertex_count = 0;
-    printf("Renderer: Draw finished, vertex count reset.\n");
+    LOG_DEBUG(LOG_RENDERER, "Renderer: Draw finished, vertex count reset.\n");
 }
 
 // Draws buffered primitives and requests buffer swap (swap happens in main loop)
 void renderer_display(Renderer* renderer) {
     if (!renderer->initialized) return;
-    printf("Renderer: Display requested.\n");
+    LOG_DEBUG(LOG_RENDERER, "Renderer: Display requested.\n");
     // Draw any remaining buffered vertices
     renderer_draw(renderer);
     // Actual swap (SDL_GL_SwapWindow) happens in main.c/main loop
@@ -416,7 +430,7 @@ void renderer_set_draw_offset(Renderer* renderer, int16_t x, int16_t y) {
      if (!renderer->initialized) return;
 
      // Draw primitives with the *old* offset before changing it
-     printf("Renderer: Setting Draw Offset (%d, %d), forcing draw first.\n", x, y);
+     LOG_DEBUG(LOG_RENDERER, "Renderer: Setting Draw Offset (%d, %d), forcing draw first.\n", x, y);
      renderer_draw(renderer);
 
      // Bind the shader program to set the uniform
@@ -428,44 +442,124 @@ void renderer_set_draw_offset(Renderer* renderer, int16_t x, int16_t y) {
      glUseProgram(0);
 }
 
+// Uploads the dirty VRAM rectangles to the VRAM texture
+uint32_t renderer_upload_vram(Renderer* renderer, Vram* vram, bool software) {
+    if (!renderer->initialized) return 0;
+    uint16_t dirty[VRAM_DIRTY_BANDS];
+    bool any = vram_take_dirty(vram, dirty);
+    if (renderer->vram_upload_layout != (int8_t)software) {
+        // The texture holds the other layout (or nothing yet): everything goes up again
+        memset(dirty, 0xFF, sizeof(dirty));
+        renderer->vram_upload_layout = (int8_t)software;
+        any = true;
+    }
+    renderer->upload_frames++;
+    renderer->upload_last_bytes = 0;
+    if (!any) return 0;
+
+    VramRect rects[RENDERER_MAX_UPLOAD_RECTS];
+    uint32_t count = vram_dirty_rects(dirty, rects, RENDERER_MAX_UPLOAD_RECTS);
+    size_t offsets[RENDERER_MAX_UPLOAD_RECTS];
+    size_t bytes = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        offsets[i] = bytes;
+        bytes += (size_t)rects[i].w * rects[i].h * VRAM_BPP;
+    }
+    GLenum type = software ? GL_UNSIGNED_SHORT_1_5_5_5_REV : GL_UNSIGNED_SHORT_5_5_5_1;
+
+    glBindTexture(GL_TEXTURE_2D, renderer->vram_texture_id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, renderer->vram_upload_buffer);
+    // Invalidating lets the driver hand out fresh storage while last frame's copy is in flight
+    uint8_t* staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)bytes,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (staging != NULL) {
+        for (uint32_t i = 0; i < count; ++i) {
+            size_t row_bytes = (size_t)rects[i].w * VRAM_BPP;
+            for (uint32_t row = 0; row < rects[i].h; ++row) {
+                memcpy(staging + offsets[i] + row * row_bytes,
+                       vram->data + ((size_t)(rects[i].y + row) * VRAM_WIDTH + rects[i].x) * VRAM_BPP, row_bytes);
+            }
+        }
+        if (!glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) staging = NULL; // Storage lost: upload from VRAM below
+    }
+    if (staging != NULL) {
+        for (uint32_t i = 0; i < count; ++i) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, rects[i].x, rects[i].y, rects[i].w, rects[i].h, GL_RGBA, type,
+                            (const void*)(uintptr_t)offsets[i]);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else {
+        LOG_WARN(LOG_RENDERER, "Renderer: VRAM upload buffer unavailable, uploading from VRAM directly.\n");
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, VRAM_WIDTH);
+        for (uint32_t i = 0; i < count; ++i) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, rects[i].x, rects[i].y, rects[i].w, rects[i].h, GL_RGBA, type,
+                            vram->data + ((size_t)rects[i].y * VRAM_WIDTH + rects[i].x) * VRAM_BPP);
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    check_gl_error("upload_vram - glTexSubImage2D");
+
+    LOG_TRACE(LOG_RENDERER, "Renderer: VRAM upload of %u rectangles, %zu bytes\n", count, bytes);
+    renderer->upload_rects += count;
+    renderer->upload_bytes += bytes;
+    renderer->upload_last_bytes = (uint32_t)bytes;
+    return (uint32_t)bytes;
+}
+
+// Copies the VRAM texture to the default framebuffer
+void renderer_blit_vram(Renderer* renderer) {
+    if (!renderer->initialized) return;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, renderer->vram_framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    // The upload puts VRAM line 0 at texture row 0, the bottom in GL: flip it
+    glBlitFramebuffer(0, 0, 1024, 512, 0, 512, 1024, 0, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    check_gl_error("blit_vram - glBlitFramebuffer");
+}
+
 // Cleans up OpenGL resources
 void renderer_destroy(Renderer* renderer) {
     if (!renderer->initialized) return;
-    printf("Destroying Renderer...\n");
+    LOG_INFO(LOG_RENDERER, "Destroying Renderer...\n");
 
     // Delete OpenGL objects
-    printf("  Deleting shader program (ID: %u)\n", renderer->shader_program);
+    LOG_INFO(LOG_RENDERER, "  Deleting shader program (ID: %u)\n", renderer->shader_program);
     glDeleteProgram(renderer->shader_program); check_gl_error("destroy - glDeleteProgram");
 
-    printf("  Deleting VBOs (Pos: %u, Col: %u)\n", renderer->position_buffer, renderer->color_buffer);
+    LOG_INFO(LOG_RENDERER, "  Deleting VBOs (Pos: %u, Col: %u)\n", renderer->position_buffer, renderer->color_buffer);
     glDeleteBuffers(1, &renderer->position_buffer); check_gl_error("destroy - glDeleteBuffers pos");
     glDeleteBuffers(1, &renderer->color_buffer); check_gl_error("destroy - glDeleteBuffers col");
     // Add texcoord buffer deletion later if implemented
 
-    printf("  Deleting VAO (ID: %u)\n", renderer->vao);
+    LOG_INFO(LOG_RENDERER, "  Deleting VAO (ID: %u)\n", renderer->vao);
     glDeleteVertexArrays(1, &renderer->vao); check_gl_error("destroy - glDeleteVertexArrays");
+    glDeleteFramebuffers(1, &renderer->vram_framebuffer); check_gl_error("destroy - glDeleteFramebuffers");
+    glDeleteBuffers(1, &renderer->vram_upload_buffer); check_gl_error("destroy - glDeleteBuffers upload");
 
     renderer->initialized = false;
-    printf("Renderer Destroyed.\n");
+    LOG_INFO(LOG_RENDERER, "Renderer Destroyed.\n");
 }
 
 // --- NEW FUNCTION IMPLEMENTATION ---
 // This is the implementation of the new function we added to the header.
 void renderer_push_textured_quad(Renderer* renderer, RendererPosition pos[4], RendererTexCoord tex[4], uint16_t clut, uint16_t tpage) {
     if (!renderer->initialized) {
-        fprintf(stderr, "Renderer Error: push_textured_quad called before initialization.\n");
+        LOG_ERROR(LOG_RENDERER, "Renderer Error: push_textured_quad called before initialization.\n");
         return;
     }
 
     if (renderer->vertex_count + 6 > VERTEX_BUFFER_LEN) {
-        printf("Renderer Info: Vertex buffer full, forcing draw before push_textured_quad.\n");
+        LOG_DEBUG(LOG_RENDERER, "Renderer Info: Vertex buffer full, forcing draw before push_textured_quad.\n");
         renderer_draw(renderer);
     }
 
     // NOTE: For a more advanced renderer, you would check if 'clut' or 'tpage'
     // has changed and force a draw. For now, we will handle it simply.
 
-    printf("Renderer: Buffering Textured Quad (Start Index: %u)\n", renderer->vertex_count);
+    LOG_DEBUG(LOG_RENDERER, "Renderer: Buffering Textured Quad (Start Index: %u)\n", renderer->vertex_count);
 
     // Decompose quad into two triangles (0, 1, 2 and 0, 2, 3)
     // Triangle 1
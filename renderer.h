@@ -8,6 +8,7 @@
 // Make sure you have GLEW (or GLAD) headers included correctly in your project setup
 #define GLEW_STATIC // Or define dynamically if preferred
 #include <GL/glew.h> // Or your GLAD/other GL header
+#include "vram.h"
 
 // --- Renderer-Specific Data Types ---
 
@@ -35,6 +36,9 @@ typedef struct {
 // Adjust as needed for performance/memory trade-offs. (Guide uses 64*1024)
 #define VERTEX_BUFFER_LEN (64 * 1024)
 
+// Most rectangles one VRAM texture upload is split into (see vram_dirty_rects)
+#define RENDERER_MAX_UPLOAD_RECTS 32
+
 // Structure holding the state of the OpenGL renderer
 typedef struct {
     // OpenGL Object IDs
@@ -46,6 +50,9 @@ typedef struct {
     // GLuint texcoord_buffer; // VBO for texture coordinates (future implementation)
     GLuint shader_program;  // ID of the compiled and linked GLSL shader program
     GLuint vram_texture_id; // VRAM 
+    GLuint vram_framebuffer; // Read framebuffer over the VRAM texture (software backend display)
+    GLuint vram_upload_buffer; // Pixel unpack buffer the dirty VRAM rectangles are staged in
+    int8_t vram_upload_layout; // Texel layout of the texture: 1 software, 0 OpenGL, -1 nothing uploaded yet
     // Shader Uniform Location
     GLint uniform_offset_loc; // Location ID of the 'offset' uniform in the vertex shader
 
@@ -58,6 +65,12 @@ typedef struct {
     // State Tracking
     uint32_t vertex_count;      // Number of vertices currently buffered in the CPU-side arrays
     bool initialized;           // Flag indicating if the renderer has been successfully initialized
+
+    // VRAM Upload Statistics (renderer_upload_vram)
+    uint64_t upload_frames;     // Calls, one per presented frame
+    uint64_t upload_rects;      // Rectangles uploaded in total
+    uint64_t upload_bytes;      // Bytes uploaded in total
+    uint32_t upload_last_bytes; // Bytes uploaded by the last call
 } Renderer;
 
 // --- Function Prototypes ---
@@ -117,6 +130,27 @@ void renderer_display(Renderer* renderer);
  */
 void renderer_set_draw_offset(Renderer* renderer, int16_t x, int16_t y);
 
+/**
+ * @brief Brings the VRAM texture up to date with the blocks written since the last call
+ * (vram_take_dirty), instead of uploading all 1 MB. The dirty blocks are merged into at
+ * most RENDERER_MAX_UPLOAD_RECTS rectangles, packed into a pixel unpack buffer and
+ * copied into the texture by the driver without stalling the CPU. A frame that wrote
+ * nothing uploads nothing; switching the texel layout uploads everything.
+ * @param renderer Pointer to the Renderer instance.
+ * @param vram VRAM to upload; its dirty bitmap is cleared.
+ * @param software true for the software backend's native 1555 BGR texels, false for
+ *        the layout the OpenGL backend samples.
+ * @return Bytes uploaded (also kept in upload_last_bytes and added to the totals).
+ */
+uint32_t renderer_upload_vram(Renderer* renderer, Vram* vram, bool software);
+
+/**
+ * @brief Copies the VRAM texture to the window (1:1, VRAM line 0 at the top).
+ * Used to display what the software rasterizer drew into VRAM.
+ * @param renderer Pointer to the Renderer instance.
+ */
+void renderer_blit_vram(Renderer* renderer);
+
 /**
  * @brief Destroys OpenGL resources (VBOs, VAO, Shader Program).
  * Should be called before the OpenGL context is destroyed.
@@ -0,0 +1,229 @@
+// rewind.c
+// Rewind ring: page-level XOR deltas between consecutive save states, LZ-compressed.
+#include "rewind.h"
+#include "lz.h"
+#include "logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t rewind_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline size_t rewind_page_length(size_t state_size, uint32_t page) {
+    size_t offset = (size_t)page << REWIND_PAGE_SHIFT;
+    return state_size - offset < REWIND_PAGE_SIZE ? state_size - offset : REWIND_PAGE_SIZE;
+}
+
+static inline void rewind_xor(uint8_t* dst, const uint8_t* a, const uint8_t* b, size_t length) {
+    for (size_t i = 0; i < length; ++i) dst[i] = a[i] ^ b[i];
+}
+
+
+// --- Data Ring ---
+static void rewind_drop_oldest(Rewind* rewind) {
+    rewind->first = (rewind->first + 1) % REWIND_MAX_ENTRIES;
+    rewind->count--;
+}
+
+static void rewind_clear_ring(Rewind* rewind) {
+    rewind->first = 0;
+    rewind->count = 0;
+    rewind->write_pos = 0;
+}
+
+/**
+ * @brief Finds room for a record of 'size' bytes after the newest one, dropping the
+ * oldest entries in its way.
+ * @return Where to write the record, or NULL if it is larger than the whole ring.
+ */
+static uint8_t* rewind_reserve(Rewind* rewind, size_t size) {
+    if (size > rewind->capacity) return NULL;
+    if (rewind->count == REWIND_MAX_ENTRIES) rewind_drop_oldest(rewind);
+
+    while (rewind->count > 0) {
+        size_t oldest = rewind->entries[rewind->first].offset;
+        if (oldest >= rewind->write_pos) {
+            // Wrapped layout: the free space ends where the oldest record starts
+            if (rewind->write_pos + size <= oldest) break;
+            rewind_drop_oldest(rewind);
+        } else {
+            // Linear layout: the free space runs to the end of the ring
+            if (rewind->write_pos + size <= rewind->capacity) break;
+            rewind->write_pos = 0;
+        }
+    }
+    if (rewind->count == 0 && rewind->write_pos + size > rewind->capacity) rewind->write_pos = 0;
+    return rewind->data + rewind->write_pos;
+}
+
+/**
+ * @brief Makes the just captured state the new head (and, if 'rebase', the oldest point
+ * the ring can go back to).
+ */
+static void rewind_swap_head(Rewind* rewind, bool rebase) {
+    SaveStateBuffer previous = rewind->head;
+    rewind->head = rewind->current;
+    rewind->current = previous;
+    rewind->has_head = true;
+    if (rebase) rewind_clear_ring(rewind);
+}
+
+static bool rewind_ensure_scratch(Rewind* rewind, size_t state_size) {
+    if (rewind->scratch_size >= state_size) return true;
+    size_t pages = (state_size + REWIND_PAGE_SIZE - 1) >> REWIND_PAGE_SHIFT;
+    free(rewind->delta);
+    free(rewind->packed);
+    rewind->delta = malloc(state_size);
+    rewind->packed = malloc(pages * sizeof(uint32_t) + lz_compress_bound(state_size));
+    if (!rewind->delta || !rewind->packed) {
+        LOG_ERROR(LOG_CPU, "Rewind: failed to allocate the scratch buffers\n");
+        rewind->scratch_size = 0;
+        return false;
+    }
+    rewind->scratch_size = state_size;
+    return true;
+}
+
+
+// --- Public API ---
+bool rewind_init(Rewind* rewind, size_t capacity, uint32_t interval) {
+    memset(rewind, 0, sizeof(*rewind));
+    rewind->data = malloc(capacity);
+    rewind->entries = malloc(REWIND_MAX_ENTRIES * sizeof(RewindEntry));
+    if (!rewind->data || !rewind->entries) {
+        LOG_ERROR(LOG_CPU, "Rewind: failed to allocate a %zu byte buffer\n", capacity);
+        rewind_destroy(rewind);
+        return false;
+    }
+    rewind->capacity = capacity;
+    rewind->interval = interval ? interval : 1;
+    rewind->countdown = 0; // First snapshot on the next frame
+    return true;
+}
+
+void rewind_destroy(Rewind* rewind) {
+    free(rewind->data);
+    free(rewind->entries);
+    free(rewind->delta);
+    free(rewind->packed);
+    savestate_buffer_free(&rewind->head);
+    savestate_buffer_free(&rewind->current);
+    memset(rewind, 0, sizeof(*rewind));
+}
+
+void rewind_frame(Rewind* rewind, Cpu* cpu) {
+    if (rewind->data == NULL) return;
+    if (rewind->countdown > 0) {
+        rewind->countdown--;
+        return;
+    }
+    rewind->countdown = rewind->interval - 1;
+    rewind_capture(rewind, cpu);
+}
+
+bool rewind_capture(Rewind* rewind, Cpu* cpu) {
+    uint64_t start = rewind_clock_ns();
+    if (!savestate_save(cpu, &rewind->current)) return false;
+
+    size_t state_size = rewind->current.size;
+    if (!rewind->has_head || rewind->head.size != state_size) {
+        rewind_swap_head(rewind, true); // First snapshot: nothing to diff against
+        return true;
+    }
+    if (!rewind_ensure_scratch(rewind, state_size)) return false;
+
+    // Collect and XOR the pages that changed since the head
+    uint32_t* page_list = (uint32_t*)rewind->packed;
+    uint32_t page_count = 0;
+    size_t delta_size = 0;
+    uint32_t pages = (uint32_t)((state_size + REWIND_PAGE_SIZE - 1) >> REWIND_PAGE_SHIFT);
+    for (uint32_t page = 0; page < pages; ++page) {
+        size_t offset = (size_t)page << REWIND_PAGE_SHIFT;
+        size_t length = rewind_page_length(state_size, page);
+        const uint8_t* now = rewind->current.data + offset;
+        const uint8_t* before = rewind->head.data + offset;
+        if (memcmp(now, before, length) == 0) continue;
+        rewind_xor(rewind->delta + delta_size, now, before, length);
+        delta_size += length;
+        page_list[page_count++] = page;
+    }
+
+    size_t list_size = page_count * sizeof(uint32_t);
+    size_t record_size = list_size + lz_compress(rewind->delta, delta_size, rewind->packed + list_size);
+    uint8_t* record = rewind_reserve(rewind, record_size);
+    if (record == NULL) {
+        LOG_WARN(LOG_CPU, "Rewind: %zu byte delta exceeds the buffer, history restarts here\n", record_size);
+        rewind_swap_head(rewind, true);
+        return false;
+    }
+    memcpy(record, rewind->packed, record_size);
+
+    RewindEntry* entry = &rewind->entries[(rewind->first + rewind->count) % REWIND_MAX_ENTRIES];
+    entry->offset = rewind->write_pos;
+    entry->size = (uint32_t)record_size;
+    entry->page_count = page_count;
+    rewind->count++;
+    rewind->write_pos += record_size;
+    rewind_swap_head(rewind, false);
+
+    rewind->captures++;
+    rewind->capture_bytes += record_size;
+    rewind->last_size = (uint32_t)record_size;
+    rewind->capture_ns += rewind_clock_ns() - start;
+    return true;
+}
+
+bool rewind_step_back(Rewind* rewind, Cpu* cpu, uint32_t steps) {
+    if (!rewind->has_head) return false;
+    size_t state_size = rewind->head.size;
+    uint32_t popped = 0;
+
+    while (popped < steps && rewind->count > 0) {
+        const RewindEntry* entry = &rewind->entries[(rewind->first + rewind->count - 1) % REWIND_MAX_ENTRIES];
+        const uint8_t* record = rewind->data + entry->offset;
+        size_t list_size = entry->page_count * sizeof(uint32_t);
+
+        size_t delta_size = 0;
+        for (uint32_t i = 0; i < entry->page_count; ++i) {
+            uint32_t page;
+            memcpy(&page, record + i * sizeof(uint32_t), sizeof(page));
+            delta_size += rewind_page_length(state_size, page);
+        }
+        if (!rewind_ensure_scratch(rewind, state_size) ||
+            !lz_decompress(record + list_size, entry->size - list_size, rewind->delta, delta_size)) {
+            LOG_ERROR(LOG_CPU, "Rewind: corrupt delta, dropping the remaining history\n");
+            rewind_clear_ring(rewind);
+            break;
+        }
+
+        // head XOR delta = the snapshot before it
+        const uint8_t* delta = rewind->delta;
+        for (uint32_t i = 0; i < entry->page_count; ++i) {
+            uint32_t page;
+            memcpy(&page, record + i * sizeof(uint32_t), sizeof(page));
+            size_t length = rewind_page_length(state_size, page);
+            uint8_t* target = rewind->head.data + ((size_t)page << REWIND_PAGE_SHIFT);
+            rewind_xor(target, target, delta, length);
+            delta += length;
+        }
+        rewind->write_pos = entry->offset;
+        rewind->count--;
+        popped++;
+    }
+
+    rewind->countdown = rewind->interval - 1;
+    savestate_load(cpu, rewind->head.data, rewind->head.size);
+    return popped > 0 || steps == 0;
+}
+
+size_t rewind_used_bytes(const Rewind* rewind) {
+    size_t used = 0;
+    for (uint32_t i = 0; i < rewind->count; ++i) {
+        used += rewind->entries[(rewind->first + i) % REWIND_MAX_ENTRIES].size;
+    }
+    return used;
+}
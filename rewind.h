@@ -0,0 +1,101 @@
+// rewind.h
+// Rewind buffer: a bounded ring of compressed XOR deltas between periodic save states.
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "cpu.h"
+#include "savestate.h"
+
+#define REWIND_PAGE_SHIFT 12 // Deltas work on 4 KiB pages of the serialized state
+#define REWIND_PAGE_SIZE  (1u << REWIND_PAGE_SHIFT)
+#define REWIND_MAX_ENTRIES 65536 // Snapshot count limit, independent of the byte budget
+
+#define REWIND_DEFAULT_CAPACITY (256u * 1024 * 1024)
+#define REWIND_DEFAULT_INTERVAL 2 // Frames between snapshots
+
+/* --- How it works ---
+ * 'head' holds the newest snapshot in full. Each ring entry holds the 4 KiB pages
+ * that differ between a snapshot and the one before it, XORed together and
+ * LZ-compressed. XOR is its own inverse, so applying the newest entry to head turns it
+ * back into the previous snapshot: rewinding walks backwards one entry at a time and
+ * only touches the pages that changed. When the byte budget is exceeded the oldest
+ * entries are dropped.
+ */
+typedef struct {
+    size_t offset;         // Position of the record in the data ring
+    uint32_t size;         // Record size (page list + compressed delta)
+    uint32_t page_count;   // Pages in the delta
+} RewindEntry;
+
+typedef struct {
+    uint8_t* data;          // Data ring holding the entry records
+    size_t capacity;        // Byte budget of the data ring
+    size_t write_pos;       // Where the next record goes
+
+    RewindEntry* entries;   // Entry ring, oldest first
+    uint32_t first;         // Index of the oldest entry
+    uint32_t count;
+
+    uint32_t interval;      // Frames between snapshots
+    uint32_t countdown;     // Frames until the next snapshot
+    bool has_head;          // False until the first snapshot
+
+    SaveStateBuffer head;    // Newest snapshot
+    SaveStateBuffer current; // Snapshot being captured
+    uint8_t* delta;          // XOR of the changed pages (state size)
+    uint8_t* packed;         // Record being built (page list + compressed delta)
+    size_t scratch_size;     // Size the two scratch buffers were allocated for
+
+    // --- Statistics ---
+    uint64_t captures;
+    uint64_t capture_bytes;  // Sum of the record sizes
+    uint64_t capture_ns;     // Time spent in rewind_capture
+    uint32_t last_size;      // Size of the newest record
+} Rewind;
+
+/**
+ * @brief Allocates the data ring.
+ * @param rewind The rewind buffer.
+ * @param capacity Byte budget for the deltas (the full head and scratch buffers come on top).
+ * @param interval Frames between snapshots (>= 1).
+ * @return false on allocation failure.
+ */
+bool rewind_init(Rewind* rewind, size_t capacity, uint32_t interval);
+
+/**
+ * @brief Releases every buffer.
+ */
+void rewind_destroy(Rewind* rewind);
+
+/**
+ * @brief Call once per emulated frame: takes a snapshot every 'interval' frames.
+ * @param rewind The rewind buffer.
+ * @param cpu The machine to snapshot.
+ */
+void rewind_frame(Rewind* rewind, Cpu* cpu);
+
+/**
+ * @brief Takes a snapshot now and appends its delta to the ring.
+ * @return false if the snapshot could not be stored.
+ */
+bool rewind_capture(Rewind* rewind, Cpu* cpu);
+
+/**
+ * @brief Steps back 'steps' snapshots (fewer if the ring holds fewer) and loads the result.
+ * Only the pages recorded in the popped deltas are touched, plus one savestate_load.
+ * @param rewind The rewind buffer.
+ * @param cpu The machine to restore.
+ * @param steps Number of snapshots to go back; 0 reloads the newest snapshot.
+ * @return false if there was no snapshot to go back to.
+ */
+bool rewind_step_back(Rewind* rewind, Cpu* cpu, uint32_t steps);
+
+/**
+ * @brief Bytes currently used by the deltas.
+ */
+size_t rewind_used_bytes(const Rewind* rewind);
+
+#endif // REWIND_H
@@ -0,0 +1,505 @@
+// savestate.c
+// Save-state serializer: one sync function per section describes its layout for
+// measuring, saving and loading alike, so the three can never disagree.
+#include "savestate.h"
+#include "interconnect.h"
+#include "logger.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- Section I/O ---
+typedef enum {
+    STATE_MEASURE, // Only count bytes (sizes the output and validates loaded sections)
+    STATE_SAVE,    // Copy fields into the buffer
+    STATE_LOAD     // Copy fields out of the buffer
+} StateMode;
+
+typedef struct {
+    StateMode mode;
+    uint32_t version; // Version of the section being processed
+    uint8_t* base;    // Section payload (NULL when measuring)
+    size_t size;      // Bytes processed so far
+} StateIo;
+
+static void state_bytes(StateIo* io, void* value, size_t length) {
+    if (io->mode == STATE_SAVE) {
+        memcpy(io->base + io->size, value, length);
+    } else if (io->mode == STATE_LOAD) {
+        memcpy(value, io->base + io->size, length);
+    }
+    io->size += length;
+}
+
+static inline void state_u8(StateIo* io, uint8_t* value)   { state_bytes(io, value, 1); }
+static inline void state_u16(StateIo* io, uint16_t* value) { state_bytes(io, value, 2); }
+static inline void state_u32(StateIo* io, uint32_t* value) { state_bytes(io, value, 4); }
+static inline void state_u64(StateIo* io, uint64_t* value) { state_bytes(io, value, 8); }
+
+// bool and enum sizes are up to the compiler: store them as fixed-width integers
+static void state_bool(StateIo* io, bool* value) {
+    uint8_t byte = *value ? 1 : 0;
+    state_u8(io, &byte);
+    if (io->mode == STATE_LOAD) *value = byte != 0;
+}
+
+#define STATE_ENUM(io, field) do { \
+        uint32_t value_ = (uint32_t)(field); \
+        state_u32((io), &value_); \
+        if ((io)->mode == STATE_LOAD) (field) = value_; \
+    } while (0)
+
+
+// --- Section Layouts ---
+static void sync_cpu(StateIo* io, Cpu* cpu) {
+    state_u32(io, &cpu->pc);
+    state_u32(io, &cpu->next_pc);
+    state_u32(io, &cpu->current_pc);
+    state_bytes(io, cpu->regs, sizeof(cpu->regs));
+    state_u32(io, &cpu->load_reg_idx);
+    state_u32(io, &cpu->load_value);
+    state_u32(io, &cpu->next_load_reg_idx);
+    state_u32(io, &cpu->next_load_value);
+    state_u32(io, &cpu->hi);
+    state_u32(io, &cpu->lo);
+    state_bool(io, &cpu->branch_taken);
+    state_bool(io, &cpu->in_delay_slot);
+    state_u32(io, &cpu->sr);
+    state_u32(io, &cpu->cause);
+    state_u32(io, &cpu->epc);
+}
+
+static void sync_icache(StateIo* io, Cpu* cpu) {
+    for (int i = 0; i < ICACHE_NUM_LINES; ++i) {
+        ICacheLine* line = &cpu->icache[i];
+        state_u32(io, &line->tag);
+        for (int w = 0; w < ICACHE_LINE_WORDS; ++w) state_bool(io, &line->valid[w]);
+        state_bytes(io, line->data, sizeof(line->data));
+    }
+}
+
+// Interrupt controller and scratchpad
+static void sync_bus(StateIo* io, Cpu* cpu) {
+    Interconnect* inter = cpu->inter;
+    state_u16(io, &inter->irq_status);
+    state_u16(io, &inter->irq_mask);
+    state_bytes(io, inter->scratchpad, sizeof(inter->scratchpad));
+}
+
+// Clock and event deadlines. The heap is rebuilt through the public API on load.
+static void sync_scheduler(StateIo* io, Cpu* cpu) {
+    Scheduler* sched = &cpu->inter->scheduler;
+    uint64_t now = sched->now;
+    state_u64(io, &now);
+
+    bool pending[SCHED_EVENT_COUNT];
+    uint64_t deadline[SCHED_EVENT_COUNT];
+    for (int event = 0; event < SCHED_EVENT_COUNT; ++event) {
+        pending[event] = scheduler_is_pending(sched, (SchedulerEvent)event);
+        deadline[event] = sched->deadline[event];
+        state_bool(io, &pending[event]);
+        state_u64(io, &deadline[event]);
+    }
+    if (io->mode != STATE_LOAD) return;
+
+    sched->now = now;
+    for (int event = 0; event < SCHED_EVENT_COUNT; ++event) {
+        scheduler_cancel(sched, (SchedulerEvent)event);
+        sched->deadline[event] = deadline[event];
+        if (pending[event]) scheduler_schedule_at(sched, (SchedulerEvent)event, deadline[event]);
+    }
+}
+
+static void sync_dma(StateIo* io, Cpu* cpu) {
+    Dma* dma = &cpu->inter->dma;
+    state_u32(io, &dma->control);
+    state_bool(io, &dma->force_irq);
+    state_u8(io, &dma->channel_irq_enable);
+    state_bool(io, &dma->master_irq_enable);
+    state_u8(io, &dma->channel_irq_flags);
+    state_bool(io, &dma->master_irq_flag);
+    state_u8(io, &dma->dicr_unknown_rw);
+    for (int i = 0; i < 7; ++i) {
+        DmaChannel* ch = &dma->channels[i];
+        state_bool(io, &ch->enable);
+        STATE_ENUM(io, ch->direction);
+        STATE_ENUM(io, ch->step);
+        STATE_ENUM(io, ch->sync);
+        state_bool(io, &ch->trigger);
+        state_u32(io, &ch->base_addr);
+        state_u16(io, &ch->block_size);
+        state_u16(io, &ch->block_count);
+    }
+}
+
+static void sync_timers(StateIo* io, Cpu* cpu) {
+    Timers* timers = &cpu->inter->timers_state;
+    for (int i = 0; i < 3; ++i) {
+        Timer* t = &timers->timers[i];
+        state_u16(io, &t->counter);
+        state_u16(io, &t->mode);
+        state_u16(io, &t->target);
+        state_bool(io, &t->sync_enable);
+        state_u8(io, &t->sync_mode);
+        state_bool(io, &t->reset_on_target);
+        state_bool(io, &t->irq_on_target);
+        state_bool(io, &t->irq_on_ffff);
+        state_bool(io, &t->irq_repeat);
+        state_bool(io, &t->irq_pulse);
+        state_u8(io, &t->clock_source);
+        state_bool(io, &t->interrupt_requested);
+        state_bool(io, &t->reached_target_flag);
+        state_bool(io, &t->reached_ffff_flag);
+    }
+    state_bytes(io, timers->fractional_ticks, sizeof(timers->fractional_ticks));
+    state_u64(io, &timers->last_sync);
+}
+
+static void sync_fifo(StateIo* io, Fifo8* fifo) {
+    state_bytes(io, fifo->data, sizeof(fifo->data));
+    state_u8(io, &fifo->count);
+    state_u8(io, &fifo->read_ptr);
+}
+
+// Drive and controller state. The mounted image (disc_file/disc_present) belongs to the host.
+static void sync_cdrom(StateIo* io, Cpu* cpu) {
+    Cdrom* cdrom = &cpu->inter->cdrom;
+    state_u8(io, &cdrom->index);
+    state_u8(io, &cdrom->status);
+    state_u8(io, &cdrom->interrupt_enable);
+    state_u8(io, &cdrom->interrupt_flags);
+    sync_fifo(io, &cdrom->param_fifo);
+    sync_fifo(io, &cdrom->response_fifo);
+    state_bytes(io, cdrom->data_buffer, sizeof(cdrom->data_buffer));
+    state_u32(io, &cdrom->data_buffer_count);
+    state_u32(io, &cdrom->data_buffer_read_ptr);
+    STATE_ENUM(io, cdrom->current_state);
+    state_u8(io, &cdrom->pending_command);
+
+    uint8_t completion = io->mode == STATE_SAVE ? cdrom_completion_id(cdrom) : 0;
+    state_u8(io, &completion);
+    if (io->mode == STATE_LOAD && !cdrom_set_completion_id(cdrom, completion)) {
+        LOG_WARN(LOG_CDROM, "Warning: Unknown CDROM completion handler ID %u in save state, dropping it\n", completion);
+        cdrom->pending_completion_handler = NULL;
+    }
+
+    state_u32(io, &cdrom->target_lba);
+    state_bool(io, &cdrom->double_speed);
+    state_bool(io, &cdrom->sector_size_is_2340);
+}
+
+// GPU registers and GP0 state (VRAM is its own section, the renderer is host-only)
+static void sync_gpu(StateIo* io, Cpu* cpu) {
+    Gpu* gpu = &cpu->inter->gpu;
+    state_u8(io, &gpu->page_base_x);
+    state_u8(io, &gpu->page_base_y);
+    state_u8(io, &gpu->semi_transparency);
+    STATE_ENUM(io, gpu->texture_depth);
+    state_bool(io, &gpu->dithering);
+    state_bool(io, &gpu->draw_to_display);
+    state_bool(io, &gpu->force_set_mask_bit);
+    state_bool(io, &gpu->preserve_masked_pixels);
+    STATE_ENUM(io, gpu->field);
+    state_bool(io, &gpu->texture_disable);
+    state_bool(io, &gpu->rectangle_texture_x_flip);
+    state_bool(io, &gpu->rectangle_texture_y_flip);
+    state_u8(io, &gpu->hres_raw.hr1);
+    state_u8(io, &gpu->hres_raw.hr2);
+    STATE_ENUM(io, gpu->vres);
+    STATE_ENUM(io, gpu->vmode);
+    STATE_ENUM(io, gpu->display_depth);
+    state_bool(io, &gpu->interlaced);
+    state_bool(io, &gpu->display_disabled);
+    state_bool(io, &gpu->interrupt);
+    STATE_ENUM(io, gpu->dma_setting);
+
+    state_u8(io, &gpu->texture_window_x_mask);
+    state_u8(io, &gpu->texture_window_y_mask);
+    state_u8(io, &gpu->texture_window_x_offset);
+    state_u8(io, &gpu->texture_window_y_offset);
+
+    state_u16(io, &gpu->drawing_area_left);
+    state_u16(io, &gpu->drawing_area_top);
+    state_u16(io, &gpu->drawing_area_right);
+    state_u16(io, &gpu->drawing_area_bottom);
+    state_u16(io, (uint16_t*)&gpu->drawing_x_offset);
+    state_u16(io, (uint16_t*)&gpu->drawing_y_offset);
+
+    state_u16(io, &gpu->display_vram_x_start);
+    state_u16(io, &gpu->display_vram_y_start);
+    state_u16(io, &gpu->display_horiz_start);
+    state_u16(io, &gpu->display_horiz_end);
+    state_u16(io, &gpu->display_line_start);
+    state_u16(io, &gpu->display_line_end);
+
+    state_bytes(io, gpu->gp0_command_buffer.buffer, sizeof(gpu->gp0_command_buffer.buffer));
+    state_u8(io, &gpu->gp0_command_buffer.count);
+    state_u32(io, &gpu->gp0_words_remaining);
+    state_u8(io, &gpu->gp0_current_opcode);
+    STATE_ENUM(io, gpu->gp0_mode);
+
+    uint8_t method = io->mode == STATE_SAVE ? gpu_gp0_method_id(gpu) : 0;
+    state_u8(io, &method);
+    if (io->mode == STATE_LOAD && !gpu_set_gp0_method_id(gpu, method)) {
+        LOG_WARN(LOG_GPU, "Warning: Unknown GP0 handler ID %u in save state, dropping it\n", method);
+        gpu->gp0_command_method = NULL;
+    }
+
+    state_u16(io, &gpu->vram_load_x);
+    state_u16(io, &gpu->vram_load_y);
+    state_u16(io, &gpu->vram_load_w);
+    state_u16(io, &gpu->vram_load_h);
+    state_u32(io, &gpu->vram_load_count);
+    if (io->version >= 2) { // GP0(C0) readback
+        state_u16(io, &gpu->vram_store_x);
+        state_u16(io, &gpu->vram_store_y);
+        state_u16(io, &gpu->vram_store_w);
+        state_u16(io, &gpu->vram_store_h);
+        state_u32(io, &gpu->vram_store_count);
+        state_u32(io, &gpu->read_latch);
+    } else if (io->mode == STATE_LOAD) {
+        gpu->vram_store_w = 0; gpu->vram_store_h = 0;
+        gpu->vram_store_count = 0; gpu->read_latch = 0;
+    }
+    state_u16(io, &gpu->tpage_x_base);
+    state_u16(io, &gpu->tpage_y_base);
+}
+
+// Loads only copy the 64-pixel blocks that differ and mark just those dirty, so the
+// texture upload after a load (or a run-ahead rollback) stays incremental.
+static void sync_vram(StateIo* io, Cpu* cpu) {
+    Vram* vram = &cpu->inter->gpu.vram;
+    if (io->mode != STATE_LOAD) {
+        state_bytes(io, vram->data, VRAM_SIZE);
+        return;
+    }
+    const size_t line_bytes = VRAM_WIDTH * VRAM_BPP;
+    const size_t block_bytes = VRAM_DIRTY_BLOCK_W * VRAM_BPP;
+    const uint8_t* src = io->base + io->size;
+    for (size_t line = 0; line < VRAM_SIZE; line += line_bytes) {
+        if (memcmp(vram->data + line, src + line, line_bytes) == 0) continue;
+        for (size_t offset = line; offset < line + line_bytes; offset += block_bytes) {
+            if (memcmp(vram->data + offset, src + offset, block_bytes) == 0) continue;
+            memcpy(vram->data + offset, src + offset, block_bytes);
+            vram_mark_dirty(vram, (uint32_t)offset);
+        }
+    }
+    io->size += VRAM_SIZE;
+}
+
+// Loads only copy the 1 KiB pages that differ: cached blocks (and JIT code) decoded from
+// unchanged pages stay valid, the rest are invalidated like after a guest store.
+static void sync_ram(StateIo* io, Cpu* cpu) {
+    Interconnect* inter = cpu->inter;
+    if (io->mode != STATE_LOAD) {
+        state_bytes(io, inter->ram->data, RAM_SIZE);
+        return;
+    }
+    const size_t page_bytes = 1u << CODE_PAGE_SHIFT;
+    const uint8_t* src = io->base + io->size;
+    for (uint32_t page = 0; page < CODE_PAGE_COUNT; ++page) {
+        size_t offset = (size_t)page << CODE_PAGE_SHIFT;
+        if (memcmp(inter->ram->data + offset, src + offset, page_bytes) == 0) continue;
+        memcpy(inter->ram->data + offset, src + offset, page_bytes);
+        interconnect_note_ram_write(inter, (uint32_t)offset);
+    }
+    io->size += RAM_SIZE;
+}
+
+typedef struct {
+    char tag[4];
+    uint32_t version; // Version written by this build; loads accept 1..version
+    void (*sync)(StateIo* io, Cpu* cpu);
+} SectionDesc;
+
+// Load applies sections in this order (the scheduler before the devices that read it)
+static const SectionDesc sections[] = {
+    { {'C','P','U',' '}, 1, sync_cpu },
+    { {'I','C','A','C'}, 1, sync_icache },
+    { {'B','U','S',' '}, 1, sync_bus },
+    { {'S','C','H','D'}, 1, sync_scheduler },
+    { {'D','M','A',' '}, 1, sync_dma },
+    { {'T','M','R','S'}, 1, sync_timers },
+    { {'C','D','R','M'}, 1, sync_cdrom },
+    { {'G','P','U',' '}, 2, sync_gpu },
+    { {'V','R','A','M'}, 1, sync_vram },
+    { {'R','A','M',' '}, 1, sync_ram },
+};
+#define SECTION_COUNT (sizeof(sections) / sizeof(sections[0]))
+
+static size_t section_size(const SectionDesc* desc, uint32_t version, Cpu* cpu) {
+    StateIo io = { STATE_MEASURE, version, NULL, 0 };
+    desc->sync(&io, cpu);
+    return io.size;
+}
+
+
+// --- Public API ---
+bool savestate_save(Cpu* cpu, SaveStateBuffer* buffer) {
+    gpu_flush(&cpu->inter->gpu); // Queued GP0 words and batched polygons land first
+    size_t sizes[SECTION_COUNT];
+    size_t total = sizeof(SaveStateHeader);
+    for (size_t i = 0; i < SECTION_COUNT; ++i) {
+        sizes[i] = section_size(&sections[i], sections[i].version, cpu);
+        total += sizeof(SaveStateSection) + sizes[i];
+    }
+    if (buffer->capacity < total) {
+        uint8_t* data = realloc(buffer->data, total);
+        if (data == NULL) {
+            LOG_ERROR(LOG_CPU, "SaveState: failed to allocate %zu bytes\n", total);
+            return false;
+        }
+        buffer->data = data;
+        buffer->capacity = total;
+    }
+
+    SaveStateHeader header;
+    memcpy(header.magic, SAVESTATE_MAGIC, sizeof(header.magic));
+    header.version = SAVESTATE_VERSION;
+    header.section_count = SECTION_COUNT;
+    memcpy(buffer->data, &header, sizeof(header));
+    size_t pos = sizeof(header);
+
+    for (size_t i = 0; i < SECTION_COUNT; ++i) {
+        SaveStateSection section;
+        memcpy(section.tag, sections[i].tag, sizeof(section.tag));
+        section.version = sections[i].version;
+        section.size = (uint32_t)sizes[i];
+        memcpy(buffer->data + pos, &section, sizeof(section));
+        pos += sizeof(section);
+
+        StateIo io = { STATE_SAVE, sections[i].version, buffer->data + pos, 0 };
+        sections[i].sync(&io, cpu);
+        pos += io.size;
+    }
+    buffer->size = pos;
+    return true;
+}
+
+bool savestate_load(Cpu* cpu, const uint8_t* data, size_t size) {
+    SaveStateHeader header;
+    if (size < sizeof(header)) {
+        LOG_ERROR(LOG_CPU, "SaveState: truncated state (%zu bytes)\n", size);
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, SAVESTATE_MAGIC, sizeof(header.magic)) != 0) {
+        LOG_ERROR(LOG_CPU, "SaveState: not a save state\n");
+        return false;
+    }
+    if (header.version != SAVESTATE_VERSION) {
+        LOG_ERROR(LOG_CPU, "SaveState: unsupported format version %u (expected %u)\n", header.version, SAVESTATE_VERSION);
+        return false;
+    }
+
+    // Pass 1: locate and validate every section without touching the machine
+    const uint8_t* payload[SECTION_COUNT] = { NULL };
+    uint32_t versions[SECTION_COUNT] = { 0 };
+    size_t pos = sizeof(header);
+    for (uint32_t n = 0; n < header.section_count; ++n) {
+        SaveStateSection section;
+        if (size - pos < sizeof(section)) {
+            LOG_ERROR(LOG_CPU, "SaveState: truncated section table\n");
+            return false;
+        }
+        memcpy(&section, data + pos, sizeof(section));
+        pos += sizeof(section);
+        if (size - pos < section.size) {
+            LOG_ERROR(LOG_CPU, "SaveState: section '%.4s' runs past the end of the state\n", section.tag);
+            return false;
+        }
+
+        size_t index = SECTION_COUNT;
+        for (size_t i = 0; i < SECTION_COUNT; ++i) {
+            if (memcmp(section.tag, sections[i].tag, sizeof(section.tag)) == 0) index = i;
+        }
+        if (index == SECTION_COUNT) {
+            LOG_WARN(LOG_CPU, "SaveState: skipping unknown section '%.4s'\n", section.tag);
+        } else if (payload[index] != NULL) {
+            LOG_ERROR(LOG_CPU, "SaveState: duplicate section '%.4s'\n", section.tag);
+            return false;
+        } else if (section.version == 0 || section.version > sections[index].version) {
+            LOG_ERROR(LOG_CPU, "SaveState: section '%.4s' has unsupported version %u\n", section.tag, section.version);
+            return false;
+        } else if (section_size(&sections[index], section.version, cpu) != section.size) {
+            LOG_ERROR(LOG_CPU, "SaveState: section '%.4s' has the wrong size (%u bytes)\n", section.tag, section.size);
+            return false;
+        } else {
+            payload[index] = data + pos;
+            versions[index] = section.version;
+        }
+        pos += section.size;
+    }
+    for (size_t i = 0; i < SECTION_COUNT; ++i) {
+        if (payload[i] == NULL) {
+            LOG_ERROR(LOG_CPU, "SaveState: missing section '%.4s'\n", sections[i].tag);
+            return false;
+        }
+    }
+
+    // Pass 2: apply
+    gpu_flush(&cpu->inter->gpu);
+    for (size_t i = 0; i < SECTION_COUNT; ++i) {
+        StateIo io = { STATE_LOAD, versions[i], (uint8_t*)payload[i], 0 };
+        sections[i].sync(&io, cpu);
+    }
+
+    // Host-side state derived from the replaced state (the RAM/VRAM sections already
+    // invalidated the code and marked the pages they changed)
+    cpu->block_exit = true;
+    cpu->idle_loop_hit = false;
+    cpu_update_irq_pending(cpu);
+    cpu->inter->gpu.renderer.vertex_count = 0; // Batched primitives belong to the old timeline
+    return true;
+}
+
+void savestate_buffer_free(SaveStateBuffer* buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+}
+
+bool savestate_save_file(Cpu* cpu, const char* path) {
+    SaveStateBuffer buffer = { NULL, 0, 0 };
+    if (!savestate_save(cpu, &buffer)) return false;
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        LOG_ERROR(LOG_CPU, "SaveState: failed to create the state file: %s\n", strerror(errno));
+        savestate_buffer_free(&buffer);
+        return false;
+    }
+    bool ok = fwrite(buffer.data, 1, buffer.size, file) == buffer.size;
+    if (fclose(file) != 0) ok = false;
+    if (ok) {
+        LOG_INFO(LOG_CPU, "SaveState: saved %zu bytes to '%s'\n", buffer.size, path);
+    } else {
+        LOG_ERROR(LOG_CPU, "SaveState: failed to write '%s'\n", path);
+    }
+    savestate_buffer_free(&buffer);
+    return ok;
+}
+
+bool savestate_load_file(Cpu* cpu, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        LOG_ERROR(LOG_CPU, "SaveState: failed to open the state file: %s\n", strerror(errno));
+        return false;
+    }
+    long length = -1;
+    if (fseek(file, 0, SEEK_END) == 0) length = ftell(file);
+    uint8_t* data = length > 0 ? malloc((size_t)length) : NULL;
+    bool ok = data != NULL && fseek(file, 0, SEEK_SET) == 0 &&
+              fread(data, 1, (size_t)length, file) == (size_t)length;
+    fclose(file);
+
+    if (!ok) {
+        LOG_ERROR(LOG_CPU, "SaveState: failed to read '%s'\n", path);
+    } else if ((ok = savestate_load(cpu, data, (size_t)length))) {
+        LOG_INFO(LOG_CPU, "SaveState: loaded '%s'\n", path);
+    }
+    free(data);
+    return ok;
+}
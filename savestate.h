@@ -0,0 +1,71 @@
+// savestate.h
+// Versioned, sectioned snapshots of the whole emulated machine (CPU, bus, devices, RAM, VRAM).
+#ifndef SAVESTATE_H
+#define SAVESTATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "cpu.h"
+
+#define SAVESTATE_MAGIC   "PSXSTATE"
+#define SAVESTATE_VERSION 1 // Container format; each section has its own version
+
+/* --- File Layout ---
+ * One SaveStateHeader, then 'section_count' sections: a SaveStateSection header followed
+ * by 'size' payload bytes (host byte order, i.e. little-endian on every supported host).
+ * A device adds fields by bumping its section version and guarding the new fields with
+ * a version test, so older states keep loading. Unknown sections are skipped.
+ *
+ * Only guest-visible state is stored. Host resources (GL objects, the renderer's vertex
+ * arrays, the block cache/JIT, the mounted disc image, pointers) are left untouched on
+ * load and function pointers are stored as small IDs.
+ */
+typedef struct {
+    char magic[8];          // SAVESTATE_MAGIC (not NUL terminated)
+    uint32_t version;       // SAVESTATE_VERSION
+    uint32_t section_count;
+} SaveStateHeader;
+
+typedef struct {
+    char tag[4];      // Section name, e.g. "CPU ", "RAM "
+    uint32_t version; // Section layout version (>= 1)
+    uint32_t size;    // Payload bytes following this header
+} SaveStateSection;
+
+// Growable output buffer. Reusing one across saves avoids reallocating every time.
+typedef struct {
+    uint8_t* data;
+    size_t size;     // Bytes of the last state written
+    size_t capacity;
+} SaveStateBuffer;
+
+/**
+ * @brief Serializes the machine the CPU is attached to.
+ * @param cpu The CPU (its interconnect provides the rest of the machine).
+ * @param buffer Output buffer, grown as needed; buffer->size is set to the state size.
+ * @return false if the buffer could not be grown.
+ */
+bool savestate_save(Cpu* cpu, SaveStateBuffer* buffer);
+
+/**
+ * @brief Restores a state produced by savestate_save().
+ * The whole state is validated before anything is applied, so a rejected state leaves
+ * the machine untouched.
+ * @param cpu The CPU (its interconnect provides the rest of the machine).
+ * @param data The serialized state.
+ * @param size Its size in bytes.
+ * @return false if the state is malformed or from an incompatible version.
+ */
+bool savestate_load(Cpu* cpu, const uint8_t* data, size_t size);
+
+/**
+ * @brief Releases the buffer's memory.
+ */
+void savestate_buffer_free(SaveStateBuffer* buffer);
+
+// File helpers around savestate_save / savestate_load.
+bool savestate_save_file(Cpu* cpu, const char* path);
+bool savestate_load_file(Cpu* cpu, const char* path);
+
+#endif // SAVESTATE_H
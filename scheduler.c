@@ -0,0 +1,112 @@
+// scheduler.c
+// Indexed binary min-heap of device events keyed by absolute CPU cycle.
+#include "scheduler.h"
+#include "logger.h"
+#include <stdio.h>
+#include <string.h>
+
+// --- Heap Helpers ---
+
+/**
+ * @brief Strict ordering of two events: earlier deadline first, lower id on ties
+ * (keeps dispatch order deterministic when several devices fire on the same cycle).
+ */
+static bool scheduler_before(const Scheduler* sched, uint8_t a, uint8_t b) {
+    if (sched->deadline[a] != sched->deadline[b]) return sched->deadline[a] < sched->deadline[b];
+    return a < b;
+}
+
+static void scheduler_heap_set(Scheduler* sched, uint32_t pos, uint8_t event) {
+    sched->heap[pos] = event;
+    sched->heap_index[event] = (int8_t)pos;
+}
+
+static void scheduler_sift_up(Scheduler* sched, uint32_t pos) {
+    uint8_t event = sched->heap[pos];
+    while (pos > 0) {
+        uint32_t parent = (pos - 1) / 2;
+        if (!scheduler_before(sched, event, sched->heap[parent])) break;
+        scheduler_heap_set(sched, pos, sched->heap[parent]);
+        pos = parent;
+    }
+    scheduler_heap_set(sched, pos, event);
+}
+
+static void scheduler_sift_down(Scheduler* sched, uint32_t pos) {
+    uint8_t event = sched->heap[pos];
+    for (;;) {
+        uint32_t child = pos * 2 + 1;
+        if (child >= sched->heap_size) break;
+        if (child + 1 < sched->heap_size && scheduler_before(sched, sched->heap[child + 1], sched->heap[child])) {
+            child++;
+        }
+        if (!scheduler_before(sched, sched->heap[child], event)) break;
+        scheduler_heap_set(sched, pos, sched->heap[child]);
+        pos = child;
+    }
+    scheduler_heap_set(sched, pos, event);
+}
+
+static void scheduler_update_next_deadline(Scheduler* sched) {
+    sched->next_deadline = sched->heap_size ? sched->deadline[sched->heap[0]] : SCHEDULER_NO_EVENT;
+}
+
+// --- Public API ---
+
+void scheduler_init(Scheduler* sched) {
+    memset(sched, 0, sizeof(*sched));
+    for (int i = 0; i < SCHED_EVENT_COUNT; ++i) {
+        sched->heap_index[i] = -1;
+    }
+    sched->next_deadline = SCHEDULER_NO_EVENT;
+}
+
+void scheduler_register(Scheduler* sched, SchedulerEvent event, SchedulerCallback callback, void* context) {
+    sched->callbacks[event] = callback;
+    sched->contexts[event] = context;
+}
+
+void scheduler_schedule_at(Scheduler* sched, SchedulerEvent event, uint64_t timestamp) {
+    int8_t pos = sched->heap_index[event];
+    sched->deadline[event] = timestamp;
+    if (pos < 0) {
+        pos = (int8_t)sched->heap_size++;
+        scheduler_heap_set(sched, (uint32_t)pos, (uint8_t)event);
+    }
+    // The deadline may have moved either way
+    scheduler_sift_up(sched, (uint32_t)pos);
+    scheduler_sift_down(sched, (uint32_t)sched->heap_index[event]);
+    scheduler_update_next_deadline(sched);
+}
+
+void scheduler_schedule(Scheduler* sched, SchedulerEvent event, uint64_t cycles) {
+    scheduler_schedule_at(sched, event, sched->now + cycles);
+}
+
+void scheduler_cancel(Scheduler* sched, SchedulerEvent event) {
+    int8_t pos = sched->heap_index[event];
+    if (pos < 0) return;
+
+    sched->heap_index[event] = -1;
+    sched->heap_size--;
+    if ((uint32_t)pos < sched->heap_size) {
+        // Move the last entry into the hole and restore the heap property around it
+        uint8_t moved = sched->heap[sched->heap_size];
+        scheduler_heap_set(sched, (uint32_t)pos, moved);
+        scheduler_sift_up(sched, (uint32_t)pos);
+        scheduler_sift_down(sched, (uint32_t)sched->heap_index[moved]);
+    }
+    scheduler_update_next_deadline(sched);
+}
+
+void scheduler_run_due(Scheduler* sched) {
+    while (sched->heap_size != 0 && sched->deadline[sched->heap[0]] <= sched->now) {
+        SchedulerEvent event = (SchedulerEvent)sched->heap[0];
+        scheduler_cancel(sched, event);
+        if (sched->callbacks[event]) {
+            sched->callbacks[event](sched->contexts[event], event);
+        } else {
+            LOG_WARN(LOG_CPU, "Scheduler: Event %d fired with no callback registered.\n", (int)event);
+        }
+    }
+}
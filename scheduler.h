@@ -0,0 +1,104 @@
+// scheduler.h
+// Global device event scheduler: a min-heap of absolute CPU-cycle deadlines.
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Master clock and the derived NTSC VBlank period (in CPU cycles)
+#define PSX_CPU_CLOCK_HZ     33868800
+#define VBLANK_PERIOD_CYCLES (PSX_CPU_CLOCK_HZ / 60)
+
+#define SCHEDULER_NO_EVENT UINT64_MAX // next_deadline value when nothing is scheduled
+
+/* --- Event Identifiers ---
+ * Every device owns a fixed slot: an event is either pending (in the heap) or not.
+ * Rescheduling moves the existing entry instead of adding a second one.
+ */
+typedef enum {
+    SCHED_EVENT_TIMERS = 0, // Next timer target/overflow IRQ
+    SCHED_EVENT_CDROM,      // Second stage of the current CD-ROM command
+    SCHED_EVENT_VBLANK,     // Start of vertical blank (IRQ 0)
+    SCHED_EVENT_DMA0,       // DMA channel completion, one slot per channel (0-6)
+    SCHED_EVENT_DMA1,
+    SCHED_EVENT_DMA2,
+    SCHED_EVENT_DMA3,
+    SCHED_EVENT_DMA4,
+    SCHED_EVENT_DMA5,
+    SCHED_EVENT_DMA6,
+    SCHED_EVENT_COUNT
+} SchedulerEvent;
+
+/**
+ * @brief Device callback run when an event's deadline has passed.
+ * The event is already removed from the heap, so the callback may schedule it again.
+ */
+typedef void (*SchedulerCallback)(void* context, SchedulerEvent event);
+
+typedef struct {
+    uint64_t now;           // Current time in CPU cycles since power-on (advanced by the CPU)
+    uint64_t next_deadline; // Deadline of the earliest pending event (SCHEDULER_NO_EVENT if none)
+
+    uint64_t deadline[SCHED_EVENT_COUNT];  // Absolute deadline per event (kept after it fires)
+    int8_t heap_index[SCHED_EVENT_COUNT];  // Position of each event in heap[], -1 if not pending
+    uint8_t heap[SCHED_EVENT_COUNT];       // Pending events ordered by (deadline, id)
+    uint32_t heap_size;
+
+    SchedulerCallback callbacks[SCHED_EVENT_COUNT];
+    void* contexts[SCHED_EVENT_COUNT];
+} Scheduler;
+
+
+/**
+ * @brief Resets the clock to 0 and clears all events and callbacks.
+ * @param sched Pointer to the Scheduler.
+ */
+void scheduler_init(Scheduler* sched);
+
+/**
+ * @brief Attaches the device callback for an event slot.
+ * @param sched Pointer to the Scheduler.
+ * @param event The event slot.
+ * @param callback Function run when the event fires.
+ * @param context Passed back to the callback (usually the device state).
+ */
+void scheduler_register(Scheduler* sched, SchedulerEvent event, SchedulerCallback callback, void* context);
+
+/**
+ * @brief Schedules (or moves) an event to an absolute timestamp.
+ * @param sched Pointer to the Scheduler.
+ * @param event The event slot.
+ * @param timestamp Absolute deadline in CPU cycles.
+ */
+void scheduler_schedule_at(Scheduler* sched, SchedulerEvent event, uint64_t timestamp);
+
+/**
+ * @brief Schedules (or moves) an event relative to the current time.
+ * @param sched Pointer to the Scheduler.
+ * @param event The event slot.
+ * @param cycles Delay in CPU cycles from now.
+ */
+void scheduler_schedule(Scheduler* sched, SchedulerEvent event, uint64_t cycles);
+
+/**
+ * @brief Removes a pending event. Does nothing if it is not scheduled.
+ * @param sched Pointer to the Scheduler.
+ * @param event The event slot.
+ */
+void scheduler_cancel(Scheduler* sched, SchedulerEvent event);
+
+/**
+ * @brief Runs, in deadline order, every event whose deadline is <= now.
+ * @param sched Pointer to the Scheduler.
+ */
+void scheduler_run_due(Scheduler* sched);
+
+/**
+ * @brief Returns true if the event is currently scheduled.
+ */
+static inline bool scheduler_is_pending(const Scheduler* sched, SchedulerEvent event) {
+    return sched->heap_index[event] >= 0;
+}
+
+#endif // SCHEDULER_H
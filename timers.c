@@ -1,6 +1,7 @@
 // timers.c
 #include "timers.h"
 #include "interconnect.h" // Needed for interconnect_request_irq and IRQ defines
+#include "logger.h"
 #include <stdio.h>
 #include "gpu.h"
 #include <string.h>
@@ -12,6 +13,12 @@
 #define DOTCLOCK_PAL_HZ 25200000.0 // PAL frequency, for completeness
 #define HBLANK_NTSC_HZ 15625.0 // Horizontal blanking frequency for NTSC
 
+// Largest step taken at once when catching up, so a counter cannot wrap more than once per step
+#define TIMERS_SYNC_CHUNK 0x8000
+
+static void timers_event(void* context, SchedulerEvent event);
+static void timers_reschedule(Timers* timers);
+
 
 /**
  * @brief Helper function to decode the mode register into internal state flags.
@@ -40,13 +47,38 @@ static void timer_update_internal_state(Timer* timer) {
     timer->mode &= ~(1 << 10);
 }
 
+// --- I/O Registers ---
+// Three 16-byte register blocks (0x1f801100, 0x1f801110, 0x1f801120); 8-bit accesses are
+// left to the interconnect's "unhandled width" warning.
+static uint32_t timers_io_read32(void* device, uint32_t offset) {
+    return timer_read32((Timers*)device, (int)(offset >> 4), offset & 0xF);
+}
+
+static uint16_t timers_io_read16(void* device, uint32_t offset) {
+    return timer_read16((Timers*)device, (int)(offset >> 4), offset & 0xF);
+}
+
+static void timers_io_write32(void* device, uint32_t offset, uint32_t value) {
+    timer_write32((Timers*)device, (int)(offset >> 4), offset & 0xF, value);
+}
+
+static void timers_io_write16(void* device, uint32_t offset, uint16_t value) {
+    timer_write16((Timers*)device, (int)(offset >> 4), offset & 0xF, value);
+}
+
+static const IoHandler timers_io_handler = {
+    .name = "Timers",
+    .read32 = timers_io_read32, .read16 = timers_io_read16,
+    .write32 = timers_io_write32, .write16 = timers_io_write16,
+};
+
 /**
  * @brief Initializes the state of all three timers.
  * @param timers Pointer to the Timers structure.
  * @param inter Pointer to the Interconnect (needed for requesting interrupts).
  */
 void timers_init(Timers* timers, Interconnect* inter) {
-    printf("Initializing Timers...\n");
+    LOG_INFO(LOG_TIMERS, "Initializing Timers...\n");
     memset(timers, 0, sizeof(Timers));
     timers->inter = inter;
 
@@ -54,7 +86,7 @@ void timers_init(Timers* timers, Interconnect* inter) {
     // This change is necessary to break the initial BIOS hang by generating
     // the first VBLANK interrupt that the BIOS is waiting for.
 
-    printf("  [HACK] Pre-configuring Timer 1 for VBLANK interrupt.\n");
+    LOG_INFO(LOG_TIMERS, "  [HACK] Pre-configuring Timer 1 for VBLANK interrupt.\n");
 
     // Get a pointer to Timer 1 for convenience
     Timer* vblank_timer = &timers->timers[1];
@@ -77,6 +109,12 @@ void timers_init(Timers* timers, Interconnect* inter) {
     timer_update_internal_state(vblank_timer);
 
     // -------------------- PROPOSED MODIFICATION END --------------------
+
+    // Counters are advanced lazily: on register access and when the next IRQ is due
+    timers->last_sync = inter->scheduler.now;
+    scheduler_register(&inter->scheduler, SCHED_EVENT_TIMERS, timers_event, timers);
+    interconnect_register_io(inter, TIMERS_START, TIMERS_SIZE, &timers_io_handler, timers);
+    timers_reschedule(timers);
 }
 
 
@@ -89,9 +127,10 @@ void timers_init(Timers* timers, Interconnect* inter) {
  */
 uint16_t timer_read16(Timers* timers, int timer_index, uint32_t offset) {
     if (timer_index < 0 || timer_index > 2) {
-        fprintf(stderr, "Timer Read Error: Invalid timer index %d\n", timer_index);
+        LOG_ERROR(LOG_TIMERS, "Timer Read Error: Invalid timer index %d\n", timer_index);
         return 0;
     }
+    timers_sync(timers); // Counter value must reflect the current cycle
     Timer* t = &timers->timers[timer_index];
 
     switch (offset) {
@@ -112,7 +151,7 @@ uint16_t timer_read16(Timers* timers, int timer_index, uint32_t offset) {
         case TMR_REG_TARGET: // 0x8: Target Value
             return t->target;
         default:
-            fprintf(stderr, "Timer Read Error: Unhandled timer%d offset 0x%x\n", timer_index, offset);
+            LOG_ERROR(LOG_TIMERS, "Timer Read Error: Unhandled timer%d offset 0x%x\n", timer_index, offset);
             return 0;
     }
 }
@@ -140,9 +179,10 @@ uint32_t timer_read32(Timers* timers, int timer_index, uint32_t offset) {
  */
 void timer_write16(Timers* timers, int timer_index, uint32_t offset, uint16_t value) {
      if (timer_index < 0 || timer_index > 2) {
-        fprintf(stderr, "Timer Write Error: Invalid timer index %d\n", timer_index);
+        LOG_ERROR(LOG_TIMERS, "Timer Write Error: Invalid timer index %d\n", timer_index);
         return;
     }
+    timers_sync(timers); // Apply the elapsed time under the old settings first
     Timer* t = &timers->timers[timer_index];
 
     switch (offset) {
@@ -158,9 +198,10 @@ void timer_write16(Timers* timers, int timer_index, uint32_t offset, uint16_t va
             t->target = value;
             break;
         default:
-            fprintf(stderr, "Timer Write Error: Unhandled timer%d offset 0x%x = 0x%04x\n", timer_index, offset, value);
+            LOG_ERROR(LOG_TIMERS, "Timer Write Error: Unhandled timer%d offset 0x%x = 0x%04x\n", timer_index, offset, value);
             break;
     }
+    timers_reschedule(timers); // Counter/target/mode changed: the next IRQ may have moved
 }
 
 /**
@@ -176,6 +217,31 @@ void timer_write32(Timers* timers, int timer_index, uint32_t offset, uint32_t va
     timer_write16(timers, timer_index, offset, (uint16_t)value);
 }
 
+/**
+ * @brief Returns how many counter ticks a timer advances per CPU cycle for its clock source.
+ * @param t Pointer to the Timer.
+ * @param timer_index Index of the timer (0, 1, or 2).
+ */
+static double timer_ticks_per_cpu_cycle(const Timer* t, int timer_index) {
+    // Timer 0: System Clock or Dot Clock
+    if (timer_index == 0) {
+        double timer_clock_hz = (t->clock_source == 0) ? PSX_SYSCLK_HZ : DOTCLOCK_NTSC_HZ; // Simplified NTSC
+        return timer_clock_hz / PSX_CPU_HZ;
+    }
+    // Timer 1: System Clock or H-Blank
+    if (timer_index == 1) {
+        if (t->clock_source <= 1) { // 0 or 1
+            return PSX_SYSCLK_HZ / PSX_CPU_HZ; // Sources 0 and 1 are System Clock for Timer 1
+        }
+        // Source 2 or 3 is H-Blank
+        // TODO: This requires accurate GPU dot/line counting. For now, we can approximate.
+        return HBLANK_NTSC_HZ / PSX_CPU_HZ;
+    }
+    // Timer 2: System Clock or System Clock / 8
+    double timer_clock_hz = (t->clock_source <= 1) ? PSX_SYSCLK_HZ : (PSX_SYSCLK_HZ / 8.0);
+    return timer_clock_hz / PSX_CPU_HZ;
+}
+
 /**
  * @brief Steps the timers forward by a number of elapsed CPU clock cycles.
  * Updates counters based on selected clock source, checks for target/overflow,
@@ -202,32 +268,10 @@ void timers_step(Timers* timers, uint32_t cpu_cycles) {
         if (is_paused) {
             continue; // Timer is paused, do nothing for it this step.
         }
-        double timer_clock_hz = 0.0;
 
-        
         // --- 2. Determine Clock Source and Ticks to Add ---
         double ticks_to_add = timers->fractional_ticks[i]; // Start with leftover fraction from last step
-
-        // Timer 0: System Clock or Dot Clock
-        if (i == 0) {
-            timer_clock_hz = (t->clock_source == 0) ? PSX_SYSCLK_HZ : DOTCLOCK_NTSC_HZ; // Simplified NTSC
-            ticks_to_add += (double)cpu_cycles * (timer_clock_hz / PSX_CPU_HZ);
-        }
-        // Timer 1: System Clock or H-Blank
-        else if (i == 1) {
-            if (t->clock_source <= 1) { // 0 or 1
-                 timer_clock_hz = PSX_SYSCLK_HZ; // Sources 0 and 1 are System Clock for Timer 1
-                 ticks_to_add += (double)cpu_cycles * (timer_clock_hz / PSX_CPU_HZ);
-            } else { // Source 2 or 3 is H-Blank
-                // TODO: This requires accurate GPU dot/line counting. For now, we can approximate.
-                ticks_to_add += (double)cpu_cycles * (HBLANK_NTSC_HZ / PSX_CPU_HZ);
-            }
-        }
-        // Timer 2: System Clock or System Clock / 8
-        else { // i == 2
-             timer_clock_hz = (t->clock_source <= 1) ? PSX_SYSCLK_HZ : (PSX_SYSCLK_HZ / 8.0);
-             ticks_to_add += (double)cpu_cycles * (timer_clock_hz / PSX_CPU_HZ);
-        }
+        ticks_to_add += (double)cpu_cycles * timer_ticks_per_cpu_cycle(t, i);
 
         uint32_t whole_ticks = (uint32_t)floor(ticks_to_add);
         if (whole_ticks == 0) {
@@ -262,7 +306,7 @@ void timers_step(Timers* timers, uint32_t cpu_cycles) {
         if (irq) {
             // Set the interrupt request bit in the mode register
             t->mode |= (1 << 10);
-             printf("~ Timers: Timer %d reached target/overflow. Requesting IRQ.\n", i);
+             LOG_TRACE(LOG_TIMERS, "~ Timers: Timer %d reached target/overflow. Requesting IRQ.\n", i);
           
             // Request the interrupt line from the interconnect
             interconnect_request_irq(timers->inter, IRQ_TIMER0 + i);
@@ -275,4 +319,67 @@ void timers_step(Timers* timers, uint32_t cpu_cycles) {
             // so we don't clear them here. This is correct.
         }
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Returns how many CPU cycles can pass before a timer newly reaches an IRQ condition.
+ * Used to place SCHED_EVENT_TIMERS. Rounds down, so the event never fires after the
+ * cycle on which timers_step() would have raised the IRQ.
+ * @param timers Pointer to the Timers structure.
+ * @return Cycles until the next timer IRQ, or UINT32_MAX if no timer can raise one.
+ */
+uint32_t timers_cycles_until_irq(const Timers* timers) {
+    double best = (double)UINT32_MAX;
+
+    for (int i = 0; i < 3; ++i) {
+        const Timer* t = &timers->timers[i];
+        if (!t->irq_on_target && !t->irq_on_ffff) continue;
+
+        // Whole ticks until the counter next crosses the target / wraps past 0xFFFF
+        uint32_t ticks = 0x10000u - t->counter;
+        if (t->irq_on_target && t->counter < t->target && (uint32_t)(t->target - t->counter) < ticks) {
+            ticks = t->target - t->counter;
+        }
+
+        double cycles = ((double)ticks - timers->fractional_ticks[i]) / timer_ticks_per_cpu_cycle(t, i);
+        if (cycles < best) best = cycles;
+    }
+    return best <= 1.0 ? 0 : (uint32_t)best - 1;
+}
+
+
+// --- Scheduler Integration ---
+
+void timers_sync(Timers* timers) {
+    uint64_t now = timers->inter->scheduler.now;
+    while (timers->last_sync < now) {
+        uint64_t behind = now - timers->last_sync;
+        uint32_t chunk = behind > TIMERS_SYNC_CHUNK ? TIMERS_SYNC_CHUNK : (uint32_t)behind;
+        timers_step(timers, chunk);
+        timers->last_sync += chunk;
+    }
+}
+
+/**
+ * @brief Moves the SCHED_EVENT_TIMERS deadline to the next timer IRQ (or cancels it).
+ * Must be called with the timers synced to the current time.
+ */
+static void timers_reschedule(Timers* timers) {
+    Scheduler* sched = &timers->inter->scheduler;
+    uint32_t cycles = timers_cycles_until_irq(timers);
+    if (cycles == UINT32_MAX) {
+        scheduler_cancel(sched, SCHED_EVENT_TIMERS);
+    } else {
+        scheduler_schedule(sched, SCHED_EVENT_TIMERS, cycles > 0 ? cycles : 1);
+    }
+}
+
+/**
+ * @brief SCHED_EVENT_TIMERS callback: catches up (raising any due IRQ) and re-arms.
+ */
+static void timers_event(void* context, SchedulerEvent event) {
+    (void)event;
+    Timers* timers = (Timers*)context;
+    timers_sync(timers);
+    timers_reschedule(timers);
+}
@@ -4,6 +4,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "scheduler.h"
 
 
 // Forward declaration needed if Timers struct holds Interconnect pointer later
@@ -70,6 +71,7 @@ typedef struct {
     // Pointer back to interconnect needed for requesting interrupts
     struct Interconnect* inter;
     double fractional_ticks[3]; // <<< ADD THIS
+    uint64_t last_sync;         // Scheduler time the counters were last advanced to
 
 } Timers;
 
@@ -130,5 +132,19 @@ void timer_write32(Timers* timers, int timer_index, uint32_t offset, uint32_t va
  */
 void timers_step(Timers* timers, uint32_t cycles);
 
+/**
+ * @brief Advances the timers to the scheduler's current time.
+ * Called before register accesses and from the timers' scheduler event.
+ * @param timers Pointer to the Timers structure.
+ */
+void timers_sync(Timers* timers);
+
+/**
+ * @brief Returns how many CPU cycles can elapse before any timer raises a new IRQ.
+ * @param timers Pointer to the Timers structure.
+ * @return Cycles until the next timer IRQ, or UINT32_MAX if none is armed.
+ */
+uint32_t timers_cycles_until_irq(const Timers* timers);
+
 
 #endif // TIMERS_H
\ No newline at end of file
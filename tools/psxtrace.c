@@ -0,0 +1,215 @@
+/**
+ * psxtrace.c
+ * Offline decoder for the emulator's binary trace files (--trace=<file>).
+ *
+ * Build: cc -O2 -I.. -o psxtrace psxtrace.c
+ * Usage: psxtrace [options] <trace file>
+ *   -t <list>     Record types to print: cpu,read,write,bus,irq,dma,gp0,gp1,gpu (default: all)
+ *   -a <lo>:<hi>  Only PCs/bus addresses in [lo, hi] (hex)
+ *   -c <lo>:<hi>  Only records with cycle in [lo, hi] (decimal, full 64-bit cycle)
+ *   -r <region>   Only bus accesses to ram,exp1,scratchpad,io,exp2,bios,cachectl,unmapped
+ *   -n <count>    Stop after printing this many records
+ *   -s            Print per-type / per-region counts instead of the records
+ */
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define READ_CHUNK_RECORDS 65536
+
+// Type filter bits (1 << TraceRecordType)
+#define TYPE_BIT(type) (1u << (type))
+#define TYPES_ALL 0xFFFFFFFFu
+
+static const char* const region_names[] = {
+    "ram", "exp1", "scratchpad", "io", "exp2", "bios", "cachectl", "unmapped",
+};
+#define REGION_COUNT (sizeof(region_names) / sizeof(region_names[0]))
+
+static const char* const irq_names[] = {
+    "VBLANK", "GPU", "CDROM", "DMA", "TIMER0", "TIMER1", "TIMER2", "PAD/MC", "SIO", "SPU", "PIO",
+};
+
+static const char* const dma_port_names[] = { "MDEC-in", "MDEC-out", "GPU", "CDROM", "SPU", "PIO", "OTC" };
+
+static const char* type_name(uint8_t type) {
+    switch (type) {
+        case TRACE_REC_INSTRUCTION: return "CPU";
+        case TRACE_REC_BUS_READ:    return "READ";
+        case TRACE_REC_BUS_WRITE:   return "WRITE";
+        case TRACE_REC_IRQ:         return "IRQ";
+        case TRACE_REC_DMA_START:   return "DMA";
+        case TRACE_REC_GP0:         return "GP0";
+        case TRACE_REC_GP1:         return "GP1";
+        default:                    return "?";
+    }
+}
+
+static uint32_t parse_types(const char* spec) {
+    static const struct { const char* name; uint32_t bits; } names[] = {
+        { "cpu", TYPE_BIT(TRACE_REC_INSTRUCTION) },
+        { "read", TYPE_BIT(TRACE_REC_BUS_READ) },
+        { "write", TYPE_BIT(TRACE_REC_BUS_WRITE) },
+        { "bus", TYPE_BIT(TRACE_REC_BUS_READ) | TYPE_BIT(TRACE_REC_BUS_WRITE) },
+        { "irq", TYPE_BIT(TRACE_REC_IRQ) },
+        { "dma", TYPE_BIT(TRACE_REC_DMA_START) },
+        { "gp0", TYPE_BIT(TRACE_REC_GP0) },
+        { "gp1", TYPE_BIT(TRACE_REC_GP1) },
+        { "gpu", TYPE_BIT(TRACE_REC_GP0) | TYPE_BIT(TRACE_REC_GP1) },
+    };
+    uint32_t mask = 0;
+    while (*spec) {
+        size_t length = strcspn(spec, ",");
+        uint32_t bits = 0;
+        for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+            if (strlen(names[i].name) == length && strncasecmp(spec, names[i].name, length) == 0) bits = names[i].bits;
+        }
+        if (bits == 0) {
+            fprintf(stderr, "psxtrace: unknown record type '%.*s'\n", (int)length, spec);
+            exit(2);
+        }
+        mask |= bits;
+        spec += length;
+        if (*spec == ',') spec++;
+    }
+    return mask;
+}
+
+static void print_record(const TraceRecord* r, uint64_t cycle) {
+    printf("%12llu %-5s ", (unsigned long long)cycle, type_name(r->type));
+    switch (r->type) {
+        case TRACE_REC_INSTRUCTION:
+            printf("pc=%08x  %08x\n", r->a, r->b);
+            break;
+        case TRACE_REC_BUS_READ:
+        case TRACE_REC_BUS_WRITE: {
+            const char* region = r->region < REGION_COUNT ? region_names[r->region] : "?";
+            int digits = r->width * 2;
+            printf("%u %-10s %08x %s %0*x\n", r->width * 8, region, r->a,
+                   r->type == TRACE_REC_BUS_READ ? "->" : "<-", digits, r->b);
+            break;
+        }
+        case TRACE_REC_IRQ:
+            printf("line %u (%s)\n", r->width, r->width < 11 ? irq_names[r->width] : "?");
+            break;
+        case TRACE_REC_DMA_START: {
+            static const char* const sync_names[] = { "manual", "request", "linked-list", "?" };
+            printf("ch%u (%s) %s %s madr=%08x bcr=%08x\n", r->width,
+                   r->width < 7 ? dma_port_names[r->width] : "?",
+                   sync_names[r->region & 3], (r->region >> 4) ? "from-ram" : "to-ram", r->a, r->b);
+            break;
+        }
+        case TRACE_REC_GP0:
+        case TRACE_REC_GP1:
+            printf("%08x (cmd %02x)\n", r->b, r->b >> 24);
+            break;
+        default:
+            printf("type=%u a=%08x b=%08x\n", r->type, r->a, r->b);
+            break;
+    }
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: psxtrace [-t types] [-a lo:hi] [-c lo:hi] [-r region] [-n count] [-s] <trace file>\n");
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    uint32_t types = TYPES_ALL;
+    uint32_t addr_lo = 0, addr_hi = 0xFFFFFFFFu;
+    uint64_t cycle_lo = 0, cycle_hi = UINT64_MAX;
+    int region = -1;
+    uint64_t limit = UINT64_MAX;
+    int stats = 0;
+    const char* path = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "-s") == 0) {
+            stats = 1;
+        } else if (arg[0] == '-' && arg[1] && !arg[2] && i + 1 < argc) {
+            const char* value = argv[++i];
+            switch (arg[1]) {
+                case 't': types = parse_types(value); break;
+                case 'a': if (sscanf(value, "%x:%x", &addr_lo, &addr_hi) != 2) usage(); break;
+                case 'c': if (sscanf(value, "%llu:%llu", (unsigned long long*)&cycle_lo, (unsigned long long*)&cycle_hi) != 2) usage(); break;
+                case 'n': limit = strtoull(value, NULL, 10); break;
+                case 'r':
+                    for (size_t k = 0; k < REGION_COUNT; ++k) {
+                        if (strcasecmp(value, region_names[k]) == 0) region = (int)k;
+                    }
+                    if (region < 0) usage();
+                    break;
+                default: usage();
+            }
+        } else if (arg[0] != '-' && !path) {
+            path = arg;
+        } else {
+            usage();
+        }
+    }
+    if (!path) usage();
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        return 1;
+    }
+    TraceHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, TRACE_MAGIC, 8) != 0) {
+        fprintf(stderr, "psxtrace: %s is not a trace file\n", path);
+        return 1;
+    }
+    if (header.version != TRACE_VERSION || header.record_size != sizeof(TraceRecord)) {
+        fprintf(stderr, "psxtrace: unsupported trace version %u (record size %u)\n", header.version, header.record_size);
+        return 1;
+    }
+
+    TraceRecord* chunk = malloc(READ_CHUNK_RECORDS * sizeof(TraceRecord));
+    uint64_t type_counts[256] = {0};
+    uint64_t region_counts[REGION_COUNT] = {0};
+    uint64_t printed = 0, total = 0;
+    uint64_t cycle_high = 0;
+    uint32_t last_cycle = 0;
+    size_t count;
+
+    while (printed < limit && (count = fread(chunk, sizeof(TraceRecord), READ_CHUNK_RECORDS, file)) > 0) {
+        for (size_t i = 0; i < count && printed < limit; ++i) {
+            const TraceRecord* r = &chunk[i];
+            total++;
+            // The stored cycle is the low 32 bits of a monotonic clock
+            if (r->cycle < last_cycle) cycle_high += 1ull << 32;
+            last_cycle = r->cycle;
+            uint64_t cycle = cycle_high | r->cycle;
+
+            bool is_bus = r->type == TRACE_REC_BUS_READ || r->type == TRACE_REC_BUS_WRITE;
+            if (!(types & TYPE_BIT(r->type))) continue;
+            if (cycle < cycle_lo || cycle > cycle_hi) continue;
+            if ((is_bus || r->type == TRACE_REC_INSTRUCTION) && (r->a < addr_lo || r->a > addr_hi)) continue;
+            if (region >= 0 && (!is_bus || r->region != region)) continue;
+
+            if (stats) {
+                type_counts[r->type]++;
+                if (is_bus && r->region < REGION_COUNT) region_counts[r->region]++;
+            } else {
+                print_record(r, cycle);
+                printed++;
+            }
+        }
+    }
+
+    if (stats) {
+        printf("%llu records\n", (unsigned long long)total);
+        for (int t = TRACE_REC_INSTRUCTION; t <= TRACE_REC_GP1; ++t) {
+            if (type_counts[t]) printf("  %-6s %12llu\n", type_name((uint8_t)t), (unsigned long long)type_counts[t]);
+        }
+        for (size_t k = 0; k < REGION_COUNT; ++k) {
+            if (region_counts[k]) printf("  bus %-10s %12llu\n", region_names[k], (unsigned long long)region_counts[k]);
+        }
+    }
+    free(chunk);
+    fclose(file);
+    return 0;
+}
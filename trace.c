@@ -0,0 +1,196 @@
+// trace.c
+// Binary tracer: records are written straight into a sliding mmap window of the file.
+#include "trace.h"
+#include "interconnect.h" // Memory map constants and mask_region() for the region field
+#include "logger.h"
+#include <stdio.h>
+#include <string.h>
+#include <strings.h> // For strncasecmp
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// Records per mmap window (64 MiB). The file grows one window at a time.
+#define TRACE_WINDOW_RECORDS (1u << 22)
+#define TRACE_WINDOW_BYTES   ((uint64_t)TRACE_WINDOW_RECORDS * sizeof(TraceRecord))
+
+_Static_assert(sizeof(TraceRecord) == 16, "TraceRecord must stay 16 bytes");
+_Static_assert(sizeof(TraceHeader) == sizeof(TraceRecord), "The header occupies one record slot");
+
+uint32_t trace_active = 0;
+
+static int trace_fd = -1;
+static uint32_t trace_event_mask = 0;
+static bool trace_enabled = false;
+static const uint64_t* trace_clock = NULL;
+
+static TraceRecord* window = NULL;     // Current mapping
+static uint64_t window_index = 0;      // Which window of the file is mapped
+static TraceRecord* cursor = NULL;     // Next free slot in the window
+static TraceRecord* window_end = NULL;
+
+
+// --- Window Management ---
+/**
+ * @brief Maps window 'index' of the file, growing the file to cover it.
+ */
+static bool trace_map_window(uint64_t index) {
+    if (window) {
+        munmap(window, TRACE_WINDOW_BYTES);
+        window = NULL;
+    }
+    off_t offset = (off_t)(index * TRACE_WINDOW_BYTES);
+    if (ftruncate(trace_fd, offset + (off_t)TRACE_WINDOW_BYTES) != 0) {
+        perror("Trace: failed to grow the trace file");
+        return false;
+    }
+    void* map = mmap(NULL, TRACE_WINDOW_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, trace_fd, offset);
+    if (map == MAP_FAILED) {
+        perror("Trace: failed to map the trace file");
+        return false;
+    }
+    window = (TraceRecord*)map;
+    window_index = index;
+    cursor = window;
+    window_end = window + TRACE_WINDOW_RECORDS;
+    return true;
+}
+
+/**
+ * @brief Returns the next free record slot, moving to the next window when full.
+ * On a mapping failure the trace is closed and NULL returned.
+ */
+static inline TraceRecord* trace_next_record(void) {
+    if (cursor == window_end && !trace_map_window(window_index + 1)) {
+        trace_close();
+        return NULL;
+    }
+    return cursor++;
+}
+
+static inline void trace_emit(uint8_t type, uint8_t width, uint8_t region, uint32_t a, uint32_t b) {
+    TraceRecord* record = trace_next_record();
+    if (!record) return;
+    record->type = type;
+    record->width = width;
+    record->region = region;
+    record->flags = 0;
+    record->cycle = (uint32_t)*trace_clock;
+    record->a = a;
+    record->b = b;
+}
+
+static uint8_t trace_region_of(uint32_t address) {
+    uint32_t physical_addr = mask_region(address);
+    if (physical_addr <= RAM_MIRROR_END) return TRACE_REGION_RAM;
+    if (physical_addr >= SCRATCHPAD_START && physical_addr <= SCRATCHPAD_END) return TRACE_REGION_SCRATCHPAD;
+    if (physical_addr >= EXPANSION_2_START && physical_addr <= EXPANSION_2_END) return TRACE_REGION_EXPANSION2;
+    if (physical_addr >= IO_PORTS_START && physical_addr <= IO_PORTS_END) return TRACE_REGION_IO;
+    if (physical_addr >= EXPANSION_1_START && physical_addr <= EXPANSION_1_END) return TRACE_REGION_EXPANSION1;
+    if (physical_addr >= BIOS_START && physical_addr <= BIOS_END) return TRACE_REGION_BIOS;
+    if (physical_addr == CACHE_CONTROL_ADDR) return TRACE_REGION_CACHE_CONTROL;
+    return TRACE_REGION_UNMAPPED;
+}
+
+
+// --- Public API ---
+bool trace_open(const char* path, uint32_t mask, const uint64_t* clock) {
+    if (trace_fd >= 0) trace_close();
+
+    trace_fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (trace_fd < 0) {
+        perror("Trace: failed to create the trace file");
+        return false;
+    }
+    trace_clock = clock;
+    trace_event_mask = mask;
+    if (!trace_map_window(0)) {
+        close(trace_fd);
+        trace_fd = -1;
+        return false;
+    }
+
+    // The header takes the first record slot
+    TraceHeader* header = (TraceHeader*)cursor++;
+    memcpy(header->magic, TRACE_MAGIC, sizeof(header->magic));
+    header->version = TRACE_VERSION;
+    header->record_size = sizeof(TraceRecord);
+    header->mask = mask;
+
+    trace_enabled = false;
+    trace_active = 0;
+    LOG_INFO(LOG_CPU, "Trace: writing to '%s' (mask 0x%02x, paused).\n", path, mask);
+    return true;
+}
+
+void trace_close(void) {
+    if (trace_fd < 0) return;
+    trace_active = 0;
+    trace_enabled = false;
+
+    uint64_t used = window_index * TRACE_WINDOW_RECORDS + (uint64_t)(cursor - window);
+    munmap(window, TRACE_WINDOW_BYTES);
+    window = cursor = window_end = NULL;
+    if (ftruncate(trace_fd, (off_t)(used * sizeof(TraceRecord))) != 0) {
+        perror("Trace: failed to trim the trace file");
+    }
+    close(trace_fd);
+    trace_fd = -1;
+    LOG_INFO(LOG_CPU, "Trace: closed after %llu records.\n", (unsigned long long)(used - 1));
+}
+
+void trace_set_enabled(bool enabled) {
+    if (trace_fd < 0) return;
+    trace_enabled = enabled;
+    trace_active = enabled ? trace_event_mask : 0;
+}
+
+bool trace_is_enabled(void) {
+    return trace_enabled;
+}
+
+uint32_t trace_mask(void) {
+    return trace_fd >= 0 ? trace_event_mask : 0;
+}
+
+uint32_t trace_parse_mask(const char* spec) {
+    static const struct { const char* name; uint32_t bits; } names[] = {
+        { "cpu", TRACE_CPU }, { "bus", TRACE_BUS }, { "irq", TRACE_IRQ },
+        { "dma", TRACE_DMA }, { "gpu", TRACE_GPU }, { "all", TRACE_ALL },
+    };
+    uint32_t mask = 0;
+    while (*spec) {
+        size_t length = strcspn(spec, ",");
+        uint32_t bits = 0;
+        for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+            if (strlen(names[i].name) == length && strncasecmp(spec, names[i].name, length) == 0) {
+                bits = names[i].bits;
+            }
+        }
+        if (bits == 0) return 0;
+        mask |= bits;
+        spec += length;
+        if (*spec == ',') spec++;
+    }
+    return mask;
+}
+
+void trace_instruction(uint32_t pc, uint32_t instruction) {
+    trace_emit(TRACE_REC_INSTRUCTION, 4, trace_region_of(pc), pc, instruction);
+}
+
+void trace_bus(bool write, uint32_t address, uint32_t width, uint32_t value) {
+    trace_emit(write ? TRACE_REC_BUS_WRITE : TRACE_REC_BUS_READ, (uint8_t)width, trace_region_of(address), address, value);
+}
+
+void trace_irq(uint32_t irq_line) {
+    trace_emit(TRACE_REC_IRQ, (uint8_t)irq_line, 0, 0, 0);
+}
+
+void trace_dma_start(uint32_t channel, uint32_t mode, uint32_t base_addr, uint32_t block_control) {
+    trace_emit(TRACE_REC_DMA_START, (uint8_t)channel, (uint8_t)mode, base_addr, block_control);
+}
+
+void trace_gpu(uint32_t port, uint32_t word) {
+    trace_emit(port == 0 ? TRACE_REC_GP0 : TRACE_REC_GP1, 4, 0, 0, word);
+}
@@ -0,0 +1,115 @@
+// trace.h
+// Compact binary execution trace: fixed-size records appended to a memory-mapped file.
+// This header is also used by the offline decoder (tools/psxtrace.c), so it only
+// depends on the C standard headers.
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TRACE_MAGIC   "PSXTRACE"
+#define TRACE_VERSION 1
+
+// --- Event Classes (bit mask) ---
+#define TRACE_CPU  (1u << 0) // Every executed instruction (PC + word)
+#define TRACE_BUS  (1u << 1) // Loads/stores that reach the interconnect
+#define TRACE_IRQ  (1u << 2) // interconnect_request_irq
+#define TRACE_DMA  (1u << 3) // DMA transfer starts
+#define TRACE_GPU  (1u << 4) // GP0/GP1 words
+#define TRACE_ALL  (TRACE_CPU | TRACE_BUS | TRACE_IRQ | TRACE_DMA | TRACE_GPU)
+
+typedef enum {
+    TRACE_REC_INSTRUCTION = 1, // a = PC, b = instruction
+    TRACE_REC_BUS_READ,        // a = address, b = value, width, region
+    TRACE_REC_BUS_WRITE,       // a = address, b = value, width, region
+    TRACE_REC_IRQ,             // width = IRQ line
+    TRACE_REC_DMA_START,       // width = channel, region = sync mode | direction << 4, a = MADR, b = BCR
+    TRACE_REC_GP0,             // b = word
+    TRACE_REC_GP1,             // b = word
+} TraceRecordType;
+
+// Physical region of a bus access (derived from the masked address)
+typedef enum {
+    TRACE_REGION_RAM = 0,
+    TRACE_REGION_EXPANSION1,
+    TRACE_REGION_SCRATCHPAD,
+    TRACE_REGION_IO,
+    TRACE_REGION_EXPANSION2,
+    TRACE_REGION_BIOS,
+    TRACE_REGION_CACHE_CONTROL,
+    TRACE_REGION_UNMAPPED,
+} TraceRegion;
+
+/* --- On-disk Layout ---
+ * The file starts with one TraceHeader followed by TraceRecords, all 16 bytes and
+ * little-endian. The record count is implied by the file size. 'cycle' holds the low
+ * 32 bits of the scheduler clock; it only grows, so readers rebuild the full value
+ * by counting wrap-arounds.
+ */
+typedef struct {
+    char magic[8];        // TRACE_MAGIC (not NUL terminated)
+    uint16_t version;     // TRACE_VERSION
+    uint16_t record_size; // sizeof(TraceRecord)
+    uint32_t mask;        // Event classes enabled when the file was opened
+} TraceHeader;
+
+typedef struct {
+    uint8_t type;   // TraceRecordType
+    uint8_t width;  // Access size in bytes / IRQ line / DMA channel
+    uint8_t region; // TraceRegion / DMA mode
+    uint8_t flags;  // Reserved (0)
+    uint32_t cycle;
+    uint32_t a;
+    uint32_t b;
+} TraceRecord;
+
+
+// --- Recording (emulator side) ---
+// Event classes currently being recorded: 0 unless a trace file is open and enabled.
+// Hooks test it inline, so a disabled tracer costs one load and branch per hook.
+extern uint32_t trace_active;
+
+static inline bool trace_on(uint32_t event_class) {
+    return (trace_active & event_class) != 0;
+}
+
+/**
+ * @brief Creates (truncates) the trace file and writes its header. Recording starts paused.
+ * @param path Output file.
+ * @param mask Event classes to record (TRACE_* bits).
+ * @param clock Time source stamped on every record (the scheduler clock).
+ * @return true on success.
+ */
+bool trace_open(const char* path, uint32_t mask, const uint64_t* clock);
+
+/**
+ * @brief Unmaps the file and truncates it to the records actually written.
+ */
+void trace_close(void);
+
+/**
+ * @brief Starts or pauses recording without closing the file (no-op if nothing is open).
+ */
+void trace_set_enabled(bool enabled);
+bool trace_is_enabled(void);
+
+/**
+ * @brief Returns the event mask of the open trace (0 if none).
+ */
+uint32_t trace_mask(void);
+
+/**
+ * @brief Parses a comma separated list of event classes ("cpu,bus,irq,dma,gpu" or "all").
+ * @return The TRACE_* mask, 0 if any name is unknown.
+ */
+uint32_t trace_parse_mask(const char* spec);
+
+// Record writers; call them behind a trace_on() test.
+void trace_instruction(uint32_t pc, uint32_t instruction);
+void trace_bus(bool write, uint32_t address, uint32_t width, uint32_t value);
+void trace_irq(uint32_t irq_line);
+void trace_dma_start(uint32_t channel, uint32_t mode, uint32_t base_addr, uint32_t block_control);
+void trace_gpu(uint32_t port, uint32_t word);
+
+#endif // TRACE_H
@@ -1,6 +1,11 @@
 #include "vram.h"
 #include <stdio.h>  // For fprintf, stderr (optional error checking)
 #include <string.h> // For memset
+#if defined(__AVX2__)
+#include <immintrin.h> // Row kernels (see vram.h)
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 /**
  * @brief Initializes the VRAM memory.
@@ -10,6 +15,8 @@
 void vram_init(Vram* vram) {
     // Fill VRAM with zeros initially. Unlike RAM, VRAM often starts cleared.
     memset(vram->data, 0x00, VRAM_SIZE);
+    // Everything starts dirty: no consumer has seen the content yet
+    memset(vram->dirty, 0xFF, sizeof(vram->dirty));
     printf("VRAM Initialized (%d bytes, filled with 0x00).\n", VRAM_SIZE);
 }
 
@@ -52,6 +59,7 @@ void vram_store32(Vram* vram, uint32_t offset, uint32_t value) {
     vram->data[offset + 1] = (uint8_t)((value >> 8) & 0xFF);
     vram->data[offset + 2] = (uint8_t)((value >> 16) & 0xFF);
     vram->data[offset + 3] = (uint8_t)((value >> 24) & 0xFF);
+    vram_mark_dirty(vram, offset);
 }
 
 // Reads a 16-bit value from VRAM (Little-Endian) - Primary access method
@@ -81,6 +89,7 @@ void vram_store16(Vram* vram, uint32_t offset, uint16_t value) {
     }
     vram->data[offset + 0] = (uint8_t)(value & 0xFF);
     vram->data[offset + 1] = (uint8_t)((value >> 8) & 0xFF);
+    vram_mark_dirty(vram, offset);
 }
 
 // Reads an 8-bit value from VRAM
@@ -99,4 +108,156 @@ void vram_store8(Vram* vram, uint32_t offset, uint8_t value) {
         return;
     }
     vram->data[offset] = value;
-}
\ No newline at end of file
+    vram_mark_dirty(vram, offset);
+}
+
+
+// --- Dirty Tracking ---
+
+void vram_mark_dirty_rect(Vram* vram, uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    vram_blocks_add_rect(vram->dirty, x, y, w, h);
+}
+
+void vram_blocks_add_rect(uint16_t blocks[VRAM_DIRTY_BANDS], uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    if (w == 0 || h == 0) return;
+    // Column mask, wrapping at the right edge
+    uint32_t first_col = (x & (VRAM_WIDTH - 1)) >> VRAM_DIRTY_BLOCK_W_SHIFT;
+    uint32_t col_count = (((x & (VRAM_DIRTY_BLOCK_W - 1)) + w - 1) >> VRAM_DIRTY_BLOCK_W_SHIFT) + 1;
+    uint16_t columns = 0xFFFF;
+    if (col_count < VRAM_DIRTY_COLUMNS) {
+        uint32_t mask = (1u << col_count) - 1;
+        columns = (uint16_t)((mask << first_col) | (mask >> (VRAM_DIRTY_COLUMNS - first_col)));
+    }
+    // Bands, wrapping at the bottom edge
+    uint32_t first_band = (y & (VRAM_HEIGHT - 1)) >> VRAM_DIRTY_BLOCK_H_SHIFT;
+    uint32_t band_count = (((y & (VRAM_DIRTY_BLOCK_H - 1)) + h - 1) >> VRAM_DIRTY_BLOCK_H_SHIFT) + 1;
+    if (band_count > VRAM_DIRTY_BANDS) band_count = VRAM_DIRTY_BANDS;
+    for (uint32_t i = 0; i < band_count; ++i) {
+        blocks[(first_band + i) & (VRAM_DIRTY_BANDS - 1)] |= columns;
+    }
+}
+
+void vram_clear_dirty(Vram* vram) {
+    memset(vram->dirty, 0, sizeof(vram->dirty));
+}
+
+bool vram_take_dirty(Vram* vram, uint16_t out[VRAM_DIRTY_BANDS]) {
+    uint16_t any = 0;
+    for (int band = 0; band < VRAM_DIRTY_BANDS; ++band) {
+        out[band] = vram->dirty[band];
+        any |= vram->dirty[band];
+        vram->dirty[band] = 0;
+    }
+    return any != 0;
+}
+
+// vram_dirty_rects fallback: one rectangle per group of consecutive dirty bands
+static uint32_t vram_dirty_rects_coarse(const uint16_t dirty[VRAM_DIRTY_BANDS], VramRect* rects) {
+    uint32_t count = 0;
+    for (uint32_t band = 0; band < VRAM_DIRTY_BANDS;) {
+        if (dirty[band] == 0) {
+            ++band;
+            continue;
+        }
+        uint32_t columns = 0, first_band = band;
+        while (band < VRAM_DIRTY_BANDS && dirty[band] != 0) columns |= dirty[band++];
+        uint32_t first = (uint32_t)__builtin_ctz(columns), last = 31 - (uint32_t)__builtin_clz(columns);
+        rects[count++] = (VramRect){ (uint16_t)(first << VRAM_DIRTY_BLOCK_W_SHIFT), (uint16_t)(first_band << VRAM_DIRTY_BLOCK_H_SHIFT),
+                                     (uint16_t)((last - first + 1) << VRAM_DIRTY_BLOCK_W_SHIFT),
+                                     (uint16_t)((band - first_band) << VRAM_DIRTY_BLOCK_H_SHIFT) };
+    }
+    return count;
+}
+
+uint32_t vram_dirty_rects(const uint16_t dirty[VRAM_DIRTY_BANDS], VramRect* rects, uint32_t max_rects) {
+    uint32_t count = 0;
+    for (uint32_t band = 0; band < VRAM_DIRTY_BANDS; ++band) {
+        uint32_t mask = dirty[band];
+        uint16_t top = (uint16_t)(band << VRAM_DIRTY_BLOCK_H_SHIFT);
+        while (mask != 0) {
+            uint32_t first = (uint32_t)__builtin_ctz(mask);
+            uint32_t length = (uint32_t)__builtin_ctz(~(mask >> first)); // Columns in this run
+            mask &= ~(((1u << length) - 1) << first);
+            uint16_t x = (uint16_t)(first << VRAM_DIRTY_BLOCK_W_SHIFT), w = (uint16_t)(length << VRAM_DIRTY_BLOCK_W_SHIFT);
+
+            // Extend the rectangle ending just above with the same columns, if any
+            uint32_t i = 0;
+            while (i < count && (rects[i].x != x || rects[i].w != w || rects[i].y + rects[i].h != top)) ++i;
+            if (i < count) {
+                rects[i].h += VRAM_DIRTY_BLOCK_H;
+                continue;
+            }
+            if (count == max_rects) return vram_dirty_rects_coarse(dirty, rects);
+            rects[count++] = (VramRect){ x, top, w, VRAM_DIRTY_BLOCK_H };
+        }
+    }
+    return count;
+}
+
+
+// --- Row Kernels ---
+
+#if defined(__AVX2__)
+#define VRAM_VECTOR_PIXELS 16 // One 256-bit register
+typedef __m256i VramVector;
+#define vram_vec_set1(p)       _mm256_set1_epi16((short)(p))
+#define vram_vec_load(ptr)     _mm256_loadu_si256((const __m256i*)(ptr))
+#define vram_vec_store(ptr, v) _mm256_storeu_si256((__m256i*)(ptr), (v))
+#define vram_vec_or(a, b)      _mm256_or_si256((a), (b))
+#define vram_vec_sign(v)       _mm256_srai_epi16((v), 15)
+#define vram_vec_select(m, a, b) _mm256_or_si256(_mm256_and_si256((m), (a)), _mm256_andnot_si256((m), (b)))
+#elif defined(__SSE2__)
+#define VRAM_VECTOR_PIXELS 8 // One 128-bit register
+typedef __m128i VramVector;
+#define vram_vec_set1(p)       _mm_set1_epi16((short)(p))
+#define vram_vec_load(ptr)     _mm_loadu_si128((const __m128i*)(ptr))
+#define vram_vec_store(ptr, v) _mm_storeu_si128((__m128i*)(ptr), (v))
+#define vram_vec_or(a, b)      _mm_or_si128((a), (b))
+#define vram_vec_sign(v)       _mm_srai_epi16((v), 15)
+#define vram_vec_select(m, a, b) _mm_or_si128(_mm_and_si128((m), (a)), _mm_andnot_si128((m), (b)))
+#endif
+
+void vram_fill_span(uint16_t* dst, uint16_t pixel, uint32_t count) {
+    uint32_t i = 0;
+#ifdef VRAM_VECTOR_PIXELS
+    VramVector fill = vram_vec_set1(pixel);
+    for (; i + 2 * VRAM_VECTOR_PIXELS <= count; i += 2 * VRAM_VECTOR_PIXELS) {
+        vram_vec_store(dst + i, fill);
+        vram_vec_store(dst + i + VRAM_VECTOR_PIXELS, fill);
+    }
+    for (; i + VRAM_VECTOR_PIXELS <= count; i += VRAM_VECTOR_PIXELS) {
+        vram_vec_store(dst + i, fill);
+    }
+#endif
+    for (; i < count; ++i) dst[i] = pixel;
+}
+
+void vram_write_span(uint16_t* dst, const void* src, uint32_t count, uint16_t mask_or, bool preserve_masked) {
+    if (mask_or == 0 && !preserve_masked) {
+        memcpy(dst, src, (size_t)count * VRAM_BPP);
+        return;
+    }
+    const uint8_t* bytes = (const uint8_t*)src;
+    uint32_t i = 0;
+#ifdef VRAM_VECTOR_PIXELS
+    VramVector set = vram_vec_set1(mask_or);
+    if (preserve_masked) {
+        for (; i + VRAM_VECTOR_PIXELS <= count; i += VRAM_VECTOR_PIXELS) {
+            VramVector old = vram_vec_load(dst + i);
+            VramVector masked = vram_vec_sign(old); // All ones where bit 15 is set
+            VramVector pixels = vram_vec_or(vram_vec_load(bytes + i * VRAM_BPP), set);
+            vram_vec_store(dst + i, vram_vec_select(masked, old, pixels));
+        }
+    } else {
+        for (; i + VRAM_VECTOR_PIXELS <= count; i += VRAM_VECTOR_PIXELS) {
+            vram_vec_store(dst + i, vram_vec_or(vram_vec_load(bytes + i * VRAM_BPP), set));
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        if (preserve_masked && (dst[i] & 0x8000)) continue;
+        uint16_t pixel;
+        memcpy(&pixel, bytes + i * VRAM_BPP, sizeof(pixel));
+        dst[i] = pixel | mask_or;
+    }
+}
@@ -2,6 +2,7 @@
 #define VRAM_H
 
 #include <stdint.h> // For uint8_t, uint16_t, uint32_t
+#include <stdbool.h>
 
 // Define the dimensions and size of the PlayStation's VRAM
 // 1024 pixels wide, 512 pixels high, 16 bits (2 bytes) per pixel
@@ -10,9 +11,21 @@
 #define VRAM_BPP 2 // Bytes per pixel
 #define VRAM_SIZE (VRAM_WIDTH * VRAM_HEIGHT * VRAM_BPP) // 1 Megabyte
 
+/* --- Dirty Tracking ---
+ * VRAM is split into 64x16-pixel blocks: 32 bands of 16 lines, each band a 16-bit
+ * mask with one bit per 64-pixel column. Writes set the bit of their block.
+ */
+#define VRAM_DIRTY_BLOCK_W_SHIFT 6  // 64 pixels
+#define VRAM_DIRTY_BLOCK_H_SHIFT 4  // 16 lines
+#define VRAM_DIRTY_BLOCK_W (1 << VRAM_DIRTY_BLOCK_W_SHIFT)
+#define VRAM_DIRTY_BLOCK_H (1 << VRAM_DIRTY_BLOCK_H_SHIFT)
+#define VRAM_DIRTY_COLUMNS (VRAM_WIDTH >> VRAM_DIRTY_BLOCK_W_SHIFT)  // 16 (bits per band)
+#define VRAM_DIRTY_BANDS   (VRAM_HEIGHT >> VRAM_DIRTY_BLOCK_H_SHIFT) // 32
+
 // Structure to hold the VRAM data
 typedef struct {
     uint8_t data[VRAM_SIZE]; // Buffer for the 1MB VRAM content
+    uint16_t dirty[VRAM_DIRTY_BANDS]; // Blocks written since the last vram_clear_dirty/vram_take_dirty
 } Vram;
 
 // --- Function Prototypes ---
@@ -75,5 +88,98 @@ uint8_t vram_load8(Vram* vram, uint32_t offset);
  */
 void vram_store8(Vram* vram, uint32_t offset, uint8_t value);
 
+/**
+ * @brief Marks the 64x16 block containing a byte offset as written (one OR, no branch).
+ * @param vram Pointer to the Vram instance.
+ * @param offset The byte offset within VRAM.
+ */
+static inline void vram_mark_dirty(Vram* vram, uint32_t offset) {
+    // offset = (y * VRAM_WIDTH + x) * 2: band = y >> 4 = offset >> 15, column = x >> 6
+    vram->dirty[(offset >> 15) & (VRAM_DIRTY_BANDS - 1)] |= (uint16_t)(1u << ((offset >> 7) & (VRAM_DIRTY_COLUMNS - 1)));
+}
+
+/**
+ * @brief Marks every block overlapping a rectangle (coordinates wrap like the GPU's).
+ * Used by writers that fill whole areas without going through vram_store*.
+ * @param vram Pointer to the Vram instance.
+ * @param x Left edge in pixels.
+ * @param y Top edge in lines.
+ * @param w Width in pixels.
+ * @param h Height in lines.
+ */
+void vram_mark_dirty_rect(Vram* vram, uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+
+/**
+ * @brief vram_mark_dirty_rect on a separate block bitmap (same layout as Vram.dirty),
+ * for code that tracks which areas it reads or writes.
+ */
+void vram_blocks_add_rect(uint16_t blocks[VRAM_DIRTY_BANDS], uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+
+/**
+ * @brief Returns the dirty column mask of a band (bit n = pixels n*64 .. n*64+63).
+ * @param vram Pointer to the Vram instance.
+ * @param band Band index (lines band*16 .. band*16+15).
+ */
+static inline uint16_t vram_dirty_band(const Vram* vram, uint32_t band) {
+    return vram->dirty[band];
+}
+
+/**
+ * @brief Clears the whole dirty bitmap.
+ * @param vram Pointer to the Vram instance.
+ */
+void vram_clear_dirty(Vram* vram);
+
+/**
+ * @brief Copies the dirty bitmap to 'out' and clears it.
+ * @param vram Pointer to the Vram instance.
+ * @param out Receives one column mask per band.
+ * @return true if any block was dirty.
+ */
+bool vram_take_dirty(Vram* vram, uint16_t out[VRAM_DIRTY_BANDS]);
+
+// A pixel rectangle of VRAM (vram_dirty_rects)
+typedef struct {
+    uint16_t x, y, w, h;
+} VramRect;
+
+/**
+ * @brief Turns a dirty bitmap into a few rectangles covering every dirty block: each run
+ * of dirty columns in a band is a rectangle, grown downwards while the bands below have
+ * the same run. If that needs more than 'max_rects', each group of consecutive dirty
+ * bands becomes one rectangle spanning its leftmost to rightmost dirty column instead
+ * (at most VRAM_DIRTY_BANDS / 2), which may cover clean blocks too.
+ * @param dirty Column masks, as filled by vram_take_dirty.
+ * @param rects Receives the rectangles, in pixels.
+ * @param max_rects Capacity of 'rects', at least VRAM_DIRTY_BANDS / 2.
+ * @return Number of rectangles (0 if nothing is dirty).
+ */
+uint32_t vram_dirty_rects(const uint16_t dirty[VRAM_DIRTY_BANDS], VramRect* rects, uint32_t max_rects);
+
+/* --- Row Kernels ---
+ * Bulk pixel operations on one span of a VRAM line, used by the GP0 transfer commands.
+ * They use 256-bit (AVX2) or 128-bit (SSE2) vectors when the compiler targets them and
+ * plain loops otherwise. Spans must not cross the right edge of VRAM; the caller splits
+ * them where X wraps and marks the blocks dirty.
+ */
+
+/**
+ * @brief Sets 'count' pixels to 'pixel' (GP0(02) fill).
+ * @param dst First pixel of the span.
+ * @param pixel 16-bit value stored as is.
+ * @param count Pixels to fill.
+ */
+void vram_fill_span(uint16_t* dst, uint16_t pixel, uint32_t count);
+
+/**
+ * @brief Stores 'count' pixels read from 'src' (any alignment, little-endian) with the
+ * GP0(E6) mask settings applied: OR 'mask_or' into every pixel and, with
+ * 'preserve_masked', leave the pixels that already have bit 15 set. Without either it
+ * is a memcpy. 'src' must not overlap 'dst'.
+ * @param mask_or 0x8000 to force the mask bit, else 0.
+ * @param preserve_masked Skip destination pixels with the mask bit set.
+ */
+void vram_write_span(uint16_t* dst, const void* src, uint32_t count, uint16_t mask_or, bool preserve_masked);
+
 
 #endif // VRAM_H
\ No newline at end of file